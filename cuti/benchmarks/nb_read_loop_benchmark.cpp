@@ -0,0 +1,218 @@
+/*
+ * Copyright (C) 2021-2026 CodeShop B.V.
+ *
+ * This file is part of the cuti library.
+ *
+ * The cuti library is free software: you can redistribute it and/or
+ * modify it under the terms of version 2.1 of the GNU Lesser General
+ * Public License as published by the Free Software Foundation.
+ *
+ * The cuti library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See version
+ * 2.1 of the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of version 2.1 of the GNU Lesser
+ * General Public License along with the cuti library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Measures the cost of a scheduler wakeup in a tight read loop: an
+ * nb_string_inbuf is read in small chunks, with one
+ * call_when_readable() per chunk.  As the buffer is always readable,
+ * every chunk costs exactly one trip through the scheduler.
+ */
+
+#include <cuti/callback.hpp>
+#include <cuti/chrono_types.hpp>
+#include <cuti/cmdline_reader.hpp>
+#include <cuti/default_scheduler.hpp>
+#include <cuti/nb_inbuf.hpp>
+#include <cuti/nb_string_inbuf.hpp>
+#include <cuti/option_walker.hpp>
+#include <cuti/socket_layer.hpp>
+#include <cuti/stack_marker.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace // anonymous
+{
+
+using namespace cuti;
+
+struct options_t
+{
+  static unsigned int constexpr default_chunk_size = 64;
+  static unsigned int constexpr default_input_size = 3 * 1024 * 1024;
+  static unsigned int constexpr default_rounds = 10;
+
+  options_t()
+  : chunk_size_(default_chunk_size)
+  , input_size_(default_input_size)
+  , rounds_(default_rounds)
+  { }
+
+  unsigned int chunk_size_;
+  unsigned int input_size_;
+  unsigned int rounds_;
+};
+
+void print_usage(std::ostream& os, char const* argv0)
+{
+  os << "usage: " << argv0 << " [<option> ...]\n";
+  os << "options are:\n";
+  os << "  --chunk-size <n>         bytes read per wakeup " <<
+    "(default: " << options_t::default_chunk_size << ")\n";
+  os << "  --input-size <n>         bytes read per round " <<
+    "(default: " << options_t::default_input_size << ")\n";
+  os << "  --rounds <n>             number of rounds " <<
+    "(default: " << options_t::default_rounds << ")\n";
+  os << std::flush;
+}
+
+void read_options(options_t& options, option_walker_t& walker)
+{
+  while(!walker.done())
+  {
+    if(!walker.match("--chunk-size", options.chunk_size_) &&
+       !walker.match("--input-size", options.input_size_) &&
+       !walker.match("--rounds", options.rounds_))
+    {
+      break;
+    }
+  }
+}
+
+struct read_loop_t
+{
+  read_loop_t(scheduler_t& scheduler,
+              nb_inbuf_t& inbuf,
+              std::size_t chunk_size)
+  : scheduler_(scheduler)
+  , inbuf_(inbuf)
+  , chunk_(chunk_size)
+  , n_bytes_(0)
+  , n_wakeups_(0)
+  { }
+
+  void start()
+  {
+    inbuf_.call_when_readable(scheduler_,
+      [this](stack_marker_t& marker) { this->on_readable(marker); });
+  }
+
+  std::size_t n_bytes() const
+  {
+    return n_bytes_;
+  }
+
+  std::size_t n_wakeups() const
+  {
+    return n_wakeups_;
+  }
+
+private :
+  void on_readable(stack_marker_t&)
+  {
+    ++n_wakeups_;
+
+    char* first = chunk_.data();
+    char* next = inbuf_.read(first, first + chunk_.size());
+    if(next == first)
+    {
+      // eof
+      return;
+    }
+
+    n_bytes_ += next - first;
+    this->start();
+  }
+
+private :
+  scheduler_t& scheduler_;
+  nb_inbuf_t& inbuf_;
+  std::vector<char> chunk_;
+  std::size_t n_bytes_;
+  std::size_t n_wakeups_;
+};
+
+int run_benchmark(int argc, char const* const* argv)
+{
+  options_t options;
+  cmdline_reader_t reader(argc, argv);
+  option_walker_t walker(reader);
+
+  read_options(options, walker);
+  if(!walker.done() || !reader.at_end() ||
+     options.chunk_size_ == 0 || options.rounds_ == 0)
+  {
+    print_usage(std::cerr, argv[0]);
+    return 1;
+  }
+
+  socket_layer_t sockets;
+  std::string const input(options.input_size_, 'x');
+
+  std::chrono::nanoseconds total_time(0);
+  std::size_t total_wakeups = 0;
+
+  for(unsigned int round = 0; round != options.rounds_; ++round)
+  {
+    default_scheduler_t scheduler(sockets);
+    auto inbuf = make_nb_string_inbuf(input);
+    read_loop_t loop(scheduler, *inbuf, options.chunk_size_);
+
+    auto start = std::chrono::steady_clock::now();
+
+    loop.start();
+    stack_marker_t base_marker;
+    while(callback_t callback = scheduler.wait())
+    {
+      callback(base_marker);
+    }
+
+    total_time += std::chrono::steady_clock::now() - start;
+    total_wakeups += loop.n_wakeups();
+
+    if(loop.n_bytes() != input.size())
+    {
+      std::cerr << argv[0] << ": expected " << input.size() <<
+        " bytes, got " << loop.n_bytes() << std::endl;
+      return 1;
+    }
+  }
+
+  auto ns_per_round = total_time.count() / options.rounds_;
+  auto ns_per_wakeup = total_time.count() / total_wakeups;
+
+  std::cout << "chunk size: " << options.chunk_size_ <<
+    " input size: " << options.input_size_ <<
+    " rounds: " << options.rounds_ << '\n';
+  std::cout << "per wakeup: " << ns_per_wakeup << " ns" <<
+    " per round: " << ns_per_round / 1000 << " us" << std::endl;
+
+  return 0;
+}
+
+} // anonymous
+
+int main(int argc, char* argv[])
+{
+  try
+  {
+    return run_benchmark(argc, argv);
+  }
+  catch(std::exception const& ex)
+  {
+    std::cerr << argv[0] << ": exception: " << ex.what() << std::endl;
+  }
+
+  return 1;
+}
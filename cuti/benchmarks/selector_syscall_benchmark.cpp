@@ -0,0 +1,482 @@
+/*
+ * Copyright (C) 2021-2026 CodeShop B.V.
+ *
+ * This file is part of the cuti library.
+ *
+ * The cuti library is free software: you can redistribute it and/or
+ * modify it under the terms of version 2.1 of the GNU Lesser General
+ * Public License as published by the Free Software Foundation.
+ *
+ * The cuti library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See version
+ * 2.1 of the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of version 2.1 of the GNU Lesser
+ * General Public License along with the cuti library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Counts the selector syscalls needed to stream data through a
+ * connected pair of nb_tcp buffers on a single scheduler, for each of
+ * the available selectors (or just the one given with --selector).
+ *
+ * On Linux, the counts are taken by interposing epoll_ctl(),
+ * epoll_wait(), poll(), select() and syscall() (for io_uring_enter),
+ * which forward to the C library through dlsym(RTLD_NEXT).  This only
+ * sees the calls made through the dynamic linker, so the cuti library
+ * must be linked as a shared library for the counts to be complete.
+ */
+
+#include <cuti/callback.hpp>
+#include <cuti/cmdline_reader.hpp>
+#include <cuti/default_scheduler.hpp>
+#include <cuti/nb_inbuf.hpp>
+#include <cuti/nb_outbuf.hpp>
+#include <cuti/nb_tcp_buffers.hpp>
+#include <cuti/option_walker.hpp>
+#include <cuti/selector_factory.hpp>
+#include <cuti/socket_layer.hpp>
+#include <cuti/stack_marker.hpp>
+#include <cuti/tcp_connection.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+
+#include <cstdarg>
+#include <dlfcn.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/select.h>
+#include <sys/syscall.h>
+
+#endif
+
+namespace // anonymous
+{
+
+struct syscall_counts_t
+{
+  std::atomic<std::size_t> epoll_ctl_{0};
+  std::atomic<std::size_t> epoll_wait_{0};
+  std::atomic<std::size_t> poll_{0};
+  std::atomic<std::size_t> select_{0};
+  std::atomic<std::size_t> io_uring_enter_{0};
+
+  void reset()
+  {
+    epoll_ctl_ = 0;
+    epoll_wait_ = 0;
+    poll_ = 0;
+    select_ = 0;
+    io_uring_enter_ = 0;
+  }
+
+  std::size_t total() const
+  {
+    return epoll_ctl_ + epoll_wait_ + poll_ + select_ + io_uring_enter_;
+  }
+};
+
+syscall_counts_t syscall_counts;
+
+} // anonymous
+
+#ifdef __linux__
+
+namespace // anonymous
+{
+
+template<typename F>
+F* next_symbol(F*& cached, char const* name)
+{
+  if(cached == nullptr)
+  {
+    cached = reinterpret_cast<F*>(::dlsym(RTLD_NEXT, name));
+  }
+  return cached;
+}
+
+bool constexpr counting_supported = true;
+
+} // anonymous
+
+#define CUTI_INTERPOSE extern "C" __attribute__((visibility("default")))
+
+CUTI_INTERPOSE
+int epoll_ctl(int epfd, int op, int fd, epoll_event* event)
+{
+  static int (*next)(int, int, int, epoll_event*) = nullptr;
+  ++syscall_counts.epoll_ctl_;
+  return next_symbol(next, "epoll_ctl")(epfd, op, fd, event);
+}
+
+CUTI_INTERPOSE
+int epoll_wait(int epfd, epoll_event* events, int maxevents, int timeout)
+{
+  static int (*next)(int, epoll_event*, int, int) = nullptr;
+  ++syscall_counts.epoll_wait_;
+  return next_symbol(next, "epoll_wait")(epfd, events, maxevents, timeout);
+}
+
+CUTI_INTERPOSE
+int poll(pollfd* fds, nfds_t nfds, int timeout)
+{
+  static int (*next)(pollfd*, nfds_t, int) = nullptr;
+  ++syscall_counts.poll_;
+  return next_symbol(next, "poll")(fds, nfds, timeout);
+}
+
+CUTI_INTERPOSE
+int select(int nfds, fd_set* readfds, fd_set* writefds, fd_set* exceptfds,
+           timeval* timeout)
+{
+  static int (*next)(int, fd_set*, fd_set*, fd_set*, timeval*) = nullptr;
+  ++syscall_counts.select_;
+  return next_symbol(next, "select")(
+    nfds, readfds, writefds, exceptfds, timeout);
+}
+
+/*
+ * syscall() is variadic; as the kernel takes at most six
+ * register-sized arguments, these are simply passed on.
+ */
+CUTI_INTERPOSE
+long syscall(long number, ...)
+{
+  static long (*next)(long, ...) = nullptr;
+
+#ifdef __NR_io_uring_enter
+  if(number == __NR_io_uring_enter)
+  {
+    ++syscall_counts.io_uring_enter_;
+  }
+#endif
+
+  va_list args;
+  va_start(args, number);
+  long a0 = va_arg(args, long);
+  long a1 = va_arg(args, long);
+  long a2 = va_arg(args, long);
+  long a3 = va_arg(args, long);
+  long a4 = va_arg(args, long);
+  long a5 = va_arg(args, long);
+  va_end(args);
+
+  return next_symbol(next, "syscall")(number, a0, a1, a2, a3, a4, a5);
+}
+
+#undef CUTI_INTERPOSE
+
+#else // !__linux__
+
+namespace // anonymous
+{
+
+bool constexpr counting_supported = false;
+
+} // anonymous
+
+#endif // !__linux__
+
+namespace // anonymous
+{
+
+using namespace cuti;
+
+struct options_t
+{
+  static unsigned int constexpr default_chunk_size = 64 * 1024;
+  static unsigned int constexpr default_mib = 64;
+
+  options_t()
+  : chunk_size_(default_chunk_size)
+  , mib_(default_mib)
+  , selector_()
+  { }
+
+  unsigned int chunk_size_;
+  unsigned int mib_;
+  std::optional<selector_factory_t> selector_;
+};
+
+void print_usage(std::ostream& os, char const* argv0)
+{
+  os << "usage: " << argv0 << " [<option> ...]\n";
+  os << "options are:\n";
+  os << "  --chunk-size <n>         bytes written per wakeup " <<
+    "(default: " << options_t::default_chunk_size << ")\n";
+  os << "  --mib <n>                MiB streamed per selector " <<
+    "(default: " << options_t::default_mib << ")\n";
+  os << "  --selector <name>        selector to measure " <<
+    "(default: all of";
+  for(auto const& factory : available_selector_factories())
+  {
+    os << ' ' << factory;
+  }
+  os << ")\n";
+  os << std::flush;
+}
+
+void read_options(options_t& options, option_walker_t& walker)
+{
+  while(!walker.done())
+  {
+    selector_factory_t selector;
+
+    if(walker.match("--selector", selector))
+    {
+      options.selector_.emplace(selector);
+    }
+    else if(!walker.match("--chunk-size", options.chunk_size_) &&
+            !walker.match("--mib", options.mib_))
+    {
+      break;
+    }
+  }
+}
+
+struct writer_t
+{
+  writer_t(scheduler_t& scheduler,
+           nb_outbuf_t& outbuf,
+           std::string const& chunk,
+           std::size_t n_bytes)
+  : scheduler_(scheduler)
+  , outbuf_(outbuf)
+  , chunk_(chunk)
+  , n_bytes_(n_bytes)
+  , n_written_(0)
+  , flushing_(false)
+  , done_(false)
+  { }
+
+  void start()
+  {
+    outbuf_.call_when_writable(scheduler_,
+      [this](stack_marker_t& marker) { this->on_writable(marker); });
+  }
+
+  bool done() const
+  {
+    return done_;
+  }
+
+private :
+  void on_writable(stack_marker_t&)
+  {
+    if(flushing_)
+    {
+      done_ = true;
+      return;
+    }
+
+    while(outbuf_.writable() && n_written_ != n_bytes_)
+    {
+      std::size_t n = chunk_.size();
+      if(n > n_bytes_ - n_written_)
+      {
+        n = n_bytes_ - n_written_;
+      }
+      char const* first = chunk_.data();
+      char const* next = outbuf_.write(first, first + n);
+      n_written_ += next - first;
+    }
+
+    if(n_written_ == n_bytes_)
+    {
+      outbuf_.start_flush();
+      flushing_ = true;
+    }
+
+    this->start();
+  }
+
+private :
+  scheduler_t& scheduler_;
+  nb_outbuf_t& outbuf_;
+  std::string const& chunk_;
+  std::size_t const n_bytes_;
+  std::size_t n_written_;
+  bool flushing_;
+  bool done_;
+};
+
+struct reader_t
+{
+  reader_t(scheduler_t& scheduler,
+           nb_inbuf_t& inbuf,
+           std::size_t chunk_size,
+           std::size_t n_bytes)
+  : scheduler_(scheduler)
+  , inbuf_(inbuf)
+  , chunk_(chunk_size)
+  , n_bytes_(n_bytes)
+  , n_read_(0)
+  { }
+
+  void start()
+  {
+    inbuf_.call_when_readable(scheduler_,
+      [this](stack_marker_t& marker) { this->on_readable(marker); });
+  }
+
+  std::size_t n_read() const
+  {
+    return n_read_;
+  }
+
+private :
+  void on_readable(stack_marker_t&)
+  {
+    while(inbuf_.readable() && n_read_ != n_bytes_)
+    {
+      char* first = chunk_.data();
+      char* next = inbuf_.read(first, first + chunk_.size());
+      if(next == first)
+      {
+        // premature eof
+        return;
+      }
+      n_read_ += next - first;
+    }
+
+    if(n_read_ != n_bytes_)
+    {
+      this->start();
+    }
+  }
+
+private :
+  scheduler_t& scheduler_;
+  nb_inbuf_t& inbuf_;
+  std::vector<char> chunk_;
+  std::size_t const n_bytes_;
+  std::size_t n_read_;
+};
+
+bool run_selector(std::ostream& os,
+                  socket_layer_t& sockets,
+                  selector_factory_t const& factory,
+                  options_t const& options)
+{
+  std::size_t const n_bytes = std::size_t(options.mib_) << 20;
+  std::string const chunk(options.chunk_size_, 'x');
+
+  default_scheduler_t scheduler(sockets, factory);
+
+  auto [producer, consumer] = make_connected_pair(sockets);
+  auto producer_bufs = make_nb_tcp_buffers(std::move(producer));
+  auto consumer_bufs = make_nb_tcp_buffers(std::move(consumer));
+
+  writer_t writer(scheduler, *producer_bufs.second, chunk, n_bytes);
+  reader_t reader(scheduler, *consumer_bufs.first,
+    options.chunk_size_, n_bytes);
+
+  syscall_counts.reset();
+  auto start = std::chrono::steady_clock::now();
+
+  writer.start();
+  reader.start();
+  stack_marker_t base_marker;
+  while(callback_t callback = scheduler.wait())
+  {
+    callback(base_marker);
+  }
+
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+    std::chrono::steady_clock::now() - start);
+
+  os << factory << ':';
+  if(counting_supported)
+  {
+    os << " epoll_ctl=" << syscall_counts.epoll_ctl_ <<
+      " epoll_wait=" << syscall_counts.epoll_wait_ <<
+      " poll=" << syscall_counts.poll_ <<
+      " select=" << syscall_counts.select_ <<
+      " io_uring_enter=" << syscall_counts.io_uring_enter_ <<
+      " (" << syscall_counts.total() << ")";
+  }
+  os << " time=" << elapsed.count() << " ms" << std::endl;
+
+  if(!writer.done() || reader.n_read() != n_bytes)
+  {
+    std::cerr << factory << ": expected " << n_bytes <<
+      " bytes, got " << reader.n_read() << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+int run_benchmark(int argc, char const* const* argv)
+{
+  options_t options;
+  cmdline_reader_t reader(argc, argv);
+  option_walker_t walker(reader);
+
+  read_options(options, walker);
+  if(!walker.done() || !reader.at_end() ||
+     options.chunk_size_ == 0 || options.mib_ == 0)
+  {
+    print_usage(std::cerr, argv[0]);
+    return 1;
+  }
+
+  std::vector<selector_factory_t> factories;
+  if(options.selector_)
+  {
+    factories.push_back(*options.selector_);
+  }
+  else
+  {
+    factories = available_selector_factories();
+  }
+
+  if(!counting_supported)
+  {
+    std::cout << argv[0] << ": syscall counting is not supported " <<
+      "on this platform; only reporting times" << std::endl;
+  }
+  std::cout << "streaming " << options.mib_ << " MiB in chunks of " <<
+    options.chunk_size_ << " bytes" << std::endl;
+
+  socket_layer_t sockets;
+  int result = 0;
+  for(auto const& factory : factories)
+  {
+    if(!run_selector(std::cout, sockets, factory, options))
+    {
+      result = 1;
+    }
+  }
+
+  return result;
+}
+
+} // anonymous
+
+int main(int argc, char* argv[])
+{
+  try
+  {
+    return run_benchmark(argc, argv);
+  }
+  catch(std::exception const& ex)
+  {
+    std::cerr << argv[0] << ": exception: " << ex.what() << std::endl;
+  }
+
+  return 1;
+}
@@ -0,0 +1,348 @@
+/*
+ * Copyright (C) 2026 CodeShop B.V.
+ *
+ * This file is part of the cuti library.
+ *
+ * The cuti library is free software: you can redistribute it and/or
+ * modify it under the terms of version 2.1 of the GNU Lesser General
+ * Public License as published by the Free Software Foundation.
+ *
+ * The cuti library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See version
+ * 2.1 of the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of version 2.1 of the GNU Lesser
+ * General Public License along with the cuti library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "async_file_backend.hpp"
+
+#include "chrono_types.hpp"
+#include "format.hpp"
+#include "membuf.hpp"
+#include "scoped_thread.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <exception>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace cuti
+{
+
+namespace // anonymous
+{
+
+void format_entry(membuf_t& target, time_point_t tp, loglevel_t level,
+                  char const* begin_msg, char const* end_msg)
+{
+  format_time_point(target, tp);
+  target.sputc(' ');
+  format_loglevel(target, level);
+  target.sputc(' ');
+  target.sputn(begin_msg, end_msg - begin_msg);
+  target.sputc('\n');
+}
+
+} // anonymous
+
+/*
+ * The ring is a single-producer, single-consumer queue of formatted
+ * entries: report() is the producer (the logger never calls a backend
+ * concurrently), and the writer thread is the consumer.  head_ and
+ * tail_ only ever grow; their difference is the number of bytes in
+ * use.
+ */
+struct async_file_backend_t::impl_t
+{
+  impl_t(absolute_path_t path,
+         unsigned int size_limit,
+         unsigned int rotation_depth,
+         std::size_t ring_size)
+  : path_((assert(!path.empty()), std::move(path)))
+  , size_limit_(size_limit)
+  , rotation_depth_(rotation_depth)
+  , scratch_()
+  , ring_((assert(ring_size != 0), ring_size))
+  , head_(0)
+  , tail_(0)
+  , wakeups_(0)
+  , stopping_(false)
+  , n_dropped_(0)
+  , file_(create_logfile(path_.value()))
+  , file_size_(file_->size())
+  , rotate_reported_(false)
+  , n_dropped_reported_(0)
+  , n_lost_batches_(0)
+  , first_failure_time_()
+  , first_failure_reason_()
+  , writer_buf_()
+  , thread_()
+  {
+    thread_.emplace([this] { this->run(); });
+  }
+
+  impl_t(impl_t const&) = delete;
+  impl_t& operator=(impl_t const&) = delete;
+
+  void report(loglevel_t level, char const* begin_msg, char const* end_msg)
+  {
+    scratch_.clear();
+    format_entry(scratch_, cuti_clock_t::now(), level, begin_msg, end_msg);
+
+    char const* first = scratch_.begin();
+    std::size_t size = scratch_.end() - first;
+    if(size > ring_.size())
+    {
+      // truncate, keeping the terminating newline
+      size = ring_.size();
+      scratch_.clear();
+      scratch_.sputn(first, size - 1);
+      scratch_.sputc('\n');
+      first = scratch_.begin();
+    }
+
+    std::size_t head = head_.load(std::memory_order_relaxed);
+    std::size_t tail = tail_.load(std::memory_order_acquire);
+    while(size > ring_.size() - (head - tail))
+    {
+      if(level != loglevel_t::error)
+      {
+        n_dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
+      tail_.wait(tail, std::memory_order_acquire);
+      tail = tail_.load(std::memory_order_acquire);
+    }
+
+    std::size_t pos = head % ring_.size();
+    std::size_t part1 = std::min(size, ring_.size() - pos);
+    std::memcpy(ring_.data() + pos, first, part1);
+    std::memcpy(ring_.data(), first + part1, size - part1);
+
+    std::size_t new_head = head + size;
+    head_.store(new_head, std::memory_order_release);
+    this->wake_up_writer();
+
+    if(level == loglevel_t::error)
+    {
+      while((tail = tail_.load(std::memory_order_acquire)) < new_head)
+      {
+        tail_.wait(tail, std::memory_order_acquire);
+      }
+    }
+  }
+
+  std::size_t n_dropped() const noexcept
+  {
+    return n_dropped_.load(std::memory_order_relaxed);
+  }
+
+  ~impl_t()
+  {
+    stopping_.store(true, std::memory_order_release);
+    this->wake_up_writer();
+    thread_.reset();
+  }
+
+private :
+  void wake_up_writer() noexcept
+  {
+    wakeups_.fetch_add(1, std::memory_order_release);
+    wakeups_.notify_one();
+  }
+
+  void run()
+  {
+    for(;;)
+    {
+      unsigned int wakeups = wakeups_.load(std::memory_order_acquire);
+      std::size_t tail = tail_.load(std::memory_order_relaxed);
+      std::size_t head = head_.load(std::memory_order_acquire);
+
+      if(head == tail)
+      {
+        if(stopping_.load(std::memory_order_acquire))
+        {
+          break;
+        }
+        wakeups_.wait(wakeups, std::memory_order_acquire);
+        continue;
+      }
+
+      this->write_batch(tail, head);
+
+      tail_.store(head, std::memory_order_release);
+      tail_.notify_all();
+    }
+  }
+
+  void write_batch(std::size_t tail, std::size_t head)
+  {
+    std::size_t pos = tail % ring_.size();
+    std::size_t size = head - tail;
+    std::size_t part1 = std::min(size, ring_.size() - pos);
+
+    char const* first1 = ring_.data() + pos;
+    char const* first2 = ring_.data();
+
+    try
+    {
+      this->prepare_file();
+      this->report_problems();
+
+      file_->write_gathered(first1, first1 + part1,
+        first2, first2 + (size - part1));
+      file_size_ += size;
+    }
+    catch(std::exception const& ex)
+    {
+      // reopen on the next batch
+      file_.reset();
+
+      if(n_lost_batches_ == 0)
+      {
+        first_failure_time_ = cuti_clock_t::now();
+        first_failure_reason_ = ex.what();
+      }
+      ++n_lost_batches_;
+    }
+  }
+
+  void prepare_file()
+  {
+    if(file_ == nullptr)
+    {
+      file_ = create_logfile(path_.value());
+      file_size_ = file_->size();
+    }
+
+    if(size_limit_ != 0 && file_size_ >= size_limit_)
+    {
+      /*
+       * Try to add an entry to the old log to say we're rotating, but
+       * avoid repeating that entry while rotation keeps throwing.
+       */
+      if(!rotate_reported_)
+      {
+        static char const message[] = "Size limit reached. Rotating...";
+        this->write_entry(loglevel_t::info,
+          message, message + sizeof message - 1);
+        rotate_reported_ = true;
+      }
+
+      file_.reset();
+      rotate_logfiles(path_.value(), rotation_depth_);
+      rotate_reported_ = false;
+
+      file_ = create_logfile(path_.value());
+      file_size_ = file_->size();
+    }
+  }
+
+  void report_problems()
+  {
+    if(n_lost_batches_ != 0)
+    {
+      std::string message = "Logging failed at ";
+      membuf_t tp_buf;
+      format_time_point(tp_buf, first_failure_time_);
+      message.append(tp_buf.begin(), tp_buf.end());
+      message += ": ";
+      message += first_failure_reason_;
+      message += " - ";
+      message += std::to_string(n_lost_batches_);
+      message += " batch(es) of messages lost";
+
+      this->write_entry(loglevel_t::error,
+        message.data(), message.data() + message.size());
+      n_lost_batches_ = 0;
+    }
+
+    std::size_t n_dropped = n_dropped_.load(std::memory_order_relaxed);
+    if(n_dropped != n_dropped_reported_)
+    {
+      std::string message = "Log ring full - ";
+      message += std::to_string(n_dropped - n_dropped_reported_);
+      message += " message(s) dropped";
+
+      this->write_entry(loglevel_t::warning,
+        message.data(), message.data() + message.size());
+      n_dropped_reported_ = n_dropped;
+    }
+  }
+
+  void write_entry(loglevel_t level,
+                   char const* begin_msg, char const* end_msg)
+  {
+    assert(file_ != nullptr);
+
+    writer_buf_.clear();
+    format_entry(writer_buf_, cuti_clock_t::now(), level,
+      begin_msg, end_msg);
+    file_->write(writer_buf_.begin(), writer_buf_.end());
+    file_size_ += writer_buf_.end() - writer_buf_.begin();
+  }
+
+private :
+  absolute_path_t const path_;
+  unsigned int const size_limit_;
+  unsigned int const rotation_depth_;
+
+  // producer side
+  membuf_t scratch_;
+
+  // shared
+  std::vector<char> ring_;
+  static_assert(std::atomic<std::size_t>::is_always_lock_free);
+  std::atomic<std::size_t> head_;
+  std::atomic<std::size_t> tail_;
+  std::atomic<unsigned int> wakeups_;
+  std::atomic<bool> stopping_;
+  std::atomic<std::size_t> n_dropped_;
+
+  // writer side
+  std::unique_ptr<text_output_file_t> file_;
+  std::size_t file_size_;
+  bool rotate_reported_;
+  std::size_t n_dropped_reported_;
+  std::size_t n_lost_batches_;
+  time_point_t first_failure_time_;
+  std::string first_failure_reason_;
+  membuf_t writer_buf_;
+
+  // the writer thread owns the writer side; joined before it goes
+  std::optional<scoped_thread_t> thread_;
+};
+
+async_file_backend_t::async_file_backend_t(absolute_path_t path,
+                                           unsigned int size_limit,
+                                           unsigned int rotation_depth,
+                                           std::size_t ring_size)
+: impl_(std::make_unique<impl_t>(
+    std::move(path), size_limit, rotation_depth, ring_size))
+{ }
+
+void async_file_backend_t::report(loglevel_t level,
+                                  char const* begin_msg,
+                                  char const* end_msg)
+{
+  impl_->report(level, begin_msg, end_msg);
+}
+
+std::size_t async_file_backend_t::n_dropped() const noexcept
+{
+  return impl_->n_dropped();
+}
+
+async_file_backend_t::~async_file_backend_t()
+{ }
+
+} // namespace cuti
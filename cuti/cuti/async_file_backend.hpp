@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2026 CodeShop B.V.
+ *
+ * This file is part of the cuti library.
+ *
+ * The cuti library is free software: you can redistribute it and/or
+ * modify it under the terms of version 2.1 of the GNU Lesser General
+ * Public License as published by the Free Software Foundation.
+ *
+ * The cuti library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See version
+ * 2.1 of the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of version 2.1 of the GNU Lesser
+ * General Public License along with the cuti library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CUTI_ASYNC_FILE_BACKEND_HPP_
+#define CUTI_ASYNC_FILE_BACKEND_HPP_
+
+#include "linkage.h"
+
+#include "file_backend.hpp"
+#include "fs_utils.hpp"
+#include "logging_backend.hpp"
+
+#include <cstddef>
+#include <memory>
+
+namespace cuti
+{
+
+/*
+ * Logs to a named file like file_backend_t, without doing any file
+ * I/O on the reporting thread.  report() only formats the entry into
+ * a ring buffer; a dedicated writer thread, which keeps the log file
+ * open, drains the ring in batches and takes care of rotation.
+ *
+ * If the ring is full, entries are dropped and counted rather than
+ * making the reporting thread wait; the writer logs the number of
+ * dropped entries once it has caught up.  Entries at loglevel error
+ * are never dropped, and report() waits until they are written, so
+ * that a fatal error is on disk before the process aborts.
+ */
+struct CUTI_ABI async_file_backend_t : logging_backend_t
+{
+  static constexpr unsigned int no_size_limit =
+    file_backend_t::no_size_limit;
+  static constexpr unsigned int default_rotation_depth =
+    file_backend_t::default_rotation_depth;
+  static constexpr std::size_t default_ring_size = 1024 * 1024;
+
+  explicit async_file_backend_t(
+    absolute_path_t path,
+    unsigned int size_limit = no_size_limit,
+    unsigned int rotation_depth = default_rotation_depth,
+    std::size_t ring_size = default_ring_size);
+
+  void report(loglevel_t level,
+              char const* begin_msg, char const* end_msg) override;
+
+  /*
+   * Returns the number of entries dropped so far because the ring was
+   * full.  This function is thread-safe.
+   */
+  std::size_t n_dropped() const noexcept;
+
+  /*
+   * Writes any pending entries before returning.
+   */
+  ~async_file_backend_t() override;
+
+private :
+  struct impl_t;
+  std::unique_ptr<impl_t> impl_;
+};
+
+} // namespace cuti
+
+#endif
@@ -19,6 +19,7 @@
 
 #include "async_readers.hpp"
 
+#include "buffer_pool.hpp"
 #include "charclass.hpp"
 #include "exception_builder.hpp"
 #include "parse_error.hpp"
@@ -26,7 +27,9 @@
 #include "remote_error.hpp"
 #include "stack_marker.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <exception>
 #include <limits>
 
 namespace cuti
@@ -357,7 +360,10 @@ blob_reader_t<T>::blob_reader_t(result_t<T>& result, bound_inbuf_t& buf)
 , buf_(buf)
 , skipper_(*this, result_, buf_)
 , hex_digits_reader_(*this, result_, buf_)
+, length_reader_(*this, result_, buf_)
 , value_()
+, raw_length_()
+, raw_filled_()
 { }
 
 template<typename T>
@@ -373,10 +379,19 @@ void blob_reader_t<T>::read_leading_dq(stack_marker_t& base_marker, int c)
   assert(buf_.readable());
   assert(buf_.peek() == c);
 
+  if(c == '#')
+  {
+    buf_.skip();
+    length_reader_.start(
+      base_marker, &blob_reader_t::on_raw_length, value_.max_size());
+    return;
+  }
+
   if(c != '\"')
   {
     exception_builder_t<parse_error_t> builder;
     builder << "opening double quote (" << quoted_char('\"') <<
+      ") or raw blob marker (" << quoted_char('#') <<
       ") expected, but got " << quoted_char(c);
     result_.fail(base_marker, builder.exception_ptr());
     return;
@@ -504,6 +519,126 @@ void blob_reader_t<T>::on_hex_digits(stack_marker_t& base_marker, int c)
   );
 }
 
+template<typename T>
+void blob_reader_t<T>::on_raw_length(
+  stack_marker_t& base_marker, std::size_t length)
+{
+  raw_length_ = length;
+  raw_filled_ = 0;
+
+  try
+  {
+    if constexpr(std::is_same_v<T, buffer_pool_t::buffer_t>)
+    {
+      if(raw_length_ <= max_raw_prealloc)
+      {
+        // a recycled buffer is not zero-filled again
+        value_ = default_buffer_pool().acquire_sized(raw_length_);
+      }
+    }
+    value_.resize(std::min(raw_length_, max_raw_prealloc));
+  }
+  catch(std::exception const&)
+  {
+    result_.fail(base_marker, std::current_exception());
+    return;
+  }
+
+  this->read_raw_leading_dq(base_marker);
+}
+
+template<typename T>
+void blob_reader_t<T>::read_raw_leading_dq(stack_marker_t& base_marker)
+{
+  if(!buf_.readable())
+  {
+    buf_.call_when_readable(
+      [this](stack_marker_t& marker) { this->read_raw_leading_dq(marker); }
+    );
+    return;
+  }
+
+  int c = buf_.peek();
+  if(c != '\"')
+  {
+    exception_builder_t<parse_error_t> builder;
+    builder << "opening double quote (" << quoted_char('\"') <<
+      ") expected after raw blob length, but got " << quoted_char(c);
+    result_.fail(base_marker, builder.exception_ptr());
+    return;
+  }
+  buf_.skip();
+
+  this->read_raw_contents(base_marker);
+}
+
+template<typename T>
+void blob_reader_t<T>::read_raw_contents(stack_marker_t& base_marker)
+{
+  while(raw_filled_ != raw_length_ && buf_.readable())
+  {
+    if(buf_.peek() == eof)
+    {
+      result_.fail(base_marker, std::make_exception_ptr(
+        parse_error_t("unexpected eof in raw blob value")));
+      return;
+    }
+
+    if(raw_filled_ == value_.size())
+    {
+      try
+      {
+        value_.resize(raw_filled_ +
+          std::min(raw_length_ - raw_filled_, max_raw_prealloc));
+      }
+      catch(std::exception const&)
+      {
+        result_.fail(base_marker, std::current_exception());
+        return;
+      }
+    }
+
+    char* data = reinterpret_cast<char*>(value_.data());
+    char* next = buf_.read_direct(data + raw_filled_, data + value_.size());
+    raw_filled_ = next - data;
+  }
+
+  if(raw_filled_ != raw_length_)
+  {
+    buf_.call_when_readable(
+      [this](stack_marker_t& marker) { this->read_raw_contents(marker); }
+    );
+    return;
+  }
+
+  this->read_raw_trailing_dq(base_marker);
+}
+
+template<typename T>
+void blob_reader_t<T>::read_raw_trailing_dq(stack_marker_t& base_marker)
+{
+  if(!buf_.readable())
+  {
+    buf_.call_when_readable(
+      [this](stack_marker_t& marker) { this->read_raw_trailing_dq(marker); }
+    );
+    return;
+  }
+
+  int c = buf_.peek();
+  if(c != '\"')
+  {
+    exception_builder_t<parse_error_t> builder;
+    builder << "closing double quote (" << quoted_char('\"') <<
+      ") expected after raw blob contents, but got " << quoted_char(c);
+    result_.fail(base_marker, builder.exception_ptr());
+    return;
+  }
+  buf_.skip();
+
+  result_.submit(base_marker, std::move(value_));
+}
+
 template struct blob_reader_t<std::string>;
 template struct blob_reader_t<std::vector<char>>;
 template struct blob_reader_t<std::vector<signed char>>;
@@ -572,6 +707,112 @@ void identifier_reader_t::read_followers(stack_marker_t& base_marker)
   result_.submit(base_marker, std::move(wrapped_));
 }
 
+void message_drainer_t::drain(stack_marker_t& base_marker)
+{
+  int c{};
+  while(buf_.readable() && (c = buf_.peek()) != eof)
+  {
+    switch(state_)
+    {
+    case state_t::plain :
+      if(c == '\n')
+      {
+        buf_.skip();
+        result_.submit(base_marker);
+        return;
+      }
+      if(c == '\"')
+      {
+        state_ = state_t::quoted;
+      }
+      else if(c == '#')
+      {
+        state_ = state_t::raw_length;
+        raw_length_ = 0;
+      }
+      buf_.skip();
+      break;
+
+    case state_t::quoted :
+    case state_t::escaped :
+      if(c == '\n')
+      {
+        // never part of a quoted blob: resynchronize
+        state_ = state_t::plain;
+        break;
+      }
+      if(state_ == state_t::escaped)
+      {
+        state_ = state_t::quoted;
+      }
+      else if(c == '\\')
+      {
+        state_ = state_t::escaped;
+      }
+      else if(c == '\"')
+      {
+        state_ = state_t::plain;
+      }
+      buf_.skip();
+      break;
+
+    case state_t::raw_length :
+      if(int dval = digit_value(c); dval >= 0)
+      {
+        static std::size_t constexpr max =
+          std::numeric_limits<std::size_t>::max();
+        std::size_t udval = static_cast<std::size_t>(dval);
+        if(raw_length_ > max / 10 || udval > max - 10 * raw_length_)
+        {
+          // not a raw blob we could have written
+          state_ = state_t::plain;
+          break;
+        }
+        raw_length_ *= 10;
+        raw_length_ += udval;
+        buf_.skip();
+      }
+      else if(c == '\"')
+      {
+        state_ = raw_length_ != 0 ?
+          state_t::raw_contents : state_t::raw_trailing_dq;
+        buf_.skip();
+      }
+      else
+      {
+        state_ = state_t::plain;
+      }
+      break;
+
+    case state_t::raw_contents :
+      buf_.skip();
+      if(--raw_length_ == 0)
+      {
+        state_ = state_t::raw_trailing_dq;
+      }
+      break;
+
+    case state_t::raw_trailing_dq :
+      if(c == '\"')
+      {
+        buf_.skip();
+      }
+      state_ = state_t::plain;
+      break;
+    }
+  }
+
+  if(!buf_.readable())
+  {
+    buf_.call_when_readable(
+      [this](stack_marker_t& marker) { this->drain(marker); }
+    );
+    return;
+  }
+
+  result_.submit(base_marker);
+}
+
 } // detail
 
 } // cuti
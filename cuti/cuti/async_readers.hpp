@@ -384,11 +384,22 @@ struct CUTI_ABI blob_reader_t
 
   using result_value_t = T;
 
+  /*
+   * The length of a raw blob is announced up front, but we do not
+   * blindly trust it: at most this many bytes are allocated before
+   * the corresponding data has actually arrived.
+   */
+  static std::size_t constexpr max_raw_prealloc = 64 * 1024 * 1024;
+
   blob_reader_t(result_t<T>& result, bound_inbuf_t& buf);
 
   blob_reader_t(blob_reader_t const&) = delete;
   blob_reader_t& operator=(blob_reader_t const&) = delete;
 
+  /*
+   * Reads a blob in either the quoted or the raw form; see
+   * blob_writer_t for details.
+   */
   void start(stack_marker_t& base_marker);
 
 private :
@@ -396,14 +407,21 @@ private :
   void read_contents(stack_marker_t& base_marker);
   void read_escaped(stack_marker_t& base_marker);
   void on_hex_digits(stack_marker_t& base_marker, int c);
+  void on_raw_length(stack_marker_t& base_marker, std::size_t length);
+  void read_raw_leading_dq(stack_marker_t& base_marker);
+  void read_raw_contents(stack_marker_t& base_marker);
+  void read_raw_trailing_dq(stack_marker_t& base_marker);
   
 private :
   result_t<T>& result_;
   bound_inbuf_t& buf_;
   subroutine_t<blob_reader_t, whitespace_skipper_t> skipper_;
   subroutine_t<blob_reader_t, hex_digits_reader_t> hex_digits_reader_;
+  subroutine_t<blob_reader_t, digits_reader_t<std::size_t>> length_reader_;
 
   T value_;
+  std::size_t raw_length_;
+  std::size_t raw_filled_;
 };
 
 extern template struct blob_reader_t<std::string>;
@@ -915,6 +933,11 @@ private :
   subroutine_t<eom_checker_t, whitespace_skipper_t> skipper_;
 };
 
+/*
+ * message_drainer: skips the remainder of the current message,
+ * including the terminating newline.  Raw blobs are skipped as a
+ * whole, as their contents may include newlines.
+ */
 struct CUTI_ABI message_drainer_t
 {
   using result_value_t = void;
@@ -922,10 +945,14 @@ struct CUTI_ABI message_drainer_t
   message_drainer_t(result_t<void>& result, bound_inbuf_t& buf)
   : result_(result)
   , buf_(buf)
+  , state_()
+  , raw_length_()
   { }
 
   void start(stack_marker_t& base_marker)
   {
+    state_ = state_t::plain;
+
     if(base_marker.in_range())
     {
       this->drain(base_marker);
@@ -938,33 +965,23 @@ struct CUTI_ABI message_drainer_t
   }
 
 private :
-  void drain(stack_marker_t& base_marker)
-  {
-    int c{};
-    while(buf_.readable() && (c = buf_.peek()) != '\n' && c != eof)
-    {
-      buf_.skip();
-    }
-
-    if(!buf_.readable())
-    {
-      buf_.call_when_readable(
-        [this](stack_marker_t& marker) { this->drain(marker); }
-      );
-      return;
-    }
-
-    if(c != eof)
-    {
-      buf_.skip();
-    }
-
-    result_.submit(base_marker);
-  }
+  void drain(stack_marker_t& base_marker);
 
 private :
+  enum class state_t
+  {
+    plain,
+    quoted,
+    escaped,
+    raw_length,
+    raw_contents,
+    raw_trailing_dq
+  };
+
   result_t<void>& result_;
   bound_inbuf_t& buf_;
+  state_t state_;
+  std::size_t raw_length_;
 };
 
 } // detail
@@ -0,0 +1,256 @@
+/*
+ * Copyright (C) 2026 CodeShop B.V.
+ *
+ * This file is part of the cuti library.
+ *
+ * The cuti library is free software: you can redistribute it and/or
+ * modify it under the terms of version 2.1 of the GNU Lesser General
+ * Public License as published by the Free Software Foundation.
+ *
+ * The cuti library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See version
+ * 2.1 of the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of version 2.1 of the GNU Lesser
+ * General Public License along with the cuti library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "async_resolver.hpp"
+
+#include "scheduler.hpp"
+#include "scoped_thread.hpp"
+#include "socket_layer.hpp"
+#include "stack_marker.hpp"
+#include "wakeup_pipe.hpp"
+
+#include <cassert>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+namespace cuti
+{
+
+/*
+ * Lookups are numbered; only the outcome of the last one started is
+ * kept.  The helper thread runs one lookup at a time, and picks the
+ * most recently started lookup next, skipping any abandoned ones.
+ */
+struct async_resolver_t::impl_t
+{
+  explicit impl_t(socket_layer_t& sockets)
+  : sockets_(sockets)
+  , wakeup_(sockets_)
+  , scheduler_(nullptr)
+  , callback_(nullptr)
+  , mutex_()
+  , request_cv_()
+  , stopping_(false)
+  , request_()
+  , last_started_(0)
+  , last_done_(0)
+  , endpoints_()
+  , ex_(nullptr)
+  , helper_([this] { this->run(); })
+  { }
+
+  impl_t(impl_t const&) = delete;
+  impl_t& operator=(impl_t const&) = delete;
+
+  void start(std::string host, unsigned int port)
+  {
+    {
+      std::scoped_lock<std::mutex> lock(mutex_);
+      ++last_started_;
+      request_.emplace(request_t{std::move(host), port, last_started_});
+    }
+    request_cv_.notify_one();
+  }
+
+  bool done() const
+  {
+    std::scoped_lock<std::mutex> lock(mutex_);
+    return last_started_ != 0 && last_done_ == last_started_;
+  }
+
+  endpoints_t result() const
+  {
+    std::scoped_lock<std::mutex> lock(mutex_);
+    assert(last_started_ != 0 && last_done_ == last_started_);
+
+    if(ex_ != nullptr)
+    {
+      std::rethrow_exception(ex_);
+    }
+    return endpoints_;
+  }
+
+  void call_when_done(scheduler_t& scheduler, callback_t callback)
+  {
+    assert(callback != nullptr);
+
+    this->cancel_when_done();
+
+    scheduler_ = &scheduler;
+    callback_ = std::move(callback);
+
+    this->await_lookup();
+  }
+
+  void cancel_when_done() noexcept
+  {
+    wakeup_.cancel_on_wakeup();
+    scheduler_ = nullptr;
+    callback_ = nullptr;
+  }
+
+  ~impl_t()
+  {
+    this->cancel_when_done();
+
+    {
+      std::scoped_lock<std::mutex> lock(mutex_);
+      stopping_ = true;
+      request_.reset();
+    }
+    request_cv_.notify_one();
+
+    // helper_ is joined first, as it is declared last
+  }
+
+private :
+  struct request_t
+  {
+    std::string host_;
+    unsigned int port_;
+    std::uint64_t id_;
+  };
+
+  void await_lookup()
+  {
+    assert(scheduler_ != nullptr);
+
+    wakeup_.call_on_wakeup(*scheduler_,
+      [this](stack_marker_t& base_marker) { this->on_wakeup(base_marker); });
+
+    if(this->done())
+    {
+      // the lookup's wakeup may already have been consumed
+      wakeup_.wakeup();
+    }
+  }
+
+  void on_wakeup(stack_marker_t& base_marker)
+  {
+    if(!this->done())
+    {
+      // spurious, or for an abandoned lookup
+      this->await_lookup();
+      return;
+    }
+
+    callback_t callback = std::move(callback_);
+    scheduler_ = nullptr;
+    callback_ = nullptr;
+
+    callback(base_marker);
+  }
+
+  // runs on the helper thread
+  void run() noexcept
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for(;;)
+    {
+      request_cv_.wait(lock,
+        [this] { return stopping_ || request_ != std::nullopt; });
+      if(stopping_)
+      {
+        break;
+      }
+
+      request_t request = std::move(*request_);
+      request_.reset();
+
+      lock.unlock();
+
+      endpoints_t endpoints;
+      std::exception_ptr ex = nullptr;
+      try
+      {
+        endpoints = resolve_host(sockets_, request.host_, request.port_);
+      }
+      catch(std::exception const&)
+      {
+        ex = std::current_exception();
+      }
+
+      lock.lock();
+
+      if(request.id_ == last_started_)
+      {
+        last_done_ = request.id_;
+        endpoints_ = std::move(endpoints);
+        ex_ = std::move(ex);
+        wakeup_.wakeup();
+      }
+    }
+  }
+
+private :
+  socket_layer_t& sockets_;
+  wakeup_pipe_t wakeup_;
+  scheduler_t* scheduler_;
+  callback_t callback_;
+
+  std::mutex mutable mutex_;
+  std::condition_variable request_cv_;
+  bool stopping_;
+  std::optional<request_t> request_;
+  std::uint64_t last_started_;
+  std::uint64_t last_done_;
+  endpoints_t endpoints_;
+  std::exception_ptr ex_;
+
+  scoped_thread_t helper_;
+};
+
+async_resolver_t::async_resolver_t(socket_layer_t& sockets)
+: impl_(std::make_unique<impl_t>(sockets))
+{ }
+
+void async_resolver_t::start(std::string host, unsigned int port)
+{
+  impl_->start(std::move(host), port);
+}
+
+bool async_resolver_t::done() const
+{
+  return impl_->done();
+}
+
+endpoints_t async_resolver_t::result() const
+{
+  return impl_->result();
+}
+
+void async_resolver_t::call_when_done(scheduler_t& scheduler,
+                                      callback_t callback)
+{
+  impl_->call_when_done(scheduler, std::move(callback));
+}
+
+void async_resolver_t::cancel_when_done() noexcept
+{
+  impl_->cancel_when_done();
+}
+
+async_resolver_t::~async_resolver_t()
+{ }
+
+} // cuti
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2026 CodeShop B.V.
+ *
+ * This file is part of the cuti library.
+ *
+ * The cuti library is free software: you can redistribute it and/or
+ * modify it under the terms of version 2.1 of the GNU Lesser General
+ * Public License as published by the Free Software Foundation.
+ *
+ * The cuti library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See version
+ * 2.1 of the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of version 2.1 of the GNU Lesser
+ * General Public License along with the cuti library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CUTI_ASYNC_RESOLVER_HPP_
+#define CUTI_ASYNC_RESOLVER_HPP_
+
+#include "callback.hpp"
+#include "linkage.h"
+#include "resolver.hpp"
+
+#include <memory>
+#include <string>
+
+namespace cuti
+{
+
+struct scheduler_t;
+struct socket_layer_t;
+
+/*
+ * Resolves host names on a helper thread, so that a scheduler thread
+ * needing a lookup, which may take as long as a DNS timeout, is not
+ * blocked.
+ *
+ * All member functions are meant to be called from the scheduler
+ * thread.  The resolver has a single helper thread, which runs one
+ * lookup at a time: a lookup started while another is in progress
+ * waits for it.  The helper thread is joined on destruction, which
+ * may therefore have to wait for a lookup in progress.
+ */
+struct CUTI_ABI async_resolver_t
+{
+  explicit async_resolver_t(socket_layer_t& sockets);
+
+  async_resolver_t(async_resolver_t const&) = delete;
+  async_resolver_t& operator=(async_resolver_t const&) = delete;
+
+  /*
+   * Starts looking up the endpoints for host and port, abandoning
+   * any previous lookup.
+   */
+  void start(std::string host, unsigned int port);
+
+  /*
+   * Tells if the last lookup started has completed.
+   */
+  bool done() const;
+
+  /*
+   * Returns the endpoints found by the last lookup, which must be
+   * done(); if the lookup failed, its exception is rethrown.
+   */
+  endpoints_t result() const;
+
+  /*
+   * Schedules a one-time callback for when the last lookup started is
+   * done(), canceling any previously requested callback.  The
+   * scheduler must remain alive while the callback is pending.
+   */
+  void call_when_done(scheduler_t& scheduler, callback_t callback);
+
+  /*
+   * Cancels any pending callback; no effect if there is no pending
+   * callback.
+   */
+  void cancel_when_done() noexcept;
+
+  /*
+   * Abandons any lookup not yet started, and waits for the lookup in
+   * progress, if any.
+   */
+  ~async_resolver_t();
+
+private :
+  struct impl_t;
+  std::unique_ptr<impl_t> impl_;
+};
+
+} // cuti
+
+#endif
@@ -19,17 +19,45 @@
 
 #include "async_writers.hpp"
 
+#include "buffer_pool.hpp"
 #include "remote_error.hpp"
 #include "stack_marker.hpp"
 
 #include <cassert>
+#include <exception>
 #include <limits>
+#include <memory>
 #include <optional>
+#include <type_traits>
 #include <utility>
 
 namespace cuti
 {
 
+namespace // anonymous
+{
+
+template<typename T>
+std::shared_ptr<T const> make_shared_value(T value)
+{
+  if constexpr(std::is_same_v<T, buffer_pool_t::buffer_t>)
+  {
+    // recycle the buffer when the last owner lets go
+    return std::shared_ptr<T>(new T(std::move(value)),
+      [](T* buffer)
+      {
+        default_buffer_pool().release(std::move(*buffer));
+        delete buffer;
+      });
+  }
+  else
+  {
+    return std::make_shared<T const>(std::move(value));
+  }
+}
+
+} // anonymous
+
 namespace detail
 {
 
@@ -217,8 +245,11 @@ template<typename T>
 blob_writer_t<T>::blob_writer_t(result_t<void>& result, bound_outbuf_t& buf)
 : result_(result)
 , buf_(buf)
+, length_writer_(*this, result_, buf_)
 , suffix_writer_(*this, result_, buf_)
+, raw_()
 , value_()
+, shared_value_()
 , first_()
 , last_()
 { }
@@ -229,8 +260,49 @@ void blob_writer_t<T>::start(stack_marker_t& base_marker, T value)
   value_ = std::move(value);
   first_ = value_.begin();
   last_ = value_.end();
-    
-  this->write_opening_dq(base_marker);
+  raw_ = buf_.raw_blobs_enabled() && value_.size() >= min_raw_size;
+
+  if(raw_ && buf_.zerocopy_enabled() && value_.size() >= min_zerocopy_size)
+  {
+    // share the value with the sink, which may hold on to it
+    try
+    {
+      shared_value_ = make_shared_value(std::move(value_));
+    }
+    catch(std::exception const&)
+    {
+      result_.fail(base_marker, std::current_exception());
+      return;
+    }
+    first_ = shared_value_->begin();
+    last_ = shared_value_->end();
+  }
+
+  if(raw_)
+  {
+    this->write_raw_marker(base_marker);
+  }
+  else
+  {
+    this->write_opening_dq(base_marker);
+  }
+}
+
+template<typename T>
+void blob_writer_t<T>::write_raw_marker(stack_marker_t& base_marker)
+{
+  if(!buf_.writable())
+  {
+    buf_.call_when_writable(
+      [this](stack_marker_t& marker) { this->write_raw_marker(marker); }
+    );
+    return;
+  }
+  buf_.put('#');
+
+  // value_ may have been moved into shared_value_
+  length_writer_.start(base_marker, &blob_writer_t::write_opening_dq,
+    static_cast<std::size_t>(last_ - first_));
 }
 
 template<typename T>
@@ -245,7 +317,14 @@ void blob_writer_t<T>::write_opening_dq(stack_marker_t& base_marker)
   }
   buf_.put('\"');
 
-  this->write_contents(base_marker);
+  if(raw_)
+  {
+    this->write_raw_contents(base_marker);
+  }
+  else
+  {
+    this->write_contents(base_marker);
+  }
 }
 
 template<typename T>
@@ -319,10 +398,37 @@ void blob_writer_t<T>::write_escaped(stack_marker_t& base_marker)
   );
 }
 
+template<typename T>
+void blob_writer_t<T>::write_raw_contents(stack_marker_t& base_marker)
+{
+  while(first_ != last_ && buf_.writable())
+  {
+    char const* first = reinterpret_cast<char const*>(&*first_);
+    char const* next = buf_.write_direct(
+      first, first + (last_ - first_), shared_value_);
+    first_ += next - first;
+  }
+
+  if(first_ != last_)
+  {
+    buf_.call_when_writable(
+      [this](stack_marker_t& marker) { this->write_raw_contents(marker); }
+    );
+    return;
+  }
+
+  suffix_writer_.start(base_marker, &blob_writer_t::on_suffix_written);
+}
+
 template<typename T>
 void blob_writer_t<T>::on_suffix_written(stack_marker_t& base_marker)
 {
+  if constexpr(std::is_same_v<T, buffer_pool_t::buffer_t>)
+  {
+    default_buffer_pool().release(std::move(value_));
+  }
   value_.clear();
+  shared_value_.reset();
   result_.submit(base_marker);
 }
 
@@ -249,6 +249,22 @@ extern template struct signed_writer_t<long long>;
 
 extern CUTI_ABI char const blob_suffix[];
 
+/*
+ * Blobs are written in one of two forms:
+ *
+ * - the quoted form: a double-quoted string with '\n', '\"' and '\\'
+ *   escaped, which is understood by every peer;
+ * - the raw form: '#', the decimal length of the blob, and the blob's
+ *   unescaped bytes enclosed in double quotes; #3"a"b" holds the
+ *   three bytes 'a', '"' and 'b'.
+ *   This form is copied in bulk, but may only be used when the
+ *   buffer's raw_blobs_enabled() tells that the peer understands it.
+ *   If the buffer's zero-copy writes are enabled, large raw blobs
+ *   are not copied at all; the blob is then kept alive until the
+ *   kernel has sent it.
+ *
+ * Blob readers accept both forms.
+ */
 template<typename T>
 struct CUTI_ABI blob_writer_t
 {
@@ -259,6 +275,18 @@ struct CUTI_ABI blob_writer_t
 
   using result_value_t = void;
 
+  /*
+   * Smaller blobs are always written in the (more readable) quoted
+   * form.
+   */
+  static std::size_t constexpr min_raw_size = 64;
+
+  /*
+   * Smaller raw blobs are always copied: for these, pinning the
+   * memory for a zero-copy write costs more than copying it.
+   */
+  static std::size_t constexpr min_zerocopy_size = 64 * 1024;
+
   blob_writer_t(result_t<void>& result, bound_outbuf_t& buf);
 
   blob_writer_t(blob_writer_t const&) = delete;
@@ -267,18 +295,23 @@ struct CUTI_ABI blob_writer_t
   void start(stack_marker_t& base_marker, T value);
 
 private :
+  void write_raw_marker(stack_marker_t& base_marker);
   void write_opening_dq(stack_marker_t& base_marker);
   void write_contents(stack_marker_t& base_marker);
   void write_escaped(stack_marker_t& base_marker);
+  void write_raw_contents(stack_marker_t& base_marker);
   void on_suffix_written(stack_marker_t& base_marker);
 
 private :
   result_t<void>& result_;
   bound_outbuf_t& buf_;
+  subroutine_t<blob_writer_t, digits_writer_t<std::size_t>> length_writer_;
   subroutine_t<blob_writer_t, token_suffix_writer_t<blob_suffix>>
     suffix_writer_;
   
+  bool raw_;
   T value_;
+  std::shared_ptr<T const> shared_value_; // replaces value_ if not null
   typename T::const_iterator first_;
   typename T::const_iterator last_;
 };
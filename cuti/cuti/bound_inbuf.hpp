@@ -52,6 +52,15 @@ struct CUTI_ABI bound_inbuf_t
     return inbuf_.error_status();
   }
 
+  /*
+   * Returns the scheduler the buffer is bound to, for scheduling
+   * events that are not directly related to the buffer itself.
+   */
+  scheduler_t& scheduler() const noexcept
+  {
+    return scheduler_;
+  }
+
   bool readable() const
   {
     return inbuf_.readable();
@@ -72,6 +81,11 @@ struct CUTI_ABI bound_inbuf_t
     return inbuf_.read(first, last);
   }
 
+  char* read_direct(char* first, char const* last)
+  {
+    return inbuf_.read_direct(first, last);
+  }
+
   void call_when_readable(callback_t callback)
   {
     inbuf_.call_when_readable(scheduler_, std::move(callback));
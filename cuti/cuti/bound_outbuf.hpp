@@ -24,6 +24,7 @@
 #include "linkage.h"
 #include "nb_outbuf.hpp"
 
+#include <memory>
 #include <ostream>
 #include <utility>
 
@@ -52,6 +53,30 @@ struct CUTI_ABI bound_outbuf_t
     return outbuf_.error_status();
   }
 
+  /*
+   * Returns the scheduler the buffer is bound to, for scheduling
+   * events that are not directly related to the buffer itself.
+   */
+  scheduler_t& scheduler() const noexcept
+  {
+    return scheduler_;
+  }
+
+  bool raw_blobs_enabled() const noexcept
+  {
+    return outbuf_.raw_blobs_enabled();
+  }
+
+  void enable_raw_blobs() noexcept
+  {
+    outbuf_.enable_raw_blobs();
+  }
+
+  bool zerocopy_enabled() const noexcept
+  {
+    return outbuf_.zerocopy_enabled();
+  }
+
   bool writable() const
   {
     return outbuf_.writable();
@@ -67,6 +92,13 @@ struct CUTI_ABI bound_outbuf_t
     return outbuf_.write(first, last);
   }
 
+  char const* write_direct(char const* first, char const* last,
+                           std::shared_ptr<void const> const& owner =
+                             nullptr)
+  {
+    return outbuf_.write_direct(first, last, owner);
+  }
+
   void start_flush()
   {
     outbuf_.start_flush();
@@ -0,0 +1,205 @@
+/*
+ * Copyright (C) 2026 CodeShop B.V.
+ *
+ * This file is part of the cuti library.
+ *
+ * The cuti library is free software: you can redistribute it and/or
+ * modify it under the terms of version 2.1 of the GNU Lesser General
+ * Public License as published by the Free Software Foundation.
+ *
+ * The cuti library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See version
+ * 2.1 of the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of version 2.1 of the GNU Lesser
+ * General Public License along with the cuti library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "buffer_pool.hpp"
+
+#include <cassert>
+#include <exception>
+#include <utility>
+
+namespace cuti
+{
+
+namespace // anonymous
+{
+
+// returns the number of bits needed to represent value
+std::size_t bit_width(std::size_t value)
+{
+  std::size_t result = 0;
+  while(value != 0)
+  {
+    ++result;
+    value >>= 1;
+  }
+  return result;
+}
+
+} // anonymous
+
+buffer_pool_t::buffer_pool_t(std::size_t max_pooled_bytes)
+: max_pooled_bytes_(max_pooled_bytes)
+, mutex_()
+, classes_()
+, pooled_bytes_(0)
+, hits_(0)
+, misses_(0)
+{
+  static_assert(min_pooled_size == std::size_t(1) << min_class_bits);
+  static_assert(max_pooled_size == std::size_t(1) << max_class_bits);
+}
+
+buffer_pool_t::buffer_t buffer_pool_t::acquire(std::size_t size)
+{
+  buffer_t result = this->take(size);
+  result.clear();
+  return result;
+}
+
+buffer_pool_t::buffer_t buffer_pool_t::acquire_sized(std::size_t size)
+{
+  buffer_t result = this->take(size);
+  result.resize(size);
+  return result;
+}
+
+/*
+ * Returns a buffer with a capacity of at least size bytes, which may
+ * hold the contents of a previous use.
+ */
+buffer_pool_t::buffer_t buffer_pool_t::take(std::size_t size)
+{
+  buffer_t result;
+
+  if(size < min_pooled_size || size > max_pooled_size)
+  {
+    result.reserve(size);
+    return result;
+  }
+
+  // smallest class whose buffers are all large enough
+  std::size_t bits = bit_width(size - 1);
+  assert(bits >= min_class_bits);
+  assert(bits <= max_class_bits);
+
+  {
+    std::scoped_lock<std::mutex> lock(mutex_);
+
+    auto& buffers = classes_[bits - min_class_bits];
+    if(!buffers.empty())
+    {
+      result = std::move(buffers.back());
+      buffers.pop_back();
+      pooled_bytes_ -= result.capacity();
+      ++hits_;
+    }
+    else
+    {
+      ++misses_;
+    }
+  }
+
+  if(result.capacity() == 0)
+  {
+    result.reserve(std::size_t(1) << bits);
+  }
+
+  assert(result.capacity() >= size);
+  return result;
+}
+
+void buffer_pool_t::release(buffer_t&& buffer) noexcept
+{
+  std::size_t capacity = buffer.capacity();
+  if(capacity < min_pooled_size)
+  {
+    return;
+  }
+
+  // largest class that this buffer is large enough for
+  std::size_t bits = bit_width(capacity) - 1;
+  if(bits > max_class_bits)
+  {
+    bits = max_class_bits;
+  }
+
+  buffer_t doomed;
+  {
+    std::scoped_lock<std::mutex> lock(mutex_);
+
+    if(pooled_bytes_ + capacity > max_pooled_bytes_)
+    {
+      // free the buffer outside the lock
+      doomed = std::move(buffer);
+      return;
+    }
+
+    try
+    {
+      // keep the contents: acquire_sized() need not fill them again
+      classes_[bits - min_class_bits].push_back(std::move(buffer));
+      pooled_bytes_ += capacity;
+    }
+    catch(std::exception const&)
+    {
+      doomed = std::move(buffer);
+    }
+  }
+}
+
+void buffer_pool_t::set_max_pooled_bytes(std::size_t max_pooled_bytes) noexcept
+{
+  std::scoped_lock<std::mutex> lock(mutex_);
+
+  max_pooled_bytes_ = max_pooled_bytes;
+
+  // free the largest buffers first
+  for(auto it = classes_.rbegin();
+      it != classes_.rend() && pooled_bytes_ > max_pooled_bytes_;
+      ++it)
+  {
+    while(!it->empty() && pooled_bytes_ > max_pooled_bytes_)
+    {
+      pooled_bytes_ -= it->back().capacity();
+      it->pop_back();
+    }
+  }
+}
+
+std::size_t buffer_pool_t::max_pooled_bytes() const noexcept
+{
+  std::scoped_lock<std::mutex> lock(mutex_);
+  return max_pooled_bytes_;
+}
+
+std::size_t buffer_pool_t::hits() const noexcept
+{
+  std::scoped_lock<std::mutex> lock(mutex_);
+  return hits_;
+}
+
+std::size_t buffer_pool_t::misses() const noexcept
+{
+  std::scoped_lock<std::mutex> lock(mutex_);
+  return misses_;
+}
+
+std::size_t buffer_pool_t::pooled_bytes() const noexcept
+{
+  std::scoped_lock<std::mutex> lock(mutex_);
+  return pooled_bytes_;
+}
+
+buffer_pool_t& default_buffer_pool()
+{
+  static buffer_pool_t pool(0);
+  return pool;
+}
+
+} // cuti
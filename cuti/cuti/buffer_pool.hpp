@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2026 CodeShop B.V.
+ *
+ * This file is part of the cuti library.
+ *
+ * The cuti library is free software: you can redistribute it and/or
+ * modify it under the terms of version 2.1 of the GNU Lesser General
+ * Public License as published by the Free Software Foundation.
+ *
+ * The cuti library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See version
+ * 2.1 of the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of version 2.1 of the GNU Lesser
+ * General Public License along with the cuti library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CUTI_BUFFER_POOL_HPP_
+#define CUTI_BUFFER_POOL_HPP_
+
+#include "linkage.h"
+
+#include <array>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace cuti
+{
+
+/*
+ * Thread-safe pool of byte buffers, for recycling large blobs (such
+ * as video frames and encoded samples) instead of returning them to
+ * the heap.  Large heap blocks are typically mmap()ed and munmap()ed
+ * on every allocation, and each of their pages faults on first touch;
+ * a recycled buffer's pages are already mapped in.
+ *
+ * Buffers are kept in power-of-two size classes: a buffer is found
+ * in the class of the largest power of two not exceeding its
+ * capacity, and serves any request of up to that size.  Only the
+ * capacity of a freshly allocated buffer is rounded up, which costs
+ * address space but no physical memory for the pages never touched.
+ */
+struct CUTI_ABI buffer_pool_t
+{
+  using buffer_t = std::vector<unsigned char>;
+
+  /*
+   * Smaller and larger buffers are not pooled.
+   */
+  static std::size_t constexpr min_pooled_size = std::size_t(1) << 12;
+  static std::size_t constexpr max_pooled_size = std::size_t(1) << 28;
+
+  static std::size_t constexpr default_max_pooled_bytes =
+    std::size_t(256) * 1024 * 1024;
+
+  /*
+   * Constructs a pool holding at most max_pooled_bytes bytes of
+   * buffer capacity; buffers released to a full pool are freed.  A
+   * pool with a limit of 0 bytes pools nothing.
+   */
+  explicit buffer_pool_t(
+    std::size_t max_pooled_bytes = default_max_pooled_bytes);
+
+  buffer_pool_t(buffer_pool_t const&) = delete;
+  buffer_pool_t& operator=(buffer_pool_t const&) = delete;
+
+  /*
+   * Returns an empty buffer with a capacity of at least size bytes,
+   * recycling a pooled buffer if possible.
+   */
+  buffer_t acquire(std::size_t size);
+
+  /*
+   * Like acquire(), but returns a buffer of size bytes, to be filled
+   * in place.  Its contents are unspecified: a recycled buffer keeps
+   * what it held, and only the bytes beyond its previous size are
+   * zero-filled.
+   */
+  buffer_t acquire_sized(std::size_t size);
+
+  /*
+   * Returns a buffer to the pool.
+   */
+  void release(buffer_t&& buffer) noexcept;
+
+  /*
+   * Changes the limit on the pooled capacity, freeing pooled buffers
+   * as needed; a limit of 0 bytes disables the pool.
+   */
+  void set_max_pooled_bytes(std::size_t max_pooled_bytes) noexcept;
+
+  std::size_t max_pooled_bytes() const noexcept;
+
+  /*
+   * Statistics: the number of acquire() and acquire_sized() calls
+   * for a poolable size that were served from the pool (hits) or
+   * needed a new allocation (misses), and the current number of
+   * pooled bytes.
+   */
+  std::size_t hits() const noexcept;
+  std::size_t misses() const noexcept;
+  std::size_t pooled_bytes() const noexcept;
+
+private :
+  static std::size_t constexpr min_class_bits = 12;
+  static std::size_t constexpr max_class_bits = 28;
+  static std::size_t constexpr n_classes =
+    max_class_bits - min_class_bits + 1;
+
+  buffer_t take(std::size_t size);
+
+  std::size_t max_pooled_bytes_;
+
+  std::mutex mutable mutex_;
+  std::array<std::vector<buffer_t>, n_classes> classes_;
+  std::size_t pooled_bytes_;
+  std::size_t hits_;
+  std::size_t misses_;
+};
+
+/*
+ * Returns the process-wide buffer pool shared by the blob readers and
+ * writers and the encoding sessions.  Pooling is opt-in: this pool
+ * starts out with a limit of 0 bytes; see set_max_pooled_bytes().
+ */
+CUTI_ABI
+buffer_pool_t& default_buffer_pool();
+
+} // cuti
+
+#endif
@@ -20,16 +20,228 @@
 #ifndef CUTI_CALLBACK_HPP_
 #define CUTI_CALLBACK_HPP_
 
-#include "function.hpp"
 #include "stack_marker.hpp"
+#include "type_traits.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace cuti
 {
 
 /*
- * Type-erased callback wrapper.
+ * Type-erased, move-only callback wrapper.
+ *
+ * Callables that are small enough (such as lambdas capturing a few
+ * pointers or iterators) and nothrow move constructible are stored
+ * inline, so scheduling a callback does not allocate; larger ones
+ * are stored on the heap.  Like function_t, callback_t requires the
+ * wrapped callable to be const-callable.
  */
-using callback_t = function_t<void(stack_marker_t& base_marker)>;
+struct callback_t
+{
+  static std::size_t constexpr inline_size = 4 * sizeof(void*);
+
+  callback_t() noexcept
+  : ops_(nullptr)
+  { }
+
+  callback_t(std::nullptr_t) noexcept
+  : ops_(nullptr)
+  { }
+
+  template<typename F, typename = std::enable_if_t<
+    std::is_invocable_r_v<void, std::decay_t<F> const, stack_marker_t&> &&
+    !std::is_same_v<std::decay_t<F>, callback_t>>>
+  callback_t(F&& f)
+  : ops_(nullptr)
+  {
+    using impl_t = std::decay_t<F>;
+
+    if(is_null(f))
+    {
+      return;
+    }
+
+    if constexpr(stored_inline<impl_t>())
+    {
+      ::new(static_cast<void*>(storage_)) impl_t(std::forward<F>(f));
+    }
+    else
+    {
+      *reinterpret_cast<impl_t**>(storage_) = new impl_t(std::forward<F>(f));
+    }
+    ops_ = &ops_for<impl_t>;
+  }
+
+  callback_t(callback_t&& rhs) noexcept
+  : ops_(rhs.ops_)
+  {
+    if(ops_ != nullptr)
+    {
+      ops_->move_(storage_, rhs.storage_);
+      rhs.ops_ = nullptr;
+    }
+  }
+
+  callback_t(callback_t const&) = delete;
+  callback_t& operator=(callback_t const&) = delete;
+
+  callback_t& operator=(callback_t&& rhs) noexcept
+  {
+    if(this != &rhs)
+    {
+      this->reset();
+      if(rhs.ops_ != nullptr)
+      {
+        rhs.ops_->move_(storage_, rhs.storage_);
+        ops_ = rhs.ops_;
+        rhs.ops_ = nullptr;
+      }
+    }
+    return *this;
+  }
+
+  callback_t& operator=(std::nullptr_t) noexcept
+  {
+    this->reset();
+    return *this;
+  }
+
+  template<typename F, typename = std::enable_if_t<
+    std::is_invocable_r_v<void, std::decay_t<F> const, stack_marker_t&> &&
+    !std::is_same_v<std::decay_t<F>, callback_t>>>
+  callback_t& operator=(F&& f)
+  {
+    callback_t tmp(std::forward<F>(f));
+    *this = std::move(tmp);
+    return *this;
+  }
+
+  explicit operator bool() const noexcept
+  { return ops_ != nullptr; }
+
+  bool operator==(std::nullptr_t) const noexcept
+  { return ops_ == nullptr; }
+
+  void operator()(stack_marker_t& base_marker) const
+  {
+    assert(ops_ != nullptr);
+    ops_->invoke_(storage_, base_marker);
+  }
+
+  friend void swap(callback_t& cb1, callback_t& cb2) noexcept
+  {
+    callback_t tmp(std::move(cb1));
+    cb1 = std::move(cb2);
+    cb2 = std::move(tmp);
+  }
+
+  ~callback_t()
+  {
+    this->reset();
+  }
+
+private :
+  struct ops_t
+  {
+    void (*invoke_)(void const* storage, stack_marker_t& base_marker);
+    void (*move_)(void* target, void* source) noexcept;
+    void (*destroy_)(void* storage) noexcept;
+  };
+
+  template<typename F>
+  static bool constexpr stored_inline()
+  {
+    return sizeof(F) <= inline_size &&
+      alignof(F) <= alignof(std::max_align_t) &&
+      std::is_nothrow_move_constructible_v<F>;
+  }
+
+  template<typename F>
+  static bool is_null(F const& f)
+  {
+    if constexpr(std::is_function_v<F>)
+    {
+      return false;
+    }
+    else if constexpr(!is_equality_comparable_v<F, std::nullptr_t>)
+    {
+      return false;
+    }
+    else
+    {
+      return f == nullptr;
+    }
+  }
+
+  template<typename F>
+  static F const& target(void const* storage) noexcept
+  {
+    if constexpr(stored_inline<F>())
+    {
+      return *std::launder(static_cast<F const*>(storage));
+    }
+    else
+    {
+      return **static_cast<F* const*>(storage);
+    }
+  }
+
+  template<typename F>
+  static void invoke(void const* storage, stack_marker_t& base_marker)
+  {
+    std::invoke(target<F>(storage), base_marker);
+  }
+
+  template<typename F>
+  static void move(void* target, void* source) noexcept
+  {
+    if constexpr(stored_inline<F>())
+    {
+      F* f = std::launder(static_cast<F*>(source));
+      ::new(target) F(std::move(*f));
+      f->~F();
+    }
+    else
+    {
+      *static_cast<F**>(target) = *static_cast<F**>(source);
+    }
+  }
+
+  template<typename F>
+  static void destroy(void* storage) noexcept
+  {
+    if constexpr(stored_inline<F>())
+    {
+      std::launder(static_cast<F*>(storage))->~F();
+    }
+    else
+    {
+      delete *static_cast<F**>(storage);
+    }
+  }
+
+  template<typename F>
+  static inline ops_t const ops_for = { &invoke<F>, &move<F>, &destroy<F> };
+
+  void reset() noexcept
+  {
+    if(ops_ != nullptr)
+    {
+      ops_->destroy_(storage_);
+      ops_ = nullptr;
+    }
+  }
+
+private :
+  ops_t const* ops_;
+  alignas(std::max_align_t) unsigned char storage_[inline_size];
+};
 
 } // cuti
 
@@ -62,7 +62,7 @@ struct CUTI_ABI cancellation_ticket_t
 private :
   friend struct scheduler_t;
 
-  enum class type_t { empty, alarm, writable, readable };
+  enum class type_t { empty, alarm, coarse_alarm, soon, writable, readable };
 
   explicit cancellation_ticket_t(type_t type, int id) noexcept
   : type_(type)
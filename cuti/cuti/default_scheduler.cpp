@@ -34,22 +34,58 @@ default_scheduler_t::default_scheduler_t(socket_layer_t& sockets)
 default_scheduler_t::default_scheduler_t(
   socket_layer_t& sockets, selector_factory_t const& factory)
 : alarms_()
+, coarse_alarms_(cuti_clock_t::now())
+, soon_arena_()
+, soon_list_(soon_arena_.add_list())
 , selector_(factory(sockets))
 , poll_first_(false)
+, soon_calls_until_alarm_check_(soon_calls_per_alarm_check)
 { }
 
 callback_t default_scheduler_t::wait()
 {
   callback_t result = nullptr;
 
-  if(!alarms_.empty())
+  if(!soon_arena_.list_empty(soon_list_))
+  {
+    if(poll_first_ && selector_->has_work())
+    {
+      // poll for I/O
+      poll_first_ = false;
+      result = selector_->select(duration_t::zero());
+    }
+    if(result == nullptr && soon_calls_until_alarm_check_ == 0)
+    {
+      // check for due alarms without reading the clock for every
+      // soon callback
+      soon_calls_until_alarm_check_ = soon_calls_per_alarm_check;
+      if(!alarms_.empty() || !coarse_alarms_.empty())
+      {
+        auto now = cuti_clock_t::now();
+        if(alarm_due(now))
+        {
+          poll_first_ = true;
+          result = take_due_alarm(now);
+        }
+      }
+    }
+    if(result == nullptr)
+    {
+      // select the oldest soon callback
+      poll_first_ = true;
+      --soon_calls_until_alarm_check_;
+      int soon_id = soon_arena_.first(soon_list_);
+      result = std::move(soon_arena_.value(soon_id));
+      assert(result != nullptr);
+      soon_arena_.remove_element(soon_id);
+    }
+  }
+  else if(!alarms_.empty() || !coarse_alarms_.empty())
   {
-    int alarm_id = alarms_.front_element();
-    auto limit = alarms_.priority(alarm_id);
     do
     {
       auto now = cuti_clock_t::now();
-      if(now >= limit)
+      if(alarm_due(now))
       {
         if(poll_first_ && selector_->has_work())
         {
@@ -59,22 +95,29 @@ callback_t default_scheduler_t::wait()
         }
         else
         {
-          // select alarm_id
           poll_first_ = true;
-          result = std::move(alarms_.value(alarm_id));
-          assert(result != nullptr);
-          alarms_.remove_element(alarm_id);
+          result = take_due_alarm(now);
         }
       }
-      else if(selector_->has_work())
-      {
-        // wait for I/O until limit
-        result = selector_->select(limit - now);
-      }
       else
       {
-        // sleep until limit
-        std::this_thread::sleep_for(limit - now);
+        auto limit = coarse_alarms_.next_check();
+        if(!alarms_.empty() &&
+           alarms_.priority(alarms_.front_element()) < limit)
+        {
+          limit = alarms_.priority(alarms_.front_element());
+        }
+
+        if(selector_->has_work())
+        {
+          // wait for I/O until limit
+          result = selector_->select(limit - now);
+        }
+        else
+        {
+          // sleep until limit
+          std::this_thread::sleep_for(limit - now);
+        }
       }
     } while(result == nullptr);
   }
@@ -90,6 +133,45 @@ callback_t default_scheduler_t::wait()
   return result;
 }
 
+bool default_scheduler_t::alarm_due(time_point_t now)
+{
+  coarse_alarms_.advance(now);
+
+  return (!alarms_.empty() &&
+          now >= alarms_.priority(alarms_.front_element())) ||
+    coarse_alarms_.has_expired();
+}
+
+callback_t default_scheduler_t::take_due_alarm(time_point_t now)
+{
+  callback_t result = nullptr;
+
+  /*
+   * When both kinds are due (after a late wakeup), serve the one that
+   * was due first.
+   */
+  if(!alarms_.empty() && now >= alarms_.priority(alarms_.front_element()) &&
+     (!coarse_alarms_.has_expired() ||
+      alarms_.priority(alarms_.front_element()) <
+        coarse_alarms_.due_time(coarse_alarms_.first_expired())))
+  {
+    // select the first alarm
+    int alarm_id = alarms_.front_element();
+    result = std::move(alarms_.value(alarm_id));
+    alarms_.remove_element(alarm_id);
+  }
+  else
+  {
+    // select the first expired coarse alarm
+    int alarm_id = coarse_alarms_.first_expired();
+    result = std::move(coarse_alarms_.value(alarm_id));
+    coarse_alarms_.remove_timer(alarm_id);
+  }
+
+  assert(result != nullptr);
+  return result;
+}
+
 int default_scheduler_t::do_call_alarm(
   time_point_t time_point, callback_t callback)
 {
@@ -101,6 +183,28 @@ void default_scheduler_t::do_cancel_alarm(int ticket) noexcept
   alarms_.remove_element(ticket);
 }
 
+int default_scheduler_t::do_call_coarse_alarm(
+  time_point_t time_point, callback_t callback)
+{
+  return coarse_alarms_.add_timer(time_point, std::move(callback));
+}
+
+void default_scheduler_t::do_cancel_coarse_alarm(int ticket) noexcept
+{
+  coarse_alarms_.remove_timer(ticket);
+}
+
+int default_scheduler_t::do_call_soon(callback_t callback)
+{
+  return soon_arena_.add_element_before(
+    soon_arena_.last(soon_list_), std::move(callback));
+}
+
+void default_scheduler_t::do_cancel_soon(int ticket) noexcept
+{
+  soon_arena_.remove_element(ticket);
+}
+
 int default_scheduler_t::do_call_when_writable(int fd, callback_t callback)
 {
   return selector_->call_when_writable(fd, std::move(callback));
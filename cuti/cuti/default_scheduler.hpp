@@ -22,9 +22,11 @@
 
 #include "indexed_heap.hpp"
 #include "linkage.h"
+#include "list_arena.hpp"
 #include "scheduler.hpp"
 #include "selector.hpp"
 #include "selector_factory.hpp"
+#include "timer_wheel.hpp"
 
 #include <functional>
 #include <memory>
@@ -55,23 +57,40 @@ struct CUTI_ABI default_scheduler_t : scheduler_t
   /*
    * Waits for any of the registered events to occur and returns the
    * first event's callback, or nullptr if the scheduler is out of
-   * work.
+   * work.  Callbacks scheduled with call_soon() are returned without
+   * waiting, alternating with polls for I/O; due alarms are checked
+   * for every soon_calls_per_alarm_check soon callbacks, so an
+   * endless chain of soon callbacks cannot starve them.
    */
   callback_t wait();
-  
+
+  static unsigned int constexpr soon_calls_per_alarm_check = 16;
+
 private :
   int do_call_alarm(time_point_t time_point, callback_t callback) override;
   void do_cancel_alarm(int ticket) noexcept override;
+  int do_call_coarse_alarm(time_point_t time_point,
+                           callback_t callback) override;
+  void do_cancel_coarse_alarm(int ticket) noexcept override;
+  int do_call_soon(callback_t callback) override;
+  void do_cancel_soon(int ticket) noexcept override;
   int do_call_when_writable(int fd, callback_t callback) override;
   void do_cancel_when_writable(int ticket) noexcept override;
   int do_call_when_readable(int fd, callback_t callback) override;
   void do_cancel_when_readable(int ticket) noexcept override;
 
+  bool alarm_due(time_point_t now);
+  callback_t take_due_alarm(time_point_t now);
+
 private :
   indexed_heap_t<time_point_t, callback_t,
     std::greater<time_point_t>> alarms_; // std::greater results in minheap
+  timer_wheel_t<callback_t> coarse_alarms_;
+  list_arena_t<callback_t> soon_arena_;
+  int soon_list_;
   std::unique_ptr<selector_t> selector_;
   bool poll_first_;
+  unsigned int soon_calls_until_alarm_check_;
 };
 
 }
@@ -35,8 +35,10 @@
 #include "tcp_acceptor.hpp"
 #include "tcp_connection.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <condition_variable>
+#include <exception>
 #include <limits>
 #include <list>
 #include <mutex>
@@ -174,9 +176,10 @@ struct listener_t
   listener_t(logging_context_t const& context,
              socket_layer_t& sockets,
              endpoint_t const& endpoint,
-             method_map_t const& map)
+             method_map_t const& map,
+             bool reuse_port)
   : context_(context)
-  , acceptor_(sockets, endpoint)
+  , acceptor_(sockets, endpoint, reuse_port)
   , map_(map)
   , ready_ticket_()
   , scheduler_()
@@ -244,6 +247,19 @@ struct listener_t
     scheduler_ = nullptr;
     callback_ = nullptr;
   }
+
+  /*
+   * Schedules a one-time callback for when the acceptor is ready on
+   * behalf of a reactor, returning the ticket for canceling it.
+   * Unlike call_when_ready(), this may be used from several
+   * schedulers at the same time.
+   */
+  cancellation_ticket_t watch(scheduler_t& scheduler,
+                              callback_t callback) const
+  {
+    assert(callback != nullptr);
+    return acceptor_.call_when_ready(scheduler, std::move(callback));
+  }
     
   ~listener_t()
   {
@@ -283,7 +299,9 @@ struct client_t
   client_t(logging_context_t const& context,
            std::unique_ptr<tcp_connection_t> conn,
            std::size_t bufsize,
+           std::size_t max_bufsize,
            throughput_settings_t const& settings,
+           flag_t zerocopy,
            method_map_t const& map)
   : context_(context)
   , nb_inbuf_()
@@ -293,7 +311,12 @@ struct client_t
   {
     assert(conn != nullptr);
     std::tie(nb_inbuf_, nb_outbuf_) =
-      make_nb_tcp_buffers(std::move(conn), bufsize, bufsize);
+      make_nb_tcp_buffers(std::move(conn), bufsize, bufsize,
+        max_bufsize, max_bufsize);
+    if(zerocopy)
+    {
+      nb_outbuf_->enable_zerocopy();
+    }
 
     if(auto msg = context_.message_at(loglevel_t::info))
     {
@@ -391,8 +414,11 @@ struct core_dispatcher_t
   
   endpoint_t add_listener(endpoint_t const& endpoint, method_map_t const& map)
   {
+    bool reuse_port = config_.shard_listeners_ &&
+      config_.reactor_threads_ > 1 &&
+      !endpoint.is_unix();
     auto listener = listeners_.emplace(listeners_.begin(),
-      context_, sockets_, endpoint, map);
+      context_, sockets_, endpoint, map, reuse_port);
     listener->call_when_ready(
       scheduler_,
       [this, listener](stack_marker_t&) { this->on_listener_ready(listener); }
@@ -401,6 +427,11 @@ struct core_dispatcher_t
     return listener->endpoint();
   }
 
+  std::list<listener_t>& listeners()
+  {
+    return listeners_;
+  }
+
   std::optional<std::list<client_t>::iterator> select_client()
   {
     assert(!woken_up_);
@@ -515,7 +546,8 @@ private :
     {
       auto new_client = served_clients_.emplace(served_clients_.begin(),
         context_, std::move(accepted),
-        config_.bufsize_, config_.throughput_settings_,
+        config_.bufsize_, config_.max_bufsize_,
+        config_.throughput_settings_, config_.zerocopy_,
         listener->method_map());
 
       bool handler_completed = true;
@@ -939,6 +971,641 @@ bool handle_request(pooled_thread_t& current_thread, client_t& client)
   return true;
 }
 
+struct reactor_pool_t;
+
+/*
+ * A reactor accepts connections on the listeners it watches (all of
+ * them, unless listeners are sharded) and runs any number of request
+ * handlers for these connections concurrently, using a scheduler of
+ * its own on a single thread.
+ *
+ * A connection with a pending request is put in its reactor's ready
+ * queue.  While below its request limit, a reactor starts requests
+ * from its own ready queue first, and then steals from the ready
+ * queues of the other reactors.
+ */
+struct reactor_t
+{
+  reactor_t(logging_context_t const& context,
+            socket_layer_t& sockets,
+            dispatcher_config_t const& config,
+            reactor_pool_t& pool,
+            std::size_t id,
+            std::size_t max_requests,
+            std::size_t max_connections)
+  : context_(context)
+  , config_(config)
+  , pool_(pool)
+  , id_(id)
+  , max_requests_(max_requests)
+  , max_connections_(max_connections)
+  , scheduler_(sockets, config_.selector_factory_)
+  , wakeup_flag_(sockets)
+  , listener_tickets_()
+  , monitored_clients_()
+  , ready_mutex_()
+  , ready_clients_()
+  , active_requests_()
+  , n_active_requests_(0)
+  , completed_requests_()
+  { }
+
+  reactor_t(reactor_t const&) = delete;
+  reactor_t& operator=(reactor_t const&) = delete;
+
+  std::size_t id() const
+  {
+    return id_;
+  }
+
+  /*
+   * This function is thread-safe.
+   */
+  void wake_up()
+  {
+    wakeup_flag_.raise();
+  }
+
+  /*
+   * This function is thread-safe.
+   */
+  bool idle() const
+  {
+    return n_active_requests_.load(std::memory_order_acquire) == 0;
+  }
+
+  /*
+   * Moves the client that became ready first, if any, to the end of
+   * target.  This function is thread-safe.
+   */
+  bool take_ready_client(std::list<client_t>& target)
+  {
+    std::scoped_lock<std::mutex> lock(ready_mutex_);
+
+    if(ready_clients_.empty())
+    {
+      return false;
+    }
+
+    target.splice(target.end(), ready_clients_, ready_clients_.begin());
+    return true;
+  }
+
+  void run(std::list<listener_t>& listeners)
+  {
+    if(auto msg = context_.message_at(loglevel_t::info))
+    {
+      *msg << "reactor " << id_ << " started";
+    }
+
+    listener_tickets_.resize(listeners.size());
+    std::size_t index = 0;
+    for(auto& listener : listeners)
+    {
+      this->watch_listener(index, listener);
+      ++index;
+    }
+
+    wakeup_flag_.call_when_up(
+      scheduler_,
+      [this](stack_marker_t&) { this->on_wakeup_flag(); }
+    );
+
+    stack_marker_t base_marker;
+    for(;;)
+    {
+      this->start_ready_requests(base_marker);
+      this->reap_completed_requests();
+
+      if(this->stopping())
+      {
+        break;
+      }
+
+      auto cb = scheduler_.wait();
+      assert(cb != nullptr);
+      cb(base_marker);
+
+      this->reap_completed_requests();
+    }
+
+    this->shut_down();
+
+    if(auto msg = context_.message_at(loglevel_t::info))
+    {
+      *msg << "reactor " << id_ << " stopped";
+    }
+  }
+
+private :
+  struct active_request_t : result_t<void>
+  {
+    active_request_t(reactor_t& reactor, std::list<client_t> client)
+    : reactor_(reactor)
+    , client_(std::move(client))
+    , inbuf_(client_.front().nb_inbuf(), reactor_.scheduler_)
+    , outbuf_(client_.front().nb_outbuf(), reactor_.scheduler_)
+    , request_handler_(*this, client_.front().context(),
+        inbuf_, outbuf_, client_.front().method_map())
+    , self_()
+    {
+      assert(client_.size() == 1);
+
+      inbuf_.enable_throughput_checking(
+        client_.front().throughput_settings());
+      outbuf_.enable_throughput_checking(
+        client_.front().throughput_settings());
+    }
+
+    active_request_t(active_request_t const&) = delete;
+    active_request_t& operator=(active_request_t const&) = delete;
+
+    client_t& client()
+    {
+      return client_.front();
+    }
+
+    void start(stack_marker_t& base_marker,
+               std::list<active_request_t>::iterator self)
+    {
+      self_ = self;
+      request_handler_.start(base_marker);
+    }
+
+    /*
+     * Hands back the client; the request must be destroyed before the
+     * client is used again.
+     */
+    std::list<client_t> release_client()
+    {
+      return std::move(client_);
+    }
+
+  private :
+    void do_submit(stack_marker_t& /* ignored */, no_value_t) override
+    {
+      reactor_.completed_requests_.emplace_back(self_, nullptr);
+    }
+
+    void do_fail(stack_marker_t& /* ignored */, std::exception_ptr ex)
+      override
+    {
+      reactor_.completed_requests_.emplace_back(self_, std::move(ex));
+    }
+
+  private :
+    reactor_t& reactor_;
+    std::list<client_t> client_;
+    bound_inbuf_t inbuf_;
+    bound_outbuf_t outbuf_;
+    request_handler_t request_handler_;
+    std::list<active_request_t>::iterator self_;
+  };
+
+  bool stopping() const;
+  bool steal_ready_client(std::list<client_t>& target);
+  void offer_ready_client();
+
+  void watch_listener(std::size_t index, listener_t& listener)
+  {
+    listener_tickets_[index] = listener.watch(
+      scheduler_,
+      [this, index, &listener](stack_marker_t&)
+      { this->on_listener_ready(index, listener); }
+    );
+  }
+
+  void on_listener_ready(std::size_t index, listener_t& listener)
+  {
+    listener_tickets_[index].clear();
+
+    // other reactors may have beaten us to it
+    std::unique_ptr<tcp_connection_t> accepted;
+    if((accepted = listener.accept()) != nullptr)
+    {
+      std::list<client_t> new_client;
+      new_client.emplace_back(context_, std::move(accepted),
+        config_.bufsize_, config_.max_bufsize_,
+        config_.throughput_settings_, config_.zerocopy_,
+        listener.method_map());
+      this->resume_monitoring(std::move(new_client));
+    }
+
+    this->watch_listener(index, listener);
+  }
+
+  void on_wakeup_flag()
+  {
+    wakeup_flag_.lower();
+
+    wakeup_flag_.call_when_up(
+      scheduler_,
+      [this](stack_marker_t&) { this->on_wakeup_flag(); }
+    );
+  }
+
+  void resume_monitoring(std::list<client_t> client)
+  {
+    assert(client.size() == 1);
+
+    if(auto status = client.front().nb_inbuf().error_status())
+    {
+      if(auto msg = context_.message_at(loglevel_t::error))
+      {
+        *msg << "input error on connection " << client.front().nb_inbuf() <<
+          ": " << status;
+      }
+      return;
+    }
+
+    if(auto status = client.front().nb_outbuf().error_status())
+    {
+      if(auto msg = context_.message_at(loglevel_t::error))
+      {
+        *msg << "output error on connection " <<
+          client.front().nb_outbuf() << ": " << status;
+      }
+      return;
+    }
+
+    if(max_connections_ != 0 && monitored_clients_.size() == max_connections_)
+    {
+      auto oldest_client = monitored_clients_.end();
+      --oldest_client;
+      if(auto msg = context_.message_at(loglevel_t::error))
+      {
+        *msg << "maximum number of connections (" << max_connections_ <<
+          ") on reactor " << id_ <<
+          " exceeded; evicting least recently active connection " <<
+          oldest_client->nb_inbuf();
+      }
+      monitored_clients_.erase(oldest_client);
+    }
+
+    auto monitored_client = client.begin();
+    monitored_clients_.splice(monitored_clients_.begin(),
+      client, monitored_client);
+    monitored_client->nb_inbuf().call_when_readable(
+      scheduler_,
+      [this, monitored_client](stack_marker_t&)
+      { this->on_client_readable(monitored_client); }
+    );
+  }
+
+  void on_client_readable(std::list<client_t>::iterator client)
+  {
+    if(!client->nb_inbuf().readable())
+    {
+      client->nb_inbuf().call_when_readable(
+        scheduler_,
+        [this, client](stack_marker_t&) { this->on_client_readable(client); }
+      );
+      return;
+    }
+
+    if(client->nb_inbuf().peek() == eof)
+    {
+      if(auto msg = context_.message_at(loglevel_t::info))
+      {
+        *msg << "end of input on connection " << client->nb_inbuf();
+      }
+      monitored_clients_.erase(client);
+      return;
+    }
+
+    {
+      std::scoped_lock<std::mutex> lock(ready_mutex_);
+      ready_clients_.splice(ready_clients_.end(), monitored_clients_, client);
+    }
+
+    if(!active_requests_.empty())
+    {
+      // we are busy: let an idle reactor have a go at it
+      this->offer_ready_client();
+    }
+  }
+
+  void start_ready_requests(stack_marker_t& base_marker)
+  {
+    while(max_requests_ == 0 || active_requests_.size() < max_requests_)
+    {
+      std::list<client_t> client;
+      if(!this->take_ready_client(client) &&
+         !this->steal_ready_client(client))
+      {
+        break;
+      }
+
+      if(auto msg = context_.message_at(loglevel_t::info))
+      {
+        *msg << "handling request from connection " <<
+          client.front().nb_inbuf() << " on reactor " << id_;
+      }
+
+      auto request = active_requests_.emplace(active_requests_.end(),
+        *this, std::move(client));
+      n_active_requests_.store(
+        active_requests_.size(), std::memory_order_release);
+      request->start(base_marker, request);
+    }
+  }
+
+  void reap_completed_requests()
+  {
+    for(auto& [request, ex] : completed_requests_)
+    {
+      std::list<client_t> client = request->release_client();
+      active_requests_.erase(request);
+      n_active_requests_.store(
+        active_requests_.size(), std::memory_order_release);
+
+      if(ex != nullptr)
+      {
+        // the request handler gave up on the connection: drop it
+        if(auto msg = context_.message_at(loglevel_t::error))
+        {
+          *msg << "request handling on connection " <<
+            client.front().nb_inbuf() << " failed";
+          try
+          {
+            std::rethrow_exception(ex);
+          }
+          catch(std::exception const& stdex)
+          {
+            *msg << ": " << stdex.what();
+          }
+          catch(...)
+          {
+          }
+        }
+        continue;
+      }
+
+      this->resume_monitoring(std::move(client));
+    }
+
+    completed_requests_.clear();
+  }
+
+  void shut_down()
+  {
+    for(auto& request : active_requests_)
+    {
+      if(auto msg = context_.message_at(loglevel_t::error))
+      {
+        *msg << "request handling on connection " <<
+          request.client().nb_inbuf() << " interrupted";
+      }
+    }
+    active_requests_.clear();
+    n_active_requests_.store(0, std::memory_order_release);
+
+    {
+      std::scoped_lock<std::mutex> lock(ready_mutex_);
+      ready_clients_.clear();
+    }
+    monitored_clients_.clear();
+
+    for(auto& ticket : listener_tickets_)
+    {
+      if(!ticket.empty())
+      {
+        scheduler_.cancel(ticket);
+        ticket.clear();
+      }
+    }
+
+    wakeup_flag_.cancel_when_up();
+  }
+
+private :
+  logging_context_t const& context_;
+  dispatcher_config_t const& config_;
+  reactor_pool_t& pool_;
+  std::size_t const id_;
+  std::size_t const max_requests_; // 0: no limit
+  std::size_t const max_connections_; // 0: no limit
+
+  default_scheduler_t scheduler_;
+  wakeup_flag_t wakeup_flag_;
+  std::vector<cancellation_ticket_t> listener_tickets_;
+
+  std::list<client_t> monitored_clients_;
+
+  // guarded by ready_mutex_; other reactors may steal from here
+  std::mutex ready_mutex_;
+  std::list<client_t> ready_clients_;
+
+  std::list<active_request_t> active_requests_;
+  static_assert(std::atomic<std::size_t>::is_always_lock_free);
+  std::atomic<std::size_t> n_active_requests_;
+  std::vector<std::pair<std::list<active_request_t>::iterator,
+    std::exception_ptr>> completed_requests_;
+};
+
+/*
+ * Divides a dispatcher-wide limit (0: no limit) over n_reactors,
+ * rounding up so that no reactor is left without capacity.
+ */
+std::size_t reactor_share(std::size_t limit, std::size_t n_reactors)
+{
+  assert(n_reactors != 0);
+
+  if(limit == 0)
+  {
+    return 0;
+  }
+  return std::max<std::size_t>(1, (limit + n_reactors - 1) / n_reactors);
+}
+
+struct reactor_pool_t
+{
+  reactor_pool_t(logging_context_t const& context,
+                 socket_layer_t& sockets,
+                 dispatcher_config_t const& config,
+                 std::list<listener_t>& listeners)
+  : context_(context)
+  , stopping_(false)
+  , reactors_()
+  , shards_()
+  , threads_()
+  {
+    std::size_t n_reactors = config.reactor_threads_;
+    assert(n_reactors != 0);
+
+    std::size_t max_requests =
+      reactor_share(config.max_concurrent_requests_, n_reactors);
+    std::size_t max_connections =
+      reactor_share(config.max_connections_, n_reactors);
+
+    // all reactors must exist before any of them may steal
+    reactors_.reserve(n_reactors);
+    for(std::size_t id = 0; id != n_reactors; ++id)
+    {
+      reactors_.push_back(std::make_unique<reactor_t>(context_, sockets,
+        config, *this, id, max_requests, max_connections));
+    }
+
+    /*
+     * With sharded listeners, the first reactor keeps the original
+     * acceptors, and each other reactor gets its own acceptor bound
+     * to the same endpoint.  Unix domain sockets cannot share their
+     * path, so these are only watched by the first reactor.
+     */
+    if(config.shard_listeners_ && n_reactors > 1)
+    {
+      shards_.resize(n_reactors - 1);
+      for(auto& shard : shards_)
+      {
+        for(auto const& listener : listeners)
+        {
+          if(listener.endpoint().is_unix())
+          {
+            continue;
+          }
+          bool const reuse_port = true;
+          shard.emplace_back(context_, sockets,
+            listener.endpoint(), listener.method_map(), reuse_port);
+        }
+      }
+    }
+
+    for(auto& reactor : reactors_)
+    {
+      std::list<listener_t>& watched =
+        reactor->id() == 0 || shards_.empty() ?
+          listeners : shards_[reactor->id() - 1];
+      threads_.emplace_back(
+        [this, &reactor = *reactor, &watched]
+        { this->run_reactor(reactor, watched); });
+    }
+  }
+
+  reactor_pool_t(reactor_pool_t const&) = delete;
+  reactor_pool_t& operator=(reactor_pool_t const&) = delete;
+
+  /*
+   * This function is thread-safe.
+   */
+  bool stopping() const
+  {
+    return stopping_.load(std::memory_order_acquire);
+  }
+
+  /*
+   * This function is thread-safe.
+   */
+  bool steal_ready_client(reactor_t const& thief, std::list<client_t>& target)
+  {
+    std::size_t n_reactors = reactors_.size();
+    for(std::size_t i = 1; i < n_reactors; ++i)
+    {
+      reactor_t& victim = *reactors_[(thief.id() + i) % n_reactors];
+      if(victim.take_ready_client(target))
+      {
+        if(auto msg = context_.message_at(loglevel_t::debug))
+        {
+          *msg << "reactor " << thief.id() <<
+            " stole connection " << target.back().nb_inbuf() <<
+            " from reactor " << victim.id();
+        }
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /*
+   * Wakes up an idle reactor other than busy, if there is one.  This
+   * function is thread-safe.
+   */
+  void wake_idle_reactor(reactor_t const& busy)
+  {
+    std::size_t n_reactors = reactors_.size();
+    for(std::size_t i = 1; i < n_reactors; ++i)
+    {
+      reactor_t& candidate = *reactors_[(busy.id() + i) % n_reactors];
+      if(candidate.idle())
+      {
+        candidate.wake_up();
+        return;
+      }
+    }
+  }
+
+  /*
+   * This function is thread-safe.
+   */
+  void stop()
+  {
+    stopping_.store(true, std::memory_order_release);
+    for(auto& reactor : reactors_)
+    {
+      reactor->wake_up();
+    }
+  }
+
+  ~reactor_pool_t()
+  {
+    this->stop();
+    threads_.clear();
+  }
+
+private :
+  void run_reactor(reactor_t& reactor, std::list<listener_t>& listeners)
+  {
+    try
+    {
+      reactor.run(listeners);
+    }
+    catch(std::exception const& ex)
+    {
+      if(auto msg = context_.message_at(loglevel_t::error))
+      {
+        *msg << "FATAL: exception in reactor " << reactor.id() << ": " <<
+          ex.what();
+      }
+      std::abort();
+    }
+    catch(...)
+    {
+      if(auto msg = context_.message_at(loglevel_t::error))
+      {
+        *msg << "FATAL: exception of unknown type in reactor " <<
+          reactor.id();
+      }
+      std::abort();
+    }
+  }
+
+private :
+  logging_context_t const& context_;
+
+  static_assert(std::atomic<bool>::is_always_lock_free);
+  std::atomic<bool> stopping_;
+
+  std::vector<std::unique_ptr<reactor_t>> reactors_;
+  std::vector<std::list<listener_t>> shards_;
+
+  // joined before the reactors are destroyed
+  std::list<scoped_thread_t> threads_;
+};
+
+bool reactor_t::stopping() const
+{
+  return pool_.stopping();
+}
+
+bool reactor_t::steal_ready_client(std::list<client_t>& target)
+{
+  return pool_.steal_ready_client(*this, target);
+}
+
+void reactor_t::offer_ready_client()
+{
+  pool_.wake_idle_reactor(*this);
+}
+
 } // anonymous
 
 struct dispatcher_t::impl_t
@@ -969,6 +1636,27 @@ struct dispatcher_t::impl_t
   }
   
   void run()
+  {
+    if(config_.reactor_threads_ == 0)
+    {
+      this->run_thread_pool();
+    }
+    else
+    {
+      this->run_reactors();
+    }
+  }
+  
+  /*
+   * This function is signal- and thread-safe.
+   */
+  void stop(int sig)
+  {
+    signal_writer_->write(static_cast<unsigned char>(sig));
+  }
+  
+private :
+  void run_thread_pool()
   {
     thread_pool_t thread_pool(
       context_, sockets_, config_.max_concurrent_requests_);
@@ -1010,16 +1698,35 @@ struct dispatcher_t::impl_t
       *msg << "dispatcher stopped";
     }
   }
-  
-  /*
-   * This function is signal- and thread-safe.
-   */
-  void stop(int sig)
+
+  void run_reactors()
   {
-    signal_writer_->write(static_cast<unsigned char>(sig));
+    {
+      reactor_pool_t reactor_pool(
+        context_, sockets_, config_, core_.listeners());
+
+      if(auto msg = context_.message_at(loglevel_t::info))
+      {
+        *msg << "dispatcher running (" << config_.reactor_threads_ <<
+          " reactor(s))";
+      }
+
+      std::optional<int> sig = signal_reader_->read();
+      assert(sig.has_value());
+      if(auto msg = context_.message_at(loglevel_t::info))
+      {
+        *msg << "caught signal " << *sig << ", stopping dispatcher";
+      }
+
+      reactor_pool.stop();
+    }
+
+    if(auto msg = context_.message_at(loglevel_t::info))
+    {
+      *msg << "dispatcher stopped";
+    }
   }
-  
-private :
+
   void serve(pooled_thread_t& current_thread)
   {
     if(auto msg = context_.message_at(loglevel_t::info))
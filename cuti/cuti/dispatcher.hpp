@@ -22,6 +22,7 @@
 
 #include "chrono_types.hpp"
 #include "endpoint.hpp"
+#include "flag.hpp"
 #include "linkage.h"
 #include "nb_inbuf.hpp"
 #include "selector_factory.hpp"
@@ -45,6 +46,9 @@ struct CUTI_ABI dispatcher_config_t
   static std::size_t constexpr default_bufsize()
   { return nb_inbuf_t::default_bufsize; }
 
+  static std::size_t constexpr default_max_bufsize()
+  { return 256 * 1024; }
+
   static throughput_settings_t constexpr
   default_throughput_settings()
   { return throughput_settings_t(); }
@@ -55,19 +59,72 @@ struct CUTI_ABI dispatcher_config_t
   static std::size_t constexpr default_max_connections()
   { return 128; }
 
+  static std::size_t constexpr default_reactor_threads()
+  { return 0; }
+
+  static flag_t constexpr default_shard_listeners()
+  { return false; }
+
+  static flag_t constexpr default_zerocopy()
+  { return false; }
+
   dispatcher_config_t()
   : selector_factory_(default_selector_factory())
   , bufsize_(default_bufsize())
+  , max_bufsize_(default_max_bufsize())
   , throughput_settings_(default_throughput_settings())
   , max_concurrent_requests_(default_max_concurrent_requests())
   , max_connections_(default_max_connections())
+  , reactor_threads_(default_reactor_threads())
+  , shard_listeners_(default_shard_listeners())
+  , zerocopy_(default_zerocopy())
   { }
 
   selector_factory_t selector_factory_;
   std::size_t bufsize_;
+
+  /*
+   * The upper limit for a connection's buffers, which start out at
+   * bufsize_ and grow while they keep filling up.  A connection keeps
+   * its grown buffers until it is closed, so this bounds the memory
+   * held by idle connections.
+   */
+  std::size_t max_bufsize_;
+
   throughput_settings_t throughput_settings_;
   std::size_t max_concurrent_requests_; // 0: no limit
   std::size_t max_connections_; // 0: no limit
+
+  /*
+   * 0: a pool of threads takes turns waiting for the next request,
+   * and each request is handled on a thread of its own.
+   *
+   * Otherwise: this many reactor threads each accept connections and
+   * handle any number of requests from these connections
+   * concurrently; idle reactors steal pending requests from busy
+   * ones.  Request handlers must not block in this mode.  The request
+   * and connection limits are divided over the reactors.
+   */
+  std::size_t reactor_threads_;
+
+  /*
+   * With multiple reactor threads, give each reactor an SO_REUSEPORT
+   * acceptor of its own for every listener endpoint, so the kernel
+   * spreads new connections over the reactors instead of all
+   * reactors racing for a single accept queue.  Has no effect
+   * without reactor threads, or on unix domain socket endpoints.
+   * Off by default: with SO_REUSEPORT, a second process binding the
+   * same port succeeds and silently takes part of the connections.
+   */
+  flag_t shard_listeners_;
+
+  /*
+   * Send large raw blobs without copying them, if the platform
+   * supports it.  This saves CPU time when sending large samples,
+   * but the kernel has to pin their memory until the client has
+   * acknowledged them.
+   */
+  flag_t zerocopy_;
 };
 
 struct CUTI_ABI dispatcher_t
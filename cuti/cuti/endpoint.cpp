@@ -26,6 +26,9 @@
 #include <algorithm>
 #include <array>
 #include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <exception>
 #include <ostream>
 #include <utility>
 
@@ -34,6 +37,7 @@
 #include <ws2tcpip.h>
 #else
 #include <sys/socket.h>
+#include <sys/un.h>
 #include <netinet/in.h>
 #include <netdb.h>
 #endif
@@ -44,10 +48,10 @@ namespace cuti
 struct endpoint_t::rep_t
 {
   rep_t(int address_family,
-        std::string ip_address,
+        std::string address,
         unsigned int port)
   : address_family_(address_family)
-  , ip_address_(std::move(ip_address))
+  , address_(std::move(address))
   , port_(port)
   { }
 
@@ -57,8 +61,9 @@ struct endpoint_t::rep_t
   int address_family() const
   { return address_family_; }
 
-  std::string const& ip_address() const
-  { return ip_address_; }
+  // The IP address, or the path for a unix domain socket
+  std::string const& address() const
+  { return address_; }
 
   unsigned int port() const
   { return port_; }
@@ -71,7 +76,7 @@ struct endpoint_t::rep_t
     return
       this->port() == that.port() &&
       this->address_family() == that.address_family() &&
-      this->ip_address() == that.ip_address();
+      this->address() == that.address();
   }
 
   std::strong_ordering operator<=>(rep_t const& that) const noexcept
@@ -81,7 +86,7 @@ struct endpoint_t::rep_t
       return cmp;
     }
   
-    if(auto cmp = this->ip_address() <=> that.ip_address(); cmp != 0)
+    if(auto cmp = this->address() <=> that.address(); cmp != 0)
     {
       return cmp;
     }
@@ -93,7 +98,7 @@ struct endpoint_t::rep_t
 
 private :
   int address_family_;
-  std::string ip_address_;
+  std::string address_;
   unsigned int port_;
 };
   
@@ -177,6 +182,42 @@ private :
   sockaddr_in6 addr_;
 };
 
+#ifndef _WIN32
+
+std::string get_unix_path(sockaddr_un const& addr, std::size_t addr_size)
+{
+  std::size_t const path_offset = offsetof(sockaddr_un, sun_path);
+  assert(addr_size >= path_offset);
+  assert(addr_size <= sizeof addr);
+
+  // The path's terminating null character is optional; an unnamed
+  // socket has an empty path.
+  char const* first = addr.sun_path;
+  char const* last = first + (addr_size - path_offset);
+  return std::string(first, std::find(first, last, '\0'));
+}
+
+struct unix_rep_t : endpoint_t::rep_t
+{
+  unix_rep_t(sockaddr_un const& addr, std::size_t addr_size)
+  : endpoint_t::rep_t(AF_UNIX, get_unix_path(addr, addr_size), 0)
+  , addr_(addr)
+  , addr_size_(static_cast<unsigned int>(addr_size))
+  { }
+
+  sockaddr const& socket_address() const override
+  { return *reinterpret_cast<sockaddr const*>(&addr_); }
+
+  unsigned int socket_address_size() const override
+  { return addr_size_; }
+
+private :
+  sockaddr_un addr_;
+  unsigned int addr_size_;
+};
+
+#endif // !_WIN32
+
 std::shared_ptr<endpoint_t::rep_t const>
 make_rep(socket_layer_t& sockets, sockaddr const& addr, std::size_t addr_size)
 {
@@ -208,6 +249,25 @@ make_rep(socket_layer_t& sockets, sockaddr const& addr, std::size_t addr_size)
     result = std::make_shared<ipv6_rep_t const>(sockets,
       *reinterpret_cast<sockaddr_in6 const*>(&addr));
     break;
+#ifndef _WIN32
+  case AF_UNIX:
+    if(addr_size < offsetof(sockaddr_un, sun_path) ||
+       addr_size > sizeof(sockaddr_un))
+    {
+      system_exception_builder_t builder;
+      builder << "Bad sockaddr size " << addr_size <<
+        " for address family AF_UNIX (at most " << sizeof(sockaddr_un) <<
+        " expected)";
+      builder.explode();
+    }
+    {
+      sockaddr_un addr_un;
+      std::memset(&addr_un, '\0', sizeof addr_un);
+      std::memcpy(&addr_un, &addr, addr_size);
+      result = std::make_shared<unix_rep_t const>(addr_un, addr_size);
+    }
+    break;
+#endif
   default:
     {
       system_exception_builder_t builder;
@@ -243,15 +303,27 @@ unsigned int endpoint_t::socket_address_size() const
   return rep_->socket_address_size();
 }
 
-std::string const& endpoint_t::ip_address() const
+bool endpoint_t::is_unix() const
 {
   assert(!empty());
-  return rep_->ip_address();
+  return rep_->address_family() == AF_UNIX;
+}
+
+std::string const& endpoint_t::unix_path() const
+{
+  assert(is_unix());
+  return rep_->address();
+}
+
+std::string const& endpoint_t::ip_address() const
+{
+  assert(!is_unix());
+  return rep_->address();
 }
 
 unsigned int endpoint_t::port() const
 {
-  assert(!empty());
+  assert(!is_unix());
   return rep_->port();
 }
 
@@ -300,6 +372,18 @@ void endpoint_t::print(std::ostream& os) const
   {
     os << "<EMPTY ENDPOINT>";
   }
+  else if(this->is_unix())
+  {
+    os << "unix:";
+    if(this->unix_path().empty())
+    {
+      os << "<UNNAMED>";
+    }
+    else
+    {
+      os << this->unix_path();
+    }
+  }
   else
   {
     os << this->port() << '@' << this->ip_address();
@@ -310,6 +394,26 @@ void parse_endpoint(socket_layer_t& sockets,
   char const* name, args_reader_t const& reader,
   char const* in, endpoint_t& out)
 {
+  static char constexpr unix_prefix[] = "unix:";
+  std::size_t constexpr unix_prefix_size = sizeof unix_prefix - 1;
+  if(std::strncmp(in, unix_prefix, unix_prefix_size) == 0)
+  {
+    in += unix_prefix_size;
+    try
+    {
+      out = resolve_unix(sockets, in);
+    }
+    catch(std::exception const& ex)
+    {
+      system_exception_builder_t builder;
+      builder << reader.current_origin() <<
+        ": bad unix domain socket path '" << in <<
+        "' for option '" << name << "': " << ex.what();
+      builder.explode();
+    }
+    return;
+  }
+
   unsigned int port = 0;
   do
   {
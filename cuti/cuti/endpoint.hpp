@@ -55,6 +55,16 @@ struct CUTI_ABI endpoint_t
   int address_family() const;
   sockaddr const& socket_address() const;
   unsigned int socket_address_size() const;
+
+  /*
+   * Tells if this is a unix domain socket endpoint.  Unix domain
+   * endpoints have a unix_path() instead of an ip_address() and a
+   * port(); the path is empty for an unnamed socket, such as the
+   * client side of a unix domain connection.
+   */
+  bool is_unix() const;
+  std::string const& unix_path() const;
+
   std::string const& ip_address() const;
   unsigned int port() const;
 
@@ -82,6 +92,10 @@ private :
   std::shared_ptr<rep_t const> rep_;
 };
 
+/*
+ * Parses an endpoint option value: either <port>@<ip>, or
+ * unix:<path> for a unix domain socket.
+ */
 CUTI_ABI void parse_endpoint(socket_layer_t& sockets,
   char const* name, args_reader_t const& reader,
   char const* in, endpoint_t& out);
@@ -26,7 +26,10 @@
 #include "system_error.hpp"
 
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <limits>
+#include <vector>
 
 #include <errno.h>
 #include <poll.h>
@@ -39,6 +42,29 @@ namespace cuti
 namespace // anonymous
 {
 
+struct epoll_instance_t
+{
+  epoll_instance_t()
+  : fd_(::epoll_create1(EPOLL_CLOEXEC))
+  {
+    if(fd_ == -1)
+    {
+      int cause = last_system_error();
+      system_exception_builder_t builder;
+      builder << "error creating epoll instance: " << error_status_t(cause);
+      builder.explode();
+    }
+  }
+
+  epoll_instance_t(epoll_instance_t const&) = delete;
+  epoll_instance_t& operator=(epoll_instance_t const&) = delete;
+
+  ~epoll_instance_t()
+  { ::close(fd_); }
+
+  int const fd_;
+};
+
 struct epoll_selector_t : selector_t
 {
   epoll_selector_t()
@@ -139,29 +165,6 @@ private :
     callback_t callback_;
   };
 
-  struct epoll_instance_t
-  {
-    epoll_instance_t()
-    : fd_(::epoll_create1(EPOLL_CLOEXEC))
-    {
-      if(fd_ == -1)
-      {
-        int cause = last_system_error();
-        system_exception_builder_t builder;
-        builder << "error creating epoll instance: " << error_status_t(cause);
-        builder.explode();
-      }
-    }
-
-    epoll_instance_t(epoll_instance_t const&) = delete;
-    epoll_instance_t& operator=(epoll_instance_t const&) = delete;
-
-    ~epoll_instance_t()
-    { ::close(fd_); }
-
-    int const fd_;
-  };
-
   int make_ticket(int fd, event_t event, callback_t callback)
   {
     assert(fd != -1);
@@ -270,6 +273,319 @@ private :
   epoll_instance_t readable_instance_;
 };
     
+/*
+ * Single-instance epoll selector that keeps each fd registered until
+ * it is no longer watched in either direction.  Registrations use
+ * EPOLLONESHOT: after an event is reported, the fd is re-armed with
+ * EPOLL_CTL_MOD when a new callback is requested, which takes one
+ * system call instead of the EPOLL_CTL_ADD/EPOLL_CTL_DEL pair used by
+ * epoll_selector_t.  There is no separate poll() either: the epoll
+ * instance is waited on directly.
+ */
+struct oneshot_epoll_selector_t : selector_t
+{
+  oneshot_epoll_selector_t()
+  : selector_t()
+  , registrations_()
+  , watched_list_(registrations_.add_list())
+  , pending_list_(registrations_.add_list())
+  , fd_states_()
+  , instance_()
+  { }
+
+  int call_when_writable(int fd, callback_t callback) override
+  {
+    return make_ticket(fd, event_t::writable, std::move(callback));
+  }
+
+  void cancel_when_writable(int ticket) noexcept override
+  {
+    cancel_ticket(ticket);
+  }
+
+  int call_when_readable(int fd, callback_t callback) override
+  {
+    return make_ticket(fd, event_t::readable, std::move(callback));
+  }
+
+  void cancel_when_readable(int ticket) noexcept override
+  {
+    cancel_ticket(ticket);
+  }
+
+  bool has_work() const noexcept override
+  {
+    return !registrations_.list_empty(watched_list_) ||
+           !registrations_.list_empty(pending_list_);
+  }
+
+  callback_t select(duration_t timeout) override
+  {
+    assert(this->has_work());
+
+    if(registrations_.list_empty(pending_list_))
+    {
+      struct epoll_event epoll_events[16];
+      int count = ::epoll_wait(
+        instance_.fd_, epoll_events, 16, timeout_millis(timeout));
+      if(count < 0)
+      {
+        int cause = last_system_error();
+        if(cause != EINTR)
+        {
+          system_exception_builder_t builder;
+          builder << "oneshot_epoll_selector: epoll_wait() failure: " <<
+            error_status_t(cause);
+          builder.explode();
+        }
+        count = 0;
+      }
+
+      for(struct epoll_event const* epoll_event = epoll_events;
+          epoll_event != epoll_events + count;
+          ++epoll_event)
+      {
+        on_epoll_event(epoll_event->data.fd, epoll_event->events);
+      }
+    }
+
+    callback_t result = nullptr;
+    if(!registrations_.list_empty(pending_list_))
+    {
+      int ticket = registrations_.first(pending_list_);
+      result = std::move(registrations_.value(ticket).callback_);
+      registrations_.remove_element(ticket);
+    }
+    return result;
+  }
+
+private :
+  struct registration_t
+  {
+    registration_t(int fd, callback_t callback)
+    : fd_(fd)
+    , callback_(std::move(callback))
+    { }
+
+    int fd_; // -1 when no longer watched
+    callback_t callback_;
+  };
+
+  struct fd_state_t
+  {
+    fd_state_t()
+    : writable_ticket_(-1)
+    , readable_ticket_(-1)
+    , registered_(false)
+    , armed_events_(0)
+    { }
+
+    std::uint32_t wanted_events() const noexcept
+    {
+      std::uint32_t result = 0;
+      if(writable_ticket_ != -1)
+      {
+        result |= EPOLLOUT;
+      }
+      if(readable_ticket_ != -1)
+      {
+        result |= EPOLLIN;
+      }
+      return result;
+    }
+
+    int writable_ticket_;
+    int readable_ticket_;
+    bool registered_;
+    std::uint32_t armed_events_;
+  };
+
+  int make_ticket(int fd, event_t event, callback_t callback)
+  {
+    assert(fd != -1);
+    assert(callback != nullptr);
+
+    if(static_cast<std::size_t>(fd) >= fd_states_.size())
+    {
+      fd_states_.resize(fd + 1);
+    }
+    fd_state_t& state = fd_states_[fd];
+
+    int* slot = nullptr;
+    switch(event)
+    {
+    case event_t::writable :
+      slot = &state.writable_ticket_;
+      break;
+    case event_t::readable :
+      slot = &state.readable_ticket_;
+      break;
+    default :
+      assert(!"expected event type");
+      break;
+    }
+
+    if(*slot != -1)
+    {
+      system_exception_builder_t builder;
+      builder << "error adding epoll event: " << error_status_t(EEXIST);
+      builder.explode();
+    }
+
+    // Obtain a ticket, guarding it for exceptions
+    int ticket = registrations_.add_element_before(
+      registrations_.last(watched_list_), fd, std::move(callback));
+    auto ticket_guard = make_scoped_guard([&]
+      {
+        *slot = -1;
+        registrations_.remove_element(ticket);
+      });
+
+    *slot = ticket;
+    arm(fd, state);
+
+    ticket_guard.dismiss();
+    return ticket;
+  }
+
+  /*
+   * (Re-)arms the registration for fd if it does not already cover
+   * all wanted events.
+   */
+  void arm(int fd, fd_state_t& state)
+  {
+    std::uint32_t wanted = state.wanted_events();
+    if((wanted & ~state.armed_events_) == 0)
+    {
+      return;
+    }
+
+    struct epoll_event epoll_event;
+    epoll_event.events = wanted | EPOLLONESHOT;
+    epoll_event.data.u64 = 0;
+    epoll_event.data.fd = fd;
+
+    /*
+     * The kernel silently drops the registration when fd is closed,
+     * and fd may since have been reused for something else: fall back
+     * from EPOLL_CTL_MOD to EPOLL_CTL_ADD (and vice versa) as needed.
+     */
+    int op = state.registered_ ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+    int r = ::epoll_ctl(instance_.fd_, op, fd, &epoll_event);
+    if(r == -1)
+    {
+      int cause = last_system_error();
+      if(op == EPOLL_CTL_MOD && cause == ENOENT)
+      {
+        op = EPOLL_CTL_ADD;
+        r = ::epoll_ctl(instance_.fd_, op, fd, &epoll_event);
+      }
+      else if(op == EPOLL_CTL_ADD && cause == EEXIST)
+      {
+        op = EPOLL_CTL_MOD;
+        r = ::epoll_ctl(instance_.fd_, op, fd, &epoll_event);
+      }
+    }
+
+    if(r == -1)
+    {
+      int cause = last_system_error();
+      state.registered_ = false;
+      state.armed_events_ = 0;
+
+      system_exception_builder_t builder;
+      builder << "error arming epoll event: " << error_status_t(cause);
+      builder.explode();
+    }
+
+    state.registered_ = true;
+    state.armed_events_ = wanted;
+  }
+
+  void on_epoll_event(int fd, std::uint32_t events)
+  {
+    assert(fd >= 0);
+    assert(static_cast<std::size_t>(fd) < fd_states_.size());
+
+    fd_state_t& state = fd_states_[fd];
+
+    // EPOLLONESHOT: the registration is now disarmed
+    state.armed_events_ = 0;
+
+    if(state.writable_ticket_ != -1 &&
+       (events & (EPOLLOUT | EPOLLERR | EPOLLHUP)) != 0)
+    {
+      make_pending(state.writable_ticket_);
+    }
+
+    if(state.readable_ticket_ != -1 &&
+       (events & (EPOLLIN | EPOLLERR | EPOLLHUP)) != 0)
+    {
+      make_pending(state.readable_ticket_);
+    }
+
+    // Keep watching for the event(s) that did not occur
+    arm(fd, state);
+  }
+
+  void make_pending(int& slot) noexcept
+  {
+    int ticket = slot;
+    slot = -1;
+
+    registrations_.value(ticket).fd_ = -1;
+    registrations_.move_element_before(
+      registrations_.last(pending_list_), ticket);
+  }
+
+  void cancel_ticket(int ticket) noexcept
+  {
+    assert(ticket >= 0);
+    assert(ticket <= std::numeric_limits<int>::max());
+
+    auto& registration = registrations_.value(ticket);
+    if(int fd = registration.fd_; fd != -1)
+    {
+      assert(static_cast<std::size_t>(fd) < fd_states_.size());
+      fd_state_t& state = fd_states_[fd];
+
+      if(state.writable_ticket_ == ticket)
+      {
+        state.writable_ticket_ = -1;
+      }
+      else
+      {
+        assert(state.readable_ticket_ == ticket);
+        state.readable_ticket_ = -1;
+      }
+
+      /*
+       * A stale armed event for the other direction is harmless, but
+       * a fully unwatched fd may be closed and reused without us
+       * knowing, so we must not leave it armed.
+       */
+      if(state.wanted_events() == 0 && state.armed_events_ != 0)
+      {
+        if(::epoll_ctl(instance_.fd_, EPOLL_CTL_DEL, fd, nullptr) == -1)
+        {
+          assert(!"success deleting epoll event");
+        }
+        state.registered_ = false;
+        state.armed_events_ = 0;
+      }
+    }
+
+    registrations_.remove_element(ticket);
+  }
+
+private :
+  list_arena_t<registration_t> registrations_;
+  int const watched_list_;
+  int const pending_list_;
+  std::vector<fd_state_t> fd_states_;
+  epoll_instance_t instance_;
+};
+
 } // anonymous
 
 std::unique_ptr<selector_t> create_epoll_selector()
@@ -277,6 +593,11 @@ std::unique_ptr<selector_t> create_epoll_selector()
   return std::make_unique<epoll_selector_t>();
 }
 
+std::unique_ptr<selector_t> create_oneshot_epoll_selector()
+{
+  return std::make_unique<oneshot_epoll_selector_t>();
+}
+
 } // cuti
 
 #endif // CUTI_HAS_EPOLL_SELECTOR
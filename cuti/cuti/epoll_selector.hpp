@@ -39,6 +39,13 @@ namespace cuti
 CUTI_ABI
 std::unique_ptr<selector_t> create_epoll_selector();
 
+/*
+ * Creates an epoll selector that keeps fds registered with
+ * EPOLLONESHOT between callbacks, re-arming them with EPOLL_CTL_MOD.
+ */
+CUTI_ABI
+std::unique_ptr<selector_t> create_oneshot_epoll_selector();
+
 } // cuti
 
 #endif // CUTI_HAS_EPOLL_SELECTOR
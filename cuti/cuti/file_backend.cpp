@@ -63,13 +63,13 @@ void do_rotate(std::string const& name, unsigned int level, unsigned int depth)
   }
 }
 
-void rotate(std::string const& name, unsigned int depth)
+} // anonymous
+
+void rotate_logfiles(std::string const& path, unsigned int rotation_depth)
 {
-  do_rotate(name, 0, depth);
+  do_rotate(path, 0, rotation_depth);
 }
 
-} // anonymous
-
 file_backend_t::file_backend_t(absolute_path_t path,
                                unsigned int size_limit,
                                unsigned int rotation_depth)
@@ -108,7 +108,7 @@ file_backend_t::open_log_handle()
     }
 
     result.reset();
-    rotate(path_.value(), rotation_depth_);
+    rotate_logfiles(path_.value(), rotation_depth_);
     rotate_reported_ = false;
 
     result = create_logfile(path_.value());
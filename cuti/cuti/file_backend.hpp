@@ -64,6 +64,13 @@ private :
   bool rotate_reported_;
 };
 
+/*
+ * Renames <path> to <path>.1, <path>.1 to <path>.2, etc., deleting
+ * any old log file beyond rotation_depth.
+ */
+CUTI_ABI
+void rotate_logfiles(std::string const& path, unsigned int rotation_depth);
+
 } // namespace cuti
 
 #endif
@@ -38,6 +38,7 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <sys/uio.h>
 #include <stdio.h>
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -328,6 +329,48 @@ struct text_output_file_impl_t : text_output_file_t
     }
   }
 
+  void write_gathered(char const* first1, char const* last1,
+                      char const* first2, char const* last2) override
+  {
+    if(first1 == last1)
+    {
+      first1 = first2;
+      last1 = last2;
+      first2 = last2;
+    }
+
+    while(first1 != last1)
+    {
+      iovec iov[2];
+      iov[0].iov_base = const_cast<char*>(first1);
+      iov[0].iov_len = last1 - first1;
+      iov[1].iov_base = const_cast<char*>(first2);
+      iov[1].iov_len = last2 - first2;
+
+      auto result = ::writev(fd_, iov, first2 != last2 ? 2 : 1);
+      if(result == -1)
+      {
+        int cause = last_system_error();
+        system_exception_builder_t builder;
+        builder <<  "Error writing to file " << path_ << ": " <<
+          error_status_t(cause);
+        builder.explode();
+      }
+
+      if(static_cast<std::size_t>(result) < iov[0].iov_len)
+      {
+        first1 += result;
+      }
+      else
+      {
+        first2 += result - iov[0].iov_len;
+        first1 = first2;
+        last1 = last2;
+        first2 = last2;
+      }
+    }
+  }
+
   ~text_output_file_impl_t() override
   {
     ::close(fd_);
@@ -503,6 +546,13 @@ void change_directory(char const* path)
 text_output_file_t::text_output_file_t()
 { }
 
+void text_output_file_t::write_gathered(char const* first1, char const* last1,
+                                        char const* first2, char const* last2)
+{
+  this->write(first1, last1);
+  this->write(first2, last2);
+}
+
 text_output_file_t::~text_output_file_t()
 { }
 
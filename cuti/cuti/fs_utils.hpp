@@ -42,6 +42,13 @@ struct CUTI_ABI text_output_file_t
   virtual std::size_t size() const noexcept = 0;
   virtual void write(char const* first, char const* last) = 0;
 
+  /*
+   * Writes [first1, last1> followed by [first2, last2>; an
+   * implementation may do so in a single system call.
+   */
+  virtual void write_gathered(char const* first1, char const* last1,
+                              char const* first2, char const* last2);
+
   virtual ~text_output_file_t();
 };
 
@@ -121,15 +121,16 @@ void test_failing_read(logging_context_t const& context,
 }
 
 template<typename T, typename Eq>
-void test_roundtrip(logging_context_t const& context,
-                    std::size_t bufsize,
-                    T value,
-                    Eq eq)
+void do_test_roundtrip(logging_context_t const& context,
+                       std::size_t bufsize,
+                       T value,
+                       Eq eq,
+                       bool raw_blobs)
 {
   if(auto msg = context.message_at(loglevel_t::info))
   {
     *msg << __func__ << '<' << typeid(T).name() <<
-      ">: starting; bufsize: " << bufsize;
+      ">: starting; bufsize: " << bufsize << " raw_blobs: " << raw_blobs;
   }
 
   socket_layer_t sockets;
@@ -137,6 +138,10 @@ void test_roundtrip(logging_context_t const& context,
 
   std::string serialized_form;
   auto outbuf = make_nb_string_outbuf(serialized_form, bufsize);
+  if(raw_blobs)
+  {
+    outbuf->enable_raw_blobs();
+  }
   bound_outbuf_t bot(*outbuf, scheduler);
 
   stack_marker_t base_marker;
@@ -249,12 +254,34 @@ void test_roundtrip(logging_context_t const& context,
   }
 }
 
+template<typename T, typename Eq>
+void test_roundtrip(logging_context_t const& context,
+                    std::size_t bufsize,
+                    T value,
+                    Eq eq)
+{
+  do_test_roundtrip(context, bufsize, std::move(value), eq, false);
+}
+
 template<typename T>
 void test_roundtrip(logging_context_t const& context,
                     std::size_t bufsize,
                     T value)
 {
-  test_roundtrip(context, bufsize, value, std::equal_to<T>{});
+  test_roundtrip(context, bufsize, std::move(value), std::equal_to<T>{});
+}
+
+/*
+ * Like test_roundtrip(), but with raw blobs enabled on the writing
+ * side.
+ */
+template<typename T>
+void test_raw_blobs_roundtrip(logging_context_t const& context,
+                              std::size_t bufsize,
+                              T value)
+{
+  do_test_roundtrip(
+    context, bufsize, std::move(value), std::equal_to<T>{}, true);
 }
 
 } // anonymous
@@ -0,0 +1,587 @@
+/*
+ * Copyright (C) 2026 CodeShop B.V.
+ *
+ * This file is part of the cuti library.
+ *
+ * The cuti library is free software: you can redistribute it and/or
+ * modify it under the terms of version 2.1 of the GNU Lesser General
+ * Public License as published by the Free Software Foundation.
+ *
+ * The cuti library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See version
+ * 2.1 of the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of version 2.1 of the GNU Lesser
+ * General Public License along with the cuti library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "io_uring_selector.hpp"
+
+#if CUTI_HAS_IO_URING_SELECTOR
+
+#include "epoll_selector.hpp"
+#include "list_arena.hpp"
+#include "scoped_guard.hpp"
+#include "system_error.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <errno.h>
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace cuti
+{
+
+namespace // anonymous
+{
+
+unsigned int constexpr ring_entries = 256;
+
+std::uint32_t constexpr required_features =
+  IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG;
+
+// user_data for operations whose completions we are not interested in
+std::uint64_t constexpr ignored_user_data = 0;
+
+int io_uring_setup(unsigned int entries, io_uring_params* params)
+{
+  return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+int io_uring_enter(int fd, unsigned int to_submit,
+                   unsigned int min_complete, unsigned int flags,
+                   void const* arg, std::size_t argsz)
+{
+  return static_cast<int>(::syscall(__NR_io_uring_enter,
+    fd, to_submit, min_complete, flags, arg, argsz));
+}
+
+std::uint32_t load_acquire(std::uint32_t const* p) noexcept
+{
+  return std::atomic_ref<std::uint32_t const>(*p).load(
+    std::memory_order_acquire);
+}
+
+void store_release(std::uint32_t* p, std::uint32_t value) noexcept
+{
+  std::atomic_ref<std::uint32_t>(*p).store(value, std::memory_order_release);
+}
+
+struct mapping_t
+{
+  mapping_t()
+  : addr_(MAP_FAILED)
+  , size_(0)
+  { }
+
+  mapping_t(mapping_t const&) = delete;
+  mapping_t& operator=(mapping_t const&) = delete;
+
+  void map(int fd, std::size_t size, off_t offset)
+  {
+    assert(addr_ == MAP_FAILED);
+
+    void* addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_POPULATE, fd, offset);
+    if(addr == MAP_FAILED)
+    {
+      int cause = last_system_error();
+      system_exception_builder_t builder;
+      builder << "error mapping io_uring: " << error_status_t(cause);
+      builder.explode();
+    }
+
+    addr_ = addr;
+    size_ = size;
+  }
+
+  char* get() const noexcept
+  {
+    assert(addr_ != MAP_FAILED);
+    return static_cast<char*>(addr_);
+  }
+
+  ~mapping_t()
+  {
+    if(addr_ != MAP_FAILED)
+    {
+      ::munmap(addr_, size_);
+    }
+  }
+
+private :
+  void* addr_;
+  std::size_t size_;
+};
+
+/*
+ * Owns an io_uring instance and its shared memory mappings.
+ */
+struct ring_t
+{
+  ring_t()
+  : params_()
+  , fd_(-1)
+  , sq_ring_()
+  , cq_ring_()
+  , sqes_()
+  , sq_head_(nullptr)
+  , sq_tail_(nullptr)
+  , sq_mask_(0)
+  , sq_entries_(0)
+  , sq_array_(nullptr)
+  , cq_head_(nullptr)
+  , cq_tail_(nullptr)
+  , cq_mask_(0)
+  , cqes_(nullptr)
+  , sqe_array_(nullptr)
+  , local_sq_tail_(0)
+  {
+    std::memset(&params_, 0, sizeof params_);
+    fd_ = io_uring_setup(ring_entries, &params_);
+    if(fd_ == -1)
+    {
+      int cause = last_system_error();
+      system_exception_builder_t builder;
+      builder << "error creating io_uring instance: " <<
+        error_status_t(cause);
+      builder.explode();
+    }
+    auto fd_guard = make_scoped_guard([&] { ::close(fd_); });
+
+    if((params_.features & required_features) != required_features)
+    {
+      system_exception_builder_t builder;
+      builder << "io_uring instance lacks required features";
+      builder.explode();
+    }
+
+    std::size_t sq_ring_size = params_.sq_off.array +
+      params_.sq_entries * sizeof(std::uint32_t);
+    std::size_t cq_ring_size = params_.cq_off.cqes +
+      params_.cq_entries * sizeof(io_uring_cqe);
+
+    char* sq_ring;
+    char* cq_ring;
+    if((params_.features & IORING_FEAT_SINGLE_MMAP) != 0)
+    {
+      sq_ring_.map(fd_, std::max(sq_ring_size, cq_ring_size),
+        IORING_OFF_SQ_RING);
+      sq_ring = sq_ring_.get();
+      cq_ring = sq_ring;
+    }
+    else
+    {
+      sq_ring_.map(fd_, sq_ring_size, IORING_OFF_SQ_RING);
+      cq_ring_.map(fd_, cq_ring_size, IORING_OFF_CQ_RING);
+      sq_ring = sq_ring_.get();
+      cq_ring = cq_ring_.get();
+    }
+    sqes_.map(fd_, params_.sq_entries * sizeof(io_uring_sqe),
+      IORING_OFF_SQES);
+
+    sq_head_ = reinterpret_cast<std::uint32_t*>(sq_ring + params_.sq_off.head);
+    sq_tail_ = reinterpret_cast<std::uint32_t*>(sq_ring + params_.sq_off.tail);
+    sq_mask_ = *reinterpret_cast<std::uint32_t*>(
+      sq_ring + params_.sq_off.ring_mask);
+    sq_entries_ = *reinterpret_cast<std::uint32_t*>(
+      sq_ring + params_.sq_off.ring_entries);
+    sq_array_ = reinterpret_cast<std::uint32_t*>(
+      sq_ring + params_.sq_off.array);
+
+    cq_head_ = reinterpret_cast<std::uint32_t*>(cq_ring + params_.cq_off.head);
+    cq_tail_ = reinterpret_cast<std::uint32_t*>(cq_ring + params_.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<std::uint32_t*>(
+      cq_ring + params_.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe*>(cq_ring + params_.cq_off.cqes);
+
+    sqe_array_ = reinterpret_cast<io_uring_sqe*>(sqes_.get());
+    local_sq_tail_ = *sq_tail_;
+
+    fd_guard.dismiss();
+  }
+
+  ring_t(ring_t const&) = delete;
+  ring_t& operator=(ring_t const&) = delete;
+
+  /*
+   * Returns a zeroed submission queue entry, submitting any queued
+   * entries first if the submission queue is full.  Returns nullptr
+   * if no entry could be obtained.
+   */
+  io_uring_sqe* get_sqe() noexcept
+  {
+    if(unsubmitted() == sq_entries_ &&
+       (submit() == -1 || unsubmitted() == sq_entries_))
+    {
+      return nullptr;
+    }
+
+    std::uint32_t index = local_sq_tail_ & sq_mask_;
+    io_uring_sqe* sqe = &sqe_array_[index];
+    std::memset(sqe, 0, sizeof *sqe);
+
+    sq_array_[index] = index;
+    ++local_sq_tail_;
+
+    return sqe;
+  }
+
+  /*
+   * Hands all queued submission queue entries to the kernel, without
+   * waiting for completions.  Returns -1 on failure, setting errno.
+   */
+  int submit() noexcept
+  {
+    unsigned int to_submit = publish_sqes();
+    if(to_submit == 0)
+    {
+      return 0;
+    }
+    return io_uring_enter(fd_, to_submit, 0, 0, nullptr, 0);
+  }
+
+  /*
+   * Submits any queued entries and waits for at least one completion
+   * for no longer than timeout_millis (see
+   * selector_t::timeout_millis()).  Returns -1 on failure, setting
+   * errno.
+   */
+  int submit_and_wait(int timeout_millis) noexcept
+  {
+    unsigned int to_submit = publish_sqes();
+
+    if(timeout_millis == 0)
+    {
+      return io_uring_enter(
+        fd_, to_submit, 0, IORING_ENTER_GETEVENTS, nullptr, 0);
+    }
+
+    __kernel_timespec ts;
+    ts.tv_sec = timeout_millis / 1000;
+    ts.tv_nsec = (timeout_millis % 1000) * 1000000LL;
+
+    io_uring_getevents_arg arg;
+    std::memset(&arg, 0, sizeof arg);
+    if(timeout_millis > 0)
+    {
+      arg.ts = reinterpret_cast<std::uintptr_t>(&ts);
+    }
+
+    return io_uring_enter(fd_, to_submit, 1,
+      IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof arg);
+  }
+
+  /*
+   * Calls handler(user_data, res) for each available completion.
+   */
+  template<typename Handler>
+  void reap(Handler handler)
+  {
+    std::uint32_t head = *cq_head_;
+    std::uint32_t tail = load_acquire(cq_tail_);
+
+    while(head != tail)
+    {
+      io_uring_cqe const& cqe = cqes_[head & cq_mask_];
+      std::uint64_t user_data = cqe.user_data;
+      std::int32_t res = cqe.res;
+      ++head;
+      store_release(cq_head_, head);
+
+      handler(user_data, res);
+    }
+  }
+
+  ~ring_t()
+  {
+    // closing the ring cancels all outstanding operations
+    ::close(fd_);
+  }
+
+private :
+  unsigned int unsubmitted() const noexcept
+  {
+    return local_sq_tail_ - load_acquire(sq_head_);
+  }
+
+  unsigned int publish_sqes() noexcept
+  {
+    store_release(sq_tail_, local_sq_tail_);
+    return unsubmitted();
+  }
+
+private :
+  io_uring_params params_;
+  int fd_;
+  mapping_t sq_ring_;
+  mapping_t cq_ring_;
+  mapping_t sqes_;
+
+  std::uint32_t* sq_head_;
+  std::uint32_t* sq_tail_;
+  std::uint32_t sq_mask_;
+  std::uint32_t sq_entries_;
+  std::uint32_t* sq_array_;
+
+  std::uint32_t* cq_head_;
+  std::uint32_t* cq_tail_;
+  std::uint32_t cq_mask_;
+  io_uring_cqe* cqes_;
+
+  io_uring_sqe* sqe_array_;
+  std::uint32_t local_sq_tail_;
+};
+
+/*
+ * Readiness selector based on io_uring poll operations.  Poll
+ * requests are queued in the submission ring and handed to the
+ * kernel in a single io_uring_enter() call that also waits for
+ * completions; cancellations are submitted immediately, as the
+ * kernel holds a reference to the file until the poll operation is
+ * gone.
+ */
+struct io_uring_selector_t : selector_t
+{
+  io_uring_selector_t()
+  : selector_t()
+  , callbacks_()
+  , watched_list_(callbacks_.add_list())
+  , pending_list_(callbacks_.add_list())
+  , user_data_()
+  , next_generation_(1)
+  , ring_()
+  { }
+
+  int call_when_writable(int fd, callback_t callback) override
+  {
+    return make_ticket(fd, POLLOUT, std::move(callback));
+  }
+
+  void cancel_when_writable(int ticket) noexcept override
+  {
+    cancel_ticket(ticket);
+  }
+
+  int call_when_readable(int fd, callback_t callback) override
+  {
+    return make_ticket(fd, POLLIN, std::move(callback));
+  }
+
+  void cancel_when_readable(int ticket) noexcept override
+  {
+    cancel_ticket(ticket);
+  }
+
+  bool has_work() const noexcept override
+  {
+    return !callbacks_.list_empty(watched_list_) ||
+           !callbacks_.list_empty(pending_list_);
+  }
+
+  callback_t select(duration_t timeout) override
+  {
+    assert(this->has_work());
+
+    if(callbacks_.list_empty(pending_list_))
+    {
+      if(ring_.submit_and_wait(timeout_millis(timeout)) == -1)
+      {
+        int cause = last_system_error();
+        if(cause != EINTR && cause != ETIME &&
+           cause != EAGAIN && cause != EBUSY)
+        {
+          system_exception_builder_t builder;
+          builder << "io_uring_selector: io_uring_enter() failure: " <<
+            error_status_t(cause);
+          builder.explode();
+        }
+      }
+
+      ring_.reap([this](std::uint64_t user_data, std::int32_t)
+      {
+        this->on_completion(user_data);
+      });
+    }
+
+    callback_t result = nullptr;
+    if(!callbacks_.list_empty(pending_list_))
+    {
+      int ticket = callbacks_.first(pending_list_);
+      result = std::move(callbacks_.value(ticket));
+      callbacks_.remove_element(ticket);
+    }
+    return result;
+  }
+
+private :
+  int make_ticket(int fd, unsigned int events, callback_t callback)
+  {
+    assert(fd != -1);
+    assert(callback != nullptr);
+
+    // Obtain a ticket, guarding it for exceptions
+    int ticket = callbacks_.add_element_before(
+      callbacks_.last(watched_list_), std::move(callback));
+    auto ticket_guard =
+      make_scoped_guard([&] { callbacks_.remove_element(ticket); });
+
+    std::size_t min_size = static_cast<unsigned int>(ticket) + 1;
+    while(user_data_.size() < min_size)
+    {
+      // use push_back(), not resize(), for amortized O(1)
+      user_data_.push_back(ignored_user_data);
+    }
+
+    io_uring_sqe* sqe = ring_.get_sqe();
+    if(sqe == nullptr)
+    {
+      system_exception_builder_t builder;
+      builder << "io_uring_selector: submission queue full";
+      builder.explode();
+    }
+
+    /*
+     * The generation in the upper half of user_data tells the
+     * completion of a canceled request apart from that of a later
+     * request reusing the same ticket.
+     */
+    std::uint64_t user_data = next_generation_ << 32 |
+      static_cast<unsigned int>(ticket);
+    if(++next_generation_ > std::numeric_limits<std::uint32_t>::max())
+    {
+      next_generation_ = 1;
+    }
+
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = fd;
+    sqe->poll32_events = events;
+    sqe->user_data = user_data;
+
+    user_data_[ticket] = user_data;
+
+    ticket_guard.dismiss();
+    return ticket;
+  }
+
+  void on_completion(std::uint64_t user_data) noexcept
+  {
+    if(user_data == ignored_user_data)
+    {
+      return;
+    }
+
+    std::size_t ticket = user_data & 0xffffffffU;
+    if(ticket >= user_data_.size() || user_data_[ticket] != user_data)
+    {
+      // completion for a canceled request
+      return;
+    }
+
+    // Any outcome, including an error, makes the callback eligible
+    user_data_[ticket] = ignored_user_data;
+    callbacks_.move_element_before(
+      callbacks_.last(pending_list_), static_cast<int>(ticket));
+  }
+
+  void cancel_ticket(int ticket) noexcept
+  {
+    assert(ticket >= 0);
+    assert(static_cast<std::size_t>(ticket) < user_data_.size());
+
+    std::uint64_t user_data = user_data_[ticket];
+    if(user_data != ignored_user_data)
+    {
+      user_data_[ticket] = ignored_user_data;
+
+      io_uring_sqe* sqe = ring_.get_sqe();
+      if(sqe != nullptr)
+      {
+        sqe->opcode = IORING_OP_POLL_REMOVE;
+        sqe->fd = -1;
+        sqe->addr = user_data;
+        sqe->user_data = ignored_user_data;
+
+        ring_.submit();
+      }
+      else
+      {
+        assert(!"success queueing poll removal");
+      }
+    }
+
+    callbacks_.remove_element(ticket);
+  }
+
+private :
+  list_arena_t<callback_t> callbacks_;
+  int const watched_list_;
+  int const pending_list_;
+  // indexed by the ids from callbacks_
+  std::vector<std::uint64_t> user_data_;
+  std::uint64_t next_generation_;
+  ring_t ring_;
+};
+
+} // anonymous
+
+bool io_uring_selector_supported()
+{
+  static bool const result = []
+  {
+    io_uring_params params;
+    std::memset(&params, 0, sizeof params);
+
+    // probe with the size we will actually use
+    int fd = io_uring_setup(ring_entries, &params);
+    if(fd == -1)
+    {
+      return false;
+    }
+    ::close(fd);
+
+    return (params.features & required_features) == required_features;
+  }();
+
+  return result;
+}
+
+std::unique_ptr<selector_t> create_io_uring_selector()
+{
+  if(!io_uring_selector_supported())
+  {
+    return create_oneshot_epoll_selector();
+  }
+
+  try
+  {
+    return std::make_unique<io_uring_selector_t>();
+  }
+  catch(system_exception_t const&)
+  {
+    /*
+     * Setting up the ring may still fail where the probe succeeded,
+     * for example when mapping it exceeds RLIMIT_MEMLOCK on older
+     * kernels.
+     */
+    return create_oneshot_epoll_selector();
+  }
+}
+
+} // cuti
+
+#endif // CUTI_HAS_IO_URING_SELECTOR
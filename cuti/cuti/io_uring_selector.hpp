@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2026 CodeShop B.V.
+ *
+ * This file is part of the cuti library.
+ *
+ * The cuti library is free software: you can redistribute it and/or
+ * modify it under the terms of version 2.1 of the GNU Lesser General
+ * Public License as published by the Free Software Foundation.
+ *
+ * The cuti library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See version
+ * 2.1 of the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of version 2.1 of the GNU Lesser
+ * General Public License along with the cuti library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CUTI_IO_URING_SELECTOR_HPP_
+#define CUTI_IO_URING_SELECTOR_HPP_
+
+#include "linkage.h"
+#include "selector.hpp"
+
+#include <memory>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define CUTI_HAS_IO_URING_SELECTOR 1
+#else
+#undef CUTI_HAS_IO_URING_SELECTOR
+#endif
+
+#if CUTI_HAS_IO_URING_SELECTOR
+
+namespace cuti
+{
+
+/*
+ * Returns true if the running kernel provides the io_uring features
+ * required by the io_uring selector, false otherwise.
+ */
+CUTI_ABI
+bool io_uring_selector_supported();
+
+/*
+ * Creates a selector that submits its readiness requests as batched
+ * io_uring poll operations.  If the running kernel does not support
+ * io_uring (or the features we need), an epoll-based selector is
+ * returned instead; the same goes for a failure to set up the ring.
+ */
+CUTI_ABI
+std::unique_ptr<selector_t> create_io_uring_selector();
+
+} // cuti
+
+#endif // CUTI_HAS_IO_URING_SELECTOR
+
+#endif // CUTI_IO_URING_SELECTOR_HPP_
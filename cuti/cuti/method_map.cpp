@@ -18,3 +18,17 @@
  */
 
 #include "method_map.hpp"
+
+#include "raw_blobs_handler.hpp"
+
+namespace cuti
+{
+
+method_map_t::method_map_t()
+: factories_()
+{
+  this->add_method_factory(
+    raw_blobs_method, default_method_factory<raw_blobs_handler_t>());
+}
+
+} // cuti
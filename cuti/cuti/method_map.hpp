@@ -38,9 +38,12 @@ namespace cuti
  */
 struct CUTI_ABI method_map_t
 {
-  method_map_t()
-  : factories_()
-  { }
+  /*
+   * Creates a method map holding cuti's built-in methods; currently,
+   * that is only the raw blobs negotiation method (see
+   * raw_blobs_handler.hpp).
+   */
+  method_map_t();
 
   method_map_t(method_map_t const&) = delete;
   method_map_t& operator=(method_map_t const&) = delete;
@@ -28,16 +28,27 @@ namespace cuti
 nb_client_t::nb_client_t(socket_layer_t& sockets,
                          endpoint_t server_address,
                          std::size_t inbufsize,
-                         std::size_t outbufsize)
+                         std::size_t outbufsize,
+                         std::size_t max_inbufsize,
+                         std::size_t max_outbufsize)
 : server_address_(std::move(server_address))
 , nb_inbuf_()
 , nb_outbuf_()
+, raw_blobs_negotiated_(false)
 {
   std::tie(nb_inbuf_, nb_outbuf_) = make_nb_tcp_buffers(
-    std::make_unique<tcp_connection_t>(sockets, server_address_),
+    std::make_unique<tcp_connection_t>(
+      sockets, server_address_, connect_mode_t::nonblocking),
     inbufsize,
-    outbufsize
+    outbufsize,
+    max_inbufsize,
+    max_outbufsize
   );
 }
 
+bool nb_client_t::idle_and_alive()
+{
+  return !nb_outbuf_->error_status() && nb_inbuf_->idle_and_alive();
+}
+
 } // cuti
@@ -37,13 +37,22 @@ struct socket_layer_t;
 /*
  * A pair of non-blocking buffers representing the client side of a
  * TCP connection.
+ *
+ * The constructor does not wait for the connection to be
+ * established: the buffers simply refuse to make progress until it
+ * is.  Failing to connect is reported as an I/O error by the buffers,
+ * so a slow or unreachable server never stalls the scheduler thread.
  */
 struct CUTI_ABI nb_client_t
 {
   explicit nb_client_t(socket_layer_t& sockets,
                        endpoint_t server_address,
                        std::size_t inbufsize = nb_inbuf_t::default_bufsize,
-                       std::size_t outbufsize = nb_outbuf_t::default_bufsize);
+                       std::size_t outbufsize = nb_outbuf_t::default_bufsize,
+                       std::size_t max_inbufsize =
+                         nb_inbuf_t::default_max_bufsize,
+                       std::size_t max_outbufsize =
+                         nb_outbuf_t::default_max_bufsize);
 
   nb_client_t(nb_client_t const&) = delete;
   nb_client_t& operator=(nb_client_t const&) = delete;
@@ -63,6 +72,22 @@ struct CUTI_ABI nb_client_t
   nb_outbuf_t const& nb_outbuf() const
   { return *nb_outbuf_; }
 
+  /*
+   * Tells if the server's support for raw blobs has been negotiated
+   * for this connection; the outcome is recorded in nb_outbuf().
+   */
+  bool raw_blobs_negotiated() const
+  { return raw_blobs_negotiated_; }
+
+  void set_raw_blobs_negotiated()
+  { raw_blobs_negotiated_ = true; }
+
+  /*
+   * Checks that an idle connection is still usable, so that a
+   * connection the server has closed in the meantime is not reused.
+   */
+  bool idle_and_alive();
+
   friend CUTI_ABI
   std::ostream& operator<<(std::ostream& os, nb_client_t const& client)
   { return os << *client.nb_inbuf_; }
@@ -71,6 +96,7 @@ private :
   endpoint_t server_address_;
   std::unique_ptr<nb_inbuf_t> nb_inbuf_;
   std::unique_ptr<nb_outbuf_t> nb_outbuf_;
+  bool raw_blobs_negotiated_;
 };
 
 } // cuti
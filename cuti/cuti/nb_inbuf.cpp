@@ -24,19 +24,22 @@
 #include "system_error.hpp"
 
 #include <algorithm>
+#include <new>
 #include <utility>
 
 namespace cuti
 {
 
 nb_inbuf_t::nb_inbuf_t(std::unique_ptr<nb_source_t> source,
-                       std::size_t bufsize)
+                       std::size_t bufsize,
+                       std::size_t max_bufsize)
 : source_((assert(source != nullptr), std::move(source)))
 , checker_(std::nullopt)
 , readable_ticket_()
 , alarm_ticket_()
 , scheduler_(nullptr)
 , callback_(nullptr)
+, max_bufsize_(max_bufsize)
 , buf_((assert(bufsize != 0), new char[bufsize]))
 , rp_(buf_)
 , ep_(buf_)
@@ -56,7 +59,7 @@ void nb_inbuf_t::enable_throughput_checking(throughput_settings_t settings)
     assert(scheduler_ != nullptr);
     
     auto guard = make_scoped_guard([&] { checker_.reset(); });
-    alarm_ticket_ = scheduler_->call_alarm(
+    alarm_ticket_ = scheduler_->call_coarse_alarm(
       checker_->next_tick(),
       [this](stack_marker_t& marker) { this->on_next_tick(marker); }
     );
@@ -92,6 +95,38 @@ char* nb_inbuf_t::read(char *first, char const* last)
   return first + count;
 }
 
+char* nb_inbuf_t::read_direct(char* first, char const* last)
+{
+  assert(this->readable());
+
+  first = this->read(first, last);
+  while(!at_eof_ && last - first >= ebuf_ - buf_)
+  {
+    char* next;
+    error_status_ = source_->read(first, last, next);
+    if(error_status_ == 0 && checker_ != std::nullopt && next != nullptr)
+    {
+      error_status_ = checker_->record_transfer(next - first);
+    }
+
+    if(error_status_ != 0 || next == first)
+    {
+      at_eof_ = true;
+    }
+    else if(next == nullptr)
+    {
+      // would block
+      break;
+    }
+    else
+    {
+      first = next;
+    }
+  }
+
+  return first;
+}
+
 void nb_inbuf_t::call_when_readable(scheduler_t& scheduler,
                                     callback_t callback)
 {
@@ -101,8 +136,7 @@ void nb_inbuf_t::call_when_readable(scheduler_t& scheduler,
 
   if(this->readable())
   {
-    alarm_ticket_ = scheduler.call_alarm(
-      duration_t(0),
+    alarm_ticket_ = scheduler.call_soon(
       [this](stack_marker_t& marker) { this->on_already_readable(marker); }
     );
   }
@@ -116,7 +150,7 @@ void nb_inbuf_t::call_when_readable(scheduler_t& scheduler,
     {
       auto guard = make_scoped_guard(
         [&] { scheduler.cancel(readable_ticket); });
-      alarm_ticket_ = scheduler.call_alarm(
+      alarm_ticket_ = scheduler.call_coarse_alarm(
         checker_->next_tick(),
         [this](stack_marker_t& marker) { this->on_next_tick(marker); }
       );
@@ -149,6 +183,16 @@ void nb_inbuf_t::cancel_when_readable() noexcept
   callback_ = nullptr;
 }
 
+bool nb_inbuf_t::idle_and_alive()
+{
+  if(rp_ != ep_ || at_eof_ || error_status_)
+  {
+    return false;
+  }
+
+  return source_->idle_and_alive();
+}
+
 nb_inbuf_t::~nb_inbuf_t()
 {
   this->cancel_when_readable();
@@ -179,6 +223,20 @@ void nb_inbuf_t::on_source_readable(stack_marker_t& base_marker)
 
   readable_ticket_.clear();
 
+  if(ep_ == ebuf_ && std::size_t(ebuf_ - buf_) < max_bufsize_)
+  {
+    // the last read filled the buffer: try a larger one
+    std::size_t bufsize = std::min(2 * std::size_t(ebuf_ - buf_), max_bufsize_);
+    if(char* buf = new (std::nothrow) char[bufsize])
+    {
+      delete[] buf_;
+      buf_ = buf;
+      rp_ = buf_;
+      ep_ = buf_;
+      ebuf_ = buf_ + bufsize;
+    }
+  }
+
   char* next;
   error_status_ = source_->read(buf_, ebuf_, next);
   if(error_status_ == 0 && checker_ != std::nullopt)
@@ -247,7 +305,7 @@ void nb_inbuf_t::on_next_tick(stack_marker_t& base_marker)
     // schedule next tick
     auto guard = make_scoped_guard(
       [this] { this->cancel_when_readable(); });
-    alarm_ticket_ = scheduler_->call_alarm(
+    alarm_ticket_ = scheduler_->call_coarse_alarm(
       checker_->next_tick(),
       [this](stack_marker_t& marker) { this->on_next_tick(marker); }
     );
@@ -45,8 +45,17 @@ struct CUTI_ABI nb_inbuf_t
 {
   static std::size_t constexpr default_bufsize = 8 * 1024;
 
+  /*
+   * A buffer that keeps filling up completely is doubled in size,
+   * up to max_bufsize.  Growth is opt-in: a max_bufsize not exceeding
+   * bufsize, such as the default, keeps the buffer at its initial
+   * size.
+   */
+  static std::size_t constexpr default_max_bufsize = 0;
+
   nb_inbuf_t(std::unique_ptr<nb_source_t> source,
-             std::size_t bufsize = default_bufsize);
+             std::size_t bufsize = default_bufsize,
+             std::size_t max_bufsize = default_max_bufsize);
 
   nb_inbuf_t(nb_inbuf_t const&) = delete;
   nb_inbuf_t& operator=(nb_inbuf_t const&) = delete;
@@ -112,6 +121,19 @@ struct CUTI_ABI nb_inbuf_t
    */
   char* read(char* first, char const* last);
 
+  /*
+   * Like read(), but meant for large transfers: once the buffered
+   * input is exhausted, and the remaining range is at least as large
+   * as the buffer, reads directly from the source into the range
+   * until it is full or the source would block.  This saves a copy,
+   * and many small reads from the source.
+   * Returns the end of the range of the characters read, which is
+   * first if the buffer is at eof.  Please note that the buffer may no
+   * longer be readable() afterwards.
+   * PRE: this->readable().
+   */
+  char* read_direct(char* first, char const* last);
+
   /*
    * Schedules a callback for when the buffer is detected to be
    * readable, canceling any previously requested callback.
@@ -125,6 +147,13 @@ struct CUTI_ABI nb_inbuf_t
    */
   void cancel_when_readable() noexcept;
 
+  /*
+   * Checks that a buffer that is expected to be idle is still usable:
+   * returns false if the buffer holds unread input, has seen EOF or
+   * an error, or if its source reports otherwise.
+   */
+  bool idle_and_alive();
+
   ~nb_inbuf_t();
 
   friend std::ostream& operator<<(std::ostream& os, nb_inbuf_t const& buf)
@@ -147,10 +176,11 @@ private :
   scheduler_t* scheduler_;
   callback_t callback_;
 
-  char* const buf_;
+  std::size_t const max_bufsize_;
+  char* buf_;
   char const* rp_;
   char const* ep_;
-  char const* const ebuf_;
+  char const* ebuf_;
 
   bool at_eof_;
   error_status_t error_status_;
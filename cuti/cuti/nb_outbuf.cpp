@@ -24,24 +24,29 @@
 #include "system_error.hpp"
 
 #include <algorithm>
+#include <new>
 #include <utility>
 
 namespace cuti
 {
 
 nb_outbuf_t::nb_outbuf_t(std::unique_ptr<nb_sink_t> sink,
-                         std::size_t bufsize)
+                         std::size_t bufsize,
+                         std::size_t max_bufsize)
 : sink_((assert(sink != nullptr), std::move(sink)))
 , checker_(std::nullopt)
 , writable_ticket_()
 , alarm_ticket_()
 , scheduler_(nullptr)
 , callback_(nullptr)
+, max_bufsize_(max_bufsize)
 , buf_((assert(bufsize != 0), new char[bufsize]))
 , rp_(buf_)
 , wp_(buf_)
 , limit_(buf_ + bufsize)
 , ebuf_(buf_ + bufsize)
+, raw_blobs_enabled_(false)
+, zerocopy_enabled_(false)
 , error_status_()
 { }
 
@@ -65,6 +70,80 @@ char const* nb_outbuf_t::write(char const* first, char const* last)
   return first + count;
 }
 
+bool nb_outbuf_t::enable_zerocopy()
+{
+  if(!zerocopy_enabled_)
+  {
+    zerocopy_enabled_ = sink_->enable_zerocopy();
+  }
+  return zerocopy_enabled_;
+}
+
+char const* nb_outbuf_t::write_direct(char const* first, char const* last,
+                                      std::shared_ptr<void const> const& owner)
+{
+  assert(this->writable());
+
+  if(error_status_ != 0 || last - first <= limit_ - wp_)
+  {
+    return this->write(first, last);
+  }
+
+  // flush the buffered output first, then the range itself
+  bool blocked = false;
+  while(!blocked && error_status_ == 0 && first != last)
+  {
+    char const* from = rp_ != wp_ ? rp_ : first;
+    char const* to = rp_ != wp_ ? wp_ : last;
+
+    char const* next;
+    if(from == first && zerocopy_enabled_ && owner != nullptr)
+    {
+      error_status_ = sink_->write_zerocopy(from, to, next, owner);
+    }
+    else
+    {
+      error_status_ = sink_->write(from, to, next);
+    }
+    if(error_status_ == 0 && checker_ != std::nullopt && next != nullptr)
+    {
+      error_status_ = checker_->record_transfer(next - from);
+    }
+
+    if(error_status_ != 0)
+    {
+      // discard, as write() does
+      rp_ = buf_;
+      wp_ = buf_;
+      first = last;
+    }
+    else if(next == nullptr)
+    {
+      blocked = true;
+    }
+    else if(rp_ != wp_)
+    {
+      rp_ = next;
+      if(rp_ == wp_)
+      {
+        rp_ = buf_;
+        wp_ = buf_;
+      }
+    }
+    else
+    {
+      first = next;
+    }
+  }
+
+  if(first != last)
+  {
+    // buffer what is left; a full buffer waits for the sink
+    first = this->write(first, last);
+  }
+  return first;
+}
+
 void nb_outbuf_t::enable_throughput_checking(throughput_settings_t settings)
 {
   this->disable_throughput_checking();
@@ -77,7 +156,7 @@ void nb_outbuf_t::enable_throughput_checking(throughput_settings_t settings)
     
     auto guard = make_scoped_guard(
       [&] { checker_.reset(); });
-    alarm_ticket_ = scheduler_->call_alarm(
+    alarm_ticket_ = scheduler_->call_coarse_alarm(
       checker_->next_tick(),
       [this](stack_marker_t& marker) { this->on_next_tick(marker); }
     );
@@ -107,8 +186,7 @@ void nb_outbuf_t::call_when_writable(scheduler_t& scheduler,
 
   if(this->writable())
   {
-    alarm_ticket_ = scheduler.call_alarm(
-      duration_t(0),
+    alarm_ticket_ = scheduler.call_soon(
       [this](stack_marker_t& marker) { this->on_already_writable(marker); });
   }
   else
@@ -121,7 +199,7 @@ void nb_outbuf_t::call_when_writable(scheduler_t& scheduler,
     {
       auto guard = make_scoped_guard(
         [&] { scheduler.cancel(writable_ticket); });
-      alarm_ticket_ = scheduler.call_alarm(
+      alarm_ticket_ = scheduler.call_coarse_alarm(
         checker_->next_tick(),
         [this](stack_marker_t& marker) { this->on_next_tick(marker); }
       );
@@ -228,6 +306,18 @@ void nb_outbuf_t::on_sink_writable(stack_marker_t& base_marker)
     alarm_ticket_.clear();
   }
 
+  if(wp_ == ebuf_ && std::size_t(ebuf_ - buf_) < max_bufsize_)
+  {
+    // the buffer filled up: try a larger one
+    std::size_t bufsize = std::min(2 * std::size_t(ebuf_ - buf_), max_bufsize_);
+    if(char* buf = new (std::nothrow) char[bufsize])
+    {
+      delete[] buf_;
+      buf_ = buf;
+      ebuf_ = buf_ + bufsize;
+    }
+  }
+
   rp_ = buf_;
   wp_ = buf_;
   limit_ = ebuf_;
@@ -257,7 +347,7 @@ void nb_outbuf_t::on_next_tick(stack_marker_t& base_marker)
     // schedule next tick
     auto guard = make_scoped_guard(
       [this] { this->cancel_when_writable(); });
-    alarm_ticket_ = scheduler_->call_alarm(
+    alarm_ticket_ = scheduler_->call_coarse_alarm(
       checker_->next_tick(),
       [this](stack_marker_t& marker) { this->on_next_tick(marker); }
     );
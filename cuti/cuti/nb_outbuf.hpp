@@ -43,8 +43,17 @@ struct CUTI_ABI nb_outbuf_t
 {
   static std::size_t constexpr default_bufsize = 8 * 1024;
 
+  /*
+   * A buffer that keeps filling up completely is doubled in size,
+   * up to max_bufsize.  Growth is opt-in: a max_bufsize not exceeding
+   * bufsize, such as the default, keeps the buffer at its initial
+   * size.
+   */
+  static std::size_t constexpr default_max_bufsize = 0;
+
   nb_outbuf_t(std::unique_ptr<nb_sink_t> sink,
-              std::size_t bufsize = default_bufsize);
+              std::size_t bufsize = default_bufsize,
+              std::size_t max_bufsize = default_max_bufsize);
 
   nb_outbuf_t(nb_outbuf_t const&) = delete;
   nb_outbuf_t& operator=(nb_outbuf_t const&) = delete;
@@ -69,6 +78,51 @@ struct CUTI_ABI nb_outbuf_t
     return error_status_;
   }
 
+  /*
+   * Tells if the peer on the other side of the sink is known to
+   * accept raw (length-prefixed) blobs; see blob_writer_t.  Raw blobs
+   * are disabled by default.
+   */
+  bool raw_blobs_enabled() const noexcept
+  {
+    return raw_blobs_enabled_;
+  }
+
+  /*
+   * Allow blob writers to use the raw blob form.  This setting sticks
+   * for the lifetime of the buffer, and should only be enabled after
+   * the peer has told us it understands raw blobs.
+   */
+  void enable_raw_blobs() noexcept
+  {
+    raw_blobs_enabled_ = true;
+  }
+
+  /*
+   * Tells if zero-copy writes are enabled; see write_direct().
+   * Zero-copy writes are disabled by default.
+   */
+  bool zerocopy_enabled() const noexcept
+  {
+    return zerocopy_enabled_;
+  }
+
+  /*
+   * Tries to enable zero-copy writes, returning true if the sink
+   * supports them.
+   */
+  bool enable_zerocopy();
+
+  /*
+   * Releases the owners of the zero-copy writes that the sink has
+   * completed.  Completions are also picked up by the sink's I/O
+   * calls; this is for buffers that are about to go idle.
+   */
+  void reap_zerocopy_completions() noexcept
+  {
+    sink_->reap_zerocopy_completions();
+  }
+
   /*
    * Returns true if buffer space is available.
    */
@@ -100,6 +154,23 @@ struct CUTI_ABI nb_outbuf_t
    */
   char const* write(char const* first, char const* last);
 
+  /*
+   * Like write(), but meant for large transfers: if the range does
+   * not fit in the buffer, the buffered output is flushed, after
+   * which the range is written directly to the sink until the sink
+   * would block; the rest of the range is then buffered as with
+   * write().  This saves a copy, and many small writes to the sink.
+   * If zero-copy writes are enabled and owner is not nullptr, the
+   * sink may even write the range without copying it; owner must
+   * keep the range unchanged, and is kept alive for as long as the
+   * sink needs it.
+   * Returns a pointer to next character to write.
+   * PRE: this->writable()
+   */
+  char const* write_direct(char const* first, char const* last,
+                           std::shared_ptr<void const> const& owner =
+                             nullptr);
+
   /*
    * Enters flushing mode.  The buffer becomes writable again when
    * all characters have been flushed.
@@ -148,12 +219,15 @@ private :
   scheduler_t* scheduler_;
   callback_t callback_;
 
-  char* const buf_;
+  std::size_t const max_bufsize_;
+  char* buf_;
   char const* rp_;
   char* wp_;
   char const* limit_;
-  char const* const ebuf_;
+  char const* ebuf_;
   
+  bool raw_blobs_enabled_;
+  bool zerocopy_enabled_;
   error_status_t error_status_;
 };
 
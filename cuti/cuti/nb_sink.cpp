@@ -22,6 +22,20 @@
 namespace cuti
 {
 
+bool nb_sink_t::enable_zerocopy()
+{
+  return false;
+}
+
+int nb_sink_t::write_zerocopy(char const* first, char const* last,
+  char const*& next, std::shared_ptr<void const>)
+{
+  return this->write(first, last, next);
+}
+
+void nb_sink_t::reap_zerocopy_completions() noexcept
+{ }
+
 nb_sink_t::~nb_sink_t()
 { }
 
@@ -25,6 +25,7 @@
 #include "linkage.h"
 
 #include <iosfwd>
+#include <memory>
 
 namespace cuti
 {
@@ -52,6 +53,27 @@ struct CUTI_ABI nb_sink_t
    */
   virtual int write(
     char const* first, char const* last, char const*& next) = 0;
+
+  /*
+   * Tries to enable zero-copy writes, returning true on success.  The
+   * default implementation returns false.
+   */
+  virtual bool enable_zerocopy();
+
+  /*
+   * Like write(), but if zero-copy writes are enabled, the sink may
+   * write the range without copying it, keeping owner alive for as
+   * long as it needs the range to remain unchanged.  The default
+   * implementation calls write().
+   */
+  virtual int write_zerocopy(char const* first, char const* last,
+    char const*& next, std::shared_ptr<void const> owner);
+
+  /*
+   * Releases the owners of the zero-copy writes that have completed.
+   * The default implementation does nothing.
+   */
+  virtual void reap_zerocopy_completions() noexcept;
   
   /*
    * Requests a one-time callback for when the sink is detected to
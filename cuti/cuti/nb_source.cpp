@@ -22,6 +22,11 @@
 namespace cuti
 {
 
+bool nb_source_t::idle_and_alive()
+{
+  return true;
+}
+
 nb_source_t::~nb_source_t()
 { }
 
@@ -60,6 +60,12 @@ struct CUTI_ABI nb_source_t
   virtual cancellation_ticket_t call_when_readable(
     scheduler_t& scheduler, callback_t callback) = 0;
 
+  /*
+   * Checks, without consuming any input, that an idle source is
+   * still usable.  The default implementation returns true.
+   */
+  virtual bool idle_and_alive();
+
   virtual void print(std::ostream& os) const = 0;
 
   virtual ~nb_source_t();
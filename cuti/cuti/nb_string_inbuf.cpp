@@ -56,7 +56,7 @@ struct nb_string_source_t : nb_source_t
   cancellation_ticket_t call_when_readable(
     scheduler_t& scheduler, callback_t callback) override
   {
-    return scheduler.call_alarm(duration_t::zero(), std::move(callback));
+    return scheduler.call_soon(std::move(callback));
   }
 
   void print(std::ostream& os) const override
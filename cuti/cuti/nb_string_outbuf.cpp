@@ -47,7 +47,7 @@ struct nb_string_sink_t : nb_sink_t
   cancellation_ticket_t call_when_writable(
     scheduler_t& scheduler, callback_t callback) override
   {
-    return scheduler.call_alarm(duration_t::zero(), std::move(callback));
+    return scheduler.call_soon(std::move(callback));
   }
 
   void print(std::ostream& os) const override
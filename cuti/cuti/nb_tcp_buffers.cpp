@@ -19,8 +19,10 @@
 
 #include "nb_tcp_buffers.hpp"
 #include "scheduler.hpp"
+#include "stack_marker.hpp"
 
 #include <ostream>
+#include <utility>
 
 namespace cuti
 {
@@ -42,7 +44,24 @@ struct nb_tcp_source_t : nb_source_t
   cancellation_ticket_t
   call_when_readable(scheduler_t& scheduler, callback_t callback) override
   {
-    return conn_->call_when_readable(scheduler, std::move(callback));
+    if(!conn_->zerocopy_enabled())
+    {
+      return conn_->call_when_readable(scheduler, std::move(callback));
+    }
+
+    // a zero-copy completion is reported as the socket being readable
+    return conn_->call_when_readable(scheduler,
+      [conn = conn_.get(), callback = std::move(callback)]
+      (stack_marker_t& base_marker)
+      {
+        conn->reap_zerocopy_completions();
+        callback(base_marker);
+      });
+  }
+
+  bool idle_and_alive() override
+  {
+    return conn_->idle_and_alive();
   }
 
   void print(std::ostream& os) const override
@@ -65,10 +84,37 @@ struct nb_tcp_sink_t : nb_sink_t
     return conn_->write(first, last, next);
   }
 
+  bool enable_zerocopy() override
+  {
+    return conn_->enable_zerocopy();
+  }
+
+  int write_zerocopy(char const* first, char const* last,
+    char const*& next, std::shared_ptr<void const> owner) override
+  {
+    return conn_->write_zerocopy(first, last, next, std::move(owner));
+  }
+
+  void reap_zerocopy_completions() noexcept override
+  {
+    conn_->reap_zerocopy_completions();
+  }
+
   cancellation_ticket_t
   call_when_writable(scheduler_t& scheduler, callback_t callback) override
   {
-    return conn_->call_when_writable(scheduler, std::move(callback));
+    if(!conn_->zerocopy_enabled())
+    {
+      return conn_->call_when_writable(scheduler, std::move(callback));
+    }
+
+    return conn_->call_when_writable(scheduler,
+      [conn = conn_.get(), callback = std::move(callback)]
+      (stack_marker_t& base_marker)
+      {
+        conn->reap_zerocopy_completions();
+        callback(base_marker);
+      });
   }
 
   void print(std::ostream& os) const override
@@ -90,7 +136,9 @@ private :
 std::pair<std::unique_ptr<nb_inbuf_t>, std::unique_ptr<nb_outbuf_t>>
 make_nb_tcp_buffers(std::unique_ptr<tcp_connection_t> conn,
                     std::size_t inbufsize,
-                    std::size_t outbufsize)
+                    std::size_t outbufsize,
+                    std::size_t max_inbufsize,
+                    std::size_t max_outbufsize)
 {
   assert(conn != nullptr);
 
@@ -102,8 +150,10 @@ make_nb_tcp_buffers(std::unique_ptr<tcp_connection_t> conn,
   auto sink = std::make_unique<nb_tcp_sink_t>(std::move(shared_conn));
 
   return std::make_pair(
-    std::make_unique<nb_inbuf_t>(std::move(source), inbufsize),
-    std::make_unique<nb_outbuf_t>(std::move(sink), outbufsize));
+    std::make_unique<nb_inbuf_t>(
+      std::move(source), inbufsize, max_inbufsize),
+    std::make_unique<nb_outbuf_t>(
+      std::move(sink), outbufsize, max_outbufsize));
 }
 
 } // cuti
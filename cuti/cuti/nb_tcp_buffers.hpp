@@ -34,13 +34,19 @@ namespace cuti
 
 /*
  * Returns an nb_inbuf_t/nb_outbuf_t pair for reading from, and
- * writing to, a tcp connection.
+ * writing to, a tcp connection.  The buffers start out at inbufsize
+ * and outbufsize, and may grow up to max_inbufsize and
+ * max_outbufsize.
  */
 CUTI_ABI
 std::pair<std::unique_ptr<nb_inbuf_t>, std::unique_ptr<nb_outbuf_t>>
 make_nb_tcp_buffers(std::unique_ptr<tcp_connection_t> conn,
                     std::size_t inbufsize,
-                    std::size_t outbufsize);
+                    std::size_t outbufsize,
+                    std::size_t max_inbufsize =
+                      nb_inbuf_t::default_max_bufsize,
+                    std::size_t max_outbufsize =
+                      nb_outbuf_t::default_max_bufsize);
 
 CUTI_ABI inline
 std::pair<std::unique_ptr<nb_inbuf_t>, std::unique_ptr<nb_outbuf_t>>
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2026 CodeShop B.V.
+ *
+ * This file is part of the cuti library.
+ *
+ * The cuti library is free software: you can redistribute it and/or
+ * modify it under the terms of version 2.1 of the GNU Lesser General
+ * Public License as published by the Free Software Foundation.
+ *
+ * The cuti library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See version
+ * 2.1 of the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of version 2.1 of the GNU Lesser
+ * General Public License along with the cuti library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "raw_blobs_handler.hpp"
+
+namespace cuti
+{
+
+char const raw_blobs_method[] = "cuti_raw_blobs";
+
+raw_blobs_handler_t::raw_blobs_handler_t(result_t<void>& result,
+                                         logging_context_t const& context,
+                                         bound_inbuf_t& /* inbuf */,
+                                         bound_outbuf_t& outbuf)
+: result_(result)
+, context_(context)
+, outbuf_(outbuf)
+, bool_writer_(*this, result, outbuf)
+{ }
+
+void raw_blobs_handler_t::start(stack_marker_t& base_marker)
+{
+  if(auto msg = context_.message_at(loglevel_t::info))
+  {
+    *msg << "raw_blobs_handler: enabling raw blobs for " << outbuf_;
+  }
+
+  outbuf_.enable_raw_blobs();
+  bool_writer_.start(base_marker, &raw_blobs_handler_t::on_done, true);
+}
+
+void raw_blobs_handler_t::on_done(stack_marker_t& base_marker)
+{
+  result_.submit(base_marker);
+}
+
+} // cuti
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2026 CodeShop B.V.
+ *
+ * This file is part of the cuti library.
+ *
+ * The cuti library is free software: you can redistribute it and/or
+ * modify it under the terms of version 2.1 of the GNU Lesser General
+ * Public License as published by the Free Software Foundation.
+ *
+ * The cuti library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See version
+ * 2.1 of the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of version 2.1 of the GNU Lesser
+ * General Public License along with the cuti library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CUTI_RAW_BLOBS_HANDLER_HPP_
+#define CUTI_RAW_BLOBS_HANDLER_HPP_
+
+#include "async_writers.hpp"
+#include "bound_inbuf.hpp"
+#include "bound_outbuf.hpp"
+#include "linkage.h"
+#include "logging_context.hpp"
+#include "result.hpp"
+#include "stack_marker.hpp"
+#include "subroutine.hpp"
+
+namespace cuti
+{
+
+/*
+ * Name of the built-in method used for negotiating raw blobs (see
+ * blob_writer_t).  Servers that do not know this method predate raw
+ * blobs.
+ */
+extern CUTI_ABI char const raw_blobs_method[];
+
+/*
+ * Handler for the raw blobs negotiation method: this tells the
+ * client that we understand raw blobs, and, because the client
+ * obviously does too, enables raw blobs for our replies on this
+ * connection.
+ */
+struct CUTI_ABI raw_blobs_handler_t
+{
+  using result_value_t = void;
+
+  raw_blobs_handler_t(result_t<void>& result,
+                      logging_context_t const& context,
+                      bound_inbuf_t& inbuf,
+                      bound_outbuf_t& outbuf);
+
+  raw_blobs_handler_t(raw_blobs_handler_t const&) = delete;
+  raw_blobs_handler_t& operator=(raw_blobs_handler_t const&) = delete;
+  
+  void start(stack_marker_t& base_marker);
+
+private :
+  void on_done(stack_marker_t& base_marker);
+
+private :
+  result_t<void>& result_;
+  logging_context_t const& context_;
+  bound_outbuf_t& outbuf_;
+  subroutine_t<raw_blobs_handler_t, writer_t<bool>> bool_writer_;
+};
+  
+} // cuti
+
+#endif
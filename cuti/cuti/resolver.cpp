@@ -22,6 +22,7 @@
 #include "system_error.hpp"
 
 #include <cassert>
+#include <cstddef>
 #include <cstring>
 #include <memory>
 #include <utility>
@@ -32,6 +33,7 @@
 #else
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/un.h>
 #include <netdb.h>
 #endif
 
@@ -108,6 +110,34 @@ struct resolver_t
     return endpoint_t(sockets, *info->ai_addr, info->ai_addrlen);
   }
 
+  static endpoint_t resolve_unix(socket_layer_t& sockets, char const* path)
+  {
+    assert(path != nullptr);
+
+#ifdef _WIN32
+    system_exception_builder_t builder;
+    builder << "Unix domain sockets are not supported on this platform";
+    builder.explode();
+#else
+    sockaddr_un addr;
+    std::memset(&addr, '\0', sizeof addr);
+    addr.sun_family = AF_UNIX;
+
+    std::size_t path_size = std::strlen(path);
+    if(path_size == 0 || path_size >= sizeof addr.sun_path)
+    {
+      system_exception_builder_t builder;
+      builder << "Unix domain socket path must have 1 to " <<
+        sizeof addr.sun_path - 1 << " characters";
+      builder.explode();
+    }
+    std::memcpy(addr.sun_path, path, path_size);
+
+    return endpoint_t(sockets, *reinterpret_cast<sockaddr const*>(&addr),
+      offsetof(sockaddr_un, sun_path) + path_size + 1);
+#endif
+  }
+
   static endpoints_t find_endpoints(socket_layer_t& sockets,
     int flags, char const* host, unsigned int port)
   {
@@ -140,6 +170,16 @@ endpoint_t resolve_ip(socket_layer_t& sockets,
   return resolve_ip(sockets, ip.c_str(), port);
 }
 
+endpoint_t resolve_unix(socket_layer_t& sockets, char const* path)
+{
+  return resolver_t::resolve_unix(sockets, path);
+}
+
+endpoint_t resolve_unix(socket_layer_t& sockets, std::string const& path)
+{
+  return resolve_unix(sockets, path.c_str());
+}
+
 endpoints_t resolve_host(socket_layer_t& sockets,
                          char const* host, unsigned int port)
 {
@@ -46,6 +46,13 @@ CUTI_ABI endpoint_t resolve_ip(socket_layer_t& sockets,
 CUTI_ABI endpoint_t resolve_ip(socket_layer_t& sockets,
                                std::string const& ip, unsigned int port);
 
+// Returns an endpoint for a unix domain socket path; throws if the
+// platform does not support unix domain sockets
+CUTI_ABI endpoint_t resolve_unix(socket_layer_t& sockets,
+                                 char const* path);
+CUTI_ABI endpoint_t resolve_unix(socket_layer_t& sockets,
+                                 std::string const& path);
+
 // Returns endpoints for a host name and port number
 CUTI_ABI endpoints_t resolve_host(socket_layer_t& sockets,
                                   char const* host, unsigned int port);
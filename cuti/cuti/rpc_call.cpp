@@ -0,0 +1,356 @@
+/*
+ * Copyright (C) 2026 CodeShop B.V.
+ *
+ * This file is part of the cuti library.
+ *
+ * The cuti library is free software: you can redistribute it and/or
+ * modify it under the terms of version 2.1 of the GNU Lesser General
+ * Public License as published by the Free Software Foundation.
+ *
+ * The cuti library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See version
+ * 2.1 of the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of version 2.1 of the GNU Lesser
+ * General Public License along with the cuti library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "rpc_call.hpp"
+
+#include "raw_blobs_handler.hpp"
+#include "remote_error.hpp"
+
+#include <cassert>
+#include <exception>
+#include <ostream>
+#include <utility>
+
+namespace cuti
+{
+
+/*
+ * The raw blobs negotiation: a cuti_raw_blobs call that reports its
+ * outcome to its rpc_call_t.
+ */
+struct rpc_call_t::negotiation_t : result_t<void>
+{
+  negotiation_t(rpc_call_t& call)
+  : call_(call)
+  , accepted_(false)
+  , ex_(nullptr)
+  , engine_(*this, call_.scheduler_,
+      call_.nb_inbuf(), call_.nb_outbuf(), call_.settings_)
+  { }
+
+  void start(stack_marker_t& base_marker)
+  {
+    engine_.start(base_marker, raw_blobs_method,
+      make_input_list_ptr<bool>(accepted_), make_output_list_ptr<>());
+  }
+
+  bool accepted() const
+  { return accepted_; }
+
+  std::exception_ptr const& exception() const
+  { return ex_; }
+
+private :
+  void do_submit(stack_marker_t& /* ignored */, no_value_t) override
+  {
+    this->on_done();
+  }
+
+  void do_fail(stack_marker_t& /* ignored */, std::exception_ptr ex) override
+  {
+    ex_ = std::move(ex);
+    this->on_done();
+  }
+
+  void on_done()
+  {
+    /*
+     * We are called from deep inside engine_; let the call continue
+     * (and destroy us) from a fresh stack.
+     */
+    assert(call_.negotiation_done_ticket_.empty());
+    call_.negotiation_done_ticket_ = call_.scheduler_.call_soon(
+      [&call = call_](stack_marker_t& base_marker)
+      { call.on_negotiation_done(base_marker); });
+  }
+
+private :
+  rpc_call_t& call_;
+  bool accepted_;
+  std::exception_ptr ex_;
+  rpc_engine_t<type_list_t<bool>, type_list_t<>> engine_;
+};
+
+rpc_call_t::rpc_call_t(
+  logging_context_t const& context,
+  default_scheduler_t& scheduler,
+  nb_client_cache_t& client_cache,
+  endpoint_t const& server_address,
+  throughput_settings_t settings)
+: rpc_call_t(context, scheduler, client_cache,
+    endpoints_t{server_address}, std::move(settings))
+{ }
+
+rpc_call_t::rpc_call_t(
+  logging_context_t const& context,
+  default_scheduler_t& scheduler,
+  nb_client_cache_t& client_cache,
+  endpoints_t server_addresses,
+  throughput_settings_t settings)
+: context_(context)
+, scheduler_(scheduler)
+, settings_(std::move(settings))
+, result_()
+, done_(false)
+, client_cache_(client_cache)
+, resolver_(nullptr)
+, endpoints_(std::move(server_addresses))
+, nb_client_(nullptr)
+, negotiation_(nullptr)
+, negotiation_done_ticket_()
+{
+  assert(!endpoints_.empty());
+  this->obtain_client();
+}
+
+rpc_call_t::rpc_call_t(
+  logging_context_t const& context,
+  default_scheduler_t& scheduler,
+  nb_client_cache_t& client_cache,
+  std::string host,
+  unsigned int port,
+  throughput_settings_t settings)
+: context_(context)
+, scheduler_(scheduler)
+, settings_(std::move(settings))
+, result_()
+, done_(false)
+, client_cache_(client_cache)
+, resolver_(std::make_unique<async_resolver_t>(client_cache_.socket_layer()))
+, endpoints_()
+, nb_client_(nullptr)
+, negotiation_(nullptr)
+, negotiation_done_ticket_()
+{
+  resolver_->start(std::move(host), port);
+}
+
+void rpc_call_t::complete()
+{
+  assert(this->busy());
+  assert(this->result_available());
+
+  done_ = true;
+  result_.value(); // this is where detected exceptions are thrown
+}
+
+void rpc_call_t::start()
+{
+  assert(negotiation_ == nullptr);
+
+  if(nb_client_ == nullptr)
+  {
+    assert(resolver_ != nullptr);
+    resolver_->call_when_done(scheduler_,
+      [this](stack_marker_t& base_marker) { this->on_resolved(base_marker); });
+  }
+  else
+  {
+    stack_marker_t base_marker;
+    this->on_connected(base_marker);
+  }
+}
+
+void rpc_call_t::obtain_client()
+{
+  assert(!endpoints_.empty());
+  assert(nb_client_ == nullptr);
+
+  for(;;)
+  {
+    try
+    {
+      nb_client_ = client_cache_.obtain(context_, endpoints_.front());
+      assert(nb_client_ != nullptr);
+      return;
+    }
+    catch(std::exception const& ex)
+    {
+      if(endpoints_.size() == 1)
+      {
+        throw;
+      }
+
+      if(auto msg = context_.message_at(loglevel_t::warning))
+      {
+        *msg << "rpc_client: " << endpoints_.front() <<
+          ": can't connect: " << ex.what() << "; trying next address";
+      }
+      endpoints_.erase(endpoints_.begin());
+    }
+  }
+}
+
+bool rpc_call_t::try_next_address(stack_marker_t& base_marker)
+{
+  assert(nb_client_ != nullptr);
+
+  if(endpoints_.size() <= 1)
+  {
+    return false;
+  }
+
+  if(auto msg = context_.message_at(loglevel_t::warning))
+  {
+    *msg << "rpc_client: " << *nb_client_ <<
+      ": connection failed; trying next address";
+  }
+
+  client_cache_.invalidate_entries(context_, endpoints_.front());
+  nb_client_.reset();
+  endpoints_.erase(endpoints_.begin());
+
+  try
+  {
+    this->obtain_client();
+  }
+  catch(std::exception const&)
+  {
+    result_.fail(base_marker, std::current_exception());
+    return true;
+  }
+
+  this->on_connected(base_marker);
+  return true;
+}
+
+void rpc_call_t::on_resolved(stack_marker_t& base_marker)
+{
+  assert(resolver_ != nullptr);
+  assert(nb_client_ == nullptr);
+
+  try
+  {
+    endpoints_ = resolver_->result();
+    assert(!endpoints_.empty());
+    this->obtain_client();
+  }
+  catch(std::exception const&)
+  {
+    endpoints_.clear();
+    result_.fail(base_marker, std::current_exception());
+    return;
+  }
+
+  this->on_connected(base_marker);
+}
+
+void rpc_call_t::on_connected(stack_marker_t& base_marker)
+{
+  assert(nb_client_ != nullptr);
+
+  if(nb_client_->raw_blobs_negotiated())
+  {
+    this->do_start(base_marker);
+  }
+  else
+  {
+    negotiation_ = std::make_unique<negotiation_t>(*this);
+    negotiation_->start(base_marker);
+  }
+}
+
+void rpc_call_t::on_negotiation_done(stack_marker_t& base_marker)
+{
+  assert(negotiation_ != nullptr);
+  negotiation_done_ticket_.clear();
+
+  bool accepted = negotiation_->accepted();
+  std::exception_ptr ex = negotiation_->exception();
+  negotiation_.reset();
+
+  if(ex != nullptr)
+  {
+    try
+    {
+      std::rethrow_exception(ex);
+    }
+    catch(remote_error_t const& remote_error)
+    {
+      // The server predates raw blobs; the connection is still usable
+      if(auto msg = context_.message_at(loglevel_t::info))
+      {
+        *msg << "rpc_client: " << *nb_client_ <<
+          ": raw blobs not supported: " << remote_error;
+      }
+      ex = nullptr;
+      accepted = false;
+    }
+    catch(...)
+    {
+      // handled below
+    }
+
+    if(ex != nullptr)
+    {
+      // The connection is fresh, so it may never have been established
+      if(!this->try_next_address(base_marker))
+      {
+        // Fail the call; the destructor clears the bad cache entries
+        result_.fail(base_marker, std::move(ex));
+      }
+      return;
+    }
+  }
+
+  if(accepted)
+  {
+    nb_client_->nb_outbuf().enable_raw_blobs();
+  }
+  nb_client_->set_raw_blobs_negotiated();
+
+  this->do_start(base_marker);
+}
+
+rpc_call_t::~rpc_call_t()
+{
+  // Unbind any pending negotiation from the connection before
+  // handing it back
+  if(!negotiation_done_ticket_.empty())
+  {
+    scheduler_.cancel(negotiation_done_ticket_);
+  }
+  negotiation_.reset();
+
+  if(nb_client_ == nullptr)
+  {
+    // The host lookup or the last connect failed, or the lookup is
+    // still pending: nothing to hand back
+    return;
+  }
+
+  // TODO: Do not let exceptions escape
+  if(done_ && result_.exception() == nullptr)
+  {
+    // No RPC errors detected: connection reusable
+    client_cache_.store(context_, std::move(nb_client_));
+  }
+  else
+  {
+    // Clear (possibly) bad cache entries
+    client_cache_.invalidate_entries(context_, nb_client_->server_address());
+
+    if (auto msg = context_.message_at(loglevel_t::info))
+    {
+      *msg << "rpc_client: closing connection " << *nb_client_;
+    }
+  }
+}
+
+} // namespace cuti
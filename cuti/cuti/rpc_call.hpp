@@ -0,0 +1,266 @@
+/*
+ * Copyright (C) 2026 CodeShop B.V.
+ *
+ * This file is part of the cuti library.
+ *
+ * The cuti library is free software: you can redistribute it and/or
+ * modify it under the terms of version 2.1 of the GNU Lesser General
+ * Public License as published by the Free Software Foundation.
+ *
+ * The cuti library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See version
+ * 2.1 of the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of version 2.1 of the GNU Lesser
+ * General Public License along with the cuti library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CUTI_RPC_CALL_HPP_
+#define CUTI_RPC_CALL_HPP_
+
+#include "async_resolver.hpp"
+#include "cancellation_ticket.hpp"
+#include "default_scheduler.hpp"
+#include "endpoint.hpp"
+#include "final_result.hpp"
+#include "identifier.hpp"
+#include "input_list.hpp"
+#include "linkage.h"
+#include "logging_context.hpp"
+#include "nb_client.hpp"
+#include "nb_client_cache.hpp"
+#include "output_list.hpp"
+#include "resolver.hpp"
+#include "rpc_engine.hpp"
+#include "stack_marker.hpp"
+#include "throughput_checker.hpp"
+#include "type_list.hpp"
+
+#include <cassert>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+
+namespace cuti
+{
+
+/*
+ * A single RPC call in progress, driven by a default_scheduler_t that
+ * may be shared with other calls.  The connection is obtained from a
+ * client cache, and returned to it when the call succeeds.
+ *
+ * A call to a host name first looks up the host on a helper thread.
+ * A call with several addresses connects to the first one; if that
+ * fails, or if the negotiation of raw blobs on a fresh connection
+ * fails, it falls back to the next one.  On a connection that has
+ * not negotiated raw blobs yet, the call performs that negotiation
+ * before the request.  Like the call itself, these steps are driven
+ * by the scheduler.
+ */
+struct CUTI_ABI rpc_call_t
+{
+  rpc_call_t(logging_context_t const& context,
+             default_scheduler_t& scheduler,
+             nb_client_cache_t& client_cache,
+             endpoint_t const& server_address,
+             throughput_settings_t settings);
+
+  /*
+   * PRE: !server_addresses.empty()
+   */
+  rpc_call_t(logging_context_t const& context,
+             default_scheduler_t& scheduler,
+             nb_client_cache_t& client_cache,
+             endpoints_t server_addresses,
+             throughput_settings_t settings);
+
+  rpc_call_t(logging_context_t const& context,
+             default_scheduler_t& scheduler,
+             nb_client_cache_t& client_cache,
+             std::string host,
+             unsigned int port,
+             throughput_settings_t settings);
+
+  rpc_call_t(rpc_call_t const&) = delete;
+  rpc_call_t& operator=(rpc_call_t const&) = delete;
+
+  bool busy() const
+  { return !done_; }
+
+  /*
+   * Tells if the outcome of the call is known; if not, running the
+   * scheduler's callbacks will make progress.
+   */
+  bool result_available() const
+  { return result_.available(); }
+
+  /*
+   * Marks the call as done, throwing any exception detected by the
+   * RPC engine.
+   * PRE: this->busy() && this->result_available()
+   */
+  void complete();
+
+  /*
+   * Returns the addresses the call may still use, starting with the
+   * one it is connected to; empty while a host lookup is pending, or
+   * if it failed.  After a successful call to a host name, these can
+   * be passed to a later call to skip the lookup.
+   */
+  endpoints_t const& server_addresses() const
+  { return endpoints_; }
+
+  virtual ~rpc_call_t() = 0;
+
+protected :
+  /*
+   * Starts the call, possibly after resolving the host and
+   * negotiating raw blobs; to be invoked once by the fully
+   * constructed derived class.
+   */
+  void start();
+
+  result_t<void>& result()
+  { return result_; }
+
+  default_scheduler_t& scheduler()
+  { return scheduler_; }
+
+  throughput_settings_t const& settings() const
+  { return settings_; }
+
+  nb_inbuf_t& nb_inbuf()
+  { return nb_client_->nb_inbuf(); }
+
+  nb_outbuf_t& nb_outbuf()
+  { return nb_client_->nb_outbuf(); }
+
+private :
+  /*
+   * Starts the actual request.
+   */
+  virtual void do_start(stack_marker_t& base_marker) = 0;
+
+private :
+  struct negotiation_t;
+
+  void obtain_client();
+  bool try_next_address(stack_marker_t& base_marker);
+  void on_resolved(stack_marker_t& base_marker);
+  void on_connected(stack_marker_t& base_marker);
+  void on_negotiation_done(stack_marker_t& base_marker);
+
+private :
+  logging_context_t const& context_;
+  default_scheduler_t& scheduler_;
+  throughput_settings_t settings_;
+  final_result_t<void> result_;
+  bool done_;
+  nb_client_cache_t& client_cache_;
+  std::unique_ptr<async_resolver_t> resolver_;
+  endpoints_t endpoints_; // endpoints_.front() is the current one
+  std::unique_ptr<nb_client_t> nb_client_;
+  std::unique_ptr<negotiation_t> negotiation_;
+  cancellation_ticket_t negotiation_done_ticket_;
+};
+
+template<typename ReplyTypes, typename RequestTypes>
+struct rpc_call_inst_t : rpc_call_t
+{
+  using input_list_ptr_t = std::unique_ptr<
+    bind_to_type_list_t<input_list_t, ReplyTypes>>;
+  using output_list_ptr_t = std::unique_ptr<
+    bind_to_type_list_t<output_list_t, RequestTypes>>;
+
+  rpc_call_inst_t(logging_context_t const& context,
+                  default_scheduler_t& scheduler,
+                  nb_client_cache_t& client_cache,
+                  endpoint_t const& server_address,
+                  throughput_settings_t settings,
+                  identifier_t method,
+                  input_list_ptr_t inputs,
+                  output_list_ptr_t outputs)
+  : rpc_call_t(context, scheduler, client_cache, server_address,
+      std::move(settings))
+  , method_(std::move(method))
+  , inputs_(std::move(inputs))
+  , outputs_(std::move(outputs))
+  , engine_()
+  {
+    assert(method_.is_valid());
+    assert(inputs_ != nullptr);
+    assert(outputs_ != nullptr);
+
+    rpc_call_t::start();
+  }
+
+  rpc_call_inst_t(logging_context_t const& context,
+                  default_scheduler_t& scheduler,
+                  nb_client_cache_t& client_cache,
+                  endpoints_t server_addresses,
+                  throughput_settings_t settings,
+                  identifier_t method,
+                  input_list_ptr_t inputs,
+                  output_list_ptr_t outputs)
+  : rpc_call_t(context, scheduler, client_cache,
+      std::move(server_addresses), std::move(settings))
+  , method_(std::move(method))
+  , inputs_(std::move(inputs))
+  , outputs_(std::move(outputs))
+  , engine_()
+  {
+    assert(method_.is_valid());
+    assert(inputs_ != nullptr);
+    assert(outputs_ != nullptr);
+
+    rpc_call_t::start();
+  }
+
+  rpc_call_inst_t(logging_context_t const& context,
+                  default_scheduler_t& scheduler,
+                  nb_client_cache_t& client_cache,
+                  std::string host,
+                  unsigned int port,
+                  throughput_settings_t settings,
+                  identifier_t method,
+                  input_list_ptr_t inputs,
+                  output_list_ptr_t outputs)
+  : rpc_call_t(context, scheduler, client_cache, std::move(host), port,
+      std::move(settings))
+  , method_(std::move(method))
+  , inputs_(std::move(inputs))
+  , outputs_(std::move(outputs))
+  , engine_()
+  {
+    assert(method_.is_valid());
+    assert(inputs_ != nullptr);
+    assert(outputs_ != nullptr);
+
+    rpc_call_t::start();
+  }
+
+private :
+  void do_start(stack_marker_t& base_marker) override
+  {
+    // The engine is only created now: its buffer bindings must not
+    // overlap with those of the raw blobs negotiation
+    engine_.emplace(rpc_call_t::result(), rpc_call_t::scheduler(),
+      rpc_call_t::nb_inbuf(), rpc_call_t::nb_outbuf(),
+      rpc_call_t::settings());
+    engine_->start(base_marker,
+      std::move(method_), std::move(inputs_), std::move(outputs_));
+  }
+
+private :
+  identifier_t method_;
+  input_list_ptr_t inputs_;
+  output_list_ptr_t outputs_;
+  std::optional<rpc_engine_t<ReplyTypes, RequestTypes>> engine_;
+};
+
+} // cuti
+
+#endif
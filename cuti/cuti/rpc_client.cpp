@@ -19,13 +19,10 @@
 
 #include "rpc_client.hpp"
 
-#include "nb_tcp_buffers.hpp"
 #include "scoped_guard.hpp"
-#include "tcp_connection.hpp"
+#include "stack_marker.hpp"
 
 #include <cassert>
-#include <ostream>
-#include <tuple>
 
 namespace cuti
 {
@@ -50,37 +47,9 @@ void rpc_client_t::step()
   auto deactivator =
     make_scoped_guard([this] { this->curr_call_.reset(); });
 
-  curr_call_->step(); // this is where detected exceptions are thrown
-
-  if(curr_call_->busy())
+  if(curr_call_->result_available())
   {
-    deactivator.dismiss(); // keep curr_call_ alive
-  }
-}
-
-rpc_client_t::call_t::call_t(
-  logging_context_t const& context,
-  default_scheduler_t& scheduler,
-  nb_client_cache_t& client_cache,
-  endpoint_t const& server_address)
-: context_(context)
-, scheduler_(scheduler)
-, result_()
-, done_(false)
-, client_cache_(client_cache)
-, nb_client_(client_cache_.obtain(context_, server_address)) 
-{
-  assert(nb_client_ != nullptr);
-}
-
-void rpc_client_t::call_t::step()
-{
-  assert(this->busy());
-
-  if(result_.available())
-  {
-    done_ = true;
-    result_.value(); // this is where detected exceptions are thrown
+    curr_call_->complete(); // this is where detected exceptions are thrown
   }
   else
   {
@@ -90,25 +59,10 @@ void rpc_client_t::call_t::step()
     stack_marker_t base_marker;
     cb(base_marker);
   }
-}
 
-rpc_client_t::call_t::~call_t()
-{
-  // TODO: Do not let exceptions escape
-  if(done_ && result_.exception() == nullptr)
-  {
-    // No RPC errors detected: connection reusable
-    client_cache_.store(context_, std::move(nb_client_));
-  }
-  else
+  if(curr_call_->busy())
   {
-    // Clear (possibly) bad cache entries
-    client_cache_.invalidate_entries(context_, nb_client_->server_address());
-
-    if (auto msg = context_.message_at(loglevel_t::info))
-    {
-      *msg << "rpc_client: closing connection " << *nb_client_;
-    }
+    deactivator.dismiss(); // keep curr_call_ alive
   }
 }
 
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2026 CodeShop B.V.
+ *
+ * This file is part of the cuti library.
+ *
+ * The cuti library is free software: you can redistribute it and/or
+ * modify it under the terms of version 2.1 of the GNU Lesser General
+ * Public License as published by the Free Software Foundation.
+ *
+ * The cuti library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See version
+ * 2.1 of the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of version 2.1 of the GNU Lesser
+ * General Public License along with the cuti library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "rpc_client_group.hpp"
+
+#include "stack_marker.hpp"
+
+#include <cassert>
+
+namespace cuti
+{
+
+rpc_client_group_t::rpc_client_group_t(logging_context_t const& context,
+                                       nb_client_cache_t& client_cache,
+                                       throughput_settings_t settings)
+: context_(context)
+, scheduler_(client_cache.socket_layer())
+, client_cache_(client_cache)
+, settings_(std::move(settings))
+, next_id_(0)
+, calls_()
+, resolved_hosts_()
+{ }
+
+std::optional<rpc_client_group_t::completion_t>
+rpc_client_group_t::step()
+{
+  assert(this->busy());
+
+  auto pos = calls_.begin();
+  while(pos != calls_.end() && !pos->call_->result_available())
+  {
+    ++pos;
+  }
+
+  if(pos == calls_.end())
+  {
+    auto cb = scheduler_.wait();
+    assert(cb != nullptr);
+
+    stack_marker_t base_marker;
+    cb(base_marker);
+
+    return std::nullopt;
+  }
+
+  completion_t completion{pos->id_, nullptr};
+  try
+  {
+    pos->call_->complete();
+  }
+  catch(std::exception const&)
+  {
+    completion.ex_ = std::current_exception();
+  }
+
+  if(pos->host_ != std::nullopt)
+  {
+    endpoints_t const& addresses = pos->call_->server_addresses();
+    if(completion.ex_ == nullptr && !addresses.empty())
+    {
+      // the address that worked comes first
+      resolved_hosts_[*pos->host_] = addresses;
+    }
+    else
+    {
+      resolved_hosts_.erase(*pos->host_);
+    }
+  }
+
+  // returns the connection to the cache, or closes it
+  calls_.erase(pos);
+
+  return completion;
+}
+
+rpc_client_group_t::completion_t
+rpc_client_group_t::complete_next_call()
+{
+  std::optional<completion_t> completion;
+  while(completion == std::nullopt)
+  {
+    completion = this->step();
+  }
+  return *completion;
+}
+
+rpc_client_group_t::~rpc_client_group_t()
+{
+  // destroy the calls before the scheduler
+  calls_.clear();
+}
+
+} // cuti
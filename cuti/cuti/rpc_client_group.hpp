@@ -0,0 +1,224 @@
+/*
+ * Copyright (C) 2026 CodeShop B.V.
+ *
+ * This file is part of the cuti library.
+ *
+ * The cuti library is free software: you can redistribute it and/or
+ * modify it under the terms of version 2.1 of the GNU Lesser General
+ * Public License as published by the Free Software Foundation.
+ *
+ * The cuti library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See version
+ * 2.1 of the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of version 2.1 of the GNU Lesser
+ * General Public License along with the cuti library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CUTI_RPC_CLIENT_GROUP_HPP_
+#define CUTI_RPC_CLIENT_GROUP_HPP_
+
+#include "default_scheduler.hpp"
+#include "endpoint.hpp"
+#include "identifier.hpp"
+#include "input_list.hpp"
+#include "linkage.h"
+#include "logging_context.hpp"
+#include "nb_client_cache.hpp"
+#include "output_list.hpp"
+#include "resolver.hpp"
+#include "rpc_call.hpp"
+#include "throughput_checker.hpp"
+#include "type_list.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <exception>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace cuti
+{
+
+/*
+ * Keeps any number of concurrent RPC calls, possibly to different
+ * servers, in flight on a single scheduler, so that a single thread
+ * can drive them all.  Each call uses its own connection from the
+ * client cache.
+ *
+ * Unlike rpc_client_t, a failing call does not throw: its exception
+ * is reported in its completion, and the other calls are unaffected.
+ */
+struct CUTI_ABI rpc_client_group_t
+{
+  using call_id_t = unsigned int;
+
+  struct completion_t
+  {
+    call_id_t id_;
+    std::exception_ptr ex_; // nullptr if the call succeeded
+  };
+
+  rpc_client_group_t(logging_context_t const& context,
+                     nb_client_cache_t& client_cache,
+                     throughput_settings_t settings = throughput_settings_t());
+
+  rpc_client_group_t(rpc_client_group_t const&) = delete;
+  rpc_client_group_t& operator=(rpc_client_group_t const&) = delete;
+
+  /*
+   * Starts an RPC call to server_address, returning an id that is
+   * unique within this group.  Throws if the call cannot be started.
+   */
+  template<typename... InputArgs, typename... OutputArgs>
+  call_id_t start(endpoint_t const& server_address,
+                  identifier_t method,
+                  std::unique_ptr<input_list_t<InputArgs...>> inputs,
+                  std::unique_ptr<output_list_t<OutputArgs...>> outputs)
+  {
+    assert(!server_address.empty());
+    assert(method.is_valid());
+    assert(inputs != nullptr);
+    assert(outputs != nullptr);
+
+    auto call = std::make_unique<rpc_call_inst_t<
+      type_list_t<InputArgs...>, type_list_t<OutputArgs...>>>(
+        context_, scheduler_, client_cache_, server_address, settings_,
+        std::move(method), std::move(inputs), std::move(outputs));
+
+    call_id_t id = next_id_++;
+    calls_.push_back(entry_t{id, std::move(call), std::nullopt});
+    return id;
+  }
+
+  /*
+   * Starts an RPC call to the first of server_addresses that can be
+   * connected to, returning an id that is unique within this group.
+   * Throws if the call cannot be started.
+   * PRE: !server_addresses.empty()
+   */
+  template<typename... InputArgs, typename... OutputArgs>
+  call_id_t start(endpoints_t server_addresses,
+                  identifier_t method,
+                  std::unique_ptr<input_list_t<InputArgs...>> inputs,
+                  std::unique_ptr<output_list_t<OutputArgs...>> outputs)
+  {
+    assert(!server_addresses.empty());
+    assert(method.is_valid());
+    assert(inputs != nullptr);
+    assert(outputs != nullptr);
+
+    auto call = std::make_unique<rpc_call_inst_t<
+      type_list_t<InputArgs...>, type_list_t<OutputArgs...>>>(
+        context_, scheduler_, client_cache_, std::move(server_addresses),
+        settings_, std::move(method), std::move(inputs), std::move(outputs));
+
+    call_id_t id = next_id_++;
+    calls_.push_back(entry_t{id, std::move(call), std::nullopt});
+    return id;
+  }
+
+  /*
+   * Starts an RPC call to a server that is looked up by host name
+   * first; the lookup does not block the group's scheduler.  The
+   * addresses found are remembered for later calls to the same host
+   * and port, until a call to them fails.  Returns an id that is
+   * unique within this group.  Throws if the call cannot be started;
+   * a failed lookup is reported in the call's completion.
+   */
+  template<typename... InputArgs, typename... OutputArgs>
+  call_id_t start(std::string host,
+                  unsigned int port,
+                  identifier_t method,
+                  std::unique_ptr<input_list_t<InputArgs...>> inputs,
+                  std::unique_ptr<output_list_t<OutputArgs...>> outputs)
+  {
+    assert(method.is_valid());
+    assert(inputs != nullptr);
+    assert(outputs != nullptr);
+
+    using call_t = rpc_call_inst_t<
+      type_list_t<InputArgs...>, type_list_t<OutputArgs...>>;
+
+    host_key_t key(std::move(host), port);
+    std::unique_ptr<rpc_call_t> call;
+
+    auto pos = resolved_hosts_.find(key);
+    if(pos != resolved_hosts_.end())
+    {
+      call = std::make_unique<call_t>(
+        context_, scheduler_, client_cache_, pos->second, settings_,
+        std::move(method), std::move(inputs), std::move(outputs));
+    }
+    else
+    {
+      call = std::make_unique<call_t>(
+        context_, scheduler_, client_cache_, key.first, key.second,
+        settings_, std::move(method), std::move(inputs), std::move(outputs));
+    }
+
+    call_id_t id = next_id_++;
+    calls_.push_back(entry_t{id, std::move(call), std::move(key)});
+    return id;
+  }
+
+  /*
+   * Returns the number of active calls.
+   */
+  std::size_t size() const
+  { return calls_.size(); }
+
+  /*
+   * Tells if there are any active calls.
+   */
+  bool busy() const
+  { return !calls_.empty(); }
+
+  /*
+   * Have the active calls make some progress; returns the completion
+   * of a call that finished, if any.
+   * PRE: this->busy()
+   */
+  std::optional<completion_t> step();
+
+  /*
+   * Makes progress until one of the active calls finishes, and
+   * returns its completion.
+   * PRE: this->busy()
+   */
+  completion_t complete_next_call();
+
+  /*
+   * Abandons any active calls, closing their connections.
+   */
+  ~rpc_client_group_t();
+
+private :
+  using host_key_t = std::pair<std::string, unsigned int>;
+
+  struct entry_t
+  {
+    call_id_t id_;
+    std::unique_ptr<rpc_call_t> call_;
+    std::optional<host_key_t> host_; // set for calls to a host name
+  };
+
+private :
+  logging_context_t const& context_;
+  default_scheduler_t scheduler_;
+  nb_client_cache_t& client_cache_;
+  throughput_settings_t settings_;
+  call_id_t next_id_;
+  std::vector<entry_t> calls_;
+  std::map<host_key_t, endpoints_t> resolved_hosts_;
+};
+
+} // cuti
+
+#endif
@@ -75,6 +75,56 @@ struct CUTI_ABI scheduler_t
     return this->call_alarm(
       cuti_clock_t::now() + timeout, std::forward<Callback>(callback));
   }
+
+  /*
+   * Schedules a one-time coarse callback at or after <when>.  Coarse
+   * alarms are cheaper to schedule and cancel than regular alarms,
+   * but may be invoked up to a few milliseconds late; use them for
+   * timeouts and periodic checks that do not need to be precise.
+   * Returns a cancellation ticket that can be used to cancel the
+   * callback before it is invoked.
+   * Call this function again if you want another callback.
+   */
+  template<typename Callback>
+  cancellation_ticket_t call_coarse_alarm(time_point_t when,
+                                          Callback&& callback)
+  {
+    callback_t callee(std::forward<Callback>(callback));
+    assert(callee != nullptr);
+    return cancellation_ticket_t(
+      cancellation_ticket_t::type_t::coarse_alarm,
+      this->do_call_coarse_alarm(when, std::move(callee)));
+  }
+    
+  /*
+   * Schedules a one-time coarse callback at or after <timeout> from
+   * now.  See above.
+   */
+  template<typename Callback>
+  cancellation_ticket_t call_coarse_alarm(duration_t timeout,
+                                          Callback&& callback)
+  {
+    return this->call_coarse_alarm(
+      cuti_clock_t::now() + timeout, std::forward<Callback>(callback));
+  }
+
+  /*
+   * Schedules a one-time callback for as soon as possible, without
+   * consulting the clock; use this for continuations that have
+   * nothing to wait for.  Callbacks scheduled this way are invoked in
+   * FIFO order.  Returns a cancellation ticket that can be used to
+   * cancel the callback before it is invoked.
+   * Call this function again if you want another callback.
+   */
+  template<typename Callback>
+  cancellation_ticket_t call_soon(Callback&& callback)
+  {
+    callback_t callee(std::forward<Callback>(callback));
+    assert(callee != nullptr);
+    return cancellation_ticket_t(
+      cancellation_ticket_t::type_t::soon,
+      this->do_call_soon(std::move(callee)));
+  }
     
   /*
    * Schedules a one-time callback for when <fd> is ready for writing.
@@ -120,6 +170,12 @@ struct CUTI_ABI scheduler_t
     case cancellation_ticket_t::type_t::alarm :
       this->do_cancel_alarm(ticket.id());
       break;
+    case cancellation_ticket_t::type_t::coarse_alarm :
+      this->do_cancel_coarse_alarm(ticket.id());
+      break;
+    case cancellation_ticket_t::type_t::soon :
+      this->do_cancel_soon(ticket.id());
+      break;
     case cancellation_ticket_t::type_t::writable :
       this->do_cancel_when_writable(ticket.id());
       break;
@@ -137,6 +193,11 @@ struct CUTI_ABI scheduler_t
 private :
   virtual int do_call_alarm(time_point_t when, callback_t callback) = 0;
   virtual void do_cancel_alarm(int ticket) noexcept = 0;
+  virtual int do_call_coarse_alarm(time_point_t when,
+                                   callback_t callback) = 0;
+  virtual void do_cancel_coarse_alarm(int ticket) noexcept = 0;
+  virtual int do_call_soon(callback_t callback) = 0;
+  virtual void do_cancel_soon(int ticket) noexcept = 0;
   virtual int do_call_when_writable(int fd, callback_t callback) = 0;
   virtual void do_cancel_when_writable(int ticket) noexcept = 0;
   virtual int do_call_when_readable(int fd, callback_t callback) = 0;
@@ -21,6 +21,7 @@
 
 #include "args_reader.hpp"
 #include "epoll_selector.hpp"
+#include "io_uring_selector.hpp"
 #include "kqueue_selector.hpp"
 #include "poll_selector.hpp"
 #include "select_selector.hpp"
@@ -61,6 +62,14 @@ std::vector<selector_factory_t> available_selector_factories()
 #if CUTI_HAS_EPOLL_SELECTOR
   result.emplace_back("epoll",
     [](socket_layer_t&) { return create_epoll_selector(); });
+  result.emplace_back("epoll_oneshot",
+    [](socket_layer_t&) { return create_oneshot_epoll_selector(); });
+#endif
+
+#if CUTI_HAS_IO_URING_SELECTOR
+  // falls back to epoll if io_uring is not supported at runtime
+  result.emplace_back("io_uring",
+    [](socket_layer_t&) { return create_io_uring_selector(); });
 #endif
 
 #if CUTI_HAS_KQUEUE_SELECTOR
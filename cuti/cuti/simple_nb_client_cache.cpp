@@ -19,8 +19,12 @@
 
 #include "simple_nb_client_cache.hpp"
 
+#include "scoped_thread.hpp"
+
 #include <algorithm>
 #include <cassert>
+#include <exception>
+#include <iterator>
 #include <memory>
 #include <utility>
 
@@ -32,8 +36,20 @@ simple_nb_client_cache_t::simple_nb_client_cache_t(
 : sockets_(sockets)
 , settings_(std::move(settings))
 , mut_()
+, reaper_cv_()
 , entries_()
-{ }
+, stacks_()
+, hits_(0)
+, misses_(0)
+, evictions_(0)
+, expirations_(0)
+, probe_failures_(0)
+, stopping_(false)
+, reaper_(nullptr)
+{
+  reaper_ = std::make_unique<scoped_thread_t>(
+    [this] { this->reap_expired_entries(); });
+}
 
 socket_layer_t& simple_nb_client_cache_t::socket_layer()
 {
@@ -47,53 +63,49 @@ simple_nb_client_cache_t::obtain(logging_context_t const& context,
   assert(!server_address.empty());
 
   std::unique_ptr<nb_client_t> result = nullptr;
-  entry_list_t expired_entries{};
-  auto expiry_timestamp = cuti_clock_t::now() - settings_.max_age_;
 
+  for(;;)
   {
-    std::lock_guard<std::mutex> guard(mut_);
-
-    auto next = entries_.begin();
+    entry_list_t expired_entries{};
+    {
+      std::lock_guard<std::mutex> guard(mut_);
+      result = this->pop_entry(server_address, expired_entries);
+    }
 
-    while(next != entries_.end() &&
-      next->timestamp_ > expiry_timestamp &&
-      result == nullptr)
+    while(!expired_entries.empty())
     {
-      assert(next->client_ != nullptr);
-      auto pos = next;
-      ++next;
-      
-      if(pos->client_->server_address() == server_address)
+      assert(expired_entries.front().client_ != nullptr);
+      if(auto msg = context.message_at(loglevel_t::info))
       {
-        result = std::move(pos->client_);
-        entries_.erase(pos);
+        *msg << *this << ": closing expired connection " <<
+          *(expired_entries.front().client_);
       }
+      expired_entries.pop_front();
     }
 
-    while(next != entries_.end() &&
-          next->timestamp_ > expiry_timestamp)
+    if(result == nullptr || result->idle_and_alive())
     {
-      assert(next->client_ != nullptr);
-      ++next;
+      break;
     }
 
-    expired_entries.splice(expired_entries.begin(),
-      entries_, next, entries_.end());
-  }
-
-  while(!expired_entries.empty())
-  {
-    assert(expired_entries.front().client_ != nullptr);
     if(auto msg = context.message_at(loglevel_t::info))
     {
-      *msg << *this << ": closing expired connection " <<
-        *(expired_entries.front().client_);
+      *msg << *this << ": closing connection closed by server " <<
+        *result;
     }
-    expired_entries.pop_front();
+    result.reset();
+
+    std::lock_guard<std::mutex> guard(mut_);
+    ++probe_failures_;
   }
         
   if(result != nullptr)
   {
+    {
+      std::lock_guard<std::mutex> guard(mut_);
+      ++hits_;
+    }
+
     if(auto msg = context.message_at(loglevel_t::info))
     {
       *msg << *this << ": reusing connection " << *result;
@@ -101,11 +113,21 @@ simple_nb_client_cache_t::obtain(logging_context_t const& context,
   }
   else
   {
+    {
+      std::lock_guard<std::mutex> guard(mut_);
+      ++misses_;
+    }
+
     try
     {
       result = std::make_unique<nb_client_t>(
         sockets_, server_address,
-        settings_.inbufsize_, settings_.outbufsize_);
+        settings_.inbufsize_, settings_.outbufsize_,
+        settings_.max_inbufsize_, settings_.max_outbufsize_);
+      if(settings_.zerocopy_)
+      {
+        result->nb_outbuf().enable_zerocopy();
+      }
     }
     catch(std::exception const&)
     {
@@ -132,27 +154,42 @@ void simple_nb_client_cache_t::store(logging_context_t const& context,
     *msg << *this << ": storing connection " << *client;
   }
 
-  std::unique_ptr<nb_client_t> evict = nullptr;
+  // nothing reaps the completions of an idle connection
+  client->nb_outbuf().reap_zerocopy_completions();
+
+  entry_list_t evicted_entries{};
+  bool was_empty;
   {
     std::lock_guard<std::mutex> guard(mut_);
-  
-    std::size_t old_size = entries_.size();
+
+    was_empty = entries_.empty();
+    auto& stack = stacks_[client->server_address()];
     entries_.emplace_front(std::move(client));
+    stack.push_back(entries_.begin());
 
-    if(old_size == settings_.max_cachesize_)
+    while(entries_.size() > settings_.max_cachesize_)
     {
-      evict = std::move(entries_.back().client_);
-      entries_.pop_back();
+      this->erase_oldest_entry(evicted_entries);
+      ++evictions_;
     }
   }
 
-  if(evict != nullptr)
+  if(was_empty)
+  {
+    // the reaper may be waiting for an entry to show up
+    reaper_cv_.notify_one();
+  }
+
+  while(!evicted_entries.empty())
   {
+    assert(evicted_entries.front().client_ != nullptr);
     if(auto msg = context.message_at(loglevel_t::info))
     {
       *msg << *this <<
-        ": max cache size reached: closing connection " << *evict;
+        ": max cache size reached: closing connection " <<
+        *(evicted_entries.front().client_);
     }
+    evicted_entries.pop_front();
   }
 }
 
@@ -169,30 +206,20 @@ void simple_nb_client_cache_t::invalidate_entries(
   }
 
   entry_list_t invalidated_entries{};
-  entry_list_t expired_entries{};
-  auto expiry_timestamp = cuti_clock_t::now() - settings_.max_age_;
 
   {
     std::lock_guard<std::mutex> guard(mut_);
 
-    auto next = entries_.begin();
-
-    while(next != entries_.end() &&
-      next->timestamp_ > expiry_timestamp)
+    auto stack = stacks_.find(server_address);
+    if(stack != stacks_.end())
     {
-      assert(next->client_ != nullptr);
-      auto pos = next;
-      ++next;
-      
-      if(pos->client_->server_address() == server_address)
+      for(auto pos : stack->second)
       {
-        invalidated_entries.splice(invalidated_entries.end(),
+        invalidated_entries.splice(invalidated_entries.begin(),
           entries_, pos);
       }
+      stacks_.erase(stack);
     }
-
-    expired_entries.splice(expired_entries.begin(),
-      entries_, next, entries_.end());
   }
 
   while(!invalidated_entries.empty())
@@ -205,16 +232,154 @@ void simple_nb_client_cache_t::invalidate_entries(
     }
     invalidated_entries.pop_front();
   }
-        
-  while(!expired_entries.empty())
+}
+
+std::size_t simple_nb_client_cache_t::hits() const noexcept
+{
+  std::lock_guard<std::mutex> guard(mut_);
+  return hits_;
+}
+
+std::size_t simple_nb_client_cache_t::misses() const noexcept
+{
+  std::lock_guard<std::mutex> guard(mut_);
+  return misses_;
+}
+
+std::size_t simple_nb_client_cache_t::evictions() const noexcept
+{
+  std::lock_guard<std::mutex> guard(mut_);
+  return evictions_;
+}
+
+std::size_t simple_nb_client_cache_t::expirations() const noexcept
+{
+  std::lock_guard<std::mutex> guard(mut_);
+  return expirations_;
+}
+
+std::size_t simple_nb_client_cache_t::probe_failures() const noexcept
+{
+  std::lock_guard<std::mutex> guard(mut_);
+  return probe_failures_;
+}
+
+simple_nb_client_cache_t::~simple_nb_client_cache_t()
+{
   {
-    assert(expired_entries.front().client_ != nullptr);
-    if(auto msg = context.message_at(loglevel_t::info))
+    std::lock_guard<std::mutex> guard(mut_);
+    stopping_ = true;
+  }
+  reaper_cv_.notify_one();
+  reaper_.reset();
+}
+
+/*
+ * Pops the most recently stored connection to server_address,
+ * moving any expired entries it runs into to expired_entries.
+ * PRE: mut_ is locked.
+ */
+std::unique_ptr<nb_client_t>
+simple_nb_client_cache_t::pop_entry(endpoint_t const& server_address,
+                                    entry_list_t& expired_entries)
+{
+  std::unique_ptr<nb_client_t> result = nullptr;
+
+  auto stack = stacks_.find(server_address);
+  if(stack == stacks_.end())
+  {
+    return result;
+  }
+
+  auto expiry_timestamp = cuti_clock_t::now() - settings_.max_age_;
+  while(result == nullptr && !stack->second.empty())
+  {
+    auto pos = stack->second.back();
+    stack->second.pop_back();
+    assert(pos->client_ != nullptr);
+
+    if(pos->timestamp_ > expiry_timestamp)
+    {
+      result = std::move(pos->client_);
+      entries_.erase(pos);
+    }
+    else
+    {
+      expired_entries.splice(expired_entries.end(), entries_, pos);
+      ++expirations_;
+    }
+  }
+
+  if(stack->second.empty())
+  {
+    stacks_.erase(stack);
+  }
+
+  return result;
+}
+
+/*
+ * Moves the oldest entry to target.
+ * PRE: mut_ is locked and entries_ is not empty.
+ */
+void simple_nb_client_cache_t::erase_oldest_entry(entry_list_t& target)
+{
+  assert(!entries_.empty());
+
+  auto pos = std::prev(entries_.end());
+  assert(pos->client_ != nullptr);
+
+  auto stack = stacks_.find(pos->client_->server_address());
+  assert(stack != stacks_.end());
+  assert(!stack->second.empty());
+  assert(stack->second.front() == pos);
+
+  stack->second.pop_front();
+  if(stack->second.empty())
+  {
+    stacks_.erase(stack);
+  }
+
+  target.splice(target.end(), entries_, pos);
+}
+
+/*
+ * Body of the reaper thread: sleeps until the oldest entry expires,
+ * then closes the expired connections.  There is no logging context
+ * here, so expirations are only counted.
+ */
+void simple_nb_client_cache_t::reap_expired_entries()
+{
+  std::unique_lock<std::mutex> lock(mut_);
+
+  while(!stopping_)
+  {
+    if(entries_.empty())
+    {
+      reaper_cv_.wait(lock);
+      continue;
+    }
+
+    auto expiry_timestamp = cuti_clock_t::now() - settings_.max_age_;
+    if(entries_.back().timestamp_ > expiry_timestamp)
+    {
+      reaper_cv_.wait_until(lock,
+        entries_.back().timestamp_ + settings_.max_age_);
+      continue;
+    }
+
+    entry_list_t expired_entries{};
+    while(!entries_.empty() &&
+          entries_.back().timestamp_ <= expiry_timestamp)
     {
-      *msg << *this << ": closing expired connection " <<
-        *(expired_entries.front().client_);
+      this->erase_oldest_entry(expired_entries);
+      ++expirations_;
     }
-    expired_entries.pop_front();
+
+    // close the connections without holding the lock
+    lock.unlock();
+    expired_entries.clear();
+    lock.lock();
   }
 }
 
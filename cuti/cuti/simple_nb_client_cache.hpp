@@ -29,8 +29,11 @@
 #include "nb_client_cache.hpp"
 
 #include <cassert>
+#include <condition_variable>
 #include <cstddef>
+#include <deque>
 #include <list>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <ostream>
@@ -39,10 +42,17 @@
 namespace cuti
 {
 
+struct scoped_thread_t;
 struct socket_layer_t;
 
 /*
  * A simple nb_client_cache_t implementation
+ *
+ * Cached connections are kept in a stack per server address, so
+ * obtain() hands out the most recently stored connection without
+ * looking at the connections to other servers.  Before a connection
+ * is handed out, it is probed for an EOF or reset from the server.
+ * Connections older than max_age_ are closed by a background thread.
  */
 struct CUTI_ABI simple_nb_client_cache_t : nb_client_cache_t
 {
@@ -53,19 +63,28 @@ struct CUTI_ABI simple_nb_client_cache_t : nb_client_cache_t
       nb_inbuf_t::default_bufsize;
     static std::size_t constexpr default_outbufsize =
       nb_outbuf_t::default_bufsize;
+    static std::size_t constexpr default_max_inbufsize = 256 * 1024;
+    static std::size_t constexpr default_max_outbufsize = 256 * 1024;
     static duration_t constexpr default_max_age = seconds_t{118};
+    static bool constexpr default_zerocopy = false;
 
     settings_t()
     : max_cachesize_(default_max_cachesize)
     , inbufsize_(default_inbufsize)
     , outbufsize_(default_outbufsize)
+    , max_inbufsize_(default_max_inbufsize)
+    , max_outbufsize_(default_max_outbufsize)
     , max_age_(default_max_age)
+    , zerocopy_(default_zerocopy)
     { }
 
     std::size_t max_cachesize_;
     std::size_t inbufsize_;
     std::size_t outbufsize_;
+    std::size_t max_inbufsize_; // cached connections keep their buffers
+    std::size_t max_outbufsize_;
     duration_t max_age_;
+    bool zerocopy_; // see nb_outbuf_t::enable_zerocopy()
   };
 
   explicit simple_nb_client_cache_t(
@@ -86,6 +105,21 @@ struct CUTI_ABI simple_nb_client_cache_t : nb_client_cache_t
   void invalidate_entries(logging_context_t const& context,
     endpoint_t const& server_address) override;
 
+  /*
+   * Statistics: the number of obtain() calls served from the cache
+   * (hits) or needing a new connection (misses), the number of
+   * connections closed because the cache was full (evictions) or too
+   * old (expirations), and the number of cached connections found
+   * closed by the server (probe failures).
+   */
+  std::size_t hits() const noexcept;
+  std::size_t misses() const noexcept;
+  std::size_t evictions() const noexcept;
+  std::size_t expirations() const noexcept;
+  std::size_t probe_failures() const noexcept;
+
+  ~simple_nb_client_cache_t() override;
+
   friend CUTI_ABI
   std::ostream& operator<<(
     std::ostream& os, simple_nb_client_cache_t const& cache);
@@ -103,12 +137,31 @@ private :
   };
 
   using entry_list_t = std::list<entry_t>;
-    
+  // per server address, in timestamp order (highest last)
+  using entry_stack_t = std::deque<entry_list_t::iterator>;
+
+  std::unique_ptr<nb_client_t> pop_entry(endpoint_t const& server_address,
+                                         entry_list_t& expired_entries);
+  void erase_oldest_entry(entry_list_t& target);
+  void reap_expired_entries();
+
+private :
   socket_layer_t& sockets_;
   settings_t const settings_;
 
-  std::mutex mut_;
+  std::mutex mutable mut_;
+  std::condition_variable reaper_cv_;
   entry_list_t entries_; // in reverse timestamp order (highest first)
+  std::map<endpoint_t, entry_stack_t> stacks_;
+  std::size_t hits_;
+  std::size_t misses_;
+  std::size_t evictions_;
+  std::size_t expirations_;
+  std::size_t probe_failures_;
+  bool stopping_;
+
+  // the reaper walks entries_ and stacks_, so it is joined first
+  std::unique_ptr<scoped_thread_t> reaper_;
 };
 
 } // cuti
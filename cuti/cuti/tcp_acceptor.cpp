@@ -27,10 +27,15 @@ namespace cuti
 {
 
 tcp_acceptor_t::tcp_acceptor_t(socket_layer_t&  sockets,
-                               endpoint_t const& endpoint)
+                               endpoint_t const& endpoint,
+                               bool reuse_port)
 : socket_(sockets, endpoint.address_family())
 , local_endpoint_()
 {
+  if(reuse_port)
+  {
+    socket_.set_reuse_port();
+  }
   socket_.bind(endpoint);
   socket_.listen();
   local_endpoint_ = socket_.local_endpoint();
@@ -37,7 +37,13 @@ struct socket_layer_t;
 
 struct CUTI_ABI tcp_acceptor_t
 {
-  tcp_acceptor_t(socket_layer_t& sockets, endpoint_t const& endpoint);
+  /*
+   * If reuse_port is set, other acceptors created with reuse_port
+   * may bind to the same endpoint, and the kernel load-balances
+   * incoming connections over them.
+   */
+  tcp_acceptor_t(socket_layer_t& sockets, endpoint_t const& endpoint,
+                 bool reuse_port = false);
 
   tcp_acceptor_t(tcp_acceptor_t const&) = delete;
   tcp_acceptor_t& operator=(tcp_acceptor_t const&) = delete;
@@ -21,35 +21,211 @@
 
 #include "tcp_acceptor.hpp"
 #include "resolver.hpp"
+#include "scoped_thread.hpp"
 #include "system_error.hpp"
 
 #include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <list>
+#include <mutex>
 #include <ostream>
 #include <utility>
 
 namespace cuti
 {
 
+namespace // anonymous
+{
+
+using zerocopy_owners_t = std::deque<std::shared_ptr<void const>>;
+
+/*
+ * Releases the owners of the completed zero-copy writes on socket;
+ * first_id is the id of owners.front().
+ */
+void reap_completions(tcp_socket_t& socket,
+                      std::uint32_t& first_id,
+                      zerocopy_owners_t& owners) noexcept
+{
+  std::uint32_t completed_first_id;
+  std::uint32_t completed_last_id;
+  while(!owners.empty() &&
+        socket.read_zerocopy_completion(
+          completed_first_id, completed_last_id))
+  {
+    // TCP completes in order: release everything up to the last id
+    while(!owners.empty() &&
+          completed_last_id - first_id < 0x80000000u)
+    {
+      owners.pop_front();
+      ++first_id;
+    }
+  }
+}
+
+/*
+ * Keeps the sockets of destroyed connections with pending zero-copy
+ * writes open, so their completions can still be read, and the
+ * owners of these writes alive until the kernel has released them.
+ * Closing the socket would not stop the kernel from sending the
+ * pinned ranges.  A sweeper thread, started on the first burial,
+ * checks the buried sockets every sweep_interval.
+ */
+struct zerocopy_graveyard_t
+{
+  static auto constexpr sweep_interval = std::chrono::milliseconds(10);
+
+  zerocopy_graveyard_t()
+  : mutex_()
+  , cv_()
+  , stopping_(false)
+  , graves_()
+  , sweeper_(nullptr)
+  { }
+
+  zerocopy_graveyard_t(zerocopy_graveyard_t const&) = delete;
+  zerocopy_graveyard_t& operator=(zerocopy_graveyard_t const&) = delete;
+
+  /*
+   * Takes over socket and owners; if this throws, they are left
+   * untouched.
+   */
+  void bury(tcp_socket_t& socket,
+            std::uint32_t first_id,
+            zerocopy_owners_t& owners)
+  {
+    std::list<grave_t> grave(1);
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    if(sweeper_ == nullptr)
+    {
+      sweeper_ = std::make_unique<scoped_thread_t>([this] { this->sweep(); });
+    }
+
+    grave.front().socket_.swap(socket);
+    grave.front().first_id_ = first_id;
+    grave.front().owners_.swap(owners);
+    graves_.splice(graves_.end(), grave);
+
+    cv_.notify_one();
+  }
+
+  ~zerocopy_graveyard_t()
+  {
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      stopping_ = true;
+    }
+    cv_.notify_one();
+    sweeper_.reset();
+  }
+
+private :
+  struct grave_t
+  {
+    tcp_socket_t socket_;
+    std::uint32_t first_id_ = 0;
+    zerocopy_owners_t owners_;
+  };
+
+  void sweep()
+  {
+    std::list<grave_t> released;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while(!stopping_)
+    {
+      if(graves_.empty())
+      {
+        cv_.wait(lock);
+        continue;
+      }
+
+      cv_.wait_for(lock, sweep_interval);
+
+      auto it = graves_.begin();
+      while(it != graves_.end())
+      {
+        reap_completions(it->socket_, it->first_id_, it->owners_);
+        auto next = std::next(it);
+        if(it->owners_.empty())
+        {
+          released.splice(released.end(), graves_, it);
+        }
+        it = next;
+      }
+
+      // close the sockets outside the lock
+      lock.unlock();
+      released.clear();
+      lock.lock();
+    }
+  }
+
+private :
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stopping_;
+  std::list<grave_t> graves_;
+  std::unique_ptr<scoped_thread_t> sweeper_;
+};
+
+zerocopy_graveyard_t& zerocopy_graveyard()
+{
+  static zerocopy_graveyard_t graveyard;
+  return graveyard;
+}
+
+} // anonymous
+
 tcp_connection_t::tcp_connection_t(socket_layer_t& sockets,
-                                   endpoint_t const& peer)
+                                   endpoint_t const& peer,
+                                   connect_mode_t mode)
 : socket_(sockets, peer.address_family())
 , local_endpoint_()
 , remote_endpoint_()
+, connecting_(false)
+, connect_error_(0)
+, zerocopy_enabled_(false)
+, zerocopy_first_id_(0)
+, zerocopy_owners_()
 {
-  socket_.connect(peer);
-  local_endpoint_ = socket_.local_endpoint();
-  remote_endpoint_ = socket_.remote_endpoint();
+  switch(mode)
+  {
+  case connect_mode_t::blocking :
+    socket_.connect(peer);
+    local_endpoint_ = socket_.local_endpoint();
+    remote_endpoint_ = socket_.remote_endpoint();
+    break;
+  case connect_mode_t::nonblocking :
+    socket_.start_connect(peer);
+    connecting_ = true;
+    // the local address is assigned when the attempt starts
+    local_endpoint_ = socket_.local_endpoint();
+    remote_endpoint_ = peer;
+    break;
+  }
 }
 
 tcp_connection_t::tcp_connection_t(tcp_socket_t&& socket)
 : socket_((assert(!socket.empty()), std::move(socket)))
 , local_endpoint_(socket_.local_endpoint())
 , remote_endpoint_(socket_.remote_endpoint())
+, connecting_(false)
+, connect_error_(0)
+, zerocopy_enabled_(false)
+, zerocopy_first_id_(0)
+, zerocopy_owners_()
 { }
 
 void tcp_connection_t::set_blocking()
 {
   socket_.set_blocking();
+
+  // From here on, the system waits for a pending connection attempt
+  connecting_ = false;
 }
 
 void tcp_connection_t::set_nonblocking()
@@ -60,9 +236,64 @@ void tcp_connection_t::set_nonblocking()
 int tcp_connection_t::write(
   char const* first, char const* last, char const*& next)
 {
+  if(connecting_ && !this->connect_completed())
+  {
+    next = nullptr;
+    return 0;
+  }
+
+  if(connect_error_ != 0)
+  {
+    next = last;
+    return connect_error_;
+  }
+
+  this->reap_zerocopy_completions();
   return socket_.write(first, last, next);
 }
 
+bool tcp_connection_t::enable_zerocopy() noexcept
+{
+  if(!zerocopy_enabled_)
+  {
+    zerocopy_enabled_ = socket_.enable_zerocopy();
+  }
+  return zerocopy_enabled_;
+}
+
+int tcp_connection_t::write_zerocopy(char const* first, char const* last,
+  char const*& next, std::shared_ptr<void const> owner)
+{
+  if(!zerocopy_enabled_ || owner == nullptr)
+  {
+    return this->write(first, last, next);
+  }
+
+  if(connecting_ && !this->connect_completed())
+  {
+    next = nullptr;
+    return 0;
+  }
+
+  if(connect_error_ != 0)
+  {
+    next = last;
+    return connect_error_;
+  }
+
+  this->reap_zerocopy_completions();
+
+  // reserve the owner's slot first, so a pinned range is never lost
+  zerocopy_owners_.push_back(std::move(owner));
+  bool pinned = false;
+  int result = socket_.write_zerocopy(first, last, next, pinned);
+  if(!pinned)
+  {
+    zerocopy_owners_.pop_back();
+  }
+  return result;
+}
+
 int tcp_connection_t::close_write_end()
 {
   return socket_.close_write_end();
@@ -70,9 +301,77 @@ int tcp_connection_t::close_write_end()
 
 int tcp_connection_t::read(char* first, char const* last, char*& next)
 {
+  if(connecting_ && !this->connect_completed())
+  {
+    next = nullptr;
+    return 0;
+  }
+
+  if(connect_error_ != 0)
+  {
+    next = first;
+    return connect_error_;
+  }
+
+  this->reap_zerocopy_completions();
   return socket_.read(first, last, next);
 }
 
+bool tcp_connection_t::idle_and_alive()
+{
+  if(connecting_ && !this->connect_completed())
+  {
+    return true;
+  }
+
+  if(connect_error_ != 0)
+  {
+    return false;
+  }
+
+  this->reap_zerocopy_completions();
+  return socket_.idle_and_alive();
+}
+
+bool tcp_connection_t::connect_completed()
+{
+  assert(connecting_);
+
+  bool done = false;
+  int error = socket_.check_connect(done);
+  if(done)
+  {
+    connecting_ = false;
+    connect_error_ = error;
+  }
+
+  return done;
+}
+
+void tcp_connection_t::reap_zerocopy_completions() noexcept
+{
+  reap_completions(socket_, zerocopy_first_id_, zerocopy_owners_);
+}
+
+tcp_connection_t::~tcp_connection_t()
+{
+  this->reap_zerocopy_completions();
+  if(!zerocopy_owners_.empty())
+  {
+    // the peer should see the EOF that closing would have given it
+    socket_.close_write_end();
+    try
+    {
+      zerocopy_graveyard().bury(
+        socket_, zerocopy_first_id_, zerocopy_owners_);
+    }
+    catch(std::exception const&)
+    {
+      // out of resources: the peer may see the ranges being reused
+    }
+  }
+}
+
 std::ostream& operator<<(std::ostream& os, tcp_connection_t const& connection)
 {
   os << connection.local_endpoint() << "<->" << connection.remote_endpoint();
@@ -113,4 +412,18 @@ make_connected_pair(socket_layer_t& sockets)
   return make_connected_pair(sockets, interfaces.front());
 }
 
+std::pair<std::unique_ptr<tcp_connection_t>,
+          std::unique_ptr<tcp_connection_t>>
+make_socketpair(socket_layer_t& sockets)
+{
+  auto sockets_pair = tcp_socket_t::make_socketpair(sockets);
+
+  std::pair<std::unique_ptr<tcp_connection_t>,
+            std::unique_ptr<tcp_connection_t>> result;
+  result.first.reset(new tcp_connection_t(std::move(sockets_pair.first)));
+  result.second.reset(new tcp_connection_t(std::move(sockets_pair.second)));
+
+  return result;
+}
+
 } // cuti
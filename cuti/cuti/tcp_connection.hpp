@@ -25,6 +25,9 @@
 #include "scheduler.hpp"
 #include "tcp_socket.hpp"
 
+#include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <iosfwd>
 #include <memory>
 #include <utility>
@@ -35,19 +38,41 @@ namespace cuti
 struct socket_layer_t;
 struct tcp_acceptor_t;
 
+enum class connect_mode_t { blocking, nonblocking };
+
 struct CUTI_ABI tcp_connection_t
 {
-  tcp_connection_t(socket_layer_t& sockets, endpoint_t const& peer);
+  /*
+   * Connects to peer.  In connect_mode_t::blocking, the constructor
+   * waits until the connection is established.
+   * In connect_mode_t::nonblocking, the constructor only starts
+   * connecting, and the connection starts out in non-blocking mode.
+   * Until the connection is established, write() and read() refuse
+   * to block; a failure to connect is reported by write() and read()
+   * as a broken connection.  The connection becomes writable when
+   * the connection attempt completes.
+   */
+  tcp_connection_t(socket_layer_t& sockets, endpoint_t const& peer,
+                   connect_mode_t mode = connect_mode_t::blocking);
 
   tcp_connection_t(tcp_connection_t const&) = delete;
   tcp_connection_t& operator=(tcp_connection_t const&) = delete;
 
+  ~tcp_connection_t();
+
   endpoint_t const& local_endpoint() const
   { return local_endpoint_; }
 
   endpoint_t const& remote_endpoint() const
   { return remote_endpoint_; }
 
+  /*
+   * Tells if a non-blocking connection attempt is still pending, as
+   * far as we know.
+   */
+  bool connecting() const
+  { return connecting_; }
+
   /*
    * In blocking mode, which is the default, I/O functions wait
    * until they can be completed.
@@ -67,6 +92,49 @@ struct CUTI_ABI tcp_connection_t
    */
   int write(char const* first, char const* last, char const*& next);
 
+  /*
+   * Zero-copy sending, which is disabled by default.  Returns true if
+   * zero-copy sending could be enabled; otherwise, write_zerocopy()
+   * simply copies.
+   */
+  bool enable_zerocopy() noexcept;
+
+  bool zerocopy_enabled() const noexcept
+  { return zerocopy_enabled_; }
+
+  /*
+   * Like write(), but if zero-copy sending is enabled, the range may
+   * be sent without copying.  The connection then keeps owner, which
+   * must keep the range unchanged, alive until the kernel no longer
+   * uses the range.  As pinning the memory costs more than copying
+   * small ranges, it is up to the caller to decide which ranges are
+   * worth it; see blob_writer_t::min_zerocopy_size.
+   * Completions are picked up by reap_zerocopy_completions(), which
+   * is called by any I/O call on the connection; the scheduler
+   * reports a pending completion as the connection being readable
+   * and writable.  If the connection is destroyed while zero-copy
+   * writes are pending, its socket and the owners are kept until the
+   * kernel has released these writes.
+   */
+  int write_zerocopy(char const* first, char const* last,
+                     char const*& next, std::shared_ptr<void const> owner);
+
+  /*
+   * Returns the number of zero-copy writes that the kernel has not
+   * yet released.
+   */
+  std::size_t pending_zerocopy_writes() noexcept
+  {
+    this->reap_zerocopy_completions();
+    return zerocopy_owners_.size();
+  }
+
+  /*
+   * Releases the owners of the zero-copy writes the kernel has
+   * completed.
+   */
+  void reap_zerocopy_completions() noexcept;
+
   /*
    * Closes the writing side of the connection, while leaving the
    * reading side open.  This should eventually result in an EOF at
@@ -86,6 +154,13 @@ struct CUTI_ABI tcp_connection_t
    */
   int read(char* first, char const* last, char*& next);
 
+  /*
+   * Checks, without consuming any input, that an idle connection is
+   * still usable; see tcp_socket_t::idle_and_alive().  A connection
+   * that is still being established is considered alive.
+   */
+  bool idle_and_alive();
+
   /*
    * Event reporting; see scheduler.hpp for detailed semantics.  A
    * callback can be canceled by calling cancel() directly on the
@@ -109,12 +184,24 @@ struct CUTI_ABI tcp_connection_t
 
 private :
   friend struct tcp_acceptor_t;
+  friend CUTI_ABI std::pair<std::unique_ptr<tcp_connection_t>,
+                            std::unique_ptr<tcp_connection_t>>
+  make_socketpair(socket_layer_t& sockets);
+
   explicit tcp_connection_t(tcp_socket_t&& socket);
 
+  bool connect_completed();
+
 private :
   tcp_socket_t socket_;
   endpoint_t local_endpoint_;
   endpoint_t remote_endpoint_;
+  bool connecting_;
+  int connect_error_;
+
+  bool zerocopy_enabled_;
+  std::uint32_t zerocopy_first_id_; // id of zerocopy_owners_.front()
+  std::deque<std::shared_ptr<void const>> zerocopy_owners_;
 };
 
 CUTI_ABI std::ostream& operator<<(std::ostream& os,
@@ -128,6 +215,15 @@ CUTI_ABI std::pair<std::unique_ptr<tcp_connection_t>,
                    std::unique_ptr<tcp_connection_t>>
 make_connected_pair(socket_layer_t& sockets);
 
+/*
+ * Returns a pair of connections over an unnamed unix domain socket
+ * pair, for peers living in the same process.  Throws if the
+ * platform does not support socketpair().
+ */
+CUTI_ABI std::pair<std::unique_ptr<tcp_connection_t>,
+                   std::unique_ptr<tcp_connection_t>>
+make_socketpair(socket_layer_t& sockets);
+
 } // cuti
 
 #endif
@@ -24,6 +24,7 @@
 #include "system_error.hpp"
 
 #include <cassert>
+#include <initializer_list>
 #include <limits>
 #include <string>
 #include <utility>
@@ -32,14 +33,28 @@
 #include <winsock2.h>
 #include <ws2tcpip.h>
 #else
+#include <cerrno>
 #include <fcntl.h>
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
 #endif
 
+#if defined(__linux__)
+#include <linux/errqueue.h>
+#endif
+
+#if defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY) && \
+    defined(SO_EE_ORIGIN_ZEROCOPY)
+#define CUTI_HAS_ZEROCOPY 1
+#else
+#undef  CUTI_HAS_ZEROCOPY
+#endif
+
 namespace cuti
 {
 
@@ -51,6 +66,9 @@ union sockaddr_buffer_t
   sockaddr addr_;
   sockaddr_in addr_in_;
   sockaddr_in6 addr_in6_;
+#ifndef _WIN32
+  sockaddr_un addr_un_;
+#endif
 };
 
 void set_v6only(socket_layer_t&, int fd, bool enable)
@@ -151,17 +169,99 @@ void set_nosigpipe(socket_layer_t&, int fd, bool enable)
 
 #endif // SO_NOSIGPIPE
 
-void set_initial_connection_flags(socket_layer_t& sockets, int fd)
+#ifdef SO_REUSEPORT
+
+void set_reuseport(socket_layer_t&, int fd, bool enable)
+{
+  const int optval = enable;
+  int r = ::setsockopt(fd, SOL_SOCKET, SO_REUSEPORT,
+                       reinterpret_cast<const char *>(&optval), sizeof optval);
+  if(r == -1)
+  {
+    int cause = last_system_error();
+    system_exception_builder_t builder;
+    builder << "Error setting SO_REUSEPORT: " << error_status_t(cause);
+    builder.explode();
+  }
+}
+
+#endif // SO_REUSEPORT
+
+bool is_connect_in_progress(socket_layer_t&, int error)
+{
+#ifdef _WIN32
+  return error == WSAEWOULDBLOCK;
+#else
+  return error == EINPROGRESS;
+#endif
+}
+
+bool is_not_connected(socket_layer_t&, int error)
+{
+#ifdef _WIN32
+  return error == WSAENOTCONN;
+#else
+  return error == ENOTCONN;
+#endif
+}
+
+void set_initial_connection_flags(socket_layer_t& sockets, int fd,
+                                  int family)
 {
   set_nonblocking(sockets, fd, false);
-  set_nodelay(sockets, fd, true);
-  set_keepalive(sockets, fd, true);
+
+  // Nagle and keepalive probes are TCP-only
+  if(family != AF_UNIX)
+  {
+    set_nodelay(sockets, fd, true);
+    set_keepalive(sockets, fd, true);
+  }
 
 #if defined(SO_NOSIGPIPE)
   set_nosigpipe(sockets, fd, true);
 #endif
 }
 
+#ifndef _WIN32
+
+/*
+ * The path of a unix domain socket outlives its listener.  If path
+ * names a socket that nobody listens on anymore, removes it and
+ * returns true; otherwise, returns false.
+ */
+bool remove_stale_socket(socket_layer_t&, endpoint_t const& endpoint)
+{
+  assert(endpoint.is_unix());
+
+  struct stat st;
+  if(::lstat(endpoint.unix_path().c_str(), &st) == -1 ||
+     !S_ISSOCK(st.st_mode))
+  {
+    return false;
+  }
+
+#if defined(SOCK_CLOEXEC)
+  int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+#else
+  int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+#endif
+  if(fd == -1)
+  {
+    return false;
+  }
+
+  int r = ::connect(fd,
+                    &endpoint.socket_address(),
+                    endpoint.socket_address_size());
+  int cause = r == -1 ? last_system_error() : 0;
+  ::close(fd);
+
+  return cause == ECONNREFUSED &&
+    ::unlink(endpoint.unix_path().c_str()) != -1;
+}
+
+#endif // !_WIN32
+
 } // anonymous
 
 tcp_socket_t::tcp_socket_t(socket_layer_t& sockets, int family)
@@ -182,12 +282,57 @@ tcp_socket_t::tcp_socket_t(socket_layer_t& sockets, int family)
   }
 
   sockets_ = &sockets;
+  family_ = family;
 
 #if !defined(_WIN32) && !defined(SOCK_CLOEXEC)
   set_cloexec(*sockets_, fd_, true);
 #endif
 }
 
+std::pair<tcp_socket_t, tcp_socket_t>
+tcp_socket_t::make_socketpair(socket_layer_t& sockets)
+{
+  std::pair<tcp_socket_t, tcp_socket_t> result;
+
+#ifdef _WIN32
+  system_exception_builder_t builder;
+  builder << "socketpair() is not supported on this platform";
+  builder.explode();
+#else
+  int fds[2];
+#if defined(SOCK_CLOEXEC)
+  int r = ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds);
+#else
+  int r = ::socketpair(AF_UNIX, SOCK_STREAM, 0, fds);
+#endif
+
+  if(r == -1)
+  {
+    int cause = last_system_error();
+    system_exception_builder_t builder;
+    builder << "Can\'t create socket pair: " << error_status_t(cause);
+    builder.explode();
+  }
+
+  result.first.sockets_ = &sockets;
+  result.first.fd_ = fds[0];
+  result.first.family_ = AF_UNIX;
+  result.second.sockets_ = &sockets;
+  result.second.fd_ = fds[1];
+  result.second.family_ = AF_UNIX;
+
+  for(tcp_socket_t* socket : { &result.first, &result.second })
+  {
+#if !defined(SOCK_CLOEXEC)
+    set_cloexec(sockets, socket->fd_, true);
+#endif
+    set_initial_connection_flags(sockets, socket->fd_, AF_UNIX);
+  }
+#endif
+
+  return result;
+}
+
 void tcp_socket_t::bind(endpoint_t const& endpoint)
 {
   assert(!empty());
@@ -204,9 +349,21 @@ void tcp_socket_t::bind(endpoint_t const& endpoint)
   int r = ::bind(fd_,
                  &endpoint.socket_address(),
                  endpoint.socket_address_size());
+  int cause = r == -1 ? last_system_error() : 0;
+
+#ifndef _WIN32
+  if(cause == EADDRINUSE && endpoint.is_unix() &&
+     remove_stale_socket(*sockets_, endpoint))
+  {
+    r = ::bind(fd_,
+               &endpoint.socket_address(),
+               endpoint.socket_address_size());
+    cause = r == -1 ? last_system_error() : 0;
+  }
+#endif
+
   if(r == -1)
   {
-    int cause = last_system_error();
     system_exception_builder_t builder;
     builder << "Can\'t bind to endpoint " << endpoint << ": " <<
       error_status_t(cause);
@@ -214,6 +371,19 @@ void tcp_socket_t::bind(endpoint_t const& endpoint)
   }
 }
 
+void tcp_socket_t::set_reuse_port()
+{
+  assert(!empty());
+
+#ifdef SO_REUSEPORT
+  set_reuseport(*sockets_, fd_, true);
+#else
+  system_exception_builder_t builder;
+  builder << "SO_REUSEPORT is not supported on this platform";
+  builder.explode();
+#endif
+}
+
 void tcp_socket_t::listen()
 {
   assert(!empty());
@@ -242,7 +412,73 @@ void tcp_socket_t::connect(endpoint_t const& peer)
     builder.explode();
   }
 
-  set_initial_connection_flags(*sockets_, fd_);
+  set_initial_connection_flags(*sockets_, fd_, peer.address_family());
+}
+
+void tcp_socket_t::start_connect(endpoint_t const& peer)
+{
+  assert(!empty());
+
+  set_initial_connection_flags(*sockets_, fd_, peer.address_family());
+  cuti::set_nonblocking(*sockets_, fd_, true);
+
+  int r = ::connect(fd_, &peer.socket_address(), peer.socket_address_size());
+  if(r == -1)
+  {
+    int cause = last_system_error();
+    if(!is_connect_in_progress(*sockets_, cause))
+    {
+      system_exception_builder_t builder;
+      builder << "Can\'t connect to endpoint " << peer << ": " <<
+        error_status_t(cause);
+      builder.explode();
+    }
+  }
+}
+
+int tcp_socket_t::check_connect(bool& done)
+{
+  assert(!empty());
+
+  int error = 0;
+  socklen_t error_size = static_cast<socklen_t>(sizeof error);
+
+  int r = ::getsockopt(fd_, SOL_SOCKET, SO_ERROR,
+                       reinterpret_cast<char*>(&error), &error_size);
+  if(r == -1)
+  {
+    int cause = last_system_error();
+    system_exception_builder_t builder;
+    builder << "Error getting SO_ERROR: " << error_status_t(cause);
+    builder.explode();
+  }
+
+  if(error != 0)
+  {
+    done = true;
+    return error;
+  }
+
+  // No pending error: we're connected once we have a peer
+  sockaddr_buffer_t buffer;
+  socklen_t size = static_cast<socklen_t>(sizeof buffer);
+
+  r = ::getpeername(fd_, &buffer.addr_, &size);
+  if(r == -1)
+  {
+    int cause = last_system_error();
+    if(!is_not_connected(*sockets_, cause))
+    {
+      system_exception_builder_t builder;
+      builder << "getpeername() failure: " << error_status_t(cause);
+      builder.explode();
+    }
+    done = false;
+    return 0;
+  }
+
+  done = true;
+  return 0;
 }
 
 endpoint_t tcp_socket_t::local_endpoint() const
@@ -327,11 +563,13 @@ int tcp_socket_t::accept(tcp_socket_t& accepted)
   else
   {
     tmp_socket.sockets_ = this->sockets_;
+    tmp_socket.family_ = this->family_;
 
 #if !defined(_WIN32) && !defined(SOCK_CLOEXEC)
     set_cloexec(*tmp_socket.sockets_, tmp_socket.fd_, true);
 #endif
-    set_initial_connection_flags(*tmp_socket.sockets_, tmp_socket.fd_);
+    set_initial_connection_flags(*tmp_socket.sockets_, tmp_socket.fd_,
+      tmp_socket.family_);
   }
 
   tmp_socket.swap(accepted);
@@ -339,23 +577,101 @@ int tcp_socket_t::accept(tcp_socket_t& accepted)
 }
 
 int tcp_socket_t::write(char const* first, char const* last, char const*& next)
+{
+  bool pinned;
+  return this->send(first, last, next, pinned, false);
+}
+
+bool tcp_socket_t::enable_zerocopy() noexcept
 {
   assert(!empty());
-  assert(first < last);
 
-  int count = std::numeric_limits<int>::max();
-  if(count > last - first)
+#if defined(CUTI_HAS_ZEROCOPY)
+  int const optval = 1;
+  return ::setsockopt(fd_, SOL_SOCKET, SO_ZEROCOPY,
+                      &optval, sizeof optval) != -1;
+#else
+  return false;
+#endif
+}
+
+int tcp_socket_t::write_zerocopy(char const* first, char const* last,
+                                 char const*& next, bool& pinned)
+{
+  return this->send(first, last, next, pinned, true);
+}
+
+bool tcp_socket_t::read_zerocopy_completion(std::uint32_t& first_id,
+                                            std::uint32_t& last_id) noexcept
+{
+  assert(!empty());
+
+#if defined(CUTI_HAS_ZEROCOPY)
+  char control[128];
+  msghdr msg{};
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof control;
+
+  while(::recvmsg(fd_, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) != -1)
   {
-    count = static_cast<int>(last - first);
+    for(cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg != nullptr;
+        cmsg = CMSG_NXTHDR(&msg, cmsg))
+    {
+      if((cmsg->cmsg_level != SOL_IP || cmsg->cmsg_type != IP_RECVERR) &&
+         (cmsg->cmsg_level != SOL_IPV6 || cmsg->cmsg_type != IPV6_RECVERR))
+      {
+        continue;
+      }
+
+      auto const* err =
+        reinterpret_cast<sock_extended_err const*>(CMSG_DATA(cmsg));
+      if(err->ee_errno == 0 && err->ee_origin == SO_EE_ORIGIN_ZEROCOPY)
+      {
+        first_id = err->ee_info;
+        last_id = err->ee_data;
+        return true;
+      }
+    }
+
+    // not a zero-copy completion: skip
+    msg.msg_controllen = sizeof control;
   }
+#endif
+
+  return false;
+}
 
+int tcp_socket_t::close_write_end() noexcept
+{
   int result = 0;
 
-#if defined(_WIN32) || defined(SO_NOSIGPIPE)
-  auto n = ::send(fd_, first, count, 0);
+#ifdef _WIN32
+  int r = ::shutdown(fd_, SD_SEND);
 #else
-  auto n = ::send(fd_, first, count, MSG_NOSIGNAL);
+  int r = ::shutdown(fd_, SHUT_WR);
 #endif
+  if(r == -1)
+  {
+    result = last_system_error();
+  }
+
+  return result;
+}
+
+int tcp_socket_t::read(char* first, char const* last, char*& next)
+{
+  assert(!empty());
+  assert(first < last);
+
+  int count = std::numeric_limits<int>::max();
+  if(count > last - first)
+  {
+    count = static_cast<int>(last - first);
+  }
+
+  auto result = 0;
+  auto n = ::recv(fd_, first, count, 0);
 
   if(n == -1)
   {
@@ -367,41 +683,45 @@ int tcp_socket_t::write(char const* first, char const* last, char const*& next)
     else if(is_fatal_io_error(*sockets_, cause))
     {
       system_exception_builder_t builder;
-      builder << "send() failure: " << error_status_t(cause);
+      builder << "recv() failure: " << error_status_t(cause);
       builder.explode();
     }
     else
     {
       result = cause;
-      next = last;
+      next = first;
     }
   }
   else
   {
-    next = first + n;
+     next = first + n;
   }
 
   return result;
 }
 
-int tcp_socket_t::close_write_end() noexcept
+bool tcp_socket_t::idle_and_alive()
 {
-  int result = 0;
+  assert(!empty());
 
-#ifdef _WIN32
-  int r = ::shutdown(fd_, SD_SEND);
-#else
-  int r = ::shutdown(fd_, SHUT_WR);
+  int flags = MSG_PEEK;
+#ifdef MSG_DONTWAIT
+  flags |= MSG_DONTWAIT;
 #endif
-  if(r == -1)
+
+  char c;
+  auto n = ::recv(fd_, &c, 1, flags);
+  if(n == -1)
   {
-    result = last_system_error();
+    return is_wouldblock(*sockets_, last_system_error());
   }
 
-  return result;
+  // EOF or unsolicited data
+  return false;
 }
 
-int tcp_socket_t::read(char* first, char const* last, char*& next)
+int tcp_socket_t::send(char const* first, char const* last,
+                       char const*& next, bool& pinned, bool zerocopy)
 {
   assert(!empty());
   assert(first < last);
@@ -412,8 +732,28 @@ int tcp_socket_t::read(char* first, char const* last, char*& next)
     count = static_cast<int>(last - first);
   }
 
-  auto result = 0;
-  auto n = ::recv(fd_, first, count, 0);
+  int result = 0;
+
+#if defined(_WIN32) || defined(SO_NOSIGPIPE)
+  int flags = 0;
+#else
+  int flags = MSG_NOSIGNAL;
+#endif
+
+#if defined(CUTI_HAS_ZEROCOPY)
+  auto n = ::send(fd_, first, count, zerocopy ? flags | MSG_ZEROCOPY : flags);
+  if(n == -1 && zerocopy && last_system_error() == ENOBUFS)
+  {
+    // out of memory for zero-copy completions: copy this time
+    zerocopy = false;
+    n = ::send(fd_, first, count, flags);
+  }
+  pinned = zerocopy && n > 0;
+#else
+  static_cast<void>(zerocopy);
+  pinned = false;
+  auto n = ::send(fd_, first, count, flags);
+#endif
 
   if(n == -1)
   {
@@ -425,18 +765,18 @@ int tcp_socket_t::read(char* first, char const* last, char*& next)
     else if(is_fatal_io_error(*sockets_, cause))
     {
       system_exception_builder_t builder;
-      builder << "recv() failure: " << error_status_t(cause);
+      builder << "send() failure: " << error_status_t(cause);
       builder.explode();
     }
     else
     {
       result = cause;
-      next = first;
+      next = last;
     }
   }
   else
   {
-     next = first + n;
+    next = first + n;
   }
 
   return result;
@@ -24,6 +24,7 @@
 #include "linkage.h"
 #include "scheduler.hpp"
 
+#include <cstdint>
 #include <memory>
 #include <utility>
 
@@ -33,7 +34,8 @@ namespace cuti
 struct socket_layer_t;
 
 /*
- * Low-level interface for TCP sockets.
+ * Low-level interface for TCP sockets, which also handles unix
+ * domain stream sockets.
  *
  * tcp_socket_t is a move-only type; its instances may be empty(),
  * that is, not holding an open file descriptor. Only re-assignment
@@ -44,16 +46,25 @@ struct CUTI_ABI tcp_socket_t
   tcp_socket_t() noexcept
   : sockets_(nullptr)
   , fd_(-1)
+  , family_(0)
   { }
 
   tcp_socket_t(socket_layer_t& sockets, int family);
 
+  /*
+   * Returns a pair of connected, unnamed unix domain sockets.  Throws
+   * if the platform does not support socketpair().
+   */
+  static std::pair<tcp_socket_t, tcp_socket_t>
+  make_socketpair(socket_layer_t& sockets);
+
   tcp_socket_t(tcp_socket_t const&) = delete;
   tcp_socket_t& operator=(tcp_socket_t const&) = delete;
 
   tcp_socket_t(tcp_socket_t&& rhs) noexcept
   : sockets_(rhs.sockets_)
   , fd_(rhs.fd_)
+  , family_(rhs.family_)
   {
     rhs.sockets_ = nullptr;
     rhs.fd_ = -1;
@@ -74,6 +85,7 @@ struct CUTI_ABI tcp_socket_t
     using std::swap;
     swap(this->sockets_, that.sockets_);
     swap(this->fd_, that.fd_);
+    swap(this->family_, that.family_);
   }
 
   ~tcp_socket_t()
@@ -85,12 +97,39 @@ struct CUTI_ABI tcp_socket_t
   }
 
   /*
-   * Socket setup
+   * Socket setup.  If a unix domain endpoint's path names a socket
+   * that nobody listens on anymore, bind() replaces it.
    */
   void bind(endpoint_t const& endpoint);
   void listen();
+
+  /*
+   * Allows other sockets that enable this option as well to bind to
+   * the same endpoint; the kernel then spreads incoming connections
+   * over their listen queues.  Must be called before bind().  Throws
+   * if the platform does not support SO_REUSEPORT.
+   */
+  void set_reuse_port();
   void connect(endpoint_t const& peer);
 
+  /*
+   * Starts connecting to peer without waiting for the connection to
+   * be established, leaving the socket in non-blocking mode.  The
+   * socket becomes writable when the connection attempt completes;
+   * use check_connect() to obtain its outcome.
+   * Throws if the attempt fails immediately.
+   */
+  void start_connect(endpoint_t const& peer);
+
+  /*
+   * Checks on a connection attempt started by start_connect().  Sets
+   * done to false if the attempt is still in progress.  Otherwise,
+   * sets done to true and returns 0 if the connection was
+   * established, or a system error code if it failed; the error code
+   * is only reported once.
+   */
+  int check_connect(bool& done);
+
   endpoint_t local_endpoint() const;
   endpoint_t remote_endpoint() const;
 
@@ -124,6 +163,30 @@ struct CUTI_ABI tcp_socket_t
    */
   int write(char const* first, char const* last, char const*& next);
 
+  /*
+   * Zero-copy sending.  enable_zerocopy() returns true if the
+   * platform supports zero-copy sends on this socket, and false
+   * otherwise.
+   * write_zerocopy() works like write(), except that the kernel may
+   * send directly from [first, last>.  If it does, pinned is set to
+   * true, and the range must remain unchanged until
+   * read_zerocopy_completion() reports the call's id; ids are
+   * assigned to these calls in order, counting from 0.  Otherwise,
+   * pinned is set to false.
+   */
+  bool enable_zerocopy() noexcept;
+  int write_zerocopy(char const* first, char const* last,
+                     char const*& next, bool& pinned);
+
+  /*
+   * Tries to read a zero-copy completion from the socket's error
+   * queue, without blocking.  Returns false if there is none;
+   * otherwise, sets [first_id, last_id] to the (inclusive, possibly
+   * wrapping) range of ids of the completed write_zerocopy() calls.
+   */
+  bool read_zerocopy_completion(std::uint32_t& first_id,
+                                std::uint32_t& last_id) noexcept;
+
   /*
    * Closes the writing side of the connection, while leaving the
    * reading side open.  This should eventually result in an EOF at
@@ -143,6 +206,13 @@ struct CUTI_ABI tcp_socket_t
    */
   int read(char* first, char const* last, char*& next);
 
+  /*
+   * Checks, without blocking or consuming any input, that an idle
+   * connection is still usable: returns false if the peer has closed
+   * or reset the connection, or has sent unsolicited data.
+   */
+  bool idle_and_alive();
+
   /*
    * Event reporting; see scheduler.hpp for detailed semantics.  A
    * callback can be canceled by calling cancel() directly on the
@@ -167,11 +237,14 @@ struct CUTI_ABI tcp_socket_t
   }
 
 private :
+  int send(char const* first, char const* last, char const*& next,
+           bool& pinned, bool zerocopy);
   static void close_fd(socket_layer_t&, int fd) noexcept;
 
 private :
   socket_layer_t* sockets_;
   int fd_;
+  int family_; // accepted sockets inherit the listener's family
 };
 
 CUTI_ABI
@@ -0,0 +1,325 @@
+/*
+ * Copyright (C) 2026 CodeShop B.V.
+ *
+ * This file is part of the cuti library.
+ *
+ * The cuti library is free software: you can redistribute it and/or
+ * modify it under the terms of version 2.1 of the GNU Lesser General
+ * Public License as published by the Free Software Foundation.
+ *
+ * The cuti library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See version
+ * 2.1 of the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of version 2.1 of the GNU Lesser
+ * General Public License along with the cuti library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef CUTI_TIMER_WHEEL_HPP_
+#define CUTI_TIMER_WHEEL_HPP_
+
+#include "chrono_types.hpp"
+#include "list_arena.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+namespace cuti
+{
+
+/*
+ * timer_wheel_t is a hierarchical timer wheel holding timers with a
+ * Value each.  Unlike an indexed_heap_t, it adds and removes timers
+ * in constant time, at the price of precision: a timer expires up to
+ * one resolution after its due time, but never before.
+ *
+ * The wheel has n_levels levels of n_slots slots each; a slot on level
+ * n spans n_slots ** n ticks of the resolution.  Timers due beyond the
+ * top level's range are parked in its last slot, and placed again when
+ * that slot is reached.
+ *
+ * Timers are identified by stable, small non-negative integer ids.
+ * Time only moves forward when advance() is called: timers found to
+ * be due are then moved to the wheel's list of expired timers.
+ */
+template<typename Value>
+struct timer_wheel_t
+{
+  static int constexpr slot_bits = 6;
+  static int constexpr n_slots = 1 << slot_bits;
+  static int constexpr n_levels = 4;
+
+  static duration_t constexpr default_resolution = milliseconds_t(4);
+
+  /*
+   * Constructs an empty wheel whose ticks start at origin.
+   */
+  explicit timer_wheel_t(time_point_t origin,
+                         duration_t resolution = default_resolution)
+  : origin_(origin)
+  , resolution_((assert(resolution > duration_t::zero()), resolution))
+  , arena_()
+  , slots_()
+  , expired_list_(-1)
+  , current_tick_(0)
+  , next_check_tick_(no_tick)
+  , n_timers_(0)
+  {
+    for(auto& level : slots_)
+    {
+      for(int& slot : level)
+      {
+        slot = arena_.add_list();
+      }
+    }
+    expired_list_ = arena_.add_list();
+  }
+
+  timer_wheel_t(timer_wheel_t const&) = delete;
+  timer_wheel_t& operator=(timer_wheel_t const&) = delete;
+
+  /*
+   * Tells if the wheel holds no timers, expired or not.
+   */
+  bool empty() const noexcept
+  {
+    return n_timers_ == 0;
+  }
+
+  /*
+   * Tells if the wheel holds any expired timers.
+   */
+  bool has_expired() const noexcept
+  {
+    return !arena_.list_empty(expired_list_);
+  }
+
+  /*
+   * Returns the id of the timer that expired first; has_expired()
+   * must be true.
+   */
+  int first_expired() const noexcept
+  {
+    assert(this->has_expired());
+    return arena_.first(expired_list_);
+  }
+
+  /*
+   * Returns the earliest time at which advance() may find timers to
+   * expire, or time_point_t::max() if no timers are pending.
+   */
+  time_point_t next_check() const noexcept
+  {
+    if(next_check_tick_ == no_tick)
+    {
+      return time_point_t::max();
+    }
+    return origin_ + next_check_tick_ * resolution_;
+  }
+
+  /*
+   * Adds a timer due at <when>, returning its id.  A timer due at or
+   * before the current tick is expired right away.
+   */
+  int add_timer(time_point_t when, Value value)
+  {
+    int id = arena_.add_element_before(arena_.last(expired_list_),
+      this->tick_at_or_after(when), std::move(value));
+    ++n_timers_;
+    this->place(id);
+    return id;
+  }
+
+  /*
+   * Removes the timer <id>, expired or not.
+   */
+  void remove_timer(int id) noexcept
+  {
+    arena_.remove_element(id);
+    --n_timers_;
+  }
+
+  /*
+   * Returns the time at which timer <id> is due, rounded up to the
+   * wheel's resolution.
+   */
+  time_point_t due_time(int id) const noexcept
+  {
+    return origin_ + arena_.value(id).tick_ * resolution_;
+  }
+
+  /*
+   * Returns a reference to the value of timer <id>.  The next call to
+   * add_timer() invalidates this reference.
+   */
+  Value& value(int id) noexcept
+  {
+    return arena_.value(id).value_;
+  }
+
+  Value const& value(int id) const noexcept
+  {
+    return arena_.value(id).value_;
+  }
+
+  /*
+   * Moves time forward to <now>, expiring the timers that are due.
+   */
+  void advance(time_point_t now)
+  {
+    if(now < origin_)
+    {
+      return;
+    }
+
+    int64_t now_tick = (now - origin_) / resolution_;
+    while(next_check_tick_ <= now_tick)
+    {
+      // the ticks up to next_check_tick_ have nothing to do
+      current_tick_ = next_check_tick_;
+      this->process_tick();
+      this->update_next_check();
+    }
+
+    if(current_tick_ < now_tick)
+    {
+      current_tick_ = now_tick;
+    }
+  }
+
+private :
+  struct entry_t
+  {
+    entry_t(int64_t tick, Value value)
+    : tick_(tick)
+    , value_(std::move(value))
+    { }
+
+    int64_t tick_;
+    Value value_;
+  };
+
+  static int64_t constexpr no_tick = std::numeric_limits<int64_t>::max();
+
+  static int64_t level_span(int level) noexcept
+  {
+    return int64_t(1) << (slot_bits * (level + 1));
+  }
+
+  int64_t tick_at_or_after(time_point_t when) const noexcept
+  {
+    if(when <= origin_)
+    {
+      return 0;
+    }
+
+    // round up: timers never expire early
+    auto count = (when - origin_).count();
+    auto resolution = resolution_.count();
+    return (count + resolution - 1) / resolution;
+  }
+
+  /*
+   * Moves timer <id> to the slot for its tick, or to the expired list
+   * if it is due.
+   */
+  void place(int id) noexcept
+  {
+    int64_t tick = arena_.value(id).tick_;
+    if(tick <= current_tick_)
+    {
+      arena_.move_element_before(arena_.last(expired_list_), id);
+      return;
+    }
+
+    int64_t delta = tick - current_tick_;
+    int level = 0;
+    while(level != n_levels - 1 && delta >= level_span(level))
+    {
+      ++level;
+    }
+    if(delta >= level_span(level))
+    {
+      // park in the top level's last slot
+      tick = current_tick_ + level_span(level) - 1;
+    }
+
+    int shift = slot_bits * level;
+    int slot = slots_[level][(tick >> shift) & (n_slots - 1)];
+    arena_.move_element_before(arena_.last(slot), id);
+
+    // the slot is visited at the start of its range
+    int64_t check_tick = (tick >> shift) << shift;
+    if(check_tick < next_check_tick_)
+    {
+      next_check_tick_ = check_tick;
+    }
+  }
+
+  void process_tick() noexcept
+  {
+    // cascade the higher levels' slots starting at this tick
+    for(int level = n_levels - 1; level != 0; --level)
+    {
+      int shift = slot_bits * level;
+      if((current_tick_ & ((int64_t(1) << shift) - 1)) == 0)
+      {
+        int slot = slots_[level][(current_tick_ >> shift) & (n_slots - 1)];
+        while(!arena_.list_empty(slot))
+        {
+          this->place(arena_.first(slot));
+        }
+      }
+    }
+
+    int slot = slots_[0][current_tick_ & (n_slots - 1)];
+    while(!arena_.list_empty(slot))
+    {
+      assert(arena_.value(arena_.first(slot)).tick_ == current_tick_);
+      arena_.move_element_before(arena_.last(expired_list_),
+        arena_.first(slot));
+    }
+  }
+
+  void update_next_check() noexcept
+  {
+    next_check_tick_ = no_tick;
+    for(int level = 0; level != n_levels; ++level)
+    {
+      int shift = slot_bits * level;
+      int64_t block = current_tick_ >> shift;
+      for(int i = 1; i <= n_slots; ++i)
+      {
+        int64_t check_tick = (block + i) << shift;
+        if(check_tick >= next_check_tick_)
+        {
+          break;
+        }
+        if(!arena_.list_empty(slots_[level][(block + i) & (n_slots - 1)]))
+        {
+          next_check_tick_ = check_tick;
+          break;
+        }
+      }
+    }
+  }
+
+private :
+  time_point_t origin_;
+  duration_t resolution_;
+  list_arena_t<entry_t> arena_;
+  int slots_[n_levels][n_slots];
+  int expired_list_;
+  int64_t current_tick_;
+  int64_t next_check_tick_; // no pending timers are visited before it
+  int n_timers_;
+};
+
+} // cuti
+
+#endif
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2026 CodeShop B.V.
+ *
+ * This file is part of the cuti library.
+ *
+ * The cuti library is free software: you can redistribute it and/or
+ * modify it under the terms of version 2.1 of the GNU Lesser General
+ * Public License as published by the Free Software Foundation.
+ *
+ * The cuti library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See version
+ * 2.1 of the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of version 2.1 of the GNU Lesser
+ * General Public License along with the cuti library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "wakeup_pipe.hpp"
+
+#include "scheduler.hpp"
+#include "stack_marker.hpp"
+
+#include <cassert>
+#include <optional>
+#include <tuple>
+#include <utility>
+
+namespace cuti
+{
+
+wakeup_pipe_t::wakeup_pipe_t(socket_layer_t& sockets)
+: reader_(nullptr)
+, writer_(nullptr)
+, scheduler_(nullptr)
+, ticket_()
+, callback_(nullptr)
+{
+  std::tie(reader_, writer_) = make_event_pipe(sockets);
+  reader_->set_nonblocking();
+  writer_->set_nonblocking();
+}
+
+void wakeup_pipe_t::wakeup() noexcept
+{
+  // a full pipe is fine: a wakeup is pending anyway
+  writer_->write(0);
+}
+
+void wakeup_pipe_t::call_on_wakeup(scheduler_t& scheduler,
+                                   callback_t callback)
+{
+  assert(callback != nullptr);
+
+  this->cancel_on_wakeup();
+
+  ticket_ = reader_->call_when_readable(scheduler,
+    [this](stack_marker_t& base_marker) { this->on_readable(base_marker); });
+  scheduler_ = &scheduler;
+  callback_ = std::move(callback);
+}
+
+void wakeup_pipe_t::cancel_on_wakeup() noexcept
+{
+  if(!ticket_.empty())
+  {
+    assert(scheduler_ != nullptr);
+    scheduler_->cancel(ticket_);
+    ticket_.clear();
+    scheduler_ = nullptr;
+    callback_ = nullptr;
+  }
+}
+
+wakeup_pipe_t::~wakeup_pipe_t()
+{
+  this->cancel_on_wakeup();
+}
+
+void wakeup_pipe_t::on_readable(stack_marker_t& base_marker)
+{
+  ticket_.clear();
+  scheduler_ = nullptr;
+  callback_t callback = std::move(callback_);
+  callback_ = nullptr;
+
+  // consume the wakeups before the callback inspects any state
+  while(reader_->read() != std::nullopt)
+    ;
+
+  callback(base_marker);
+}
+
+} // cuti
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2026 CodeShop B.V.
+ *
+ * This file is part of the cuti library.
+ *
+ * The cuti library is free software: you can redistribute it and/or
+ * modify it under the terms of version 2.1 of the GNU Lesser General
+ * Public License as published by the Free Software Foundation.
+ *
+ * The cuti library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See version
+ * 2.1 of the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of version 2.1 of the GNU Lesser
+ * General Public License along with the cuti library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CUTI_WAKEUP_PIPE_HPP_
+#define CUTI_WAKEUP_PIPE_HPP_
+
+#include "callback.hpp"
+#include "cancellation_ticket.hpp"
+#include "event_pipe.hpp"
+#include "linkage.h"
+
+#include <memory>
+
+namespace cuti
+{
+
+struct scheduler_t;
+struct socket_layer_t;
+
+/*
+ * Lets any thread wake up a callback on a scheduler thread, for
+ * handing over results computed on a helper thread.
+ *
+ * Wakeups are coalesced: any number of wakeups before the callback
+ * runs result in a single invocation, and a wakeup without a pending
+ * callback triggers the next one scheduled.  Callbacks should
+ * therefore (re)inspect the state they are interested in; wakeups
+ * can be spurious.
+ */
+struct CUTI_ABI wakeup_pipe_t
+{
+  explicit wakeup_pipe_t(socket_layer_t& sockets);
+
+  wakeup_pipe_t(wakeup_pipe_t const&) = delete;
+  wakeup_pipe_t& operator=(wakeup_pipe_t const&) = delete;
+
+  /*
+   * Wakes up the scheduler thread; never blocks.  This function is
+   * thread-safe.
+   */
+  void wakeup() noexcept;
+
+  /*
+   * Schedules a one-time callback for the next wakeup, canceling
+   * any previously requested callback.  Pending wakeups are
+   * consumed before the callback is invoked.  The scheduler must
+   * remain alive while the callback is pending.
+   */
+  void call_on_wakeup(scheduler_t& scheduler, callback_t callback);
+
+  /*
+   * Cancels any pending callback; no effect if there is no pending
+   * callback.
+   */
+  void cancel_on_wakeup() noexcept;
+
+  ~wakeup_pipe_t();
+
+private :
+  void on_readable(stack_marker_t& base_marker);
+
+private :
+  std::unique_ptr<event_pipe_reader_t> reader_;
+  std::unique_ptr<event_pipe_writer_t> writer_;
+  scheduler_t* scheduler_;
+  cancellation_ticket_t ticket_;
+  callback_t callback_;
+};
+
+} // cuti
+
+#endif
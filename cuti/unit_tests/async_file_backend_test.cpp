@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2026 CodeShop B.V.
+ *
+ * This file is part of the cuti library.
+ *
+ * The cuti library is free software: you can redistribute it and/or
+ * modify it under the terms of version 2.1 of the GNU Lesser General
+ * Public License as published by the Free Software Foundation.
+ *
+ * The cuti library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See version
+ * 2.1 of the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of version 2.1 of the GNU Lesser
+ * General Public License along with the cuti library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <cuti/async_file_backend.hpp>
+#include <cuti/fs_utils.hpp>
+
+#include <cstddef>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+// Enable assert
+#undef NDEBUG
+#include <cassert>
+
+namespace // anonymous
+{
+
+using namespace cuti;
+
+char const logfile_name[] = "async_file_backend_test.log";
+
+void delete_logfiles(std::string const& path, unsigned int rotation_depth)
+{
+  delete_if_exists(path.c_str());
+  for(unsigned int i = 1; i <= rotation_depth; ++i)
+  {
+    delete_if_exists((path + "." + std::to_string(i)).c_str());
+  }
+}
+
+std::size_t count_lines(std::string const& path, std::string const& needle)
+{
+  std::ifstream is(path);
+  assert(is);
+
+  std::size_t result = 0;
+  std::string line;
+  while(std::getline(is, line))
+  {
+    if(line.find(needle) != std::string::npos)
+    {
+      ++result;
+    }
+  }
+  return result;
+}
+
+void report(async_file_backend_t& backend,
+            loglevel_t level, std::string const& msg)
+{
+  backend.report(level, msg.data(), msg.data() + msg.size());
+}
+
+void all_entries_written()
+{
+  absolute_path_t path(logfile_name);
+  delete_logfiles(path.value(), 0);
+
+  {
+    async_file_backend_t backend(path);
+    for(int i = 0; i != 100; ++i)
+    {
+      report(backend, loglevel_t::info, "message " + std::to_string(i));
+    }
+    assert(backend.n_dropped() == 0);
+  }
+
+  assert(count_lines(path.value(), "message ") == 100);
+  assert(count_lines(path.value(), "message 99") == 1);
+
+  delete_logfiles(path.value(), 0);
+}
+
+void full_ring()
+{
+  absolute_path_t path(logfile_name);
+  delete_logfiles(path.value(), 0);
+
+  std::size_t n_dropped;
+  {
+    async_file_backend_t backend(path,
+      async_file_backend_t::no_size_limit,
+      async_file_backend_t::default_rotation_depth,
+      256);
+    for(int i = 0; i != 1000; ++i)
+    {
+      report(backend, loglevel_t::info, "message " + std::to_string(i));
+      if(i % 100 == 0)
+      {
+        report(backend, loglevel_t::error, "error " + std::to_string(i));
+      }
+    }
+    n_dropped = backend.n_dropped();
+  }
+
+  // errors are never dropped
+  assert(count_lines(path.value(), "message ") == 1000 - n_dropped);
+  assert(count_lines(path.value(), "error ") == 10);
+
+  delete_logfiles(path.value(), 0);
+}
+
+void oversized_entry()
+{
+  absolute_path_t path(logfile_name);
+  delete_logfiles(path.value(), 0);
+
+  {
+    async_file_backend_t backend(path,
+      async_file_backend_t::no_size_limit,
+      async_file_backend_t::default_rotation_depth,
+      64);
+    report(backend, loglevel_t::error, std::string(200, 'x'));
+    report(backend, loglevel_t::error, "next");
+  }
+
+  std::ifstream is(path.value());
+  std::string line;
+  assert(std::getline(is, line));
+  assert(line.size() == 63);
+  assert(std::getline(is, line));
+  assert(line.find("next") != std::string::npos);
+
+  delete_logfiles(path.value(), 0);
+}
+
+void rotation()
+{
+  absolute_path_t path(logfile_name);
+  unsigned int const rotation_depth = 2;
+  delete_logfiles(path.value(), rotation_depth);
+
+  {
+    async_file_backend_t backend(path, 1000, rotation_depth);
+    for(int i = 0; i != 200; ++i)
+    {
+      // loglevel error: make each entry a separate batch
+      report(backend, loglevel_t::error, "message " + std::to_string(i));
+    }
+  }
+
+  assert(count_lines(path.value(), "message 199") == 1);
+  assert(count_lines(path.value() + ".1", "Rotating...") == 1);
+  assert(count_lines(path.value() + ".2", "Rotating...") == 1);
+
+  delete_logfiles(path.value(), rotation_depth);
+}
+
+void run_tests(int, char const* const*)
+{
+  all_entries_written();
+  full_ring();
+  oversized_entry();
+  rotation();
+}
+
+} // anonymous
+
+int main(int argc, char* argv[])
+{
+  try
+  {
+    run_tests(argc, argv);
+  }
+  catch(std::exception const& ex)
+  {
+    std::cerr << argv[0] << ": exception: " << ex.what() << std::endl;
+    throw;
+  }
+
+  return 0;
+}
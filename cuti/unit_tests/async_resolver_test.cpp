@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2026 CodeShop B.V.
+ *
+ * This file is part of the cuti library.
+ *
+ * The cuti library is free software: you can redistribute it and/or
+ * modify it under the terms of version 2.1 of the GNU Lesser General
+ * Public License as published by the Free Software Foundation.
+ *
+ * The cuti library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See version
+ * 2.1 of the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of version 2.1 of the GNU Lesser
+ * General Public License along with the cuti library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <cuti/async_resolver.hpp>
+
+#include <cuti/default_scheduler.hpp>
+#include <cuti/resolver.hpp>
+#include <cuti/selector_factory.hpp>
+#include <cuti/socket_layer.hpp>
+#include <cuti/stack_marker.hpp>
+
+#include <exception>
+#include <iostream>
+
+// Enable assert()
+#undef NDEBUG
+#include <cassert>
+
+namespace // anonymous
+{
+
+using namespace cuti;
+
+void await_lookup(default_scheduler_t& scheduler,
+                  async_resolver_t& resolver)
+{
+  bool called = false;
+  resolver.call_when_done(scheduler,
+    [&called](stack_marker_t&) { called = true; });
+
+  stack_marker_t base_marker;
+  while(!called)
+  {
+    auto callback = scheduler.wait();
+    assert(callback != nullptr);
+    callback(base_marker);
+  }
+  assert(resolver.done());
+}
+
+void numeric_host(selector_factory_t const& factory)
+{
+  socket_layer_t sockets;
+  default_scheduler_t scheduler(sockets, factory);
+  async_resolver_t resolver(sockets);
+
+  resolver.start("127.0.0.1", 11264);
+  await_lookup(scheduler, resolver);
+
+  auto endpoints = resolver.result();
+  assert(!endpoints.empty());
+  assert(endpoints.front() == resolve_ip(sockets, "127.0.0.1", 11264));
+}
+
+void unknown_host(selector_factory_t const& factory)
+{
+  socket_layer_t sockets;
+  default_scheduler_t scheduler(sockets, factory);
+  async_resolver_t resolver(sockets);
+
+  resolver.start("mail.dev.null", 25);
+  await_lookup(scheduler, resolver);
+
+  bool caught = false;
+  try
+  {
+    resolver.result();
+  }
+  catch(std::exception const&)
+  {
+    caught = true;
+  }
+  assert(caught);
+}
+
+void restart(selector_factory_t const& factory)
+{
+  socket_layer_t sockets;
+  default_scheduler_t scheduler(sockets, factory);
+  async_resolver_t resolver(sockets);
+
+  // the first lookup is abandoned
+  resolver.start("mail.dev.null", 25);
+  resolver.start("127.0.0.1", 80);
+  await_lookup(scheduler, resolver);
+
+  auto endpoints = resolver.result();
+  assert(!endpoints.empty());
+  assert(endpoints.front().port() == 80);
+
+  // a completed lookup reports right away
+  await_lookup(scheduler, resolver);
+}
+
+void canceled_callback(selector_factory_t const& factory)
+{
+  socket_layer_t sockets;
+  default_scheduler_t scheduler(sockets, factory);
+  async_resolver_t resolver(sockets);
+
+  resolver.start("127.0.0.1", 80);
+  resolver.call_when_done(scheduler,
+    [](stack_marker_t&) { assert(!"unexpected call"); });
+  resolver.cancel_when_done();
+
+  assert(scheduler.wait() == nullptr);
+}
+
+void run_tests(int, char const* const*)
+{
+  for(auto const& factory : available_selector_factories())
+  {
+    numeric_host(factory);
+    unknown_host(factory);
+    restart(factory);
+    canceled_callback(factory);
+  }
+}
+
+} // anonymous
+
+int main(int argc, char* argv[])
+{
+  try
+  {
+    run_tests(argc, argv);
+  }
+  catch(std::exception const& ex)
+  {
+    std::cerr << argv[0] << ": exception: " << ex.what() << std::endl;
+    throw;
+  }
+
+  return 0;
+}
@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2026 CodeShop B.V.
+ *
+ * This file is part of the cuti library.
+ *
+ * The cuti library is free software: you can redistribute it and/or
+ * modify it under the terms of version 2.1 of the GNU Lesser General
+ * Public License as published by the Free Software Foundation.
+ *
+ * The cuti library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See version
+ * 2.1 of the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of version 2.1 of the GNU Lesser
+ * General Public License along with the cuti library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <cuti/buffer_pool.hpp>
+#include <cuti/scoped_thread.hpp>
+
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Enable assert()
+#undef NDEBUG
+#include <cassert>
+
+namespace // anonymous
+{
+
+using namespace cuti;
+
+void small_and_huge_buffers()
+{
+  buffer_pool_t pool;
+
+  auto small = pool.acquire(buffer_pool_t::min_pooled_size - 1);
+  assert(small.empty());
+  assert(small.capacity() >= buffer_pool_t::min_pooled_size - 1);
+  pool.release(std::move(small));
+
+  assert(pool.hits() == 0);
+  assert(pool.misses() == 0);
+  assert(pool.pooled_bytes() == 0);
+}
+
+void recycling()
+{
+  buffer_pool_t pool;
+
+  std::size_t const size = 460800; // 640x480 YUV420P
+  auto buffer = pool.acquire(size);
+  assert(buffer.empty());
+  assert(buffer.capacity() >= size);
+  assert(pool.hits() == 0);
+  assert(pool.misses() == 1);
+
+  buffer.resize(size);
+  unsigned char const* data = buffer.data();
+  pool.release(std::move(buffer));
+  assert(pool.pooled_bytes() >= size);
+
+  auto recycled = pool.acquire(size);
+  assert(recycled.empty());
+  assert(recycled.data() == data);
+  assert(pool.hits() == 1);
+  assert(pool.misses() == 1);
+  assert(pool.pooled_bytes() == 0);
+
+  // a smaller request is served from the same class
+  pool.release(std::move(recycled));
+  auto smaller = pool.acquire(size - 1000);
+  assert(smaller.data() == data);
+  assert(pool.hits() == 2);
+}
+
+void foreign_buffers()
+{
+  buffer_pool_t pool;
+
+  // a buffer not from the pool only serves requests for its class
+  std::size_t const capacity = 3 * buffer_pool_t::min_pooled_size;
+  buffer_pool_t::buffer_t buffer;
+  buffer.reserve(capacity);
+  unsigned char const* data = buffer.data();
+  pool.release(std::move(buffer));
+
+  auto larger = pool.acquire(capacity);
+  assert(larger.data() != data);
+  assert(pool.misses() == 1);
+
+  auto fits = pool.acquire(2 * buffer_pool_t::min_pooled_size);
+  assert(fits.data() == data);
+  assert(pool.hits() == 1);
+}
+
+void byte_limit()
+{
+  std::size_t const size = 1024 * 1024;
+  buffer_pool_t pool(size);
+
+  auto buffer1 = pool.acquire(size);
+  auto buffer2 = pool.acquire(size);
+  pool.release(std::move(buffer1));
+  pool.release(std::move(buffer2));
+
+  assert(pool.pooled_bytes() == size);
+}
+
+void sized_buffers()
+{
+  buffer_pool_t pool;
+
+  std::size_t const size = 65536;
+  auto buffer = pool.acquire_sized(size);
+  assert(buffer.size() == size);
+  buffer.back() = 42;
+  unsigned char const* data = buffer.data();
+  pool.release(std::move(buffer));
+
+  // a recycled buffer keeps its contents
+  auto recycled = pool.acquire_sized(size);
+  assert(recycled.data() == data);
+  assert(recycled.size() == size);
+  assert(recycled.back() == 42);
+  assert(pool.hits() == 1);
+
+  // ...but acquire() still hands out empty buffers
+  pool.release(std::move(recycled));
+  auto empty = pool.acquire(size);
+  assert(empty.data() == data);
+  assert(empty.empty());
+}
+
+void changed_limit()
+{
+  std::size_t const size = 1024 * 1024;
+  buffer_pool_t pool(0);
+
+  // a pool with a limit of 0 bytes keeps nothing
+  pool.release(pool.acquire(size));
+  assert(pool.pooled_bytes() == 0);
+
+  pool.set_max_pooled_bytes(2 * size);
+  assert(pool.max_pooled_bytes() == 2 * size);
+  auto buffer1 = pool.acquire(size);
+  auto buffer2 = pool.acquire(size);
+  pool.release(std::move(buffer1));
+  pool.release(std::move(buffer2));
+  assert(pool.pooled_bytes() == 2 * size);
+
+  pool.set_max_pooled_bytes(size);
+  assert(pool.pooled_bytes() == size);
+
+  pool.set_max_pooled_bytes(0);
+  assert(pool.pooled_bytes() == 0);
+}
+
+void concurrent_use()
+{
+  buffer_pool_t pool;
+  std::size_t const n_threads = 4;
+  std::size_t const n_rounds = 1000;
+
+  {
+    std::vector<std::unique_ptr<scoped_thread_t>> threads;
+    for(std::size_t i = 0; i != n_threads; ++i)
+    {
+      threads.push_back(std::make_unique<scoped_thread_t>([&]
+      {
+        for(std::size_t round = 0; round != n_rounds; ++round)
+        {
+          auto buffer = pool.acquire(65536);
+          buffer.resize(65536);
+          pool.release(std::move(buffer));
+        }
+      }));
+    }
+  }
+
+  assert(pool.hits() + pool.misses() == n_threads * n_rounds);
+  assert(pool.misses() <= n_threads);
+}
+
+void run_tests(int, char const* const*)
+{
+  small_and_huge_buffers();
+  recycling();
+  foreign_buffers();
+  byte_limit();
+  sized_buffers();
+  changed_limit();
+  concurrent_use();
+}
+
+} // anonymous
+
+int main(int argc, char* argv[])
+{
+  try
+  {
+    run_tests(argc, argv);
+  }
+  catch(std::exception const& ex)
+  {
+    std::cerr << argv[0] << ": exception: " << ex.what() << std::endl;
+    throw;
+  }
+
+  return 0;
+}
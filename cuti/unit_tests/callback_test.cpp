@@ -20,8 +20,10 @@
 #include <cuti/callback.hpp>
 #include <cuti/stack_marker.hpp>
 
+#include <array>
 #include <exception>
 #include <functional>
+#include <memory>
 #include <utility>
 #include <type_traits>
 
@@ -53,9 +55,11 @@ static_assert(std::is_nothrow_default_constructible_v<callback_t>);
 static_assert(std::is_nothrow_move_constructible_v<callback_t>);
 static_assert(std::is_nothrow_move_assignable_v<callback_t>);
 static_assert(std::is_nothrow_swappable_v<callback_t>);
+static_assert(!std::is_copy_constructible_v<callback_t>);
+static_assert(!std::is_copy_assignable_v<callback_t>);
 
 // check that callback's templated constructor and assignment operator
-// (which allocate an impl object) are not noexcept
+// (which may allocate) are not noexcept
 static_assert(!std::is_nothrow_constructible_v<callback_t, functor_t const&>);
 static_assert(!std::is_nothrow_assignable_v<callback_t, functor_t const&>);
 static_assert(!std::is_nothrow_constructible_v<callback_t, functor_t&>);
@@ -78,6 +82,58 @@ static_assert(
 static_assert(
   std::is_nothrow_assignable_v<callback_t, std::nullptr_t&&>);
 
+/*
+ * Keeps track of the number of live instances, so we can check that
+ * callback_t destroys what it wraps.
+ */
+template<std::size_t Padding>
+struct counted_functor_t
+{
+  counted_functor_t(int& n_instances, int& n_calls)
+  : n_instances_(n_instances)
+  , n_calls_(n_calls)
+  , padding_()
+  {
+    ++n_instances_;
+  }
+
+  counted_functor_t(counted_functor_t const& rhs)
+  : n_instances_(rhs.n_instances_)
+  , n_calls_(rhs.n_calls_)
+  , padding_(rhs.padding_)
+  {
+    ++n_instances_;
+  }
+
+  counted_functor_t(counted_functor_t&& rhs) noexcept
+  : n_instances_(rhs.n_instances_)
+  , n_calls_(rhs.n_calls_)
+  , padding_(rhs.padding_)
+  {
+    ++n_instances_;
+  }
+
+  counted_functor_t& operator=(counted_functor_t const&) = delete;
+
+  void operator()(stack_marker_t& /* ignored */) const
+  {
+    ++n_calls_;
+  }
+
+  ~counted_functor_t()
+  {
+    --n_instances_;
+  }
+
+private :
+  int& n_instances_;
+  int& n_calls_;
+  std::array<char, Padding> padding_;
+};
+
+using small_functor_t = counted_functor_t<1>;
+using large_functor_t = counted_functor_t<2 * callback_t::inline_size>;
+
 bool function_called = false;
 
 void function(stack_marker_t& /* ignored */)
@@ -210,6 +266,72 @@ void swapped()
   assert(cb2 != nullptr);
 }
 
+template<typename Functor>
+void counted_callback()
+{
+  stack_marker_t base_marker;
+
+  int n_instances = 0;
+  int n_calls = 0;
+
+  {
+    callback_t cb1 = Functor(n_instances, n_calls);
+    assert(n_instances == 1);
+
+    cb1(base_marker);
+    assert(n_calls == 1);
+
+    callback_t cb2(std::move(cb1));
+    assert(cb1 == nullptr);
+    assert(cb2 != nullptr);
+    assert(n_instances == 1);
+
+    cb2(base_marker);
+    assert(n_calls == 2);
+
+    callback_t cb3 = Functor(n_instances, n_calls);
+    assert(n_instances == 2);
+
+    cb3 = std::move(cb2);
+    assert(cb2 == nullptr);
+    assert(n_instances == 1);
+
+    cb3(base_marker);
+    assert(n_calls == 3);
+
+    swap(cb2, cb3);
+    assert(cb3 == nullptr);
+    assert(n_instances == 1);
+
+    cb2 = nullptr;
+    assert(n_instances == 0);
+
+    cb1 = Functor(n_instances, n_calls);
+    assert(n_instances == 1);
+  }
+
+  assert(n_instances == 0);
+}
+
+void move_only_capture()
+{
+  stack_marker_t base_marker;
+
+  auto value = std::make_unique<int>(0);
+  int* observed = value.get();
+
+  callback_t cb1(
+    [value = std::move(value)](stack_marker_t& /* ignored */)
+    { ++*value; }
+  );
+  cb1(base_marker);
+  assert(*observed == 1);
+
+  callback_t cb2 = std::move(cb1);
+  cb2(base_marker);
+  assert(*observed == 2);
+}
+
 } // anonymous
 
 int main()
@@ -225,5 +347,9 @@ int main()
   move_assign();
   swapped();
 
+  counted_callback<small_functor_t>();
+  counted_callback<large_functor_t>();
+  move_only_capture();
+
   return 0;
 }
@@ -35,6 +35,8 @@
 #include <exception>
 #include <iostream>
 #include <memory>
+#include <thread>
+#include <vector>
 
 // Enable assert()
 #undef NDEBUG
@@ -251,6 +253,164 @@ void check_alarm_order(logging_context_t const& context)
   }
 }
 
+void check_coarse_alarms(logging_context_t const& context,
+                         socket_layer_t& sockets,
+                         selector_factory_t const& factory)
+{
+  if(auto msg = context.message_at(loglevel))
+  {
+    *msg << "check_coarse_alarms(): using " << factory << " selector";
+  }
+
+  default_scheduler_t scheduler(sockets, factory);
+
+  std::vector<int> order;
+  std::vector<time_point_t> limits;
+
+  auto start = cuti_clock_t::now();
+  limits.push_back(start + milliseconds_t(20));
+  scheduler.call_coarse_alarm(limits.back(),
+    [&](stack_marker_t&)
+    {
+      assert(cuti_clock_t::now() >= limits[0]);
+      order.push_back(0);
+    });
+  limits.push_back(start + milliseconds_t(30));
+  scheduler.call_alarm(limits.back(),
+    [&](stack_marker_t&)
+    {
+      assert(cuti_clock_t::now() >= limits[1]);
+      order.push_back(1);
+    });
+  auto ticket = scheduler.call_coarse_alarm(milliseconds_t(5),
+    [&](stack_marker_t&) { assert(!"unexpected call"); });
+  limits.push_back(start + milliseconds_t(500));
+  scheduler.call_coarse_alarm(limits.back(),
+    [&](stack_marker_t&)
+    {
+      assert(cuti_clock_t::now() >= limits[2]);
+      order.push_back(2);
+    });
+  scheduler.cancel(ticket);
+
+  stack_marker_t base_marker;
+
+  while(auto cb = scheduler.wait())
+  {
+    cb(base_marker);
+  }
+
+  assert(order.size() == 3);
+  assert(order[0] == 0);
+  assert(order[1] == 1);
+  assert(order[2] == 2);
+}
+  
+void check_coarse_alarms(logging_context_t const& context)
+{
+  socket_layer_t sockets;
+  auto factories = available_selector_factories();
+  for(auto const& factory : factories)
+  {
+    check_coarse_alarms(context, sockets, factory);
+  }
+}
+
+void check_late_alarm_order(logging_context_t const& context,
+                            socket_layer_t& sockets,
+                            selector_factory_t const& factory)
+{
+  if(auto msg = context.message_at(loglevel))
+  {
+    *msg << "check_late_alarm_order(): using " << factory << " selector";
+  }
+
+  default_scheduler_t scheduler(sockets, factory);
+
+  std::vector<int> order;
+
+  auto start = cuti_clock_t::now();
+  scheduler.call_alarm(start + milliseconds_t(30),
+    [&](stack_marker_t&) { order.push_back(1); });
+  scheduler.call_coarse_alarm(start + milliseconds_t(20),
+    [&](stack_marker_t&) { order.push_back(0); });
+  scheduler.call_alarm(start + milliseconds_t(10),
+    [&](stack_marker_t&) { order.push_back(-1); });
+
+  // simulate a late wakeup: everything is due at once
+  std::this_thread::sleep_for(milliseconds_t(50));
+
+  stack_marker_t base_marker;
+
+  while(auto cb = scheduler.wait())
+  {
+    cb(base_marker);
+  }
+
+  assert(order.size() == 3);
+  assert(order[0] == -1);
+  assert(order[1] == 0);
+  assert(order[2] == 1);
+}
+
+void check_late_alarm_order(logging_context_t const& context)
+{
+  socket_layer_t sockets;
+  auto factories = available_selector_factories();
+  for(auto const& factory : factories)
+  {
+    check_late_alarm_order(context, sockets, factory);
+  }
+}
+
+void check_soon_order(logging_context_t const& context,
+                      socket_layer_t& sockets,
+                      selector_factory_t const& factory)
+{
+  if(auto msg = context.message_at(loglevel))
+  {
+    *msg << "check_soon_order(): using " << factory << " selector";
+  }
+
+  default_scheduler_t scheduler(sockets, factory);
+
+  std::vector<int> order;
+
+  scheduler.call_soon([&](stack_marker_t&) { order.push_back(0); });
+  auto ticket = scheduler.call_soon(
+    [&](stack_marker_t&) { order.push_back(1); });
+  scheduler.call_soon([&](stack_marker_t&)
+  {
+    order.push_back(2);
+    scheduler.call_soon([&](stack_marker_t&) { order.push_back(4); });
+  });
+  scheduler.call_soon([&](stack_marker_t&) { order.push_back(3); });
+  scheduler.cancel(ticket);
+
+  stack_marker_t base_marker;
+
+  while(auto cb = scheduler.wait())
+  {
+    cb(base_marker);
+  }
+
+  assert(order.size() == 4);
+  assert(order[0] == 0);
+  assert(order[1] == 2);
+  assert(order[2] == 3);
+  assert(order[3] == 4);
+}
+
+void check_soon_order(logging_context_t const& context)
+{
+  socket_layer_t sockets;
+  auto factories = available_selector_factories();
+  for(auto const& factory : factories)
+  {
+    check_soon_order(context, sockets, factory);
+  }
+}
+
 void empty_scheduler(logging_context_t const& context,
                      socket_layer_t& sockets,
                      selector_factory_t const& factory)
@@ -599,6 +759,121 @@ void scheduler_switch(logging_context_t const& context)
   }
 }
 
+void busy_soon_chain(logging_context_t const& context,
+                     socket_layer_t& sockets,
+                     selector_factory_t const& factory,
+                     endpoint_t const& interface)
+{
+  default_scheduler_t scheduler(sockets, factory);
+
+  tcp_acceptor_t acceptor(sockets, interface);
+  acceptor.set_nonblocking();
+  tcp_connection_t client(sockets, acceptor.local_endpoint());
+
+  if(auto msg = context.message_at(loglevel))
+  {
+    *msg << "busy_soon_chain(): using " << factory <<
+      " selector; acceptor: " << acceptor << " client: " << client;
+  }
+
+  // a chain of soon callbacks that keeps rescheduling itself...
+  int n_soon_calls = 0;
+  bool ready = false;
+  callback_t on_soon;
+  on_soon = [&](stack_marker_t&)
+  {
+    ++n_soon_calls;
+    if(!ready)
+    {
+      scheduler.call_soon([&](stack_marker_t& marker) { on_soon(marker); });
+    }
+  };
+  scheduler.call_soon([&](stack_marker_t& marker) { on_soon(marker); });
+
+  // ...must not starve I/O
+  acceptor.call_when_ready(scheduler, [&](stack_marker_t&) { ready = true; });
+
+  stack_marker_t base_marker;
+  while(callback_t callback = scheduler.wait())
+  {
+    callback(base_marker);
+  }
+
+  assert(ready);
+  assert(n_soon_calls < 1000);
+}
+
+void busy_soon_chain(logging_context_t const& context)
+{
+  socket_layer_t sockets;
+  auto factories = available_selector_factories();
+  auto interfaces = local_interfaces(sockets, any_port);
+
+  for(auto const& factory : factories)
+  {
+    for(auto const& interface : interfaces)
+    {
+      busy_soon_chain(context, sockets, factory, interface);
+    }
+  }
+}
+
+void alarms_behind_soon_chain(logging_context_t const& context,
+                              socket_layer_t& sockets,
+                              selector_factory_t const& factory)
+{
+  default_scheduler_t scheduler(sockets, factory);
+
+  if(auto msg = context.message_at(loglevel))
+  {
+    *msg << "alarms_behind_soon_chain(): using " << factory <<
+      " selector";
+  }
+
+  // a chain of soon callbacks that never ends by itself...
+  bool alarm_fired = false;
+  bool coarse_alarm_fired = false;
+  int n_soon_calls = 0;
+  callback_t on_soon;
+  on_soon = [&](stack_marker_t&)
+  {
+    ++n_soon_calls;
+    if(!alarm_fired || !coarse_alarm_fired)
+    {
+      scheduler.call_soon([&](stack_marker_t& marker) { on_soon(marker); });
+    }
+  };
+  scheduler.call_soon([&](stack_marker_t& marker) { on_soon(marker); });
+
+  // ...must not starve precise or coarse alarms
+  auto now = cuti_clock_t::now();
+  scheduler.call_alarm(now + milliseconds_t(1),
+    [&](stack_marker_t&) { alarm_fired = true; });
+  scheduler.call_coarse_alarm(now + milliseconds_t(10),
+    [&](stack_marker_t&) { coarse_alarm_fired = true; });
+
+  stack_marker_t base_marker;
+  while(callback_t callback = scheduler.wait())
+  {
+    callback(base_marker);
+  }
+
+  assert(alarm_fired);
+  assert(coarse_alarm_fired);
+  assert(n_soon_calls > 0);
+}
+
+void alarms_behind_soon_chain(logging_context_t const& context)
+{
+  socket_layer_t sockets;
+  auto factories = available_selector_factories();
+
+  for(auto const& factory : factories)
+  {
+    alarms_behind_soon_chain(context, sockets, factory);
+  }
+}
+
 void run_tests(int argc, char const* const* argv)
 {
   logger_t logger(std::make_unique<cuti::streambuf_backend_t>(std::cerr));
@@ -606,6 +881,9 @@ void run_tests(int argc, char const* const* argv)
     logger, argc == 1 ? loglevel_t::error : loglevel_t::info);
 
   check_alarm_order(context);
+  check_coarse_alarms(context);
+  check_late_alarm_order(context);
+  check_soon_order(context);
   empty_scheduler(context);
   no_client(context);
   single_client(context);
@@ -614,6 +892,8 @@ void run_tests(int argc, char const* const* argv)
   one_idle_acceptor(context);
 
   scheduler_switch(context);
+  busy_soon_chain(context);
+  alarms_behind_soon_chain(context);
 }
 
 } // anonymous
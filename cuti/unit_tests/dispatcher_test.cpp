@@ -24,6 +24,7 @@
 #include <cuti/cmdline_reader.hpp>
 #include <cuti/echo_handler.hpp>
 #include <cuti/error_status.hpp>
+#include <cuti/fs_utils.hpp>
 #include <cuti/logging_context.hpp>
 #include <cuti/method_map.hpp>
 #include <cuti/option_walker.hpp>
@@ -37,6 +38,7 @@
 #include <cuti/streambuf_backend.hpp>
 #include <cuti/tcp_connection.hpp>
 
+#include <algorithm>
 #include <csignal>
 #include <iostream>
 #include <list>
@@ -221,11 +223,13 @@ void remote_sleep(rpc_client_t& client, unsigned int msecs)
 
 void test_deaf_client(logging_context_t const& client_context,
                       logging_context_t const& server_context,
-                      std::size_t bufsize)
+                      std::size_t bufsize,
+                      std::size_t reactor_threads)
 {
   if(auto msg = client_context.message_at(loglevel_t::info))
   {
-    *msg << __func__ << ": starting (bufsize: " << bufsize << ")";
+    *msg << __func__ << ": starting (bufsize: " << bufsize <<
+      " reactor_threads: " << reactor_threads << ")";
   }
 
   method_map_t map;
@@ -235,6 +239,7 @@ void test_deaf_client(logging_context_t const& client_context,
 
   dispatcher_config_t config;
   config.bufsize_ = bufsize;
+  config.reactor_threads_ = reactor_threads;
   config.throughput_settings_.min_bytes_per_tick_ = 512;
   config.throughput_settings_.low_ticks_limit_ = 10;
   config.throughput_settings_.tick_length_ = milliseconds_t(100);
@@ -280,11 +285,13 @@ void test_deaf_client(logging_context_t const& client_context,
 
 void test_slow_client(logging_context_t const& client_context,
                       logging_context_t const& server_context,
-                      std::size_t bufsize)
+                      std::size_t bufsize,
+                      std::size_t reactor_threads)
 {
   if(auto msg = client_context.message_at(loglevel_t::info))
   {
-    *msg << __func__ << ": starting (bufsize: " << bufsize << ")";
+    *msg << __func__ << ": starting (bufsize: " << bufsize <<
+      " reactor_threads: " << reactor_threads << ")";
   }
 
   method_map_t map;
@@ -294,6 +301,7 @@ void test_slow_client(logging_context_t const& client_context,
 
   dispatcher_config_t config;
   config.bufsize_ = bufsize;
+  config.reactor_threads_ = reactor_threads;
   config.throughput_settings_.min_bytes_per_tick_ = 512;
   config.throughput_settings_.low_ticks_limit_ = 10;
   config.throughput_settings_.tick_length_ = milliseconds_t(10);
@@ -334,13 +342,40 @@ void test_slow_client(logging_context_t const& client_context,
   }
 }
 
+/*
+ * Waits until cache finds its idle connection to server_address
+ * closed by the server, which replaces it with a new connection.
+ */
+void await_probe_failure(logging_context_t const& context,
+                         simple_nb_client_cache_t& cache,
+                         endpoint_t const& server_address)
+{
+  auto const deadline = cuti_clock_t::now() + seconds_t(60);
+  auto const failures = cache.probe_failures();
+
+  for(;;)
+  {
+    auto client = cache.obtain(context, server_address);
+    cache.store(context, std::move(client));
+    if(cache.probe_failures() != failures)
+    {
+      break;
+    }
+
+    assert(cuti_clock_t::now() < deadline);
+    std::this_thread::sleep_for(milliseconds_t(1));
+  }
+}
+
 void test_eviction(logging_context_t const& client_context,
                    logging_context_t const& server_context,
-                   std::size_t bufsize)
+                   std::size_t bufsize,
+                   std::size_t reactor_threads)
 {
   if(auto msg = client_context.message_at(loglevel_t::info))
   {
-    *msg << __func__ << ": starting (bufsize: " << bufsize << ")";
+    *msg << __func__ << ": starting (bufsize: " << bufsize <<
+      " reactor_threads: " << reactor_threads << ")";
   }
 
   method_map_t map;
@@ -350,6 +385,8 @@ void test_eviction(logging_context_t const& client_context,
 
   dispatcher_config_t config;
   config.bufsize_ = bufsize;
+  // connection limits are per reactor: keep both clients on one
+  config.reactor_threads_ = std::min<std::size_t>(reactor_threads, 1);
   config.max_concurrent_requests_ = 1;
   config.max_connections_ = 1;
 
@@ -373,20 +410,14 @@ void test_eviction(logging_context_t const& client_context,
     rpc_client_t client2(client_context, cache2, server_address);
     echo_nothing(client2);
 
-    bool caught = false;
-    try
-    {
-      echo_nothing(client1);
-    }
-    catch(const std::exception& ex)
-    {
-      if(auto msg = client_context.message_at(loglevel_t::info))
-      {
-        *msg << __func__ << ": got expected exception: " << ex.what();
-      }
-      caught = true;
-    }
-    assert(caught);
+    /*
+     * The server evicts client1's connection after serving client2.
+     * Once the cache notices that the connection is gone, client1's
+     * next call succeeds on a new connection.
+     */
+    await_probe_failure(client_context, cache1, server_address);
+    echo_nothing(client1);
+    assert(cache1.probe_failures() == 1);
   }
   
   if(auto msg = client_context.message_at(loglevel_t::info))
@@ -398,12 +429,14 @@ void test_eviction(logging_context_t const& client_context,
 void test_remote_sleeps(logging_context_t const& client_context,
                         logging_context_t const& server_context,
                         std::size_t bufsize,
+                        std::size_t reactor_threads,
                         std::size_t max_concurrent_requests,
                         std::size_t n_clients)
 {
   if(auto msg = client_context.message_at(loglevel_t::info))
   {
     *msg << __func__ << ": starting (bufsize: " << bufsize <<
+      " reactor_threads: " << reactor_threads <<
       " max_concurrent_requests: " << max_concurrent_requests <<
       " n_clients: " << n_clients << ")";
   }
@@ -415,6 +448,7 @@ void test_remote_sleeps(logging_context_t const& client_context,
 
   dispatcher_config_t config;
   config.bufsize_ = bufsize;
+  config.reactor_threads_ = reactor_threads;
   config.max_concurrent_requests_ = max_concurrent_requests;
 
   {
@@ -458,14 +492,17 @@ void test_remote_sleeps(logging_context_t const& client_context,
 
 void test_concurrent_requests(logging_context_t const& client_context,
                               logging_context_t const& server_context,
-                              std::size_t bufsize)
+                              std::size_t bufsize,
+                              std::size_t reactor_threads)
 {
   if(auto msg = client_context.message_at(loglevel_t::info))
   {
-    *msg << __func__ << ": starting (bufsize: " << bufsize << ")";
+    *msg << __func__ << ": starting (bufsize: " << bufsize <<
+      " reactor_threads: " << reactor_threads << ")";
   }
 
   test_remote_sleeps(client_context, server_context, bufsize,
+    reactor_threads,
     dispatcher_config_t::default_max_concurrent_requests(),
     dispatcher_config_t::default_max_concurrent_requests());
 
@@ -477,14 +514,17 @@ void test_concurrent_requests(logging_context_t const& client_context,
 
 void test_full_thread_pool(logging_context_t const& client_context,
                            logging_context_t const& server_context,
-                           std::size_t bufsize)
+                           std::size_t bufsize,
+                           std::size_t reactor_threads)
 {
   if(auto msg = client_context.message_at(loglevel_t::info))
   {
-    *msg << __func__ << ": starting (bufsize: " << bufsize << ")";
+    *msg << __func__ << ": starting (bufsize: " << bufsize <<
+      " reactor_threads: " << reactor_threads << ")";
   }
 
   test_remote_sleeps(client_context, server_context, bufsize,
+    reactor_threads,
     dispatcher_config_t::default_max_concurrent_requests() / 2,
     dispatcher_config_t::default_max_concurrent_requests());
 
@@ -497,12 +537,14 @@ void test_full_thread_pool(logging_context_t const& client_context,
 void do_test_interrupted_server(logging_context_t const& client_context,
                                 logging_context_t const& server_context,
                                 std::size_t bufsize,
+                                std::size_t reactor_threads,
                                 std::size_t max_concurrent_requests,
                                 std::size_t n_clients)
 {
   if(auto msg = client_context.message_at(loglevel_t::info))
   {
     *msg << __func__ << ": starting (bufsize: " << bufsize <<
+      " reactor_threads: " << reactor_threads <<
       " max_concurrent_requests: " << max_concurrent_requests <<
       " n_clients: " << n_clients << ")";
   }
@@ -514,6 +556,7 @@ void do_test_interrupted_server(logging_context_t const& client_context,
 
   dispatcher_config_t config;
   config.bufsize_ = bufsize;
+  config.reactor_threads_ = reactor_threads;
   config.max_concurrent_requests_ = max_concurrent_requests;
 
   {
@@ -575,14 +618,17 @@ void do_test_interrupted_server(logging_context_t const& client_context,
 
 void test_interrupted_server(logging_context_t const& client_context,
                              logging_context_t const& server_context,
-                             std::size_t bufsize)
+                             std::size_t bufsize,
+                             std::size_t reactor_threads)
 {
   if(auto msg = client_context.message_at(loglevel_t::info))
   {
-    *msg << __func__ << ": starting (bufsize: " << bufsize << ")";
+    *msg << __func__ << ": starting (bufsize: " << bufsize <<
+      " reactor_threads: " << reactor_threads << ")";
   }
 
   do_test_interrupted_server(client_context, server_context, bufsize,
+    reactor_threads,
     dispatcher_config_t::default_max_concurrent_requests(),
     dispatcher_config_t::default_max_concurrent_requests());
 
@@ -595,14 +641,17 @@ void test_interrupted_server(logging_context_t const& client_context,
 void test_overloaded_interrupted_server(
   logging_context_t const& client_context,
   logging_context_t const& server_context,
-  std::size_t bufsize)
+  std::size_t bufsize,
+  std::size_t reactor_threads)
 {
   if(auto msg = client_context.message_at(loglevel_t::info))
   {
-    *msg << __func__ << ": starting (bufsize: " << bufsize << ")";
+    *msg << __func__ << ": starting (bufsize: " << bufsize <<
+      " reactor_threads: " << reactor_threads << ")";
   }
 
   do_test_interrupted_server(client_context, server_context, bufsize,
+    reactor_threads,
     dispatcher_config_t::default_max_concurrent_requests() / 2,
     dispatcher_config_t::default_max_concurrent_requests());
 
@@ -614,7 +663,8 @@ void test_overloaded_interrupted_server(
 
 void test_restart(logging_context_t const& client_context,
                   logging_context_t const& server_context,
-                  std::size_t bufsize)
+                  std::size_t bufsize,
+                  std::size_t reactor_threads)
 {
   method_map_t map;
   map.add_method_factory("echo", default_method_factory<echo_handler_t>());
@@ -623,10 +673,12 @@ void test_restart(logging_context_t const& client_context,
 
   dispatcher_config_t config;
   config.bufsize_ = bufsize;
+  config.reactor_threads_ = reactor_threads;
 
   if(auto msg = client_context.message_at(loglevel_t::info))
   {
-    *msg << __func__ << ": starting (bufsize: " << bufsize << ")";
+    *msg << __func__ << ": starting (bufsize: " << bufsize <<
+      " reactor_threads: " << reactor_threads << ")";
   }
 
   {
@@ -663,18 +715,153 @@ void test_restart(logging_context_t const& client_context,
   }
 }
 
+void test_sharded_listeners(logging_context_t const& client_context,
+                            logging_context_t const& server_context,
+                            std::size_t bufsize,
+                            std::size_t reactor_threads)
+{
+  if(auto msg = client_context.message_at(loglevel_t::info))
+  {
+    *msg << __func__ << ": starting (bufsize: " << bufsize <<
+      " reactor_threads: " << reactor_threads << ")";
+  }
+
+  method_map_t map;
+  map.add_method_factory("echo", default_method_factory<echo_handler_t>());
+
+  socket_layer_t sockets;
+
+  dispatcher_config_t config;
+  config.bufsize_ = bufsize;
+  config.reactor_threads_ = reactor_threads;
+  config.shard_listeners_ = true;
+
+  {
+    dispatcher_t dispatcher(server_context, sockets, config);
+    endpoint_t server_address = dispatcher.add_listener(
+      local_interfaces(sockets, any_port).front(), map);
+
+    scoped_thread_t server_thread([&] { dispatcher.run(); });
+    auto stop_guard = make_scoped_guard([&] { dispatcher.stop(SIGINT); });
+
+    simple_nb_client_cache_t::settings_t cache_settings{};
+    cache_settings.inbufsize_ = bufsize;
+    cache_settings.outbufsize_ = bufsize;
+    
+    simple_nb_client_cache_t cache(sockets, cache_settings);
+
+    std::list<scoped_thread_t> client_threads;
+    for(int i = 0; i != 8; ++i)
+    {
+      client_threads.emplace_back([&]
+      {
+        rpc_client_t client(client_context, cache, server_address);
+        for(int j = 0; j != 4; ++j)
+        {
+          echo_some_strings(client);
+        }
+      });
+    }
+  }
+  
+  if(auto msg = client_context.message_at(loglevel_t::info))
+  {
+    *msg << __func__ << ": done";
+  }
+}
+
+void test_unix_listener(logging_context_t const& client_context,
+                        logging_context_t const& server_context,
+                        std::size_t bufsize,
+                        std::size_t reactor_threads)
+{
+#ifndef _WIN32
+  if(auto msg = client_context.message_at(loglevel_t::info))
+  {
+    *msg << __func__ << ": starting (bufsize: " << bufsize <<
+      " reactor_threads: " << reactor_threads << ")";
+  }
+
+  method_map_t map;
+  map.add_method_factory("echo", default_method_factory<echo_handler_t>());
+
+  socket_layer_t sockets;
+  char const socket_name[] = "dispatcher_test.sock";
+
+  dispatcher_config_t config;
+  config.bufsize_ = bufsize;
+  config.reactor_threads_ = reactor_threads;
+  // unix domain listeners are never sharded
+  config.shard_listeners_ = true;
+
+  {
+    dispatcher_t dispatcher(server_context, sockets, config);
+    endpoint_t server_address = dispatcher.add_listener(
+      resolve_unix(sockets, socket_name), map);
+    assert(server_address.is_unix());
+
+    scoped_thread_t server_thread([&] { dispatcher.run(); });
+    auto stop_guard = make_scoped_guard([&] { dispatcher.stop(SIGINT); });
+
+    simple_nb_client_cache_t::settings_t cache_settings{};
+    cache_settings.inbufsize_ = bufsize;
+    cache_settings.outbufsize_ = bufsize;
+    
+    simple_nb_client_cache_t cache(sockets, cache_settings);
+
+    std::list<scoped_thread_t> client_threads;
+    for(int i = 0; i != 4; ++i)
+    {
+      client_threads.emplace_back([&]
+      {
+        rpc_client_t client(client_context, cache, server_address);
+        for(int j = 0; j != 4; ++j)
+        {
+          echo_some_strings(client);
+        }
+      });
+    }
+  }
+
+  delete_if_exists(socket_name);
+  
+  if(auto msg = client_context.message_at(loglevel_t::info))
+  {
+    *msg << __func__ << ": done";
+  }
+#else
+  static_cast<void>(client_context);
+  static_cast<void>(server_context);
+  static_cast<void>(bufsize);
+  static_cast<void>(reactor_threads);
+#endif
+}
+
 void do_run_tests(logging_context_t const& client_context,
                   logging_context_t const& server_context,
-                  std::size_t bufsize)
+                  std::size_t bufsize,
+                  std::size_t reactor_threads)
 {
-  test_deaf_client(client_context, server_context, bufsize);
-  test_slow_client(client_context, server_context, bufsize);
-  test_eviction(client_context, server_context, bufsize);
-  test_concurrent_requests(client_context, server_context, bufsize);
-  test_full_thread_pool(client_context, server_context, bufsize);
-  test_interrupted_server(client_context, server_context, bufsize);
-  test_overloaded_interrupted_server(client_context, server_context, bufsize);
-  test_restart(client_context, server_context, bufsize);
+  test_deaf_client(client_context, server_context, bufsize,
+    reactor_threads);
+  test_slow_client(client_context, server_context, bufsize,
+    reactor_threads);
+  test_eviction(client_context, server_context, bufsize,
+    reactor_threads);
+  test_concurrent_requests(client_context, server_context, bufsize,
+    reactor_threads);
+  test_full_thread_pool(client_context, server_context, bufsize,
+    reactor_threads);
+  test_interrupted_server(client_context, server_context, bufsize,
+    reactor_threads);
+  test_overloaded_interrupted_server(client_context, server_context, bufsize,
+    reactor_threads);
+  test_restart(client_context, server_context, bufsize,
+    reactor_threads);
+  test_sharded_listeners(client_context, server_context, bufsize,
+    reactor_threads);
+  test_unix_listener(client_context, server_context, bufsize,
+    reactor_threads);
 }
 
 struct options_t
@@ -737,9 +924,14 @@ int run_tests(int argc, char const* const* argv)
   static std::size_t constexpr bufsizes[] =
     { 512, dispatcher_config_t::default_bufsize() };
 
+  static std::size_t constexpr reactor_threads[] = { 0, 1, 4 };
+
   for(auto bufsize: bufsizes)
   {
-    do_run_tests(client_context, server_context, bufsize);
+    for(auto n_reactors: reactor_threads)
+    {
+      do_run_tests(client_context, server_context, bufsize, n_reactors);
+    }
   }
   
   return 0;
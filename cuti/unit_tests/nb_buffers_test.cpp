@@ -44,7 +44,7 @@ namespace // anoymous
 
 using namespace cuti;
 
-template<bool use_bulk_io>
+template<bool use_bulk_io, bool use_direct_io = false>
 struct copier_t
 {
   copier_t(logging_context_t const& context,
@@ -86,7 +86,9 @@ private :
       if constexpr(use_bulk_io)
       {
         auto begin = circbuf_.begin_slack();
-        auto next = inbuf_->read(begin, circbuf_.end_slack());
+        auto next = use_direct_io ?
+          inbuf_->read_direct(begin, circbuf_.end_slack()) :
+          inbuf_->read(begin, circbuf_.end_slack());
         if(next != begin)
         {
           circbuf_.push_back(next);
@@ -146,7 +148,9 @@ private :
       if constexpr(use_bulk_io)
       {
         auto begin = circbuf_.begin_data();
-        auto next = outbuf_->write(begin, circbuf_.end_data());
+        auto next = use_direct_io ?
+          outbuf_->write_direct(begin, circbuf_.end_data()) :
+          outbuf_->write(begin, circbuf_.end_data());
         circbuf_.pop_front(next);
 
         bytes += next - begin;    
@@ -231,14 +235,14 @@ private :
   std::string name_;
 };
 
-template<bool use_bulk_io>
+template<bool use_bulk_io, bool use_direct_io = false>
 void do_test_string_buffers(logging_context_t const& context,
                             std::size_t circ_bufsize)
 {
   if(auto msg = context.message_at(loglevel_t::info))
   {
     *msg << "do_test_string_buffers(): use_bulk_io: " << use_bulk_io <<
-      " circ_bufsize: " << circ_bufsize;
+      " use_direct_io: " << use_direct_io << " circ_bufsize: " << circ_bufsize;
   }
 
   socket_layer_t sockets;
@@ -252,14 +256,14 @@ void do_test_string_buffers(logging_context_t const& context,
     { 1, nb_outbuf_t::default_bufsize, 1, nb_outbuf_t::default_bufsize };
 
   std::string outputs[4];
-  std::unique_ptr<copier_t<use_bulk_io>> copiers[4];
+  std::unique_ptr<copier_t<use_bulk_io, use_direct_io>> copiers[4];
 
   for(int i = 0; i != 4; ++i)
   {
     auto inbuf = make_nb_string_inbuf(input, inbuf_sizes[i]);
     auto outbuf = make_nb_string_outbuf(outputs[i], outbuf_sizes[i]);
 
-    copiers[i] = std::make_unique<copier_t<use_bulk_io>>(
+    copiers[i] = std::make_unique<copier_t<use_bulk_io, use_direct_io>>(
       context, scheduler, std::move(inbuf), std::move(outbuf), circ_bufsize);
 
     if(auto msg = context.message_at(loglevel_t::info))
@@ -297,6 +301,8 @@ void test_string_buffers(logging_context_t const& context)
   do_test_string_buffers<false>(context, 16 * 1024);
   do_test_string_buffers<true>(context, 1);
   do_test_string_buffers<true>(context, 16 * 1024);
+  do_test_string_buffers<true, true>(context, 1);
+  do_test_string_buffers<true, true>(context, 16 * 1024);
 }
   
 std::string make_large_payload()
@@ -315,19 +321,22 @@ std::string make_large_payload()
   return result;
 }
   
-template<bool use_bulk_io>
+template<bool use_bulk_io, bool use_direct_io = false>
 void do_test_tcp_buffers(logging_context_t const& context,
                          std::size_t circ_bufsize,
                          std::size_t client_bufsize,
                          std::size_t server_bufsize,
-                         std::string const& input)
+                         std::string const& input,
+                         std::size_t max_bufsize = 0)
 {
   if(auto msg = context.message_at(loglevel_t::info))
   {
     *msg << "do_test_tcp_buffers: use_bulk_io: " << use_bulk_io <<
+      " use_direct_io: " << use_direct_io <<
       " circ_bufsize: " << circ_bufsize <<
       " client_bufsize: " << client_bufsize <<
       " server_bufsize: " << server_bufsize <<
+      " max_bufsize: " << max_bufsize <<
       " payload: " << input.size() << " bytes";
   }
 
@@ -346,18 +355,20 @@ void do_test_tcp_buffers(logging_context_t const& context,
   std::unique_ptr<nb_inbuf_t> consumer_in;
   std::unique_ptr<nb_outbuf_t> producer_out;
   std::tie(consumer_in, producer_out) = make_nb_tcp_buffers(
-    std::move(client_side), client_bufsize, client_bufsize);
+    std::move(client_side), client_bufsize, client_bufsize,
+    max_bufsize, max_bufsize);
 
   std::unique_ptr<nb_inbuf_t> echoer_in;
   std::unique_ptr<nb_outbuf_t> echoer_out;
   std::tie(echoer_in, echoer_out) = make_nb_tcp_buffers(
-    std::move(server_side), server_bufsize, server_bufsize);
+    std::move(server_side), server_bufsize, server_bufsize,
+    max_bufsize, max_bufsize);
 
-  copier_t<use_bulk_io> producer(context, scheduler,
+  copier_t<use_bulk_io, use_direct_io> producer(context, scheduler,
     std::move(producer_in), std::move(producer_out), circ_bufsize);
-  copier_t<use_bulk_io> echoer(context, scheduler,
+  copier_t<use_bulk_io, use_direct_io> echoer(context, scheduler,
     std::move(echoer_in), std::move(echoer_out), circ_bufsize);
-  copier_t<use_bulk_io> consumer(context, scheduler,
+  copier_t<use_bulk_io, use_direct_io> consumer(context, scheduler,
     std::move(consumer_in), std::move(consumer_out), circ_bufsize);
 
   if(auto msg = context.message_at(loglevel_t::info))
@@ -405,6 +416,20 @@ void test_tcp_buffers(logging_context_t const& context)
     8 * 1024, 8 * 1024, 8 * 1024, large_payload);
   do_test_tcp_buffers<true>(context,
     8 * 1024, 8 * 1024, 8 * 1024, large_payload);
+  do_test_tcp_buffers<true, true>(context,
+    1, 1, 1, small_payload);
+  do_test_tcp_buffers<true, true>(context,
+    64 * 1024, 4 * 1024, 8 * 1024, large_payload);
+  do_test_tcp_buffers<true, true>(context,
+    256 * 1024, 8 * 1024, 4 * 1024, large_payload);
+
+  // growing tcp buffers
+  do_test_tcp_buffers<false>(context,
+    4 * 1024, 1, 1, large_payload, 64 * 1024);
+  do_test_tcp_buffers<true>(context,
+    4 * 1024, 1, 1, large_payload, 64 * 1024);
+  do_test_tcp_buffers<true, true>(context,
+    64 * 1024, 1, 16, large_payload, 256 * 1024);
 }
 
 void drain(scheduler_t& scheduler, nb_inbuf_t& inbuf)
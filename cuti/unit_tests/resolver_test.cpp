@@ -18,11 +18,13 @@
  */
 
 #include <cuti/resolver.hpp>
+#include <cuti/cmdline_reader.hpp>
 #include <cuti/socket_layer.hpp>
 #include <cuti/system_error.hpp>
 
 #include <exception>
 #include <iostream>
+#include <string>
 
 // enable assert()
 #undef NDEBUG
@@ -103,6 +105,64 @@ void not_an_ip_address()
   assert(caught);
 }
 
+#ifndef _WIN32
+
+void unix_path()
+{
+  socket_layer_t sockets;
+  endpoint_t ep = resolve_unix(sockets, "resolver_test.sock");
+#if PRINT
+  std::cout << "unix_path(): " << ep << std::endl;
+#endif
+  assert(ep.is_unix());
+  assert(ep.unix_path() == "resolver_test.sock");
+
+  assert(ep == resolve_unix(sockets, std::string("resolver_test.sock")));
+  assert(ep != resolve_unix(sockets, "other.sock"));
+
+  endpoint_t empty{};
+  assert(empty < ep);
+}
+
+void bad_unix_path()
+{
+  socket_layer_t sockets;
+
+  for(std::string const& path : { std::string(), std::string(200, 'x') })
+  {
+    bool caught = false;
+    try
+    {
+      resolve_unix(sockets, path);
+    }
+    catch(system_exception_t const& ex)
+    {
+#if PRINT
+      std::cout << "bad_unix_path(): caught expected exception: " <<
+        ex.what() << std::endl;
+#else
+      static_cast<void>(ex);
+#endif
+      caught = true;
+    }
+    assert(caught);
+  }
+}
+
+void parsed_unix_path()
+{
+  socket_layer_t sockets;
+  char const* const argv[] = { "resolver_test", "unix:resolver_test.sock" };
+  cmdline_reader_t reader(2, argv);
+
+  endpoint_t ep;
+  parse_endpoint(sockets, "--endpoint", reader,
+    reader.current_argument(), ep);
+  assert(ep == resolve_unix(sockets, "resolver_test.sock"));
+}
+
+#endif // !_WIN32
+
 void local_endpoints()
 {
   socket_layer_t sockets;
@@ -277,6 +337,11 @@ void run_tests(int, char const* const*)
 {
   ip_address();
   not_an_ip_address();
+#ifndef _WIN32
+  unix_path();
+  bad_unix_path();
+  parsed_unix_path();
+#endif
   local_endpoints();
   local_endpoints_with_port();
   all_endpoints();
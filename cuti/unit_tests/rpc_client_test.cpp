@@ -29,13 +29,16 @@
 #include <cuti/quoted.hpp>
 #include <cuti/resolver.hpp>
 #include <cuti/rpc_client.hpp>
+#include <cuti/rpc_client_group.hpp>
 #include <cuti/scoped_thread.hpp>
 #include <cuti/simple_nb_client_cache.hpp>
 #include <cuti/socket_layer.hpp>
 #include <cuti/streambuf_backend.hpp>
 #include <cuti/subtract_handler.hpp>
+#include <cuti/tcp_acceptor.hpp>
 #include <cuti/tcp_connection.hpp>
 
+#include <algorithm>
 #include <csignal>
 #include <iostream>
 #include <limits>
@@ -78,6 +81,34 @@ std::vector<std::string> make_echo_args()
 
 std::vector<std::string> const echo_args = make_echo_args();
 
+std::vector<std::string> make_blob_echo_args()
+{
+  std::vector<std::string> result;
+  result.reserve(n_echo_args);
+
+  for(unsigned int i = 0; i != n_echo_args; ++i)
+  {
+    if(i == n_echo_args / 2)
+    {
+      result.push_back(censored);
+    }
+    else
+    {
+      // long enough to be sent as raw blobs, and full of newlines
+      std::string arg;
+      for(unsigned int j = 0; j != 1000 + i; ++j)
+      {
+        arg += static_cast<char>(i + j);
+      }
+      result.push_back(std::move(arg));
+    }
+  }
+
+  return result;
+}
+
+std::vector<std::string> const blob_echo_args = make_blob_echo_args();
+
 struct string_source_t
 {
   explicit string_source_t(
@@ -339,6 +370,52 @@ void test_vector_echo(logging_context_t const& context, rpc_client_t& client)
   }
 }
   
+void test_blob_echo(logging_context_t const& context, rpc_client_t& client)
+{
+  if(auto msg = context.message_at(loglevel_t::info))
+  {
+    *msg << __func__ << ": starting";
+  }
+
+  std::vector<std::string> reply;
+  auto inputs = make_input_list_ptr<std::vector<std::string>>(reply);
+
+  auto outputs = make_output_list_ptr<std::vector<std::string>>(
+    blob_echo_args);
+
+  client("echo", std::move(inputs), std::move(outputs));
+
+  assert(reply == blob_echo_args);
+
+  if(auto msg = context.message_at(loglevel_t::info))
+  {
+    *msg << __func__ << ": done";
+  }
+}
+  
+void test_blob_censored_echo(logging_context_t const& context,
+                             rpc_client_t& client)
+{
+  if(auto msg = context.message_at(loglevel_t::info))
+  {
+    *msg << __func__ << ": starting";
+  }
+
+  std::vector<std::string> reply;
+  auto inputs = make_input_list_ptr<std::vector<std::string>>(reply);
+
+  auto outputs = make_output_list_ptr<std::vector<std::string>>(
+    blob_echo_args);
+
+  check_rpc_failure(
+    context, client, "censored_echo", std::move(inputs), std::move(outputs));
+
+  if(auto msg = context.message_at(loglevel_t::info))
+  {
+    *msg << __func__ << ": done";
+  }
+}
+  
 void test_vector_censored_echo(logging_context_t const& context,
                                rpc_client_t& client)
 {
@@ -495,6 +572,199 @@ auto censored_echo_method_factory(std::string censored)
   };
 }
     
+void test_group(logging_context_t const& context,
+                nb_client_cache_t& cache,
+                endpoint_t const& server_endpoint)
+{
+  if(auto msg = context.message_at(loglevel_t::info))
+  {
+    *msg << __func__ << ": starting";
+  }
+
+  rpc_client_group_t group(context, cache);
+
+  std::size_t constexpr n_calls = 6;
+  std::vector<int> sums(n_calls);
+  std::vector<std::vector<std::string>> echoes(n_calls);
+  std::vector<rpc_client_group_t::call_id_t> ids;
+
+  for(std::size_t i = 0; i != n_calls; ++i)
+  {
+    ids.push_back(group.start(server_endpoint, "add",
+      make_input_list_ptr<int>(sums[i]),
+      make_output_list_ptr<int, int>(42, static_cast<int>(i))));
+    ids.push_back(group.start(server_endpoint, "echo",
+      make_input_list_ptr<std::vector<std::string>>(echoes[i]),
+      make_output_list_ptr<std::vector<std::string>>(echo_args)));
+  }
+
+  int bad_reply{};
+  auto bad_id = group.start(server_endpoint, "huh",
+    make_input_list_ptr<int>(bad_reply),
+    make_output_list_ptr<int, int>(42, 4711));
+
+  assert(group.size() == 2 * n_calls + 1);
+
+  std::size_t n_completed = 0;
+  while(group.busy())
+  {
+    auto completion = group.complete_next_call();
+    ++n_completed;
+
+    if(completion.id_ == bad_id)
+    {
+      assert(completion.ex_ != nullptr);
+    }
+    else
+    {
+      assert(completion.ex_ == nullptr);
+      assert(std::find(ids.begin(), ids.end(), completion.id_) != ids.end());
+    }
+  }
+  assert(n_completed == 2 * n_calls + 1);
+
+  for(std::size_t i = 0; i != n_calls; ++i)
+  {
+    assert(sums[i] == 42 + static_cast<int>(i));
+    assert(echoes[i] == echo_args);
+  }
+
+  if(auto msg = context.message_at(loglevel_t::info))
+  {
+    *msg << __func__ << ": done";
+  }
+}
+
+void test_group_host_names(logging_context_t const& context,
+                           nb_client_cache_t& cache,
+                           endpoint_t const& server_endpoint)
+{
+  if(auto msg = context.message_at(loglevel_t::info))
+  {
+    *msg << __func__ << ": starting";
+  }
+
+  rpc_client_group_t group(context, cache);
+
+  int sum{};
+  auto good_id = group.start(
+    server_endpoint.ip_address(), server_endpoint.port(), "add",
+    make_input_list_ptr<int>(sum),
+    make_output_list_ptr<int, int>(42, 4711));
+
+  int bad_sum{};
+  auto bad_id = group.start(
+    "mail.dev.null", server_endpoint.port(), "add",
+    make_input_list_ptr<int>(bad_sum),
+    make_output_list_ptr<int, int>(42, 4711));
+
+  std::size_t n_completed = 0;
+  while(group.busy())
+  {
+    auto completion = group.complete_next_call();
+    ++n_completed;
+
+    if(completion.id_ == bad_id)
+    {
+      assert(completion.ex_ != nullptr);
+    }
+    else
+    {
+      assert(completion.id_ == good_id);
+      assert(completion.ex_ == nullptr);
+    }
+  }
+  assert(n_completed == 2);
+  assert(sum == 42 + 4711);
+
+  // this one uses the addresses found by the first lookup
+  int second_sum{};
+  auto second_id = group.start(
+    server_endpoint.ip_address(), server_endpoint.port(), "add",
+    make_input_list_ptr<int>(second_sum),
+    make_output_list_ptr<int, int>(4711, 42));
+  auto completion = group.complete_next_call();
+  assert(completion.id_ == second_id);
+  assert(completion.ex_ == nullptr);
+  assert(second_sum == 4711 + 42);
+
+  if(auto msg = context.message_at(loglevel_t::info))
+  {
+    *msg << __func__ << ": done";
+  }
+}
+
+void test_group_fallback(logging_context_t const& context,
+                         nb_client_cache_t& cache,
+                         endpoint_t const& server_endpoint)
+{
+  if(auto msg = context.message_at(loglevel_t::info))
+  {
+    *msg << __func__ << ": starting";
+  }
+
+  // an address nobody listens on anymore
+  endpoint_t dead_endpoint;
+  {
+    socket_layer_t& sockets = cache.socket_layer();
+    tcp_acceptor_t acceptor(sockets,
+      resolve_ip(sockets, server_endpoint.ip_address(), any_port));
+    dead_endpoint = acceptor.local_endpoint();
+  }
+
+  rpc_client_group_t group(context, cache);
+
+  int sum{};
+  auto id = group.start(endpoints_t{dead_endpoint, server_endpoint}, "add",
+    make_input_list_ptr<int>(sum),
+    make_output_list_ptr<int, int>(42, 4711));
+
+  auto completion = group.complete_next_call();
+  assert(completion.id_ == id);
+  assert(completion.ex_ == nullptr);
+  assert(sum == 42 + 4711);
+
+  if(auto msg = context.message_at(loglevel_t::info))
+  {
+    *msg << __func__ << ": done";
+  }
+}
+
+void test_group_silent_server(logging_context_t const& context)
+{
+  if(auto msg = context.message_at(loglevel_t::info))
+  {
+    *msg << __func__ << ": starting";
+  }
+
+  socket_layer_t sockets;
+
+  // a server that accepts connections (through its backlog), but
+  // never replies
+  tcp_acceptor_t acceptor(sockets,
+    local_interfaces(sockets, any_port).front());
+
+  simple_nb_client_cache_t cache(sockets);
+  rpc_client_group_t group(context, cache);
+
+  // starting the calls, including their raw blobs negotiation, must
+  // not wait for the server
+  std::size_t constexpr n_calls = 3;
+  std::vector<int> sums(n_calls);
+  for(std::size_t i = 0; i != n_calls; ++i)
+  {
+    group.start(acceptor.local_endpoint(), "add",
+      make_input_list_ptr<int>(sums[i]),
+      make_output_list_ptr<int, int>(42, static_cast<int>(i)));
+  }
+  assert(group.size() == n_calls);
+
+  if(auto msg = context.message_at(loglevel_t::info))
+  {
+    *msg << __func__ << ": done";
+  }
+}
+
 void run_logic_tests(logging_context_t const& client_context,
                      logging_context_t const& server_context,
                      selector_factory_t factory,
@@ -550,6 +820,13 @@ void run_logic_tests(logging_context_t const& client_context,
       test_streaming_output_error(client_context, client);
       test_streaming_input_error(client_context, client);
       test_streaming_multiple_errors(client_context, client);
+      test_blob_echo(client_context, client);
+      test_blob_censored_echo(client_context, client);
+      test_blob_echo(client_context, client);
+
+      test_group(client_context, cache, server_endpoint);
+      test_group_host_names(client_context, cache, server_endpoint);
+      test_group_fallback(client_context, cache, server_endpoint);
     }
   }
 
@@ -823,6 +1100,8 @@ int run_tests(int argc, char const* const* argv)
     options.enable_server_logging_ ? cerr_logger : null_logger,
     options.loglevel_);
 
+  test_group_silent_server(client_context);
+
   auto factories = available_selector_factories();
   for(auto const& factory : factories)
   {
@@ -196,6 +196,8 @@ void test_single_server_reuse(logging_context_t const& context)
     auto id_2 = connection_id(*client_2);
 
     assert(id_1 == id_2);
+    assert(cache.hits() == 1);
+    assert(cache.misses() == 1);
   }
     
   if(auto msg = context.message_at(loglevel_t::info))
@@ -354,6 +356,50 @@ void test_eviction(logging_context_t const& context)
     auto id_2 = connection_id(*client_2);
 
     assert(id_1 != id_2);
+    assert(cache.evictions() == 1);
+    assert(cache.hits() == 0);
+  }
+    
+  if(auto msg = context.message_at(loglevel_t::info))
+  {
+    *msg << __func__ << ": done";
+  }
+}
+
+void test_server_hangup(logging_context_t const& context)
+{
+  if(auto msg = context.message_at(loglevel_t::info))
+  {
+    *msg << __func__ << ": starting";
+  }
+
+  {
+    socket_layer_t sockets;
+    simple_nb_client_cache_t cache(sockets);
+    tcp_acceptor_t acceptor(sockets,
+      local_interfaces(sockets, any_port).front());
+
+    auto client_1 = cache.obtain(context, acceptor.local_endpoint());
+    assert(client_1 != nullptr);
+    auto id_1 = connection_id(*client_1);
+
+    {
+      std::unique_ptr<tcp_connection_t> accepted;
+      acceptor.accept(accepted);
+      assert(accepted != nullptr);
+      // accepted goes out of scope: the server hangs up
+    }
+
+    cache.store(context, std::move(client_1));
+
+    auto client_2 = cache.obtain(context, acceptor.local_endpoint());
+    assert(client_2 != nullptr);
+    auto id_2 = connection_id(*client_2);
+
+    assert(id_1 != id_2);
+    assert(cache.probe_failures() == 1);
+    assert(cache.hits() == 0);
+    assert(cache.misses() == 2);
   }
     
   if(auto msg = context.message_at(loglevel_t::info))
@@ -404,6 +450,10 @@ void test_aging(logging_context_t const& context)
 
     assert(id_1_2 != id_2_2);
 
+    // closed by either the reaper thread or obtain()
+    assert(cache.expirations() == 2);
+    assert(cache.hits() == 0);
+
     cache.store(context, std::move(client_1_2));
     cache.store(context, std::move(client_2_2));
 
@@ -483,6 +533,7 @@ int run_tests(int argc, char const* const* argv)
   test_single_server_invalidation(context);
   test_multi_server_invalidation(context);
   test_eviction(context);
+  test_server_hangup(context);
   test_aging(context);
 
   return 0;
@@ -23,10 +23,15 @@
 #include <cuti/charclass.hpp>
 #include <cuti/cmdline_reader.hpp>
 #include <cuti/io_test_utils.hpp>
+#include <cuti/nb_inbuf.hpp>
+#include <cuti/nb_outbuf.hpp>
+#include <cuti/nb_tcp_buffers.hpp>
 #include <cuti/option_walker.hpp>
 #include <cuti/streambuf_backend.hpp>
+#include <cuti/tcp_connection.hpp>
 
 #include <iostream>
+#include <string>
 #include <utility>
 
 #undef NDEBUG
@@ -60,6 +65,23 @@ void test_failing_reads(logging_context_t const& context, std::size_t bufsize)
   test_failing_read<T>(context, bufsize, "\"\\x\"");
   test_failing_read<T>(context, bufsize, "\"\\xg\"");
   test_failing_read<T>(context, bufsize, "\"\\xa\"");
+
+  // bad raw blob length
+  test_failing_read<T>(context, bufsize, "#");
+  test_failing_read<T>(context, bufsize, "#\"\"");
+  test_failing_read<T>(context, bufsize, "#3\n\"abc\"");
+  test_failing_read<T>(context, bufsize, "#99999999999999999999999\"\"");
+
+  // missing double quote after raw blob length
+  test_failing_read<T>(context, bufsize, "#3");
+  test_failing_read<T>(context, bufsize, "#3 \"abc\"");
+
+  // premature eof in raw blob
+  test_failing_read<T>(context, bufsize, "#3\"ab");
+
+  // missing closing double quote after raw blob
+  test_failing_read<T>(context, bufsize, "#3\"abc");
+  test_failing_read<T>(context, bufsize, "#3\"abcd\"");
 }
 
 std::string printables()
@@ -104,6 +126,77 @@ void test_roundtrips(logging_context_t const& context, std::size_t bufsize)
   test_roundtrip(context, bufsize, printables());
   test_roundtrip(context, bufsize, non_printables());
   test_roundtrip(context, bufsize, all_characters());
+
+  test_raw_blobs_roundtrip(context, bufsize, std::string());
+  test_raw_blobs_roundtrip(context, bufsize, printables());
+  test_raw_blobs_roundtrip(context, bufsize, non_printables());
+  test_raw_blobs_roundtrip(context, bufsize, all_characters());
+}
+
+/*
+ * Sends a blob that is large enough for a zero-copy write over a tcp
+ * connection, with both raw blobs and zero-copy writes enabled.
+ */
+void test_zerocopy_raw_blob(logging_context_t const& context)
+{
+  std::string value(
+    4 * detail::blob_writer_t<std::string>::min_zerocopy_size, '\0');
+  for(std::size_t i = 0; i != value.size(); ++i)
+  {
+    value[i] = static_cast<char>(i * 7 + i / 4096);
+  }
+
+  socket_layer_t sockets;
+  default_scheduler_t scheduler(sockets);
+
+  auto [producer, consumer] = make_connected_pair(sockets);
+  auto producer_bufs = make_nb_tcp_buffers(std::move(producer));
+  auto consumer_bufs = make_nb_tcp_buffers(std::move(consumer));
+
+  nb_outbuf_t& outbuf = *producer_bufs.second;
+  outbuf.enable_raw_blobs();
+  bool zerocopy = outbuf.enable_zerocopy();
+
+  if(auto msg = context.message_at(loglevel_t::info))
+  {
+    *msg << __func__ << ": zerocopy enabled: " << zerocopy <<
+      " blob size: " << value.size();
+  }
+
+  bound_outbuf_t bot(outbuf, scheduler);
+  bound_inbuf_t bit(*consumer_bufs.first, scheduler);
+
+  stack_marker_t base_marker;
+
+  final_result_t<void> write_result;
+  writer_t<std::string> writer(write_result, bot);
+  final_result_t<std::string> read_result;
+  reader_t<std::string> reader(read_result, bit);
+
+  writer.start(base_marker, value);
+  reader.start(base_marker);
+
+  while(!write_result.available())
+  {
+    auto cb = scheduler.wait();
+    assert(cb != nullptr);
+    cb(base_marker);
+  }
+  write_result.value();
+
+  final_result_t<void> flush_result;
+  flusher_t flusher(flush_result, bot);
+  flusher.start(base_marker);
+
+  while(!flush_result.available() || !read_result.available())
+  {
+    auto cb = scheduler.wait();
+    assert(cb != nullptr);
+    cb(base_marker);
+  }
+  flush_result.value();
+
+  assert(read_result.value() == value);
 }
 
 struct options_t
@@ -159,6 +252,8 @@ int run_tests(int argc, char const* const* argv)
     test_failing_reads(context, bufsize);
     test_roundtrips(context, bufsize);
   }
+
+  test_zerocopy_raw_blob(context);
   
   return 0;
 }
@@ -198,6 +198,76 @@ void duplicate_bind(logging_context_t const& context)
   }
 }
 
+#ifndef _WIN32 // POSIX
+
+void shared_bind(logging_context_t const& context,
+                 socket_layer_t& sockets,
+                 endpoint_t const& interface)
+{
+  bool const reuse_port = true;
+
+  tcp_acceptor_t acceptor1(sockets, interface, reuse_port);
+  if(auto msg = context.message_at(loglevel))
+  {
+    *msg << "shared_bind: acceptor " << acceptor1 <<
+      " at interface " << interface;
+  }
+
+  tcp_acceptor_t acceptor2(sockets, acceptor1.local_endpoint(), reuse_port);
+  if(auto msg = context.message_at(loglevel))
+  {
+    *msg << "shared_bind: second acceptor " << acceptor2;
+  }
+  assert(acceptor2.local_endpoint().port() ==
+    acceptor1.local_endpoint().port());
+
+  // each incoming connection is queued on exactly one of the acceptors
+  acceptor1.set_nonblocking();
+  acceptor2.set_nonblocking();
+
+  tcp_connection_t client(sockets, acceptor1.local_endpoint());
+
+  std::unique_ptr<tcp_connection_t> server;
+  unsigned int pause = 0;
+  unsigned int attempt;
+  for(attempt = 0; server == nullptr && attempt != 10; ++attempt)
+  {
+    if(pause != 0)
+    {
+      std::this_thread::sleep_for(milliseconds_t(pause));
+    }
+    pause = pause * 2 + 1;
+
+    int r = acceptor1.accept(server);
+    assert(r == 0);
+    if(server == nullptr)
+    {
+      r = acceptor2.accept(server);
+      assert(r == 0);
+    }
+  }
+  assert(server != nullptr);
+  if(auto msg = context.message_at(loglevel))
+  {
+    *msg << "shared_bind: server side: " << *server <<
+      " after " << attempt << " attempt(s)";
+  }
+}
+
+void shared_bind(logging_context_t const& context)
+{
+  socket_layer_t sockets;
+  auto interfaces = local_interfaces(sockets, any_port);
+  assert(!interfaces.empty());
+
+  for(auto const& interface : interfaces)
+  {
+    shared_bind(context, sockets, interface);
+  }
+}
+
+#endif // POSIX
+
 bool prove_dual_stack(logging_context_t const& context,
                       socket_layer_t& sockets,
                       endpoints_t const& interfaces)
@@ -293,6 +363,9 @@ void run_tests(int argc, char const* const* /* argv */)
   blocking_accept(context);
   nonblocking_accept(context);
   duplicate_bind(context);
+#ifndef _WIN32
+  shared_bind(context);
+#endif
   dual_stack(context);
 }
 
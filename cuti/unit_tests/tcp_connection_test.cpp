@@ -25,6 +25,7 @@
 #include <cuti/endpoint.hpp>
 #include <cuti/error_status.hpp>
 #include <cuti/file_backend.hpp>
+#include <cuti/fs_utils.hpp>
 #include <cuti/logger.hpp>
 #include <cuti/logging_context.hpp>
 #include <cuti/option_walker.hpp>
@@ -35,18 +36,27 @@
 #include <cuti/socket_layer.hpp>
 #include <cuti/stack_marker.hpp>
 #include <cuti/streambuf_backend.hpp>
+#include <cuti/system_error.hpp>
+#include <cuti/tcp_acceptor.hpp>
 
 #include <algorithm>
+#include <chrono>
+#include <cstdlib>
 #include <cstring>
 #include <exception>
 #include <iostream>
 #include <limits>
 #include <memory>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <utility>
 #include <vector>
 
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
 // Enable assert()
 #undef NDEBUG
 #include <cassert>
@@ -856,6 +866,108 @@ void run_pipe_serially(producer_t& producer,
 unsigned int const bufsize = 256 * 1024;
 std::string const payload = make_lorems(256);
 
+#ifndef _WIN32
+
+/*
+ * A private temporary directory holding the unix domain socket; both
+ * are removed on exit.
+ */
+struct unix_socket_dir_t
+{
+  unix_socket_dir_t()
+  : path_()
+  {
+    char const* tmpdir = std::getenv("TMPDIR");
+    std::string templ = tmpdir != nullptr && *tmpdir != '\0' ?
+      tmpdir : "/tmp";
+    templ += "/tcp_connection_test.XXXXXX";
+
+    if(::mkdtemp(templ.data()) == nullptr)
+    {
+      int cause = last_system_error();
+      system_exception_builder_t builder;
+      builder << "can't create directory " << templ << ": " <<
+        error_status_t(cause);
+      builder.explode();
+    }
+
+    path_ = std::move(templ);
+  }
+
+  unix_socket_dir_t(unix_socket_dir_t const&) = delete;
+  unix_socket_dir_t& operator=(unix_socket_dir_t const&) = delete;
+
+  std::string socket_path() const
+  {
+    return path_ + "/test.sock";
+  }
+
+  ~unix_socket_dir_t()
+  {
+    try_delete(this->socket_path().c_str());
+    ::rmdir(path_.c_str());
+  }
+
+private :
+  std::string path_;
+};
+
+std::string const& unix_socket_path()
+{
+  static unix_socket_dir_t const dir;
+  static std::string const path = dir.socket_path();
+  return path;
+}
+
+#endif // !_WIN32
+
+/*
+ * The local IP interfaces, plus a unix domain socket where available
+ */
+endpoints_t test_interfaces(socket_layer_t& sockets)
+{
+  auto result = local_interfaces(sockets, any_port);
+#ifndef _WIN32
+  result.push_back(resolve_unix(sockets, unix_socket_path()));
+#endif
+  return result;
+}
+
+void socketpair_transfer(logging_context_t const& context)
+{
+#ifndef _WIN32
+  socket_layer_t sockets;
+
+  char const* first = payload.data();
+  char const* last = payload.data() + payload.size();
+
+  auto[producer_out, filter_in] = make_socketpair(sockets);
+  auto[filter_out, consumer_in] = make_socketpair(sockets);
+
+  if(auto msg = context.message_at(loglevel_t::info))
+  {
+    *msg << "socketpair_transfer():" <<
+      " producer out: " << *producer_out <<
+      " filter in: " << *filter_in <<
+      " filter out: " << *filter_out <<
+      " consumer in: " << *consumer_in <<
+      " buffer size: " << bufsize <<
+      " bytes to transfer: " << payload.size();
+  }
+
+  assert(producer_out->local_endpoint().is_unix());
+  assert(producer_out->remote_endpoint().unix_path().empty());
+
+  producer_t producer(context, *producer_out, first, last, bufsize);
+  filter_t filter(context, *filter_in, *filter_out, bufsize);
+  consumer_t consumer(context, *consumer_in, first, last, bufsize);
+
+  run_pipe_in_parallel(producer, filter, consumer);
+#else
+  static_cast<void>(context);
+#endif
+}
+
 void blocking_transfer(logging_context_t const& context,
                        socket_layer_t& sockets,
                        endpoint_t const& interface)
@@ -888,7 +1000,7 @@ void blocking_transfer(logging_context_t const& context)
 {
   socket_layer_t sockets;
 
-  auto interfaces = local_interfaces(sockets, any_port);
+  auto interfaces = test_interfaces(sockets);
   for(auto const& interface : interfaces)
   {
     blocking_transfer(context, sockets, interface);
@@ -934,7 +1046,7 @@ void nonblocking_transfer(logging_context_t const& context, bool agile)
 {
   socket_layer_t sockets;
 
-  auto interfaces = local_interfaces(sockets, any_port);
+  auto interfaces = test_interfaces(sockets);
   for(auto const& interface : interfaces)
   {
     nonblocking_transfer(context, sockets, interface, agile);
@@ -992,7 +1104,7 @@ void selected_transfer(logging_context_t const& context)
   socket_layer_t sockets;
 
   auto factories = available_selector_factories();
-  auto interfaces = local_interfaces(sockets, any_port);
+  auto interfaces = test_interfaces(sockets);
 
   for(auto const& factory : factories)
   {
@@ -1031,7 +1143,7 @@ void blocking_client_server(logging_context_t const& context,
 void blocking_client_server(logging_context_t const& context)
 {
   socket_layer_t sockets;
-  auto interfaces = local_interfaces(sockets, any_port);
+  auto interfaces = test_interfaces(sockets);
   for(auto const& interface : interfaces)
   {
     blocking_client_server(context, sockets, interface);
@@ -1070,7 +1182,7 @@ void nonblocking_client_server(logging_context_t const& context,
 void nonblocking_client_server(logging_context_t const& context, bool agile)
 {
   socket_layer_t sockets;
-  auto interfaces = local_interfaces(sockets, any_port);
+  auto interfaces = test_interfaces(sockets);
   for(auto const& interface : interfaces)
   {
     nonblocking_client_server(context, sockets, interface, agile);
@@ -1122,7 +1234,7 @@ void selected_client_server(logging_context_t const& context)
   socket_layer_t sockets;
 
   auto factories = available_selector_factories();
-  auto interfaces = local_interfaces(sockets, any_port);
+  auto interfaces = test_interfaces(sockets);
 
   for(auto const& factory : factories)
   {
@@ -1160,7 +1272,7 @@ void broken_pipe(logging_context_t const& context)
 {
   socket_layer_t sockets;
 
-  auto interfaces = local_interfaces(sockets, any_port);
+  auto interfaces = test_interfaces(sockets);
   for(auto const& interface : interfaces)
   {
     broken_pipe(context, sockets, interface);
@@ -1254,7 +1366,7 @@ void scheduler_switch(logging_context_t const& context)
   socket_layer_t sockets;
 
   auto factories = available_selector_factories();
-  auto interfaces = local_interfaces(sockets, any_port);
+  auto interfaces = test_interfaces(sockets);
 
   for(auto const& factory : factories)
   {
@@ -1282,6 +1394,274 @@ struct options_t
   loglevel_t loglevel_;
 };
 
+void await_writable(default_scheduler_t& scheduler,
+                    tcp_connection_t const& conn)
+{
+  bool writable = false;
+  conn.call_when_writable(scheduler,
+    [&writable](stack_marker_t&) { writable = true; });
+
+  stack_marker_t base_marker;
+  while(!writable)
+  {
+    auto callback = scheduler.wait();
+    assert(callback != nullptr);
+    callback(base_marker);
+  }
+}
+
+void nonblocking_connect(logging_context_t const& context,
+                         socket_layer_t& sockets,
+                         selector_factory_t const& factory,
+                         endpoint_t const& interface)
+{
+  tcp_acceptor_t acceptor(sockets, interface);
+  tcp_connection_t client(sockets, acceptor.local_endpoint(),
+    connect_mode_t::nonblocking);
+
+  if(auto msg = context.message_at(loglevel_t::info))
+  {
+    *msg << "nonblocking_connect():" <<
+      " selector: " << factory <<
+      " client: " << client;
+  }
+
+  default_scheduler_t scheduler(sockets, factory);
+  await_writable(scheduler, client);
+
+  char const* first = lorem;
+  char const* last = lorem + 5;
+  char const* next = nullptr;
+  int r = client.write(first, last, next);
+  assert(r == 0);
+  assert(next == last);
+  assert(!client.connecting());
+
+  std::unique_ptr<tcp_connection_t> server;
+  acceptor.accept(server);
+  assert(server != nullptr);
+  assert(server->remote_endpoint() == client.local_endpoint());
+
+  char buf[5];
+  char* rnext = nullptr;
+  r = server->read(buf, buf + sizeof buf, rnext);
+  assert(r == 0);
+  assert(rnext != buf);
+  assert(std::equal(buf, rnext, first));
+}
+
+void refused_connect(logging_context_t const& context,
+                     socket_layer_t& sockets,
+                     selector_factory_t const& factory,
+                     endpoint_t const& interface)
+{
+  endpoint_t target;
+  {
+    tcp_acceptor_t acceptor(sockets, interface);
+    target = acceptor.local_endpoint();
+  }
+
+  // nobody is listening at target anymore
+  std::unique_ptr<tcp_connection_t> client;
+  try
+  {
+    client = std::make_unique<tcp_connection_t>(
+      sockets, target, connect_mode_t::nonblocking);
+  }
+  catch(system_exception_t const& ex)
+  {
+    // refused right away
+    if(auto msg = context.message_at(loglevel_t::info))
+    {
+      *msg << "refused_connect(): selector: " << factory <<
+        " immediate failure: " << ex.what();
+    }
+    return;
+  }
+
+  default_scheduler_t scheduler(sockets, factory);
+  await_writable(scheduler, *client);
+
+  char const* first = lorem;
+  char const* last = lorem + 5;
+  char const* next = nullptr;
+  int r = client->write(first, last, next);
+  assert(r != 0);
+  assert(next == last);
+
+  if(auto msg = context.message_at(loglevel_t::info))
+  {
+    *msg << "refused_connect(): selector: " << factory <<
+      " client: " << *client << " write error: " << error_status_t(r);
+  }
+
+  // the failure sticks
+  char buf[5];
+  char* rnext = nullptr;
+  r = client->read(buf, buf + sizeof buf, rnext);
+  assert(r != 0);
+  assert(rnext == buf);
+}
+
+void nonblocking_connect(logging_context_t const& context)
+{
+  socket_layer_t sockets;
+
+  auto factories = available_selector_factories();
+  auto interfaces = test_interfaces(sockets);
+
+  for(auto const& factory : factories)
+  {
+    for(auto const& interface : interfaces)
+    {
+      nonblocking_connect(context, sockets, factory, interface);
+      refused_connect(context, sockets, factory, interface);
+    }
+  }
+}
+
+void zerocopy_transfer(logging_context_t const& context,
+                       socket_layer_t& sockets,
+                       endpoint_t const& interface)
+{
+  auto blob = std::make_shared<std::string>(
+    1024 * 1024, static_cast<char>(0));
+  for(std::size_t i = 0; i != blob->size(); ++i)
+  {
+    (*blob)[i] = static_cast<char>(i * 7 + i / 4096);
+  }
+
+  auto[producer_out, consumer_in] = make_connected_pair(sockets, interface);
+  bool enabled = producer_out->enable_zerocopy();
+  assert(enabled == producer_out->zerocopy_enabled());
+
+  if(auto msg = context.message_at(loglevel_t::info))
+  {
+    *msg << "zerocopy_transfer():" <<
+      " producer out: " << *producer_out <<
+      " consumer in: " << *consumer_in <<
+      " zerocopy enabled: " << enabled <<
+      " bytes to transfer: " << blob->size();
+  }
+
+  std::string received;
+  {
+    scoped_thread_t consumer_thread([&]
+    {
+      char buf[4096];
+      char* next;
+      do
+      {
+        int r = consumer_in->read(buf, buf + sizeof buf, next);
+        assert(r == 0);
+        received.append(buf, next);
+      } while(next != buf);
+    });
+
+    char const* first = blob->data();
+    char const* last = blob->data() + blob->size();
+    while(first != last)
+    {
+      char const* next;
+      int r = producer_out->write_zerocopy(first, last, next, blob);
+      assert(r == 0);
+      first = next;
+    }
+    producer_out->close_write_end();
+  }
+
+  assert(received == *blob);
+
+  // the kernel releases our blob after the peer acknowledged it
+  while(producer_out->pending_zerocopy_writes() != 0)
+  {
+    assert(enabled);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  assert(blob.use_count() == 1);
+}
+
+void zerocopy_transfer(logging_context_t const& context)
+{
+  socket_layer_t sockets;
+
+  auto interfaces = test_interfaces(sockets);
+  for(auto const& interface : interfaces)
+  {
+    zerocopy_transfer(context, sockets, interface);
+  }
+}
+
+void zerocopy_after_close(logging_context_t const& context,
+                          socket_layer_t& sockets,
+                          endpoint_t const& interface)
+{
+  auto blob = std::make_shared<std::string>(
+    1024 * 1024, static_cast<char>(0));
+  for(std::size_t i = 0; i != blob->size(); ++i)
+  {
+    (*blob)[i] = static_cast<char>(i * 11 + i / 4096);
+  }
+
+  auto[producer_out, consumer_in] = make_connected_pair(sockets, interface);
+  bool enabled = producer_out->enable_zerocopy();
+
+  if(auto msg = context.message_at(loglevel_t::info))
+  {
+    *msg << "zerocopy_after_close():" <<
+      " producer out: " << *producer_out <<
+      " consumer in: " << *consumer_in <<
+      " zerocopy enabled: " << enabled;
+  }
+
+  std::string received;
+  {
+    scoped_thread_t consumer_thread([&]
+    {
+      char buf[4096];
+      char* next;
+      do
+      {
+        int r = consumer_in->read(buf, buf + sizeof buf, next);
+        assert(r == 0);
+        received.append(buf, next);
+      } while(next != buf);
+    });
+
+    char const* first = blob->data();
+    char const* last = blob->data() + blob->size();
+    while(first != last)
+    {
+      char const* next;
+      int r = producer_out->write_zerocopy(first, last, next, blob);
+      assert(r == 0);
+      first = next;
+    }
+
+    // the kernel may still be using the blob; closing must not free it
+    producer_out.reset();
+  }
+
+  assert(received == *blob);
+
+  while(blob.use_count() != 1)
+  {
+    assert(enabled);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+void zerocopy_after_close(logging_context_t const& context)
+{
+  socket_layer_t sockets;
+
+  auto interfaces = test_interfaces(sockets);
+  for(auto const& interface : interfaces)
+  {
+    zerocopy_after_close(context, sockets, interface);
+  }
+}
+
 void print_usage(std::ostream& os, char const* argv0)
 {
   os << "usage: " << argv0 << " [<option> ...]\n";
@@ -1349,6 +1729,13 @@ int run_tests(int argc, char const* const* argv)
 
   scheduler_switch(context);
 
+  nonblocking_connect(context);
+
+  zerocopy_transfer(context);
+  zerocopy_after_close(context);
+
+  socketpair_transfer(context);
+
   if(auto msg = context.message_at(loglevel_t::info))
   {
       *msg << "tests completed";
@@ -0,0 +1,300 @@
+/*
+ * Copyright (C) 2026 CodeShop B.V.
+ *
+ * This file is part of the cuti library.
+ *
+ * The cuti library is free software: you can redistribute it and/or
+ * modify it under the terms of version 2.1 of the GNU Lesser General
+ * Public License as published by the Free Software Foundation.
+ *
+ * The cuti library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See version
+ * 2.1 of the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of version 2.1 of the GNU Lesser
+ * General Public License along with the cuti library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <cuti/timer_wheel.hpp>
+
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <vector>
+
+// Enable assert()
+#undef NDEBUG
+#include <cassert>
+
+namespace // anonymous
+{
+
+using namespace cuti;
+
+duration_t const resolution = milliseconds_t(4);
+time_point_t const origin = time_point_t() + seconds_t(1000000);
+
+using wheel_t = timer_wheel_t<int>;
+
+/*
+ * Removes the expired timers from the wheel, returning their values
+ * in expiration order.
+ */
+std::vector<int> drain(wheel_t& wheel)
+{
+  std::vector<int> result;
+  while(wheel.has_expired())
+  {
+    int id = wheel.first_expired();
+    result.push_back(wheel.value(id));
+    wheel.remove_timer(id);
+  }
+  return result;
+}
+
+/*
+ * Returns a pseudo-random number; deterministic for repeatable
+ * tests.
+ */
+unsigned int next_random(unsigned int& state)
+{
+  state = state * 1103515245 + 12345;
+  return (state >> 8) & 0xFFFFFF;
+}
+
+void empty_wheel()
+{
+  wheel_t wheel(origin, resolution);
+
+  assert(wheel.empty());
+  assert(!wheel.has_expired());
+  assert(wheel.next_check() == time_point_t::max());
+
+  wheel.advance(origin + seconds_t(3600));
+  assert(wheel.empty());
+  assert(!wheel.has_expired());
+}
+
+void due_timers()
+{
+  wheel_t wheel(origin, resolution);
+  wheel.advance(origin + seconds_t(1));
+
+  // due timers expire right away, in order of addition
+  wheel.add_timer(origin, 0);
+  wheel.add_timer(origin + milliseconds_t(500), 1);
+  wheel.add_timer(origin - seconds_t(1), 2);
+  assert(!wheel.empty());
+  assert(wheel.next_check() == time_point_t::max());
+
+  auto expired = drain(wheel);
+  assert(wheel.empty());
+  assert(expired.size() == 3);
+  assert(expired[0] == 0);
+  assert(expired[1] == 1);
+  assert(expired[2] == 2);
+}
+
+void due_time()
+{
+  wheel_t wheel(origin, resolution);
+
+  auto when = origin + resolution + milliseconds_t(1);
+  int id = wheel.add_timer(when, 0);
+
+  // rounded up to the resolution, and unaffected by expiry
+  assert(wheel.due_time(id) == origin + 2 * resolution);
+  wheel.advance(origin + seconds_t(1));
+  assert(wheel.has_expired());
+  assert(wheel.due_time(id) == origin + 2 * resolution);
+
+  // timers beyond the wheel's range keep their own due time
+  auto far = origin + seconds_t(3600 * 24 * 365);
+  id = wheel.add_timer(far, 1);
+  assert(wheel.due_time(id) >= far);
+  assert(wheel.due_time(id) < far + resolution);
+}
+
+void never_early()
+{
+  wheel_t wheel(origin, resolution);
+
+  auto when = origin + resolution + milliseconds_t(1);
+  wheel.add_timer(when, 0);
+
+  wheel.advance(when - milliseconds_t(1));
+  assert(!wheel.has_expired());
+  assert(wheel.next_check() >= when);
+  assert(wheel.next_check() < when + resolution);
+
+  wheel.advance(wheel.next_check());
+  auto expired = drain(wheel);
+  assert(expired.size() == 1);
+  assert(expired[0] == 0);
+  assert(wheel.empty());
+}
+
+void removed_timers()
+{
+  wheel_t wheel(origin, resolution);
+
+  int id0 = wheel.add_timer(origin + milliseconds_t(10), 0);
+  wheel.add_timer(origin + milliseconds_t(20), 1);
+  int id2 = wheel.add_timer(origin + seconds_t(10), 2);
+  int id3 = wheel.add_timer(origin, 3);
+
+  wheel.remove_timer(id0);
+  wheel.remove_timer(id2);
+  wheel.remove_timer(id3);
+  assert(!wheel.has_expired());
+
+  wheel.advance(origin + seconds_t(60));
+  auto expired = drain(wheel);
+  assert(expired.size() == 1);
+  assert(expired[0] == 1);
+  assert(wheel.empty());
+}
+
+/*
+ * Follows the wheel's next_check() times, verifying that each timer
+ * expires at or after its due time, but less than one resolution
+ * later, and in order.  Some of the timers are due beyond the wheel's
+ * range, some are removed, and some are added along the way.
+ */
+void random_timers(unsigned int seed, int n_timers)
+{
+  wheel_t wheel(origin, resolution);
+  unsigned int state = seed;
+
+  std::vector<time_point_t> dues;
+  std::vector<int> ids;
+  std::vector<bool> removed;
+
+  auto add = [&](time_point_t now)
+  {
+    duration_t delay;
+    switch(next_random(state) % 4)
+    {
+    case 0 :
+      delay = milliseconds_t(next_random(state) % 300);
+      break;
+    case 1 :
+      delay = seconds_t(next_random(state) % 300);
+      break;
+    case 2 :
+      delay = seconds_t(next_random(state) % 100000);
+      break;
+    default :
+      // beyond the wheel's range
+      delay = seconds_t(100000 + next_random(state) % 500000);
+      break;
+    }
+    delay += std::chrono::microseconds(next_random(state) % 1000);
+
+    dues.push_back(now + delay);
+    ids.push_back(wheel.add_timer(dues.back(), int(dues.size() - 1)));
+    removed.push_back(false);
+  };
+
+  for(int i = 0; i != n_timers; ++i)
+  {
+    add(origin);
+  }
+  for(int i = 0; i < n_timers; i += 7)
+  {
+    wheel.remove_timer(ids[i]);
+    removed[i] = true;
+  }
+
+  int n_expired = 0;
+  time_point_t last_due = origin;
+  while(!wheel.empty())
+  {
+    auto now = wheel.next_check();
+    assert(now != time_point_t::max());
+    wheel.advance(now);
+
+    for(int value : drain(wheel))
+    {
+      assert(!removed[value]);
+      assert(dues[value] <= now);
+      assert(now - dues[value] < resolution);
+      assert(dues[value] > last_due - resolution);
+      last_due = dues[value];
+      ++n_expired;
+
+      if(value < n_timers && value % 5 == 0)
+      {
+        add(now);
+      }
+    }
+  }
+
+  int n_removed = 0;
+  for(bool r : removed)
+  {
+    n_removed += r;
+  }
+  assert(n_expired + n_removed == int(dues.size()));
+}
+
+/*
+ * Advances the wheel in one big step after a period of inactivity;
+ * all timers expire, in order of their due times' ticks.
+ */
+void idle_jump(unsigned int seed, int n_timers)
+{
+  wheel_t wheel(origin, resolution);
+  unsigned int state = seed;
+
+  std::vector<time_point_t> dues;
+  for(int i = 0; i != n_timers; ++i)
+  {
+    dues.push_back(origin + milliseconds_t(next_random(state) % 10000000));
+    wheel.add_timer(dues.back(), i);
+  }
+
+  auto now = origin + seconds_t(20000);
+  wheel.advance(now);
+  auto expired = drain(wheel);
+  assert(wheel.empty());
+  assert(int(expired.size()) == n_timers);
+
+  for(std::size_t i = 1; i < expired.size(); ++i)
+  {
+    assert(dues[expired[i - 1]] - dues[expired[i]] < resolution);
+  }
+}
+
+void run_tests(int, char const* const*)
+{
+  empty_wheel();
+  due_timers();
+  due_time();
+  never_early();
+  removed_timers();
+  random_timers(1, 1000);
+  random_timers(42, 10000);
+  idle_jump(1, 1000);
+  idle_jump(42, 10000);
+}
+
+} // anonymous
+
+int main(int argc, char* argv[])
+{
+  try
+  {
+    run_tests(argc, argv);
+  }
+  catch(std::exception const& ex)
+  {
+    std::cerr << argv[0] << ": exception: " << ex.what() << std::endl;
+    throw;
+  }
+
+  return 0;
+}
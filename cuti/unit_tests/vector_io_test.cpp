@@ -76,6 +76,11 @@ void test_failing_reads(logging_context_t const& context, std::size_t bufsize)
   test_failing_read<VC>(context, bufsize, "\"\\x\"");
   test_failing_read<VC>(context, bufsize, "\"\\xg\"");
   test_failing_read<VC>(context, bufsize, "\"\\xa\"");
+
+  // bad raw blobs
+  test_failing_read<VC>(context, bufsize, "#\"\"");
+  test_failing_read<VC>(context, bufsize, "#3\"ab");
+  test_failing_read<VC>(context, bufsize, "#3\"abcd\"");
 }
 
 std::vector<int> medium_int_vector()
@@ -162,6 +167,13 @@ void test_roundtrips(logging_context_t const& context, std::size_t bufsize)
     test_roundtrip(context, bufsize, char_vector<char>(vector_size));
     test_roundtrip(context, bufsize, char_vector<signed char>(vector_size));
     test_roundtrip(context, bufsize, char_vector<unsigned char>(vector_size));
+
+    test_raw_blobs_roundtrip(
+      context, bufsize, char_vector<char>(vector_size));
+    test_raw_blobs_roundtrip(
+      context, bufsize, char_vector<signed char>(vector_size));
+    test_raw_blobs_roundtrip(
+      context, bufsize, char_vector<unsigned char>(vector_size));
   }
 }
 
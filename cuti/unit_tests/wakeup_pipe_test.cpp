@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2026 CodeShop B.V.
+ *
+ * This file is part of the cuti library.
+ *
+ * The cuti library is free software: you can redistribute it and/or
+ * modify it under the terms of version 2.1 of the GNU Lesser General
+ * Public License as published by the Free Software Foundation.
+ *
+ * The cuti library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See version
+ * 2.1 of the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of version 2.1 of the GNU Lesser
+ * General Public License along with the cuti library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <cuti/wakeup_pipe.hpp>
+
+#include <cuti/default_scheduler.hpp>
+#include <cuti/scoped_thread.hpp>
+#include <cuti/selector_factory.hpp>
+#include <cuti/socket_layer.hpp>
+#include <cuti/stack_marker.hpp>
+
+#include <exception>
+#include <iostream>
+
+// Enable assert()
+#undef NDEBUG
+#include <cassert>
+
+namespace // anonymous
+{
+
+using namespace cuti;
+
+unsigned int run_scheduler(default_scheduler_t& scheduler)
+{
+  unsigned int n_callbacks = 0;
+
+  stack_marker_t base_marker;
+  while(auto callback = scheduler.wait())
+  {
+    callback(base_marker);
+    ++n_callbacks;
+  }
+
+  return n_callbacks;
+}
+
+void coalesced_wakeups(selector_factory_t const& factory)
+{
+  socket_layer_t sockets;
+  default_scheduler_t scheduler(sockets, factory);
+  wakeup_pipe_t pipe(sockets);
+
+  unsigned int n_calls = 0;
+  pipe.call_on_wakeup(scheduler, [&](stack_marker_t&) { ++n_calls; });
+  pipe.wakeup();
+  pipe.wakeup();
+  pipe.wakeup();
+
+  assert(run_scheduler(scheduler) == 1);
+  assert(n_calls == 1);
+}
+
+void early_wakeup(selector_factory_t const& factory)
+{
+  socket_layer_t sockets;
+  default_scheduler_t scheduler(sockets, factory);
+  wakeup_pipe_t pipe(sockets);
+
+  // a wakeup without a pending callback triggers the next one
+  pipe.wakeup();
+
+  unsigned int n_calls = 0;
+  pipe.call_on_wakeup(scheduler, [&](stack_marker_t&) { ++n_calls; });
+
+  assert(run_scheduler(scheduler) == 1);
+  assert(n_calls == 1);
+}
+
+void wakeup_from_thread(selector_factory_t const& factory)
+{
+  socket_layer_t sockets;
+  default_scheduler_t scheduler(sockets, factory);
+  wakeup_pipe_t pipe(sockets);
+
+  unsigned int n_calls = 0;
+  pipe.call_on_wakeup(scheduler, [&](stack_marker_t&) { ++n_calls; });
+
+  {
+    scoped_thread_t waker([&] { pipe.wakeup(); });
+    assert(run_scheduler(scheduler) == 1);
+  }
+  assert(n_calls == 1);
+}
+
+void canceled_callback(selector_factory_t const& factory)
+{
+  socket_layer_t sockets;
+  default_scheduler_t scheduler(sockets, factory);
+  wakeup_pipe_t pipe(sockets);
+
+  pipe.call_on_wakeup(scheduler,
+    [](stack_marker_t&) { assert(!"unexpected call"); });
+  pipe.wakeup();
+  pipe.cancel_on_wakeup();
+
+  assert(scheduler.wait() == nullptr);
+}
+
+void run_tests(int, char const* const*)
+{
+  for(auto const& factory : available_selector_factories())
+  {
+    coalesced_wakeups(factory);
+    early_wakeup(factory);
+    wakeup_from_thread(factory);
+    canceled_callback(factory);
+  }
+}
+
+} // anonymous
+
+int main(int argc, char* argv[])
+{
+  try
+  {
+    run_tests(argc, argv);
+  }
+  catch(std::exception const& ex)
+  {
+    std::cerr << argv[0] << ": exception: " << ex.what() << std::endl;
+    throw;
+  }
+
+  return 0;
+}
@@ -17,6 +17,7 @@
  * <http://www.gnu.org/licenses/>.
  */
 
+#include <cuti/chrono_types.hpp>
 #include <cuti/cmdline_reader.hpp>
 #include <cuti/dispatcher.hpp>
 #include <cuti/endpoint.hpp>
@@ -33,6 +34,7 @@
 #include <cuti/streambuf_backend.hpp>
 
 #include <x264_proto/client.hpp>
+#include <x26x_proto/frame_queue.hpp>
 #include <x26x_es_utils/unit_tests_common.hpp>
 #include <x264_es_utils/service.hpp>
 
@@ -41,6 +43,9 @@
 #include <csignal>
 #include <exception>
 #include <iostream>
+#include <iterator>
+#include <thread>
+#include <vector>
 
 #undef NDEBUG
 #include <cassert>
@@ -233,19 +238,205 @@ void test_streaming_encode(cuti::logging_context_t const& context,
   }
 }
 
+void test_stream_encode(cuti::logging_context_t const& context,
+                        x264_proto::client_t& client,
+                        std::size_t count)
+{
+  if(auto msg = context.message_at(cuti::loglevel_t::info))
+  {
+    *msg << __func__ << ": starting";
+  }
+
+  constexpr uint32_t timescale = 600;
+  constexpr uint32_t bitrate = 400000;
+  constexpr uint32_t width = 640;
+  constexpr uint32_t height = 480;
+  constexpr auto format = x26x_proto::format_t::NV12;
+  auto session_params = common::make_test_session_params(
+    timescale, bitrate, width, height, format);
+
+  constexpr size_t gop_size = 12;
+  constexpr uint32_t duration = 25;
+
+  // frames are produced on another thread, a few at a time
+  x26x_proto::frame_queue_t frame_queue(4);
+  cuti::scoped_thread_t producer_thread([&]
+  {
+    for(std::size_t i = 0; i != count; ++i)
+    {
+      if(!frame_queue.push(common::make_test_frame(width, height, format,
+        i * duration, timescale, i % gop_size == 0, common::yuv_black_8)))
+      {
+        // the encode call failed
+        return;
+      }
+    }
+    frame_queue.close();
+  });
+
+  bool sample_headers_received = false;
+  std::size_t n_samples = 0;
+  client.encode_stream(std::move(session_params),
+    frame_queue,
+    [&](x264_proto::sample_headers_t)
+    {
+      assert(!sample_headers_received);
+      sample_headers_received = true;
+    },
+    [&](x26x_proto::sample_t)
+    {
+      assert(sample_headers_received);
+      ++n_samples;
+    });
+
+  assert(n_samples == count);
+
+  if(auto msg = context.message_at(cuti::loglevel_t::info))
+  {
+    *msg << __func__ << ": done";
+  }
+}
+
+void test_ladder_encode(cuti::logging_context_t const& context,
+                        cuti::nb_client_cache_t& cache,
+                        cuti::endpoint_t const& endpoint,
+                        std::size_t count)
+{
+  if(auto msg = context.message_at(cuti::loglevel_t::info))
+  {
+    *msg << __func__ << ": starting";
+  }
+
+  struct rung_t
+  {
+    uint32_t bitrate_;
+    uint32_t width_;
+    uint32_t height_;
+  };
+  static rung_t constexpr rungs[] = {
+    { 400000, 640, 480 },
+    { 200000, 480, 360 },
+    { 100000, 320, 240 }
+  };
+  std::size_t constexpr n_rungs = std::size(rungs);
+
+  constexpr uint32_t timescale = 600;
+  constexpr auto format = x26x_proto::format_t::NV12;
+  constexpr size_t gop_size = 12;
+  constexpr uint32_t duration = 25;
+
+  std::vector<x264_proto::sample_headers_t> sample_headers(n_rungs);
+  std::vector<std::vector<x26x_proto::sample_t>> samples(n_rungs);
+
+  // a single thread drives all the encodes
+  x264_proto::client_group_t group(context, cache);
+  for(std::size_t i = 0; i != n_rungs; ++i)
+  {
+    auto session_params = common::make_test_session_params(
+      timescale, rungs[i].bitrate_, rungs[i].width_, rungs[i].height_,
+      format);
+    auto frames = common::make_test_frames(count, gop_size,
+      rungs[i].width_, rungs[i].height_, format, timescale, duration,
+      common::yuv_black_8);
+
+    group.start_encode(endpoint, sample_headers[i], samples[i],
+      std::move(session_params), std::move(frames));
+  }
+  assert(group.size() == n_rungs);
+
+  while(group.busy())
+  {
+    auto completion = group.complete_next_call();
+    assert(completion.ex_ == nullptr);
+  }
+
+  for(auto const& rung_samples : samples)
+  {
+    assert(rung_samples.size() == count);
+  }
+
+  if(auto msg = context.message_at(cuti::loglevel_t::info))
+  {
+    *msg << __func__ << ": done";
+  }
+}
+
+void test_encode_ladder(cuti::logging_context_t const& context,
+                        x264_proto::client_t& client,
+                        std::size_t count)
+{
+  if(auto msg = context.message_at(cuti::loglevel_t::info))
+  {
+    *msg << __func__ << ": starting";
+  }
+
+  struct rung_t
+  {
+    uint32_t bitrate_;
+    uint32_t width_;
+    uint32_t height_;
+  };
+  static rung_t constexpr rungs[] = {
+    { 400000, 640, 480 },
+    { 200000, 480, 360 },
+    { 100000, 320, 240 }
+  };
+  std::size_t constexpr n_rungs = std::size(rungs);
+
+  constexpr uint32_t timescale = 600;
+  constexpr auto format = x26x_proto::format_t::NV12;
+  constexpr size_t gop_size = 12;
+  constexpr uint32_t duration = 25;
+
+  std::vector<x264_proto::session_params_t> session_params;
+  for(auto const& rung : rungs)
+  {
+    session_params.push_back(common::make_test_session_params(
+      timescale, rung.bitrate_, rung.width_, rung.height_, format));
+  }
+
+  // frames for the top rung only: the server scales them for the others
+  auto frames = common::make_test_frames(count, gop_size,
+    rungs[0].width_, rungs[0].height_, format, timescale, duration,
+    common::yuv_black_8);
+
+  auto [sample_headers, samples] = client.encode_ladder(
+    std::move(session_params), std::move(frames));
+  assert(sample_headers.size() == n_rungs);
+
+  std::vector<std::size_t> counts(n_rungs, 0);
+  for(auto const& rendition_sample : samples)
+  {
+    assert(rendition_sample.rendition_ < n_rungs);
+    ++counts[rendition_sample.rendition_];
+  }
+  for(std::size_t rung_count : counts)
+  {
+    assert(rung_count == count);
+  }
+
+  if(auto msg = context.message_at(cuti::loglevel_t::info))
+  {
+    *msg << __func__ << ": done";
+  }
+}
+
 void test_service(cuti::logging_context_t const& client_context,
                   cuti::logging_context_t const& server_context,
-                  std::size_t frame_count)
+                  std::size_t frame_count,
+                  unsigned int frame_queue_depth)
 {
   if(auto msg = client_context.message_at(cuti::loglevel_t::info))
   {
-    *msg << __func__ << ": starting";
+    *msg << __func__ << ": starting (frame_queue_depth: " <<
+      frame_queue_depth << ")";
   }
 
   cuti::socket_layer_t sockets;
   cuti::dispatcher_config_t dispatcher_config;
 
   x264_es_utils::encoder_settings_t encoder_settings;
+  encoder_settings.frame_queue_depth_ = frame_queue_depth;
   encoder_settings.deterministic_ = true;
 
   auto interfaces = cuti::local_interfaces(sockets, cuti::any_port);
@@ -268,6 +459,129 @@ void test_service(cuti::logging_context_t const& client_context,
     test_echo(client_context, client);
     test_encode(client_context, client, frame_count);
     test_streaming_encode(client_context, client, frame_count);
+    test_stream_encode(client_context, client, frame_count);
+    test_ladder_encode(client_context, cache, endpoints.front(), frame_count);
+    test_encode_ladder(client_context, client, frame_count);
+  }
+
+  if(auto msg = client_context.message_at(cuti::loglevel_t::info))
+  {
+    *msg << __func__ << ": done";
+  }
+}
+
+void test_encoder_pool(cuti::logging_context_t const& client_context,
+                       cuti::logging_context_t const& server_context,
+                       std::size_t frame_count)
+{
+  if(auto msg = client_context.message_at(cuti::loglevel_t::info))
+  {
+    *msg << __func__ << ": starting";
+  }
+
+  cuti::socket_layer_t sockets;
+  cuti::dispatcher_config_t dispatcher_config;
+
+  x264_es_utils::encoder_settings_t encoder_settings;
+  encoder_settings.deterministic_ = true;
+  encoder_settings.encoder_pool_size_ = 2;
+
+  auto interfaces = cuti::local_interfaces(sockets, cuti::any_port);
+
+  {
+    x264_es_utils::service_t service(
+      server_context, sockets, dispatcher_config, encoder_settings, interfaces);
+
+    cuti::scoped_thread_t server_thread([&] { service.run(); });
+    cuti::scoped_guard_t stop_guard([&] { service.stop(SIGINT); });
+
+    auto const& endpoints = service.endpoints();
+    assert(!endpoints.empty());
+
+    cuti::simple_nb_client_cache_t cache(sockets);
+    x264_proto::client_t client(client_context, cache, endpoints.front());
+
+    constexpr uint32_t timescale = 600;
+    constexpr uint32_t bitrate = 400000;
+    constexpr uint32_t width = 640;
+    constexpr uint32_t height = 480;
+    constexpr auto format = x26x_proto::format_t::NV12;
+    constexpr size_t gop_size = 12;
+    constexpr uint32_t duration = 25;
+
+    auto const& pool = service.encoder_pool();
+    for(std::size_t i = 0; i != 3; ++i)
+    {
+      if(i != 0)
+      {
+        // wait for the spare opened after the previous request
+        while(pool.spares() == 0)
+        {
+          std::this_thread::sleep_for(cuti::milliseconds_t(10));
+        }
+      }
+
+      auto session_params = common::make_test_session_params(
+        timescale, bitrate, width, height, format);
+      auto frames = common::make_test_frames(frame_count, gop_size,
+        width, height, format, timescale, duration, common::yuv_black_8);
+
+      auto [sample_headers, samples] = client.encode(
+        std::move(session_params), std::move(frames));
+      assert(samples.size() == frame_count);
+    }
+
+    assert(pool.misses() == 1);
+    assert(pool.hits() == 2);
+    assert(pool.spares() <= 2);
+  }
+
+  if(auto msg = client_context.message_at(cuti::loglevel_t::info))
+  {
+    *msg << __func__ << ": done";
+  }
+}
+
+void test_thread_budget(cuti::logging_context_t const& client_context,
+                        cuti::logging_context_t const& server_context,
+                        std::size_t frame_count)
+{
+  if(auto msg = client_context.message_at(cuti::loglevel_t::info))
+  {
+    *msg << __func__ << ": starting";
+  }
+
+  cuti::socket_layer_t sockets;
+  cuti::dispatcher_config_t dispatcher_config;
+
+  x264_es_utils::encoder_settings_t encoder_settings;
+  encoder_settings.deterministic_ = true;
+  encoder_settings.encoder_threads_ = 2;
+  encoder_settings.max_session_threads_ = 1;
+
+  auto interfaces = cuti::local_interfaces(sockets, cuti::any_port);
+
+  {
+    x264_es_utils::service_t service(
+      server_context, sockets, dispatcher_config, encoder_settings, interfaces);
+
+    cuti::scoped_thread_t server_thread([&] { service.run(); });
+    cuti::scoped_guard_t stop_guard([&] { service.stop(SIGINT); });
+
+    auto const& endpoints = service.endpoints();
+    assert(!endpoints.empty());
+
+    // more concurrent encodes than the budget admits at once
+    cuti::simple_nb_client_cache_t cache(sockets);
+    test_ladder_encode(client_context, cache, endpoints.front(), frame_count);
+
+    // grants are returned when the handlers are destroyed
+    auto const& budget = service.thread_budget();
+    while(budget.active_sessions() != 0)
+    {
+      std::this_thread::sleep_for(cuti::milliseconds_t(10));
+    }
+    assert(budget.available_threads() == 2);
   }
 
   if(auto msg = client_context.message_at(cuti::loglevel_t::info))
@@ -343,7 +657,12 @@ int run_tests(int argc, char const* const* argv)
     options.enable_server_logging_ ? cerr_logger : null_logger,
     options.loglevel_);
 
-  test_service(client_context, server_context, options.frame_count_);
+  // default (lookahead-based) and minimal frame queue depths
+  test_service(client_context, server_context, options.frame_count_, 0);
+  test_service(client_context, server_context, options.frame_count_, 1);
+
+  test_encoder_pool(client_context, server_context, options.frame_count_);
+  test_thread_budget(client_context, server_context, options.frame_count_);
 
   return 0;
 }
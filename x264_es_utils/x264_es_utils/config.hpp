@@ -89,6 +89,7 @@ private :
   std::vector<cuti::endpoint_t> endpoints_;
   encoder_settings_t encoder_settings_;
   cuti::absolute_path_t logfile_;
+  cuti::flag_t logfile_async_;
   unsigned int logfile_rotation_depth_;
   unsigned int logfile_size_limit_;
   cuti::loglevel_t loglevel_;
@@ -108,4 +108,92 @@ void parse_optval(char const* name, cuti::args_reader_t const& reader,
   parse_optval(name, reader, in, out.value_, X264_LOOKAHEAD_THREAD_MAX);
 }
 
+void parse_optval(char const* name, cuti::args_reader_t const& reader,
+  char const* in, encoder_settings_t::frame_queue_depth_t& out)
+{
+  parse_optval(name, reader, in, out.value_);
+  if(out.value_ > encoder_settings_t::max_frame_queue_depth())
+  {
+    x264_exception_builder_t builder;
+    builder << reader.current_origin() <<
+      ": invalid value '" << in << "' for option '" << name <<
+      "'; valid values are 0 through " <<
+      encoder_settings_t::max_frame_queue_depth();
+    builder.explode();
+  }
+}
+
+void parse_optval(char const* name, cuti::args_reader_t const& reader,
+  char const* in, encoder_settings_t::encoder_pool_size_t& out)
+{
+  parse_optval(name, reader, in, out.value_);
+  if(out.value_ > encoder_settings_t::max_encoder_pool_size())
+  {
+    x264_exception_builder_t builder;
+    builder << reader.current_origin() <<
+      ": invalid value '" << in << "' for option '" << name <<
+      "'; valid values are 0 through " <<
+      encoder_settings_t::max_encoder_pool_size();
+    builder.explode();
+  }
+}
+
+void parse_optval(char const* name, cuti::args_reader_t const& reader,
+  char const* in, encoder_settings_t::encoder_pool_memory_t& out)
+{
+  parse_optval(name, reader, in, out.value_);
+}
+
+void parse_optval(char const* name, cuti::args_reader_t const& reader,
+  char const* in, encoder_settings_t::buffer_pool_memory_t& out)
+{
+  parse_optval(name, reader, in, out.value_);
+}
+
+void parse_optval(char const* name, cuti::args_reader_t const& reader,
+  char const* in, encoder_settings_t::encoder_threads_t& out)
+{
+  parse_optval(name, reader, in, out.value_);
+}
+
+void parse_optval(char const* name, cuti::args_reader_t const& reader,
+  char const* in, encoder_settings_t::max_session_threads_t& out)
+{
+  parse_optval(name, reader, in, out.value_);
+  if(out.value_ == 0)
+  {
+    x264_exception_builder_t builder;
+    builder << reader.current_origin() <<
+      ": invalid value '" << in << "' for option '" << name <<
+      "'; value must be at least 1";
+    builder.explode();
+  }
+}
+
+void parse_optval(char const* name, cuti::args_reader_t const& reader,
+  char const* in, encoder_settings_t::admission_timeout_t& out)
+{
+  parse_optval(name, reader, in, out.value_);
+}
+
+void apply_thread_grant(encoder_settings_t& settings, unsigned int threads)
+{
+  if(threads == 0)
+  {
+    return;
+  }
+
+  // 0 means auto: libx264 would start a thread for every core
+  int max_threads = static_cast<int>(threads);
+  if(settings.session_threads_.value_ == 0 ||
+     settings.session_threads_.value_ > max_threads)
+  {
+    settings.session_threads_.value_ = max_threads;
+  }
+  if(settings.session_lookahead_threads_.value_ > max_threads)
+  {
+    settings.session_lookahead_threads_.value_ = max_threads;
+  }
+}
+
 } // x264_es_utils
@@ -20,9 +20,11 @@
 #include "encoding_session.hpp"
 #include "x264_exception.hpp"
 
+#include <cuti/buffer_pool.hpp>
 #include <cuti/stringprintf.hpp>
 #include <x264_proto/types.hpp>
 
+#include <chrono>
 #include <iomanip>
 #include <limits>
 #include <thread>
@@ -108,11 +110,17 @@ struct x264_output_t
   x264_picture_t pic_;
 };
 
+/*
+ * Wraps an incoming frame as an x264 picture.  The picture's planes
+ * refer directly to the frame's data, so the frame's pixels are not
+ * copied before x264_encoder_encode() imports them into its own
+ * (internal) frame buffers.
+ */
 struct input_picture_t
 {
 public:
   input_picture_t(
-    x26x_proto::frame_t const& frame);
+    x26x_proto::frame_t&& frame);
 
   input_picture_t(input_picture_t const&) = delete;
   input_picture_t& operator=(input_picture_t const&) = delete;
@@ -124,9 +132,14 @@ public:
 
   void print(std::ostream& os) const;
 
-  ~input_picture_t();
+  ~input_picture_t()
+  {
+    // libx264 has copied the picture; recycle the frame's buffer
+    cuti::default_buffer_pool().release(std::move(frame_.data_));
+  }
 
 private :
+  x26x_proto::frame_t frame_;
   x264_picture_t picture_;
 };
 
@@ -153,6 +166,8 @@ struct wrap_x264_encoder_t
 
   int delayed_frames() const;
 
+  int maximum_delayed_frames() const;
+
   int flush(x264_output_t& output) const;
 
 private :
@@ -724,35 +739,56 @@ std::ostream& operator<<(std::ostream& os, x264_picture_t const& rhs)
   return os;
 }
 
-input_picture_t::input_picture_t(x26x_proto::frame_t const& frame)
+input_picture_t::input_picture_t(x26x_proto::frame_t&& frame)
+: frame_(std::move(frame))
 {
-  int x264_csp = to_x264_csp(frame.format_);
+  int x264_csp = to_x264_csp(frame_.format_);
 
-  size_t img_size = frame_size(frame.width_, frame.height_, frame.format_);
-  if(frame.data_.size() != img_size)
+  size_t img_size = frame_size(frame_.width_, frame_.height_, frame_.format_);
+  if(frame_.data_.size() != img_size)
   {
     x264_exception_builder_t builder;
     builder << "unexpected x264_proto::frame.data_ size " <<
-      frame.data_.size();
+      frame_.data_.size();
     builder.explode();
   }
 
-  if(x264_picture_alloc(&picture_, x264_csp, frame.width_, frame.height_) < 0)
+  x264_picture_init(&picture_);
+
+  picture_.i_type = frame_.keyframe_ ? X264_TYPE_IDR : X264_TYPE_AUTO;
+  picture_.i_pts = frame_.pts_;
+
+  // Point the x264 picture planes into our frame data. This assumes the pixel
+  // format is identical, i.e. our frame_t's NV12 is the same as x264's
+  // X264_CSP_NV12, YUV420P is the same as x264's X264_CSP_I420, and
+  // YUV420P10LE is the same as X264_CSP_I420 combined with
+  // X264_CSP_HIGH_DEPTH. The plane layout mirrors x264_picture_alloc().
+  int const elem_size = (x264_csp & X264_CSP_HIGH_DEPTH) != 0 ? 2 : 1;
+  int const y_stride = frame_.width_ * elem_size;
+  std::size_t const y_size = static_cast<std::size_t>(y_stride) *
+    frame_.height_;
+
+  picture_.img.i_csp = x264_csp;
+  picture_.img.plane[0] = frame_.data_.data();
+  picture_.img.i_stride[0] = y_stride;
+  if(frame_.format_ == x26x_proto::format_t::NV12)
   {
-    x264_exception_builder_t builder;
-    builder << "libx264 failed to allocate picture of "
-      << frame.width_ << "x" << frame.height_;
-    builder.explode();
+    picture_.img.i_plane = 2;
+    picture_.img.plane[1] = frame_.data_.data() + y_size;
+    picture_.img.i_stride[1] = y_stride;
+  }
+  else
+  {
+    int const u_stride = frame_.width_ / 2 * elem_size;
+    std::size_t const u_size = static_cast<std::size_t>(u_stride) *
+      (frame_.height_ / 2);
+
+    picture_.img.i_plane = 3;
+    picture_.img.plane[1] = frame_.data_.data() + y_size;
+    picture_.img.plane[2] = frame_.data_.data() + y_size + u_size;
+    picture_.img.i_stride[1] = u_stride;
+    picture_.img.i_stride[2] = u_stride;
   }
-
-  picture_.i_type = frame.keyframe_ ? X264_TYPE_IDR : X264_TYPE_AUTO;
-  picture_.i_pts = frame.pts_;
-
-  // Copy our frame data into x264 picture plane. This assumes the pixel format
-  // is identical, i.e. our frame_t's NV12 is the same as x264's X264_CSP_NV12,
-  // YUV420P is the same as x264's X264_CSP_I420, and YUV420P10LE is the same as
-  // X264_CSP_I420 combined with X264_CSP_HIGH_DEPTH.
-  std::copy(frame.data_.begin(), frame.data_.end(), picture_.img.plane[0]);
 }
 
 void input_picture_t::print(std::ostream& os) const
@@ -760,11 +796,6 @@ void input_picture_t::print(std::ostream& os) const
   os << picture_;
 }
 
-input_picture_t::~input_picture_t()
-{
-  x264_picture_clean(&picture_);
-}
-
 // Utility class for easy hex dumping
 struct hexdump_t
 {
@@ -876,6 +907,11 @@ int wrap_x264_encoder_t::delayed_frames() const
   return x264_encoder_delayed_frames(handle_.get());
 }
 
+int wrap_x264_encoder_t::maximum_delayed_frames() const
+{
+  return x264_encoder_maximum_delayed_frames(handle_.get());
+}
+
 int wrap_x264_encoder_t::flush(x264_output_t& output) const
 {
   return x264_encoder_encode(handle_.get(),
@@ -973,6 +1009,11 @@ struct encoding_session_t::impl_t
     return sample_headers;
   }
 
+  int max_delayed_frames() const
+  {
+    return encoder_.maximum_delayed_frames();
+  }
+
   std::optional<x26x_proto::sample_t> encode(x26x_proto::frame_t frame)
   {
     assert(! flush_called_);
@@ -989,7 +1030,7 @@ struct encoding_session_t::impl_t
     ++frame_count_;
 
     x264_output_t output;
-    input_picture_t pic_in(frame);
+    input_picture_t pic_in(std::move(frame));
     int num_bytes = encoder_.encode(output, pic_in);
     if(num_bytes < 0)
     {
@@ -1042,10 +1083,23 @@ struct encoding_session_t::impl_t
 
     x264_output_t output;
     int num_bytes;
+    int attempts = 0;
     while((num_bytes = encoder_.flush(output)) == 0)
     {
-      // Unfortunately, x264 requires a busy loop here.
-      std::this_thread::yield();
+      /*
+       * Unfortunately, x264 requires polling here.  Yield a few times
+       * for fast lookahead threads, then back off so we do not burn a
+       * core while a slow frame is being encoded.
+       */
+      if(attempts < 16)
+      {
+        ++attempts;
+        std::this_thread::yield();
+      }
+      else
+      {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+      }
     }
 
     if(num_bytes < 0)
@@ -1116,6 +1170,7 @@ private :
     }
     // x264_encoder_encode's documentation says: the payloads of all output NALs
     // are guaranteed to be sequential in memory.
+    sample.data_ = cuti::default_buffer_pool().acquire(size);
     sample.data_.insert(sample.data_.end(),
       output.nals_[0].p_payload,
       output.nals_[0].p_payload + size);
@@ -1145,6 +1200,11 @@ x264_proto::sample_headers_t encoding_session_t::sample_headers() const
   return impl_->sample_headers();
 }
 
+int encoding_session_t::max_delayed_frames() const
+{
+  return impl_->max_delayed_frames();
+}
+
 std::optional<x26x_proto::sample_t>
 encoding_session_t::encode(x26x_proto::frame_t frame)
 {
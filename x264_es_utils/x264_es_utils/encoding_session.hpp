@@ -42,6 +42,12 @@ struct encoding_session_t
 
   x264_proto::sample_headers_t sample_headers() const;
 
+  /*
+   * Returns the maximum number of frames libx264 may hold before
+   * producing a sample.
+   */
+  int max_delayed_frames() const;
+
   std::optional<x26x_proto::sample_t> encode(x26x_proto::frame_t frame);
   std::optional<x26x_proto::sample_t> flush();
 
@@ -35,6 +35,7 @@
 #include <cuti/type_list.hpp>
 
 #include <x26x_proto/client.hpp>
+#include <x26x_proto/client_group.hpp>
 #include <x26x_proto/types.hpp>
 
 #include <string>
@@ -45,6 +46,8 @@ namespace x264_proto
 {
 
 using client_t = x26x_proto::client_t<session_params_t, sample_headers_t>;
+using client_group_t =
+  x26x_proto::client_group_t<session_params_t, sample_headers_t>;
 
 } // x264_proto
 
@@ -24,6 +24,7 @@
 #include <x265_proto/default_endpoints.hpp>
 
 #include <cuti/args_reader.hpp>
+#include <cuti/async_file_backend.hpp>
 #include <cuti/cmdline_reader.hpp>
 #include <cuti/config_file_reader.hpp>
 #include <cuti/exception_builder.hpp>
@@ -67,6 +68,7 @@ config_t::config_t(cuti::socket_layer_t& sockets,
 , endpoints_()
 , encoder_settings_()
 , logfile_()
+, logfile_async_(false)
 , logfile_rotation_depth_(cuti::file_backend_t::default_rotation_depth)
 , logfile_size_limit_(cuti::file_backend_t::no_size_limit)
 , loglevel_(default_loglevel)
@@ -112,7 +114,12 @@ config_t::create_logging_backend() const
 {
   std::unique_ptr<cuti::logging_backend_t> result = nullptr;
 
-  if(!logfile_.empty())
+  if(!logfile_.empty() && logfile_async_)
+  {
+    result = std::make_unique<cuti::async_file_backend_t>(
+      logfile_, logfile_size_limit_, logfile_rotation_depth_);
+  }
+  else if(!logfile_.empty())
   {
     result = std::make_unique<cuti::file_backend_t>(
       logfile_, logfile_size_limit_, logfile_rotation_depth_);
@@ -238,10 +245,25 @@ void config_t::read_options(cuti::args_reader_t& reader,
 #ifndef _WIN32
       !walker.match("--daemon", daemon_) &&
 #endif
+      !walker.match("--admission-timeout",
+        encoder_settings_.admission_timeout_) &&
+      !walker.match("--analysis-reuse-level",
+        encoder_settings_.analysis_reuse_level_) &&
+      !walker.match("--buffer-pool-memory",
+        encoder_settings_.buffer_pool_memory_) &&
       !walker.match("--directory", directory_) &&
       !walker.match("--dry-run", dry_run_) &&
+      !walker.match("--encoder-pool-memory",
+        encoder_settings_.encoder_pool_memory_) &&
+      !walker.match("--encoder-pool-size",
+        encoder_settings_.encoder_pool_size_) &&
+      !walker.match("--encoder-threads",
+        encoder_settings_.encoder_threads_) &&
       !walker.match("--endpoint", handle_endpoint) &&
+      !walker.match("--frame-queue-depth",
+        encoder_settings_.frame_queue_depth_) &&
       !walker.match("--frame-threads", encoder_settings_.frame_threads_) &&
+      !walker.match("--logfile-async", logfile_async_) &&
       !walker.match("--logfile-rotation-depth", logfile_rotation_depth_) &&
       !walker.match("--logfile-size-limit", logfile_size_limit_) &&
       !walker.match("--loglevel", loglevel_) &&
@@ -249,16 +271,23 @@ void config_t::read_options(cuti::args_reader_t& reader,
         dispatcher_config_.max_concurrent_requests_) &&
       !walker.match("--max-connections",
         dispatcher_config_.max_connections_) &&
+      !walker.match("--max-session-threads",
+        encoder_settings_.max_session_threads_) &&
       !walker.match("--numa-pools", encoder_settings_.numa_pools_) &&
       !walker.match("--pidfile", pidfile_) &&
       !walker.match("--preset", encoder_settings_.preset_) &&
+      !walker.match("--reactor-threads",
+        dispatcher_config_.reactor_threads_) &&
       !walker.match("--selector",
         dispatcher_config_.selector_factory_) &&
+      !walker.match("--shard-listeners",
+        dispatcher_config_.shard_listeners_) &&
       !walker.match("--tune", encoder_settings_.tune_) &&
 #ifndef _WIN32
       !walker.match("--umask", umask_) &&
       !walker.match("--user", user_) &&
 #endif
+      !walker.match("--zerocopy", dispatcher_config_.zerocopy_) &&
       true
     )
     {
@@ -285,6 +314,22 @@ void config_t::print_usage(std::ostream& os)
   os << std::endl;
   os << "usage: " << argv0_ << " [<option> ...]" << std::endl;
   os << "options are:" << std::endl;
+  os << "  --admission-timeout <ms>         " <<
+    "sets max wait for encoder threads" << std::endl;
+  os << "                                     (default: " <<
+    encoder_settings_t::default_admission_timeout() <<
+    "; 0=reject at once)" << std::endl;
+  os << "  --analysis-reuse-level <level>   " <<
+    "share analysis data between renditions" << std::endl;
+  os << "                                     of the same size (1-" <<
+    encoder_settings_t::max_analysis_reuse_level() << "; default: " <<
+    encoder_settings_t::default_analysis_reuse_level() << "=off)" <<
+    std::endl;
+  os << "  --buffer-pool-memory <MiB>       " <<
+    "sets memory limit for recycled frame and" << std::endl;
+  os << "                                     sample buffers (default: " <<
+    encoder_settings_t::default_buffer_pool_memory() << "=off)" <<
+    std::endl;
   os << "  --config <path>                  " <<
     "insert options from file <path>" << std::endl;
 #ifndef _WIN32
@@ -297,6 +342,19 @@ void config_t::print_usage(std::ostream& os)
     std::endl;
   os << "  --dry-run                        " <<
     "initialize the service, but do not run it" << std::endl;
+  os << "  --encoder-pool-memory <MiB>      " <<
+    "sets memory limit for spare encoders" << std::endl;
+  os << "                                     (default: " <<
+    encoder_settings_t::default_encoder_pool_memory() << ")" << std::endl;
+  os << "  --encoder-pool-size <n>          " <<
+    "sets max #spare encoders kept open" << std::endl;
+  os << "                                     (default: " <<
+    encoder_settings_t::default_encoder_pool_size() << ")" << std::endl;
+  os << "  --encoder-threads <n>            " <<
+    "sets service-wide encoder thread budget" << std::endl;
+  os << "                                     (default: " <<
+    encoder_settings_t::default_encoder_threads() <<
+    "; 0=unlimited)" << std::endl;
   os << "  --endpoint <port>@<ip>           " <<
     "add endpoint to listen on" << std::endl;
   os << "                                     (defaults:";
@@ -308,11 +366,20 @@ void config_t::print_usage(std::ostream& os)
     }
     os << ")" << std::endl;
   }
+  os << "  --endpoint unix:<path>           " <<
+    "add unix domain socket to listen on" << std::endl;
+  os << "  --frame-queue-depth <n>          " <<
+    "sets max #frames queued per encoding session" << std::endl;
+  os << "                                     (default: " <<
+    encoder_settings_t::default_frame_queue_depth() <<
+    "; 0=follow encoder lookahead)" << std::endl;
   os << "  --frame-threads <number>         " <<
     "sets libx265 frame threads (default: " <<
     encoder_settings_t::default_frame_threads() << ")" << std::endl;
   os << "  --logfile <path>                 " <<
     "log to file <path>" << std::endl;
+  os << "  --logfile-async                  " <<
+    "write logfile from a background thread" << std::endl;
   os << "  --logfile-rotation-depth <depth> " <<
     "sets logfile rotation depth (default: " <<
     cuti::file_backend_t::default_rotation_depth << ')' << std::endl;
@@ -331,6 +398,10 @@ void config_t::print_usage(std::ostream& os)
   os << "                                     (default: " <<
     cuti::dispatcher_config_t::default_max_connections() <<
     "; 0=unlimited) " << std::endl;
+  os << "  --max-session-threads <n>        " <<
+    "sets max #encoder threads per session" << std::endl;
+  os << "                                     (default: " <<
+    encoder_settings_t::default_max_session_threads() << ")" << std::endl;
   os << "  --numa-pools <string>            " <<
     "sets libx265 numa pools (default: \"" <<
     encoder_settings_t::default_numa_pools() << "\")" << std::endl;
@@ -339,9 +410,18 @@ void config_t::print_usage(std::ostream& os)
   os << "  --preset <presets>               " <<
     "sets libx265 session presets (default: \"" <<
     encoder_settings_t::default_preset() << "\")" << std::endl;
+  os << "  --reactor-threads <n>            " <<
+    "sets #reactor threads" << std::endl;
+  os << "                                     (default: " <<
+    cuti::dispatcher_config_t::default_reactor_threads() <<
+    "; 0=thread per request) " << std::endl;
   os << "  --selector <type>                " <<
     "sets selector type (default: " <<
     cuti::dispatcher_config_t::default_selector_factory() << ")" << std::endl;
+  os << "  --shard-listeners                " <<
+    "gives each reactor thread its own SO_REUSEPORT" << std::endl;
+  os << "                                     " <<
+    "acceptor per endpoint" << std::endl;
   os << "  --syslog                         " <<
     "log to system log as " << cuti::default_syslog_name(argv0_) <<
     std::endl;
@@ -356,6 +436,8 @@ void config_t::print_usage(std::ostream& os)
   os << "  --user <name>                    " <<
     "run as user <name>" << std::endl;
 #endif
+  os << "  --zerocopy                       " <<
+    "send large samples without copying (Linux)" << std::endl;
   os << std::endl;
   os << copyright_notice() << std::endl;
 }
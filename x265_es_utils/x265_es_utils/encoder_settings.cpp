@@ -105,4 +105,108 @@ void parse_optval(char const* name, cuti::args_reader_t const& reader,
   out.value_ = in;
 }
 
+void parse_optval(char const* name, cuti::args_reader_t const& reader,
+  char const* in, encoder_settings_t::frame_queue_depth_t& out)
+{
+  parse_optval(name, reader, in, out.value_);
+  if(out.value_ > encoder_settings_t::max_frame_queue_depth())
+  {
+    x265_exception_builder_t builder;
+    builder << reader.current_origin() <<
+      ": invalid value '" << in << "' for option '" << name <<
+      "'; valid values are 0 through " <<
+      encoder_settings_t::max_frame_queue_depth();
+    builder.explode();
+  }
+}
+
+void parse_optval(char const* name, cuti::args_reader_t const& reader,
+  char const* in, encoder_settings_t::encoder_pool_size_t& out)
+{
+  parse_optval(name, reader, in, out.value_);
+  if(out.value_ > encoder_settings_t::max_encoder_pool_size())
+  {
+    x265_exception_builder_t builder;
+    builder << reader.current_origin() <<
+      ": invalid value '" << in << "' for option '" << name <<
+      "'; valid values are 0 through " <<
+      encoder_settings_t::max_encoder_pool_size();
+    builder.explode();
+  }
+}
+
+void parse_optval(char const* name, cuti::args_reader_t const& reader,
+  char const* in, encoder_settings_t::encoder_pool_memory_t& out)
+{
+  parse_optval(name, reader, in, out.value_);
+}
+
+void parse_optval(char const* name, cuti::args_reader_t const& reader,
+  char const* in, encoder_settings_t::buffer_pool_memory_t& out)
+{
+  parse_optval(name, reader, in, out.value_);
+}
+
+void parse_optval(char const* name, cuti::args_reader_t const& reader,
+  char const* in, encoder_settings_t::encoder_threads_t& out)
+{
+  parse_optval(name, reader, in, out.value_);
+}
+
+void parse_optval(char const* name, cuti::args_reader_t const& reader,
+  char const* in, encoder_settings_t::max_session_threads_t& out)
+{
+  parse_optval(name, reader, in, out.value_);
+  if(out.value_ == 0)
+  {
+    x265_exception_builder_t builder;
+    builder << reader.current_origin() <<
+      ": invalid value '" << in << "' for option '" << name <<
+      "'; value must be at least 1";
+    builder.explode();
+  }
+}
+
+void parse_optval(char const* name, cuti::args_reader_t const& reader,
+  char const* in, encoder_settings_t::admission_timeout_t& out)
+{
+  parse_optval(name, reader, in, out.value_);
+}
+
+void parse_optval(char const* name, cuti::args_reader_t const& reader,
+  char const* in, encoder_settings_t::analysis_reuse_level_t& out)
+{
+  parse_optval(name, reader, in, out.value_);
+  if(out.value_ > encoder_settings_t::max_analysis_reuse_level())
+  {
+    x265_exception_builder_t builder;
+    builder << reader.current_origin() <<
+      ": invalid value '" << in << "' for option '" << name <<
+      "'; valid values are 0 through " <<
+      encoder_settings_t::max_analysis_reuse_level();
+    builder.explode();
+  }
+}
+
+void apply_thread_grant(encoder_settings_t& settings, unsigned int threads)
+{
+  if(threads == 0)
+  {
+    return;
+  }
+
+  /*
+   * By default, libx265 creates a thread pool with a thread for every
+   * core; an explicit --numa-pools setting is left alone.
+   */
+  if(settings.numa_pools_.value_.empty())
+  {
+    settings.numa_pools_.value_ = std::to_string(threads);
+  }
+  if(settings.frame_threads_.value_ > threads)
+  {
+    settings.frame_threads_.value_ = threads;
+  }
+}
+
 } // x265_es_utils
@@ -53,22 +53,105 @@ struct encoder_settings_t
     std::string value_;
   };
 
+  struct frame_queue_depth_t
+  {
+    frame_queue_depth_t(unsigned int value) : value_(value) { }
+    unsigned int value_;
+  };
+
+  struct encoder_pool_size_t
+  {
+    encoder_pool_size_t(unsigned int value) : value_(value) { }
+    unsigned int value_;
+  };
+
+  // in MiB
+  struct encoder_pool_memory_t
+  {
+    encoder_pool_memory_t(unsigned int value) : value_(value) { }
+    unsigned int value_;
+  };
+
+  // in MiB
+  struct buffer_pool_memory_t
+  {
+    buffer_pool_memory_t(unsigned int value) : value_(value) { }
+    unsigned int value_;
+  };
+
+  struct encoder_threads_t
+  {
+    encoder_threads_t(unsigned int value) : value_(value) { }
+    unsigned int value_;
+  };
+
+  struct max_session_threads_t
+  {
+    max_session_threads_t(unsigned int value) : value_(value) { }
+    unsigned int value_;
+  };
+
+  // in milliseconds
+  struct admission_timeout_t
+  {
+    admission_timeout_t(unsigned int value) : value_(value) { }
+    unsigned int value_;
+  };
+
+  /*
+   * x265's analysis reuse level (1 through 10) for renditions of an
+   * encode_ladder request sharing their analysis data; 0 disables
+   * sharing.
+   */
+  struct analysis_reuse_level_t
+  {
+    analysis_reuse_level_t(unsigned int value) : value_(value) { }
+    unsigned int value_;
+  };
+
   static constexpr std::string default_preset() { return {}; }
   static constexpr std::string default_tune() { return {}; }
   static constexpr unsigned int default_frame_threads() { return 0; }
   static constexpr std::string default_numa_pools() { return {}; }
+  static constexpr unsigned int default_frame_queue_depth() { return 0; }
+  static constexpr unsigned int max_frame_queue_depth() { return 1024; }
+  static constexpr unsigned int default_encoder_pool_size() { return 0; }
+  static constexpr unsigned int max_encoder_pool_size() { return 64; }
+  static constexpr unsigned int default_encoder_pool_memory() { return 256; }
+  static constexpr unsigned int default_buffer_pool_memory() { return 0; }
+  static constexpr unsigned int default_encoder_threads() { return 0; }
+  static constexpr unsigned int default_max_session_threads() { return 16; }
+  static constexpr unsigned int default_admission_timeout() { return 10000; }
+  static constexpr unsigned int default_analysis_reuse_level() { return 0; }
+  static constexpr unsigned int max_analysis_reuse_level() { return 10; }
 
   encoder_settings_t()
   : preset_(default_preset())
   , tune_(default_tune())
   , frame_threads_(default_frame_threads())
   , numa_pools_(default_numa_pools())
+  , frame_queue_depth_(default_frame_queue_depth())
+  , encoder_pool_size_(default_encoder_pool_size())
+  , encoder_pool_memory_(default_encoder_pool_memory())
+  , buffer_pool_memory_(default_buffer_pool_memory())
+  , encoder_threads_(default_encoder_threads())
+  , max_session_threads_(default_max_session_threads())
+  , admission_timeout_(default_admission_timeout())
+  , analysis_reuse_level_(default_analysis_reuse_level())
   { }
 
   preset_t preset_;
   tune_t tune_;
   frame_threads_t frame_threads_;
   numa_pools_t numa_pools_;
+  frame_queue_depth_t frame_queue_depth_;
+  encoder_pool_size_t encoder_pool_size_;
+  encoder_pool_memory_t encoder_pool_memory_;
+  buffer_pool_memory_t buffer_pool_memory_;
+  encoder_threads_t encoder_threads_;
+  max_session_threads_t max_session_threads_;
+  admission_timeout_t admission_timeout_;
+  analysis_reuse_level_t analysis_reuse_level_;
 };
 
 void parse_optval(char const* name, cuti::args_reader_t const& reader,
@@ -83,6 +166,37 @@ void parse_optval(char const* name, cuti::args_reader_t const& reader,
 void parse_optval(char const* name, cuti::args_reader_t const& reader,
   char const* in, encoder_settings_t::numa_pools_t& out);
 
+void parse_optval(char const* name, cuti::args_reader_t const& reader,
+  char const* in, encoder_settings_t::frame_queue_depth_t& out);
+
+void parse_optval(char const* name, cuti::args_reader_t const& reader,
+  char const* in, encoder_settings_t::encoder_pool_size_t& out);
+
+void parse_optval(char const* name, cuti::args_reader_t const& reader,
+  char const* in, encoder_settings_t::encoder_pool_memory_t& out);
+
+void parse_optval(char const* name, cuti::args_reader_t const& reader,
+  char const* in, encoder_settings_t::buffer_pool_memory_t& out);
+
+void parse_optval(char const* name, cuti::args_reader_t const& reader,
+  char const* in, encoder_settings_t::encoder_threads_t& out);
+
+void parse_optval(char const* name, cuti::args_reader_t const& reader,
+  char const* in, encoder_settings_t::max_session_threads_t& out);
+
+void parse_optval(char const* name, cuti::args_reader_t const& reader,
+  char const* in, encoder_settings_t::admission_timeout_t& out);
+
+void parse_optval(char const* name, cuti::args_reader_t const& reader,
+  char const* in, encoder_settings_t::analysis_reuse_level_t& out);
+
+/*
+ * Limits the session threads in settings to the number of threads
+ * granted by the service's thread budget; a grant of 0 threads means
+ * there is no budget.
+ */
+void apply_thread_grant(encoder_settings_t& settings, unsigned int threads);
+
 } // x265_es_utils
 
 #endif
@@ -20,11 +20,16 @@
 #include "encoding_session.hpp"
 #include "x265_exception.hpp"
 
+#include <cuti/buffer_pool.hpp>
 #include <cuti/hexdump.hpp>
 #include <cuti/stringprintf.hpp>
 #include <x265_proto/types.hpp>
 
+#include <cstddef>
+#include <cstring>
+#include <memory>
 #include <string_view>
+#include <vector>
 
 #include <x265.h>
 
@@ -1268,6 +1273,12 @@ struct x265_input_picture_t
   x265_input_picture_t(x265_input_picture_t const&) = delete;
   x265_input_picture_t& operator=(x265_input_picture_t const&) = delete;
 
+  ~x265_input_picture_t()
+  {
+    // libx265 has copied the picture; recycle the frame's buffer
+    cuti::default_buffer_pool().release(std::move(frame_.data_));
+  }
+
   x265_picture const* get() const
   {
     return picture_.get();
@@ -1433,11 +1444,13 @@ struct x265_encoder_t
   x265_encoder_t(
     cuti::logging_context_t const& logging_context,
     encoder_settings_t const& encoder_settings,
-    x265_proto::session_params_t const& session_params)
+    x265_proto::session_params_t const& session_params,
+    std::optional<x26x_es_utils::analysis_role_t> analysis_role)
   : logging_context_(logging_context)
   , api_(to_x265_bitdepth(session_params.common_.format_))
   , param_(api_, encoder_settings, session_params)
   , encoder_()
+  , encoder_param_(api_)
   {
     if(auto msg = logging_context_.message_at(cuti::loglevel_t::info))
     {
@@ -1472,6 +1485,14 @@ struct x265_encoder_t
       *msg << "initial param:\n" << param_;
     }
 
+    /*
+     * libx265 creates its worker thread pools in x265_encoder_open()
+     * and registers the encoder's job providers with them for good, so
+     * pools cannot be shared between sessions.  The service limits the
+     * cost instead: the encoder pool opens sessions (and their thread
+     * pools) off the request path, and the thread budget sizes each
+     * session's pools through these settings.
+     */
     param_->frameNumThreads = encoder_settings.frame_threads_.value_;
     auto const np_size = encoder_settings.numa_pools_.value_.size() + 1;
     assert(np_size <= X265_MAX_STRING_SIZE);
@@ -1479,6 +1500,11 @@ struct x265_encoder_t
     std::copy(np_cstr, np_cstr + np_size, param_->numaPools);
     param_->logCallback = x265_log_callback;
     param_->logContext = const_cast<cuti::logging_context_t*>(&logging_context_);
+    if(analysis_role)
+    {
+      set_analysis_reuse(*analysis_role,
+        encoder_settings.analysis_reuse_level_.value_);
+    }
     assert(param_->internalBitDepth == api_->bit_depth);
     assert(param_->internalCsp == X265_CSP_I420);
     if(session_params.common_.framerate_)
@@ -1593,11 +1619,10 @@ struct x265_encoder_t
     }
     encoder_ = std::make_unique<wrap_x265_encoder_t>(api_, param_);
 
-    wrap_x265_param_t encoder_param(api_);
-    encoder_->parameters(encoder_param.get());
+    encoder_->parameters(encoder_param_.get());
     if(auto msg = logging_context_.message_at(cuti::loglevel_t::debug))
     {
-      *msg << "encoder param:\n" << encoder_param;
+      *msg << "encoder param:\n" << encoder_param_;
     }
   }
 
@@ -1614,11 +1639,25 @@ struct x265_encoder_t
     return param_;
   }
 
+  /*
+   * Returns the parameters as adjusted by libx265.
+   */
+  x265_param const& encoder_param() const
+  {
+    return *encoder_param_.get();
+  }
+
   int headers(x265_nal** headers_out, uint32_t *num_headers_out) const
   {
     return encoder_->headers(headers_out, num_headers_out);
   }
 
+  int max_delayed_frames() const
+  {
+    // libx265 has no x264_encoder_maximum_delayed_frames(); estimate
+    return param_->lookaheadDepth + param_->bframes;
+  }
+
   int encode(x265_nal** nals_out, uint32_t* num_nals_out, x265_picture* pic_in,
     x265_picture* pic_out) const
   {
@@ -1631,11 +1670,40 @@ struct x265_encoder_t
     return encoder_->encode(nals_out, num_nals_out, nullptr, pic_out);
   }
 
+private :
+  void set_analysis_reuse(x26x_es_utils::analysis_role_t role,
+                          unsigned int level)
+  {
+    if(level < 1 || level > encoder_settings_t::max_analysis_reuse_level())
+    {
+      x265_exception_builder_t builder;
+      builder << "bad analysis reuse level " << level <<
+        " for a session sharing analysis data";
+      builder.explode();
+    }
+
+    // "memory" is a placeholder: the data is passed in x265_picture
+    static char const mode[] = "memory";
+    static_assert(sizeof mode <= X265_MAX_STRING_SIZE);
+    param_->bUseAnalysisFile = 0;
+    if(role == x26x_es_utils::analysis_role_t::publisher)
+    {
+      std::copy(mode, mode + sizeof mode, param_->analysisSave);
+      param_->analysisSaveReuseLevel = level;
+    }
+    else
+    {
+      std::copy(mode, mode + sizeof mode, param_->analysisLoad);
+      param_->analysisLoadReuseLevel = level;
+    }
+  }
+
 private :
   cuti::logging_context_t const& logging_context_;
   wrap_x265_api_t api_;
   wrap_x265_param_t param_;
   std::unique_ptr<wrap_x265_encoder_t> encoder_;
+  wrap_x265_param_t encoder_param_;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1750,6 +1818,132 @@ std::ostream& operator<<(std::ostream& os, x265_nal const& rhs)
   return os;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+
+/*
+ * A copy of the analysis data libx265 returns with an encoded picture;
+ * libx265 frees the original on the next call to x265_encoder_encode().
+ * Only the arrays that libx265 reads back for a picture of the same
+ * size are copied.
+ */
+struct shared_analysis_t : x26x_es_utils::frame_analysis_t
+{
+  shared_analysis_t(x265_param const& param, x265_analysis_data const& source)
+  : buffers_()
+  , intra_data_()
+  , inter_data_()
+  , data_(source)
+  {
+    data_.wt = nullptr;
+    data_.interData = nullptr;
+    data_.intraData = nullptr;
+    data_.lookahead.vbvCost = nullptr;
+    data_.lookahead.intraVbvCost = nullptr;
+    data_.lookahead.satdForVbv = nullptr;
+    data_.lookahead.intraSatdForVbv = nullptr;
+    data_.modeFlag[0] = nullptr;
+    data_.modeFlag[1] = nullptr;
+    data_.distortionData = nullptr;
+
+    int const level = param.analysisSaveReuseLevel;
+    bool const cu_tree = param.rc.cuTree;
+    std::size_t const depth_bytes = source.depthBytes;
+    std::size_t const n_parts =
+      std::size_t(source.numCUsInFrame) * source.numPartitions;
+
+    if(source.sliceType == X265_TYPE_IDR || source.sliceType == X265_TYPE_I)
+    {
+      if(level < 2)
+      {
+        return;
+      }
+
+      x265_analysis_intra_data const& intra = *source.intraData;
+      intra_data_.depth = copy_array(intra.depth, depth_bytes);
+      intra_data_.chromaModes = copy_array(intra.chromaModes, depth_bytes);
+      intra_data_.partSizes = copy_array(intra.partSizes, depth_bytes);
+      if(cu_tree)
+      {
+        intra_data_.cuQPOff = copy_array(intra.cuQPOff, depth_bytes);
+      }
+      intra_data_.modes = copy_array(intra.modes, n_parts);
+      data_.intraData = &intra_data_;
+      return;
+    }
+
+    std::size_t const n_dirs = source.sliceType == X265_TYPE_P ? 1 : 2;
+    std::size_t const n_planes = param.internalCsp == X265_CSP_I400 ? 1 : 3;
+    data_.wt = copy_array(source.wt, n_planes * n_dirs);
+    if(level < 2)
+    {
+      return;
+    }
+
+    x265_analysis_inter_data const& inter = *source.interData;
+    inter_data_.depth = copy_array(inter.depth, depth_bytes);
+    inter_data_.modes = copy_array(inter.modes, depth_bytes);
+    if(cu_tree)
+    {
+      inter_data_.cuQPOff = copy_array(inter.cuQPOff, depth_bytes);
+    }
+    if(level > 4)
+    {
+      inter_data_.partSize = copy_array(inter.partSize, depth_bytes);
+      inter_data_.mergeFlag = copy_array(inter.mergeFlag, depth_bytes);
+    }
+
+    if(level == 10)
+    {
+      inter_data_.interDir = copy_array(inter.interDir, depth_bytes);
+      for(std::size_t dir = 0; dir != n_dirs; ++dir)
+      {
+        inter_data_.mvpIdx[dir] = copy_array(inter.mvpIdx[dir], depth_bytes);
+        inter_data_.refIdx[dir] = copy_array(inter.refIdx[dir], depth_bytes);
+        inter_data_.mv[dir] = copy_array(inter.mv[dir], depth_bytes);
+      }
+
+      if(source.sliceType == X265_TYPE_P || param.bIntraInBFrames)
+      {
+        x265_analysis_intra_data const& intra = *source.intraData;
+        intra_data_.chromaModes = copy_array(intra.chromaModes, depth_bytes);
+        intra_data_.modes = copy_array(intra.modes, n_parts);
+        data_.intraData = &intra_data_;
+      }
+    }
+    else
+    {
+      inter_data_.ref = copy_array(inter.ref,
+        source.numCUsInFrame * max_pred_modes_per_ctu * n_dirs);
+    }
+    data_.interData = &inter_data_;
+  }
+
+  x265_analysis_data const& data() const
+  {
+    return data_;
+  }
+
+private :
+  // X265_MAX_PRED_MODE_PER_CTU, which libx265 does not export
+  static std::size_t constexpr max_pred_modes_per_ctu = 85 * 2 * 8;
+
+  template<typename T>
+  T* copy_array(T const* source, std::size_t count)
+  {
+    assert(source != nullptr);
+
+    auto& buffer = buffers_.emplace_back(count * sizeof(T));
+    std::memcpy(buffer.data(), source, buffer.size());
+    return reinterpret_cast<T*>(buffer.data());
+  }
+
+private :
+  std::vector<std::vector<unsigned char>> buffers_;
+  x265_analysis_intra_data intra_data_;
+  x265_analysis_inter_data inter_data_;
+  x265_analysis_data data_;
+};
+
 } // anonymous namespace
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1758,9 +1952,15 @@ struct encoding_session_t::impl_t
 {
   impl_t(cuti::logging_context_t const& logging_context,
          encoder_settings_t const& encoder_settings,
-         x265_proto::session_params_t const& session_params)
+         x265_proto::session_params_t const& session_params,
+         x26x_es_utils::analysis_exchange_t* analysis_exchange,
+         std::optional<x26x_es_utils::analysis_role_t> analysis_role)
   : logging_context_(logging_context)
-  , encoder_(logging_context_, encoder_settings, session_params)
+  , encoder_(logging_context_, encoder_settings, session_params,
+      analysis_role)
+  , analysis_exchange_((assert((analysis_exchange != nullptr) ==
+      analysis_role.has_value()), analysis_exchange))
+  , analysis_role_(analysis_role)
   , frame_count_(0)
   , sample_count_(0)
   , first_cto_(std::nullopt)
@@ -1857,6 +2057,11 @@ struct encoding_session_t::impl_t
     return sample_headers;
   }
 
+  int max_delayed_frames() const
+  {
+    return encoder_.max_delayed_frames();
+  }
+
   std::optional<x26x_proto::sample_t> encode(x26x_proto::frame_t frame)
   {
     assert(! flush_called_);
@@ -1870,11 +2075,20 @@ struct encoding_session_t::impl_t
         *msg << " (keyframe)";
       }
     }
-    ++frame_count_;
-
     x265_output_t output(encoder_.api(), encoder_.param());
     x265_input_picture_t pic_in(encoder_.api(), encoder_.param(),
       std::move(frame));
+
+    // libx265 copies the analysis data while encoding the frame
+    std::shared_ptr<x26x_es_utils::frame_analysis_t const> analysis;
+    if(analysis_role_ == x26x_es_utils::analysis_role_t::consumer)
+    {
+      analysis = analysis_exchange_->take(frame_count_);
+      pic_in.get()->analysisData =
+        static_cast<shared_analysis_t const&>(*analysis).data();
+    }
+    ++frame_count_;
+
     auto result = encoder_.encode(&output.nals_, &output.num_nals_,
       pic_in.get(), output.picture_.get());
     if(result < 0)
@@ -1903,6 +2117,7 @@ struct encoding_session_t::impl_t
         sample_count_;
     }
 
+    this->publish_analysis(output);
     return generate_sample(output);
   }
 
@@ -1945,10 +2160,24 @@ struct encoding_session_t::impl_t
         sample_count_;
     }
 
+    this->publish_analysis(output);
     return generate_sample(output);
   }
 
 private :
+  void publish_analysis(x265_output_t const& output)
+  {
+    if(analysis_role_ != x26x_es_utils::analysis_role_t::publisher)
+    {
+      return;
+    }
+
+    assert(output.picture_->poc >= 0);
+    analysis_exchange_->publish(output.picture_->poc,
+      std::make_shared<shared_analysis_t>(encoder_.encoder_param(),
+        output.picture_->analysisData));
+  }
+
   x26x_proto::sample_t generate_sample(x265_output_t const& output)
   {
     assert(output.nals_ != nullptr);
@@ -2003,6 +2232,8 @@ private :
         slice_type_t(output.picture_->sliceType);
       builder.explode();
     }
+    sample.data_ = cuti::default_buffer_pool().acquire(
+      output.nals_[0].sizeBytes);
     sample.data_.insert(sample.data_.end(), output.nals_[0].payload,
       output.nals_[0].payload + output.nals_[0].sizeBytes);
 
@@ -2012,6 +2243,8 @@ private :
 private :
   cuti::logging_context_t const& logging_context_;
   x265_encoder_t encoder_;
+  x26x_es_utils::analysis_exchange_t* const analysis_exchange_;
+  std::optional<x26x_es_utils::analysis_role_t> const analysis_role_;
   uint64_t frame_count_;
   uint64_t sample_count_;
   std::optional<int32_t> first_cto_;
@@ -2025,7 +2258,20 @@ encoding_session_t::encoding_session_t(
   encoder_settings_t const& encoder_settings,
   x265_proto::session_params_t const& session_params)
 : impl_(std::make_unique<impl_t>(
-    logging_context, encoder_settings, session_params))
+    logging_context, encoder_settings, session_params,
+    nullptr, std::nullopt))
+{
+}
+
+encoding_session_t::encoding_session_t(
+  cuti::logging_context_t const& logging_context,
+  encoder_settings_t const& encoder_settings,
+  x265_proto::session_params_t const& session_params,
+  x26x_es_utils::analysis_exchange_t& analysis_exchange,
+  x26x_es_utils::analysis_role_t analysis_role)
+: impl_(std::make_unique<impl_t>(
+    logging_context, encoder_settings, session_params,
+    &analysis_exchange, analysis_role))
 {
 }
 
@@ -2034,6 +2280,11 @@ x265_proto::sample_headers_t encoding_session_t::sample_headers() const
   return impl_->sample_headers();
 }
 
+int encoding_session_t::max_delayed_frames() const
+{
+  return impl_->max_delayed_frames();
+}
+
 std::optional<x26x_proto::sample_t>
 encoding_session_t::encode(x26x_proto::frame_t frame)
 {
@@ -26,6 +26,8 @@
 
 #include <x265_proto/types.hpp>
 
+#include <x26x_es_utils/analysis_exchange.hpp>
+
 #include <optional>
 
 namespace x265_es_utils
@@ -37,11 +39,31 @@ struct encoding_session_t
                      encoder_settings_t const& encoder_settings,
                      x265_proto::session_params_t const& session_params);
 
+  /*
+   * Creates a session sharing analysis data through exchange, at the
+   * analysis reuse level in encoder_settings: a publisher publishes
+   * the analysis data of each frame it encodes, and a consumer reuses
+   * the data published for each frame it is passed, which must be
+   * available by then.  The exchange must outlive the session's calls
+   * to encode() and flush().
+   */
+  encoding_session_t(cuti::logging_context_t const& logging_context,
+                     encoder_settings_t const& encoder_settings,
+                     x265_proto::session_params_t const& session_params,
+                     x26x_es_utils::analysis_exchange_t& analysis_exchange,
+                     x26x_es_utils::analysis_role_t analysis_role);
+
   encoding_session_t(encoding_session_t const&) = delete;
   encoding_session_t& operator=(encoding_session_t const&) = delete;
 
   x265_proto::sample_headers_t sample_headers() const;
 
+  /*
+   * Returns an estimate of the maximum number of frames libx265 may
+   * hold before producing a sample.
+   */
+  int max_delayed_frames() const;
+
   std::optional<x26x_proto::sample_t> encode(x26x_proto::frame_t frame);
   std::optional<x26x_proto::sample_t> flush();
 
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2026 CodeShop B.V.
+ *
+ * This file is part of the x26x_es_utils library.
+ *
+ * The x26x_es_utils library is free software: you can redistribute it
+ * and/or modify it under the terms of version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * The x26x_es_utils library is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See version 2 of the GNU General Public License for more details.
+ *
+ * You should have received a copy of version 2 of the GNU General
+ * Public License along with the x26x_es_utils library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "analysis_exchange.hpp"
+
+#include <cuti/exception_builder.hpp>
+
+#include <cassert>
+#include <stdexcept>
+#include <utility>
+
+namespace x26x_es_utils
+{
+
+frame_analysis_t::~frame_analysis_t()
+{ }
+
+analysis_exchange_t::analysis_exchange_t(std::size_t n_consumers)
+: n_consumers_((assert(n_consumers != 0), n_consumers))
+, mutex_()
+, entries_()
+, available_frames_(0)
+{ }
+
+void analysis_exchange_t::publish(
+  uint64_t index, std::shared_ptr<frame_analysis_t const> analysis)
+{
+  assert(analysis != nullptr);
+
+  std::scoped_lock<std::mutex> lock(mutex_);
+
+  assert(index >= available_frames_);
+  auto [pos, inserted] = entries_.emplace(
+    index, entry_t{std::move(analysis), n_consumers_});
+  assert(inserted);
+
+  // frames before available_frames_ may already have been taken
+  while(pos != entries_.end() && pos->first == available_frames_)
+  {
+    ++available_frames_;
+    ++pos;
+  }
+}
+
+uint64_t analysis_exchange_t::available_frames() const noexcept
+{
+  std::scoped_lock<std::mutex> lock(mutex_);
+  return available_frames_;
+}
+
+std::shared_ptr<frame_analysis_t const> analysis_exchange_t::take(
+  uint64_t index)
+{
+  std::scoped_lock<std::mutex> lock(mutex_);
+
+  auto pos = entries_.find(index);
+  if(index >= available_frames_ || pos == entries_.end())
+  {
+    cuti::exception_builder_t<std::runtime_error> builder;
+    builder << "analysis_exchange: no analysis data for frame #" << index;
+    builder.explode();
+  }
+
+  std::shared_ptr<frame_analysis_t const> result = pos->second.analysis_;
+  if(--pos->second.takes_left_ == 0)
+  {
+    entries_.erase(pos);
+  }
+  return result;
+}
+
+std::size_t analysis_exchange_t::held_frames() const noexcept
+{
+  std::scoped_lock<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+} // x26x_es_utils
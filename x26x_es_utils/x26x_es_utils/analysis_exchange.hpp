@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2026 CodeShop B.V.
+ *
+ * This file is part of the x26x_es_utils library.
+ *
+ * The x26x_es_utils library is free software: you can redistribute it
+ * and/or modify it under the terms of version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * The x26x_es_utils library is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See version 2 of the GNU General Public License for more details.
+ *
+ * You should have received a copy of version 2 of the GNU General
+ * Public License along with the x26x_es_utils library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef X26X_ES_UTILS_ANALYSIS_EXCHANGE_HPP_
+#define X26X_ES_UTILS_ANALYSIS_EXCHANGE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace x26x_es_utils
+{
+
+/*
+ * The part an encoding session plays in an analysis exchange.
+ */
+enum class analysis_role_t
+{
+  publisher,
+  consumer
+};
+
+/*
+ * Per-frame encoder analysis data, as published by an encoding
+ * session; its contents are only known to the encoder library's
+ * sessions.
+ */
+struct frame_analysis_t
+{
+  frame_analysis_t() = default;
+
+  frame_analysis_t(frame_analysis_t const&) = delete;
+  frame_analysis_t& operator=(frame_analysis_t const&) = delete;
+
+  virtual ~frame_analysis_t();
+};
+
+/*
+ * Hands the analysis data of one encoding session (the publisher) to
+ * other encoding sessions for the same frames (the consumers), so
+ * that the consumers can skip most of their own analysis.  Frames
+ * are identified by their index in the input sequence.
+ *
+ * The publisher and the consumers run on their own worker threads.
+ * The publisher produces analysis data in encoding order, which may
+ * differ from input order; a consumer may only be given frame n once
+ * available_frames() > n, so it never has to wait for the publisher.
+ * The analysis data for a frame is dropped once every consumer has
+ * taken it.
+ */
+struct analysis_exchange_t
+{
+  explicit analysis_exchange_t(std::size_t n_consumers);
+
+  analysis_exchange_t(analysis_exchange_t const&) = delete;
+  analysis_exchange_t& operator=(analysis_exchange_t const&) = delete;
+
+  /*
+   * Publishes the analysis data for frame index.
+   */
+  void publish(uint64_t index,
+               std::shared_ptr<frame_analysis_t const> analysis);
+
+  /*
+   * Returns the number of leading frames for which analysis data has
+   * been published.
+   */
+  uint64_t available_frames() const noexcept;
+
+  /*
+   * Takes the analysis data for frame index, which must be available;
+   * throws if it is not.
+   */
+  std::shared_ptr<frame_analysis_t const> take(uint64_t index);
+
+  /*
+   * Returns the number of frames whose analysis data is held.
+   */
+  std::size_t held_frames() const noexcept;
+
+private :
+  struct entry_t
+  {
+    std::shared_ptr<frame_analysis_t const> analysis_;
+    std::size_t takes_left_;
+  };
+
+  std::size_t const n_consumers_;
+
+  std::mutex mutable mutex_;
+  std::map<uint64_t, entry_t> entries_;
+  uint64_t available_frames_;
+};
+
+} // x26x_es_utils
+
+#endif
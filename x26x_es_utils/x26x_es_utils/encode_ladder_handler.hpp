@@ -0,0 +1,1066 @@
+/*
+ * Copyright (C) 2026 CodeShop B.V.
+ *
+ * This file is part of the x26x_es_utils library.
+ *
+ * The x26x_es_utils library is free software: you can redistribute it
+ * and/or modify it under the terms of version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * The x26x_es_utils library is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See version 2 of the GNU General Public License for more details.
+ *
+ * You should have received a copy of version 2 of the GNU General
+ * Public License along with the x26x_es_utils library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef X26X_ES_UTILS_ENCODE_LADDER_HANDLER_HPP_
+#define X26X_ES_UTILS_ENCODE_LADDER_HANDLER_HPP_
+
+#include <cuti/async_readers.hpp>
+#include <cuti/async_writers.hpp>
+#include <cuti/bound_inbuf.hpp>
+#include <cuti/bound_outbuf.hpp>
+#include <cuti/cancellation_ticket.hpp>
+#include <cuti/chrono_types.hpp>
+#include <cuti/exception_builder.hpp>
+#include <cuti/logging_context.hpp>
+#include <cuti/result.hpp>
+#include <cuti/socket_layer.hpp>
+#include <cuti/stack_marker.hpp>
+#include <cuti/subroutine.hpp>
+
+#include <x26x_proto/types.hpp>
+
+#include "analysis_exchange.hpp"
+#include "encode_worker.hpp"
+#include "encoder_pool.hpp"
+#include "frame_ring.hpp"
+#include "frame_scaler.hpp"
+#include "thread_budget.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace x26x_es_utils
+{
+
+/*
+ * The message formats of an encode_ladder request: a list of session
+ * parameters and sample headers, one per rendition, and samples
+ * tagged with the index of their rendition.  Frames are scaled to
+ * each rendition's size.
+ */
+template<typename SessionParams, typename SampleHeaders>
+struct ladder_request_form_t
+{
+  using session_params_t = std::vector<SessionParams>;
+  using sample_headers_t = std::vector<SampleHeaders>;
+  using sample_t = x26x_proto::rendition_sample_t;
+
+  static bool constexpr scales_frames = true;
+
+  static std::vector<SessionParams> renditions(
+    session_params_t session_params)
+  {
+    return session_params;
+  }
+
+  static sample_headers_t sample_headers(
+    std::vector<SampleHeaders> sample_headers)
+  {
+    return sample_headers;
+  }
+
+  static sample_t sample(std::size_t rendition, x26x_proto::sample_t sample)
+  {
+    sample_t result;
+    result.rendition_ = static_cast<uint32_t>(rendition);
+    result.sample_ = std::move(sample);
+    return result;
+  }
+};
+
+/*
+ * Handles a single encode_ladder request: the frames, which are
+ * uploaded only once, are encoded for each of the requested
+ * renditions.  Each rendition has its own encode worker, which opens
+ * its session and scales the frames to the rendition's size (if
+ * needed) on its own thread, so the scheduler thread never blocks
+ * inside the encoder library.  Frames are read while the samples of
+ * all renditions are written back as they become available, so socket
+ * I/O overlaps with encoding.  A plain encode request is handled as a
+ * ladder of one rendition; see encode_handler_t.
+ *
+ * The workers' frame queues are bounded.  While one is full, no
+ * frames are read, so TCP flow control throttles the client instead
+ * of the server buffering an unbounded number of frames.
+ *
+ * Before opening its sessions, the handler obtains a grant from the
+ * service's thread budget, sized for its number of renditions, which
+ * is divided over the renditions.  While the budget is exhausted, it
+ * waits in line (see thread_budget_t::waiter_t) until the admission
+ * timeout from the encoder settings expires, and then fails the
+ * request.
+ *
+ * If the encoding session type supports it and the encoder settings
+ * enable it, renditions that differ only in their bitrate share the
+ * encoder's analysis data: the first of them (which clients should
+ * make the highest quality one) publishes its analysis data, and the
+ * others reuse it instead of analyzing each frame themselves.  A
+ * consumer gets a frame only once the publisher's analysis data for
+ * that frame is available; until then, the frame is held here.
+ * Sessions tied to a request's analysis exchange are newly opened
+ * rather than taken from the encoder pool.  Either way, sessions are
+ * opened on their workers' threads.
+ */
+template<typename EncoderSettings, typename EncodingSession,
+         typename SessionParams, typename SampleHeaders,
+         typename RequestForm =
+           ladder_request_form_t<SessionParams, SampleHeaders>>
+struct encode_ladder_handler_t
+{
+  using result_value_t = void;
+  using encoder_pool_t = x26x_es_utils::encoder_pool_t<
+    EncoderSettings, EncodingSession, SessionParams>;
+
+  static std::size_t constexpr max_renditions = 16;
+
+  static bool constexpr shares_analysis = std::is_constructible_v<
+    EncodingSession, cuti::logging_context_t const&, EncoderSettings const&,
+    SessionParams const&, analysis_exchange_t&, analysis_role_t>;
+
+  encode_ladder_handler_t(cuti::result_t<void>& result,
+                          cuti::logging_context_t const& context,
+                          cuti::bound_inbuf_t& inbuf,
+                          cuti::bound_outbuf_t& outbuf,
+                          cuti::socket_layer_t& sockets,
+                          EncoderSettings encoder_settings,
+                          encoder_pool_t& encoder_pool,
+                          thread_budget_t& thread_budget)
+  : result_(result)
+  , context_(context)
+  , inbuf_(inbuf)
+  , outbuf_(outbuf)
+  , sockets_(sockets)
+  , encoder_settings_(std::move(encoder_settings))
+  , encoder_pool_(encoder_pool)
+  , thread_budget_(thread_budget)
+  , session_params_()
+  , admission_waiter_(std::nullopt)
+  , admission_ticket_()
+  , thread_grant_(std::nullopt)
+  , analysis_groups_()
+  , renditions_()
+  , next_rendition_(0)
+  , session_params_reader_(*this, result_, inbuf)
+  , sample_headers_writer_(*this, result_, outbuf)
+  , begin_sequence_reader_(*this, result_, inbuf)
+  , begin_sequence_writer_(*this, result_, outbuf)
+  , end_sequence_checker_(*this,
+      &encode_ladder_handler_t::on_input_error, inbuf)
+  , frame_reader_(*this, &encode_ladder_handler_t::on_input_error, inbuf)
+  , end_of_frames_(false)
+  , input_state_(input_not_started)
+  , sample_writer_(*this, &encode_ladder_handler_t::on_output_error, outbuf)
+  , end_sequence_writer_(*this,
+      &encode_ladder_handler_t::on_output_error, outbuf)
+  , output_state_(output_not_started)
+  , ex_(nullptr)
+  { }
+
+  encode_ladder_handler_t(encode_ladder_handler_t const&) = delete;
+  encode_ladder_handler_t& operator=(encode_ladder_handler_t const&) = delete;
+
+  void start(cuti::stack_marker_t& marker)
+  {
+    session_params_reader_.start(
+      marker, &encode_ladder_handler_t::await_admission);
+  }
+
+  ~encode_ladder_handler_t()
+  {
+    if(!admission_ticket_.empty())
+    {
+      outbuf_.scheduler().cancel(admission_ticket_);
+    }
+
+    // hands the sessions back to the pool
+    renditions_.clear();
+  }
+
+private :
+  /*
+   * An encoding session for one rendition, as seen by its worker:
+   * frames are scaled to the rendition's size before encoding.
+   */
+  struct scaled_session_t
+  {
+    scaled_session_t(std::unique_ptr<EncodingSession> session,
+                     uint32_t width, uint32_t height)
+    : session_((assert(session != nullptr), std::move(session)))
+    , width_(width)
+    , height_(height)
+    { }
+
+    scaled_session_t(scaled_session_t const&) = delete;
+    scaled_session_t& operator=(scaled_session_t const&) = delete;
+
+    int max_delayed_frames() const
+    {
+      return session_->max_delayed_frames();
+    }
+
+    std::optional<x26x_proto::sample_t> encode(x26x_proto::frame_t frame)
+    {
+      if constexpr(RequestForm::scales_frames)
+      {
+        if(frame.width_ != width_ || frame.height_ != height_)
+        {
+          frame = scale_frame(frame, width_, height_);
+        }
+      }
+      return session_->encode(std::move(frame));
+    }
+
+    std::optional<x26x_proto::sample_t> flush()
+    {
+      return session_->flush();
+    }
+
+    std::unique_ptr<EncodingSession> session_;
+    uint32_t const width_;
+    uint32_t const height_;
+  };
+
+  struct rendition_t
+  {
+    explicit rendition_t(bool consumer)
+    : consumer_(consumer)
+    , worker_(std::nullopt)
+    { }
+
+    rendition_t(rendition_t const&) = delete;
+    rendition_t& operator=(rendition_t const&) = delete;
+
+    bool const consumer_;
+    std::optional<encode_worker_t<scaled_session_t>> worker_;
+  };
+
+  /*
+   * A rendition publishing its analysis data, and the renditions
+   * consuming it.
+   */
+  struct analysis_group_t
+  {
+    analysis_group_t(std::size_t publisher,
+                     std::vector<std::size_t> consumers)
+    : publisher_(publisher)
+    , consumers_((assert(!consumers.empty()), std::move(consumers)))
+    , exchange_(consumers_.size())
+    , held_frames_()
+    , max_held_frames_(0)
+    , frames_fed_(0)
+    , flushed_(false)
+    { }
+
+    analysis_group_t(analysis_group_t const&) = delete;
+    analysis_group_t& operator=(analysis_group_t const&) = delete;
+
+    std::size_t const publisher_;
+    std::vector<std::size_t> const consumers_;
+    analysis_exchange_t exchange_;
+
+    // frames waiting for the publisher's analysis data
+    std::deque<x26x_proto::frame_t> held_frames_;
+    std::size_t max_held_frames_;
+    uint64_t frames_fed_;
+    bool flushed_;
+  };
+
+  void await_admission(
+    cuti::stack_marker_t& marker,
+    typename RequestForm::session_params_t request_params)
+  {
+    std::vector<SessionParams> session_params =
+      RequestForm::renditions(std::move(request_params));
+    if(session_params.empty() || session_params.size() > max_renditions)
+    {
+      cuti::exception_builder_t<std::runtime_error> builder;
+      builder << "encode_ladder: unsupported number of renditions " <<
+        session_params.size() << " (max: " << max_renditions << ")";
+      result_.fail(marker, builder.exception_ptr());
+      return;
+    }
+
+    session_params_ = std::move(session_params);
+    if(thread_budget_.total_threads() != 0 &&
+       this->n_sessions() > thread_budget_.total_threads())
+    {
+      cuti::exception_builder_t<std::runtime_error> builder;
+      builder << "encode_ladder: " << this->n_sessions() <<
+        " renditions need more threads than the encoder thread budget (" <<
+        thread_budget_.total_threads() << ")";
+      result_.fail(marker, builder.exception_ptr());
+      return;
+    }
+
+    this->try_admission(marker);
+  }
+
+  unsigned int n_sessions() const
+  {
+    return static_cast<unsigned int>(session_params_.size());
+  }
+
+  void try_admission(cuti::stack_marker_t& marker)
+  {
+    std::optional<thread_budget_t::grant_t> grant =
+      thread_budget_.try_acquire(this->n_sessions());
+    if(grant != std::nullopt)
+    {
+      this->admitted(marker, std::move(*grant));
+      return;
+    }
+
+    // wait in line, until the admission timeout expires
+    try
+    {
+      admission_waiter_.emplace(
+        thread_budget_, sockets_, this->n_sessions());
+    }
+    catch(std::exception const&)
+    {
+      result_.fail(marker, std::current_exception());
+      return;
+    }
+
+    admission_ticket_ = outbuf_.scheduler().call_alarm(
+      cuti::milliseconds_t(encoder_settings_.admission_timeout_.value_),
+      [this](cuti::stack_marker_t& base_marker)
+      {
+        admission_ticket_.clear();
+        this->on_admission_timeout(base_marker);
+      });
+    this->await_grant();
+  }
+
+  void await_grant()
+  {
+    assert(admission_waiter_ != std::nullopt);
+
+    admission_waiter_->call_when_ready(outbuf_.scheduler(),
+      [this](cuti::stack_marker_t& base_marker)
+      { this->on_grant_ready(base_marker); });
+  }
+
+  void on_grant_ready(cuti::stack_marker_t& marker)
+  {
+    assert(admission_waiter_ != std::nullopt);
+
+    std::optional<thread_budget_t::grant_t> grant =
+      admission_waiter_->try_acquire();
+    if(grant == std::nullopt)
+    {
+      this->await_grant();
+      return;
+    }
+
+    outbuf_.scheduler().cancel(admission_ticket_);
+    admission_ticket_.clear();
+    admission_waiter_.reset();
+
+    this->admitted(marker, std::move(*grant));
+  }
+
+  void on_admission_timeout(cuti::stack_marker_t& marker)
+  {
+    // leave the queue
+    admission_waiter_.reset();
+
+    cuti::exception_builder_t<std::runtime_error> builder;
+    builder << "encoder thread budget exhausted: no threads available "
+      "after " << encoder_settings_.admission_timeout_.value_ << "ms";
+    result_.fail(marker, builder.exception_ptr());
+  }
+
+  void admitted(cuti::stack_marker_t& marker,
+                thread_budget_t::grant_t grant)
+  {
+    thread_grant_.emplace(std::move(grant));
+    this->create_sessions(marker);
+  }
+
+  void create_sessions(cuti::stack_marker_t& marker)
+  {
+    assert(thread_grant_ != std::nullopt);
+
+    /*
+     * 0 means no budget; otherwise, the grant holds at least one
+     * thread per rendition, and any remainder goes to the first
+     * renditions.
+     */
+    unsigned int const granted = thread_grant_->threads();
+    unsigned int const n_sessions = this->n_sessions();
+
+    try
+    {
+      this->plan_analysis_groups();
+
+      for(std::size_t i = 0; i != session_params_.size(); ++i)
+      {
+        renditions_.push_back(std::make_unique<rendition_t>(
+          this->analysis_group(i, analysis_role_t::consumer) != nullptr));
+        renditions_.back()->worker_.emplace(context_, sockets_,
+          this->session_opener(i,
+            granted / n_sessions + (i < granted % n_sessions ? 1 : 0)),
+          [&pool = encoder_pool_](std::unique_ptr<scaled_session_t> session)
+          { pool.release(std::move(session->session_)); },
+          encoder_settings_.frame_queue_depth_.value_);
+      }
+    }
+    catch(std::exception const&)
+    {
+      result_.fail(marker, std::current_exception());
+      return;
+    }
+
+    this->await_sessions();
+  }
+
+  /*
+   * Waits until all sessions are opened, or one of them fails to
+   * open.
+   */
+  void await_sessions()
+  {
+    for(auto& rendition : renditions_)
+    {
+      rendition->worker_->call_when_ready(outbuf_.scheduler(),
+        [this](cuti::stack_marker_t& base_marker)
+        { this->on_sessions_ready(base_marker); });
+    }
+  }
+
+  void on_sessions_ready(cuti::stack_marker_t& marker)
+  {
+    this->cancel_workers_ready();
+
+    std::vector<SampleHeaders> sample_headers;
+    try
+    {
+      for(auto const& rendition : renditions_)
+      {
+        if(!rendition->worker_->session_opened())
+        {
+          this->await_sessions();
+          return;
+        }
+      }
+
+      for(std::size_t i = 0; i != renditions_.size(); ++i)
+      {
+        auto const& worker = *renditions_[i]->worker_;
+        sample_headers.push_back(
+          worker.session().session_->sample_headers());
+
+        if(auto* group = this->analysis_group(i, analysis_role_t::publisher))
+        {
+          group->max_held_frames_ = worker.frame_queue_depth();
+        }
+      }
+    }
+    catch(std::exception const&)
+    {
+      result_.fail(marker, std::current_exception());
+      return;
+    }
+
+    sample_headers_writer_.start(
+      marker,
+      &encode_ladder_handler_t::read_begin_sequence,
+      RequestForm::sample_headers(std::move(sample_headers)));
+  }
+
+  /*
+   * Groups the renditions that can share analysis data, if enabled.
+   */
+  void plan_analysis_groups()
+  {
+    if constexpr(shares_analysis)
+    {
+      if(encoder_settings_.analysis_reuse_level_.value_ == 0)
+      {
+        return;
+      }
+
+      std::size_t const n_renditions = session_params_.size();
+      std::vector<bool> grouped(n_renditions, false);
+      for(std::size_t i = 0; i != n_renditions; ++i)
+      {
+        if(grouped[i])
+        {
+          continue;
+        }
+
+        std::vector<std::size_t> consumers;
+        for(std::size_t j = i + 1; j != n_renditions; ++j)
+        {
+          if(!grouped[j] &&
+             same_pictures(session_params_[i], session_params_[j]))
+          {
+            consumers.push_back(j);
+            grouped[j] = true;
+          }
+        }
+
+        if(!consumers.empty())
+        {
+          if(auto msg = context_.message_at(cuti::loglevel_t::info))
+          {
+            *msg << "encode_ladder: rendition " << i <<
+              " shares its analysis data with " << consumers.size() <<
+              " other rendition(s)";
+          }
+          analysis_groups_.push_back(std::make_unique<analysis_group_t>(
+            i, std::move(consumers)));
+        }
+      }
+    }
+  }
+
+  /*
+   * Tells if two renditions encode the same pictures, differing only
+   * in their bitrate.
+   */
+  static bool same_pictures(SessionParams const& lhs,
+                            SessionParams const& rhs)
+  {
+    SessionParams params = rhs;
+    params.common_.bitrate_ = lhs.common_.bitrate_;
+    return params == lhs;
+  }
+
+  /*
+   * Returns the analysis group of the rendition at index if it plays
+   * the given role in it, or nullptr otherwise.
+   */
+  analysis_group_t* analysis_group(std::size_t index, analysis_role_t role)
+  {
+    for(auto& group : analysis_groups_)
+    {
+      if(role == analysis_role_t::publisher)
+      {
+        if(group->publisher_ == index)
+        {
+          return group.get();
+        }
+      }
+      else if(std::find(group->consumers_.begin(), group->consumers_.end(),
+                index) != group->consumers_.end())
+      {
+        return group.get();
+      }
+    }
+    return nullptr;
+  }
+
+  /*
+   * Returns the function that opens the session for the rendition at
+   * index on its worker's thread.
+   */
+  typename encode_worker_t<scaled_session_t>::session_opener_t
+  session_opener(std::size_t index, unsigned int threads)
+  {
+    auto const& session_params = session_params_[index];
+    uint32_t const width = session_params.common_.width_;
+    uint32_t const height = session_params.common_.height_;
+
+    if constexpr(shares_analysis)
+    {
+      for(analysis_role_t role :
+        { analysis_role_t::publisher, analysis_role_t::consumer })
+      {
+        if(auto* group = this->analysis_group(index, role))
+        {
+          EncoderSettings encoder_settings = encoder_settings_;
+          apply_thread_grant(encoder_settings, threads);
+          return [&context = context_, encoder_settings, session_params,
+                  &exchange = group->exchange_, role, width, height]
+          {
+            return std::make_unique<scaled_session_t>(
+              std::make_unique<EncodingSession>(context,
+                encoder_settings, session_params, exchange, role),
+              width, height);
+          };
+        }
+      }
+    }
+
+    return [&pool = encoder_pool_, session_params, threads, width, height]
+    {
+      return std::make_unique<scaled_session_t>(
+        pool.obtain(session_params, threads), width, height);
+    };
+  }
+
+  void read_begin_sequence(cuti::stack_marker_t& marker)
+  {
+    begin_sequence_reader_.start(
+      marker,
+      &encode_ladder_handler_t::write_begin_sequence);
+  }
+
+  void write_begin_sequence(cuti::stack_marker_t& marker)
+  {
+    begin_sequence_writer_.start(
+      marker, &encode_ladder_handler_t::start_streaming);
+  }
+
+  void start_streaming(cuti::stack_marker_t& marker)
+  {
+    if(input_state_ == input_not_started)
+    {
+      this->check_eos(marker);
+    }
+
+    // ...but be careful here: input side may have changed output state
+    if(output_state_ == output_not_started)
+    {
+      this->await_sample(marker);
+    }
+  }
+
+  bool frame_queue_full() const
+  {
+    for(auto const& rendition : renditions_)
+    {
+      if(!rendition->consumer_ && rendition->worker_->frame_queue_full())
+      {
+        return true;
+      }
+    }
+
+    /*
+     * Held frames only hold up the input when a consumer falls behind;
+     * when they are waiting for the publisher, the publisher may need
+     * more frames to produce its analysis data.
+     */
+    for(auto const& group : analysis_groups_)
+    {
+      if(group->held_frames_.size() >= group->max_held_frames_ &&
+         this->consumer_queue_full(*group))
+      {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  bool consumer_queue_full(analysis_group_t const& group) const
+  {
+    for(std::size_t index : group.consumers_)
+    {
+      if(renditions_[index]->worker_->frame_queue_full())
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /*
+   * Returns the frame itself for the last of its recipients, and a
+   * copy for the others.
+   */
+  static x26x_proto::frame_t hand_out(x26x_proto::frame_t& frame,
+                                      std::size_t& copies_left)
+  {
+    if(copies_left == 0)
+    {
+      return std::move(frame);
+    }
+    --copies_left;
+    return frame;
+  }
+
+  /*
+   * Passes the held frames whose analysis data is available to their
+   * consumers, and flushes the consumers after the last frame.
+   */
+  void feed_consumers()
+  {
+    if(ex_ != nullptr)
+    {
+      return;
+    }
+
+    for(auto& group : analysis_groups_)
+    {
+      uint64_t available = group->exchange_.available_frames();
+      while(!group->held_frames_.empty() &&
+            group->frames_fed_ < available &&
+            !this->consumer_queue_full(*group))
+      {
+        std::size_t copies_left = group->consumers_.size() - 1;
+        for(std::size_t index : group->consumers_)
+        {
+          renditions_[index]->worker_->push_frame(
+            hand_out(group->held_frames_.front(), copies_left));
+        }
+        group->held_frames_.pop_front();
+        ++group->frames_fed_;
+      }
+
+      if(group->held_frames_.empty())
+      {
+        if(end_of_frames_ && !group->flushed_)
+        {
+          for(std::size_t index : group->consumers_)
+          {
+            renditions_[index]->worker_->start_flush();
+          }
+          group->flushed_ = true;
+        }
+      }
+      else if(group->frames_fed_ >= available &&
+              renditions_[group->publisher_]->worker_->done())
+      {
+        cuti::exception_builder_t<std::runtime_error> builder;
+        builder << "encode_ladder: rendition " << group->publisher_ <<
+          " published no analysis data for frame #" << group->frames_fed_;
+        this->set_error(builder.exception_ptr());
+        return;
+      }
+    }
+  }
+
+  void check_eos(cuti::stack_marker_t& marker)
+  {
+    this->feed_consumers();
+
+    if(ex_ != nullptr)
+    {
+      this->input_finished(marker);
+      return;
+    }
+
+    if(this->frame_queue_full())
+    {
+      input_state_ = awaiting_queue_space;
+      this->await_workers();
+      return;
+    }
+
+    input_state_ = checking_eos;
+    end_sequence_checker_.start(
+      marker, &encode_ladder_handler_t::handle_eos_check);
+  }
+
+  void handle_eos_check(cuti::stack_marker_t& marker, bool at_end)
+  {
+    assert(input_state_ == checking_eos);
+
+    if(! at_end)
+    {
+      input_state_ = reading_frame;
+      frame_reader_.start(marker, &encode_ladder_handler_t::on_frame);
+    }
+    else
+    {
+      for(auto& rendition : renditions_)
+      {
+        if(!rendition->consumer_)
+        {
+          rendition->worker_->start_flush();
+        }
+      }
+      end_of_frames_ = true;
+      this->feed_consumers();
+      this->input_finished(marker);
+    }
+  }
+
+  void on_frame(cuti::stack_marker_t& marker, x26x_proto::frame_t frame)
+  {
+    assert(input_state_ == reading_frame);
+
+    if(ex_ == nullptr)
+    {
+      // consumers get their frames through their analysis group
+      std::size_t copies_left = analysis_groups_.size();
+      for(auto const& rendition : renditions_)
+      {
+        if(!rendition->consumer_)
+        {
+          ++copies_left;
+        }
+      }
+      --copies_left;
+
+      for(auto& rendition : renditions_)
+      {
+        if(!rendition->consumer_)
+        {
+          rendition->worker_->push_frame(hand_out(frame, copies_left));
+        }
+      }
+      for(auto& group : analysis_groups_)
+      {
+        group->held_frames_.push_back(hand_out(frame, copies_left));
+      }
+    }
+
+    this->check_eos(marker);
+  }
+
+  void on_input_error(cuti::stack_marker_t& marker, std::exception_ptr ex)
+  {
+    assert(input_state_ == checking_eos || input_state_ == reading_frame);
+
+    this->set_error(std::move(ex));
+    this->input_finished(marker);
+  }
+
+  void input_finished(cuti::stack_marker_t& marker)
+  {
+    input_state_ = input_done;
+
+    if(output_state_ == output_done)
+    {
+      this->report_result(marker);
+    }
+  }
+
+  void await_sample(cuti::stack_marker_t& marker)
+  {
+    this->feed_consumers();
+
+    if(ex_ != nullptr)
+    {
+      this->output_finished(marker);
+      return;
+    }
+
+    output_state_ = writing_samples;
+
+    // take turns, so no rendition's samples are held back for long
+    bool all_done = true;
+    std::size_t const n_renditions = renditions_.size();
+    for(std::size_t n = 0; n != n_renditions; ++n)
+    {
+      std::size_t index = (next_rendition_ + n) % n_renditions;
+      auto& worker = *renditions_[index]->worker_;
+
+      std::optional<x26x_proto::sample_t> opt_sample;
+      try
+      {
+        opt_sample = worker.pop_sample();
+      }
+      catch(std::exception const&)
+      {
+        this->set_error(std::current_exception());
+        this->output_finished(marker);
+        return;
+      }
+
+      if(opt_sample != std::nullopt)
+      {
+        next_rendition_ = (index + 1) % n_renditions;
+
+        sample_writer_.start(
+          marker,
+          &encode_ladder_handler_t::await_sample,
+          RequestForm::sample(index, std::move(*opt_sample)));
+        return;
+      }
+
+      if(!worker.done())
+      {
+        all_done = false;
+      }
+    }
+
+    if(all_done)
+    {
+      output_state_ = writing_eos;
+      end_sequence_writer_.start(
+        marker, &encode_ladder_handler_t::output_finished);
+    }
+    else
+    {
+      output_state_ = awaiting_sample;
+      this->await_workers();
+    }
+  }
+
+  /*
+   * Waits for progress from any of the workers.
+   */
+  void await_workers()
+  {
+    for(auto& rendition : renditions_)
+    {
+      rendition->worker_->call_when_ready(outbuf_.scheduler(),
+        [this](cuti::stack_marker_t& base_marker)
+        { this->on_worker_ready(base_marker); });
+    }
+  }
+
+  void cancel_workers_ready() noexcept
+  {
+    for(auto& rendition : renditions_)
+    {
+      rendition->worker_->cancel_when_ready();
+    }
+  }
+
+  void on_worker_ready(cuti::stack_marker_t& marker)
+  {
+    this->cancel_workers_ready();
+
+    /*
+     * Neither side can complete the handler while the other one is
+     * still waiting for the workers, so resuming both is safe.
+     */
+    bool resume_input = input_state_ == awaiting_queue_space;
+    bool resume_output = output_state_ == awaiting_sample;
+
+    if(resume_input)
+    {
+      this->check_eos(marker);
+    }
+    if(resume_output)
+    {
+      this->await_sample(marker);
+    }
+  }
+
+  void on_output_error(cuti::stack_marker_t& marker, std::exception_ptr ex)
+  {
+    assert(output_state_ == writing_samples || output_state_ == writing_eos);
+
+    this->set_error(std::move(ex));
+    this->output_finished(marker);
+  }
+
+  void output_finished(cuti::stack_marker_t& marker)
+  {
+    output_state_ = output_done;
+
+    if(input_state_ == input_done)
+    {
+      this->report_result(marker);
+    }
+  }
+
+  void set_error(std::exception_ptr ex)
+  {
+    if(ex_ != nullptr)
+    {
+      return;
+    }
+    ex_ = std::move(ex);
+    for(auto& rendition : renditions_)
+    {
+      rendition->worker_->stop();
+    }
+
+    /*
+     * The input side is only interrupted between frames; a frame
+     * being read is completed so the request can be drained later.
+     */
+    if(input_state_ == checking_eos)
+    {
+      inbuf_.cancel_when_readable();
+      input_state_ = input_done;
+    }
+    else if(input_state_ == awaiting_queue_space)
+    {
+      input_state_ = input_done;
+    }
+  }
+
+  void report_result(cuti::stack_marker_t& marker)
+  {
+    assert(input_state_ == input_done);
+    assert(output_state_ == output_done);
+
+    this->cancel_workers_ready();
+
+    if(ex_ != nullptr)
+    {
+      result_.fail(marker, std::move(ex_));
+    }
+    else
+    {
+      result_.submit(marker);
+    }
+  }
+
+private :
+  cuti::result_t<void>& result_;
+  cuti::logging_context_t const& context_;
+  cuti::bound_inbuf_t& inbuf_;
+  cuti::bound_outbuf_t& outbuf_;
+  cuti::socket_layer_t& sockets_;
+  EncoderSettings encoder_settings_;
+  encoder_pool_t& encoder_pool_;
+  thread_budget_t& thread_budget_;
+  std::vector<SessionParams> session_params_;
+  std::optional<thread_budget_t::waiter_t> admission_waiter_;
+  cuti::cancellation_ticket_t admission_ticket_;
+
+  // declared before the renditions: released after them
+  std::optional<thread_budget_t::grant_t> thread_grant_;
+  std::vector<std::unique_ptr<analysis_group_t>> analysis_groups_;
+  std::vector<std::unique_ptr<rendition_t>> renditions_;
+  std::size_t next_rendition_;
+
+  cuti::subroutine_t<encode_ladder_handler_t, cuti::reader_t<
+    typename RequestForm::session_params_t>> session_params_reader_;
+  cuti::subroutine_t<encode_ladder_handler_t, cuti::writer_t<
+    typename RequestForm::sample_headers_t>> sample_headers_writer_;
+
+  cuti::subroutine_t<encode_ladder_handler_t,
+    cuti::begin_sequence_reader_t> begin_sequence_reader_;
+  cuti::subroutine_t<encode_ladder_handler_t,
+    cuti::begin_sequence_writer_t> begin_sequence_writer_;
+
+  cuti::subroutine_t<encode_ladder_handler_t, cuti::end_sequence_checker_t,
+    cuti::failure_mode_t::handle_in_parent> end_sequence_checker_;
+  cuti::subroutine_t<encode_ladder_handler_t,
+    cuti::reader_t<x26x_proto::frame_t>,
+    cuti::failure_mode_t::handle_in_parent> frame_reader_;
+  bool end_of_frames_;
+  enum { input_not_started, awaiting_queue_space, checking_eos,
+    reading_frame, input_done } input_state_;
+
+  cuti::subroutine_t<encode_ladder_handler_t,
+    cuti::writer_t<typename RequestForm::sample_t>,
+    cuti::failure_mode_t::handle_in_parent> sample_writer_;
+  cuti::subroutine_t<encode_ladder_handler_t, cuti::end_sequence_writer_t,
+    cuti::failure_mode_t::handle_in_parent> end_sequence_writer_;
+  enum { output_not_started, writing_samples, awaiting_sample,
+    writing_eos, output_done } output_state_;
+
+  std::exception_ptr ex_;
+};
+
+} // x26x_es_utils
+
+#endif
@@ -0,0 +1,411 @@
+/*
+ * Copyright (C) 2026 CodeShop B.V.
+ *
+ * This file is part of the x26x_es_utils library.
+ *
+ * The x26x_es_utils library is free software: you can redistribute it
+ * and/or modify it under the terms of version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * The x26x_es_utils library is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See version 2 of the GNU General Public License for more details.
+ *
+ * You should have received a copy of version 2 of the GNU General
+ * Public License along with the x26x_es_utils library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef X26X_ES_UTILS_ENCODE_WORKER_HPP_
+#define X26X_ES_UTILS_ENCODE_WORKER_HPP_
+
+#include <cuti/callback.hpp>
+#include <cuti/logging_context.hpp>
+#include <cuti/scheduler.hpp>
+#include <cuti/scoped_thread.hpp>
+#include <cuti/socket_layer.hpp>
+#include <cuti/wakeup_pipe.hpp>
+
+#include <x26x_proto/types.hpp>
+
+#include "frame_ring.hpp"
+
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+namespace x26x_es_utils
+{
+
+/*
+ * Runs an encoding session on a dedicated thread, so the scheduler
+ * thread that feeds it frames and writes its samples is never blocked
+ * inside the encoder library.  Opening the session, which may take as
+ * long as encoding a number of frames, is the worker's first step.
+ *
+ * All member functions except the constructor and the destructor are
+ * meant to be called from the scheduler thread.  The worker thread
+ * reports the opening of the session, new samples, freed frame queue
+ * slots, the end of the samples and failures through a wakeup pipe;
+ * see call_when_ready().
+ *
+ * The frame queue depth follows from the configured depth and the
+ * session (see frame_queue_depth()); the queue's user is expected to
+ * stop reading frames while the queue is full.
+ */
+template<typename EncodingSession>
+struct encode_worker_t
+{
+  using session_opener_t = std::function<std::unique_ptr<EncodingSession>()>;
+  using session_closer_t = std::function<
+    void(std::unique_ptr<EncodingSession>)>;
+
+  /*
+   * opener is called on the worker thread.  closer is called from
+   * the destructor, once the worker has stopped, if the session was
+   * opened.
+   */
+  encode_worker_t(cuti::logging_context_t const& context,
+                  cuti::socket_layer_t& sockets,
+                  session_opener_t opener,
+                  session_closer_t closer,
+                  unsigned int configured_queue_depth)
+  : context_(context)
+  , opener_((assert(opener != nullptr), std::move(opener)))
+  , closer_((assert(closer != nullptr), std::move(closer)))
+  , configured_queue_depth_(configured_queue_depth)
+  , ready_(sockets)
+  , mutex_()
+  , cv_()
+  , encoding_session_(nullptr)
+  , frames_(std::nullopt)
+  , samples_()
+  , flush_requested_(false)
+  , stopping_(false)
+  , done_(false)
+  , ex_(nullptr)
+  , thread_(nullptr)
+  {
+    thread_ = std::make_unique<cuti::scoped_thread_t>(
+      [this] { this->run(); });
+  }
+
+  encode_worker_t(encode_worker_t const&) = delete;
+  encode_worker_t& operator=(encode_worker_t const&) = delete;
+
+  /*
+   * Tells if the session has been opened; rethrows the exception if
+   * opening it failed.
+   */
+  bool session_opened() const
+  {
+    std::scoped_lock<std::mutex> lock(mutex_);
+    if(frames_ == std::nullopt && ex_ != nullptr)
+    {
+      std::rethrow_exception(ex_);
+    }
+    return frames_ != std::nullopt;
+  }
+
+  /*
+   * Returns the session, which the worker thread only uses for
+   * encoding.
+   * PRE: this->session_opened()
+   */
+  EncodingSession& session() const
+  {
+    std::scoped_lock<std::mutex> lock(mutex_);
+    assert(encoding_session_ != nullptr);
+    return *encoding_session_;
+  }
+
+  /*
+   * Returns the capacity of the frame queue.
+   * PRE: this->session_opened()
+   */
+  std::size_t frame_queue_depth() const
+  {
+    std::scoped_lock<std::mutex> lock(mutex_);
+    assert(frames_ != std::nullopt);
+    return frames_->capacity();
+  }
+
+  /*
+   * Tells if the frame queue is full; it is considered full until the
+   * session is opened.
+   */
+  bool frame_queue_full() const
+  {
+    std::scoped_lock<std::mutex> lock(mutex_);
+    return frames_ == std::nullopt || frames_->full();
+  }
+
+  /*
+   * Queues a frame for encoding; the frame queue must not be full.
+   */
+  void push_frame(x26x_proto::frame_t frame)
+  {
+    {
+      std::scoped_lock<std::mutex> lock(mutex_);
+      assert(!flush_requested_);
+      if(stopping_)
+      {
+        return;
+      }
+      assert(frames_ != std::nullopt);
+      frames_->push_back(std::move(frame));
+    }
+    cv_.notify_one();
+  }
+
+  /*
+   * Tells the worker that no more frames will follow, so it can flush
+   * the encoder once the queued frames are encoded.
+   */
+  void start_flush()
+  {
+    {
+      std::scoped_lock<std::mutex> lock(mutex_);
+      flush_requested_ = true;
+    }
+    cv_.notify_one();
+  }
+
+  /*
+   * Makes the worker drop any queued frames and stop encoding;
+   * done() becomes true when the worker has stopped.
+   */
+  void stop() noexcept
+  {
+    {
+      std::scoped_lock<std::mutex> lock(mutex_);
+      stopping_ = true;
+      if(frames_ != std::nullopt)
+      {
+        frames_->clear();
+      }
+    }
+    cv_.notify_one();
+  }
+
+  /*
+   * Returns the next encoded sample, or std::nullopt if no sample is
+   * available (yet).  If the encoding session failed, its exception
+   * is rethrown once the samples produced before the failure have
+   * been returned.
+   */
+  std::optional<x26x_proto::sample_t> pop_sample()
+  {
+    std::scoped_lock<std::mutex> lock(mutex_);
+
+    std::optional<x26x_proto::sample_t> result = std::nullopt;
+    if(!samples_.empty())
+    {
+      result.emplace(std::move(samples_.front()));
+      samples_.pop_front();
+    }
+    else if(ex_ != nullptr)
+    {
+      std::rethrow_exception(ex_);
+    }
+    return result;
+  }
+
+  /*
+   * Tells if the worker has stopped and all samples have been popped.
+   */
+  bool done() const
+  {
+    std::scoped_lock<std::mutex> lock(mutex_);
+    return done_ && samples_.empty() && ex_ == nullptr;
+  }
+
+  /*
+   * Schedules a one-time callback for when the worker may have made
+   * progress, canceling any previously requested callback.  The
+   * scheduler must remain alive while the callback is pending.
+   */
+  void call_when_ready(cuti::scheduler_t& scheduler, cuti::callback_t callback)
+  {
+    ready_.call_on_wakeup(scheduler, std::move(callback));
+  }
+
+  /*
+   * Cancels any pending callback; no effect if there is no pending
+   * callback.
+   */
+  void cancel_when_ready() noexcept
+  {
+    ready_.cancel_on_wakeup();
+  }
+
+  ~encode_worker_t()
+  {
+    this->cancel_when_ready();
+    this->stop();
+    thread_.reset();
+
+    if(encoding_session_ != nullptr)
+    {
+      closer_(std::move(encoding_session_));
+    }
+  }
+
+private :
+  void signal_ready() noexcept
+  {
+    ready_.wakeup();
+  }
+
+  void open_session()
+  {
+    std::unique_ptr<EncodingSession> session = nullptr;
+    std::size_t depth = 0;
+    std::exception_ptr ex = nullptr;
+    try
+    {
+      session = opener_();
+      assert(session != nullptr);
+      depth = x26x_es_utils::frame_queue_depth(
+        configured_queue_depth_, session->max_delayed_frames());
+    }
+    catch(std::exception const&)
+    {
+      ex = std::current_exception();
+    }
+
+    std::scoped_lock<std::mutex> lock(mutex_);
+
+    encoding_session_ = std::move(session);
+    if(ex != nullptr)
+    {
+      ex_ = std::move(ex);
+    }
+    else
+    {
+      frames_.emplace(depth);
+    }
+    this->signal_ready();
+  }
+
+  void run()
+  {
+    this->open_session();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while(!stopping_ && ex_ == nullptr && !done_)
+    {
+      if(!frames_->empty())
+      {
+        bool was_full = frames_->full();
+        x26x_proto::frame_t frame = frames_->pop_front();
+        if(was_full)
+        {
+          // let the frame reader resume
+          this->signal_ready();
+        }
+
+        lock.unlock();
+        std::optional<x26x_proto::sample_t> opt_sample;
+        std::exception_ptr ex = nullptr;
+        try
+        {
+          opt_sample = encoding_session_->encode(std::move(frame));
+        }
+        catch(std::exception const&)
+        {
+          ex = std::current_exception();
+        }
+        lock.lock();
+
+        if(ex != nullptr)
+        {
+          ex_ = std::move(ex);
+          this->signal_ready();
+        }
+        else if(opt_sample != std::nullopt)
+        {
+          samples_.push_back(std::move(*opt_sample));
+          this->signal_ready();
+        }
+      }
+      else if(flush_requested_)
+      {
+        lock.unlock();
+        std::optional<x26x_proto::sample_t> opt_sample;
+        std::exception_ptr ex = nullptr;
+        try
+        {
+          opt_sample = encoding_session_->flush();
+        }
+        catch(std::exception const&)
+        {
+          ex = std::current_exception();
+        }
+        lock.lock();
+
+        if(ex != nullptr)
+        {
+          ex_ = std::move(ex);
+        }
+        else if(opt_sample != std::nullopt)
+        {
+          samples_.push_back(std::move(*opt_sample));
+        }
+        else
+        {
+          done_ = true;
+        }
+        this->signal_ready();
+      }
+      else
+      {
+        cv_.wait(lock);
+      }
+    }
+
+    if(stopping_ && !done_)
+    {
+      if(auto msg = context_.message_at(cuti::loglevel_t::debug))
+      {
+        *msg << "encode_worker[" << this << "]: stopped";
+      }
+      done_ = true;
+      this->signal_ready();
+    }
+  }
+
+private :
+  cuti::logging_context_t const& context_;
+  session_opener_t const opener_;
+  session_closer_t const closer_;
+  unsigned int const configured_queue_depth_;
+
+  cuti::wakeup_pipe_t ready_;
+
+  std::mutex mutable mutex_;
+  std::condition_variable cv_;
+  std::unique_ptr<EncodingSession> encoding_session_;
+  std::optional<frame_ring_t> frames_; // set once the session is open
+  std::deque<x26x_proto::sample_t> samples_;
+  bool flush_requested_;
+  bool stopping_;
+  bool done_;
+  std::exception_ptr ex_;
+
+  // the worker uses all of the above, so it is stopped first
+  std::unique_ptr<cuti::scoped_thread_t> thread_;
+};
+
+} // x26x_es_utils
+
+#endif
@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2026 CodeShop B.V.
+ *
+ * This file is part of the x26x_es_utils library.
+ *
+ * The x26x_es_utils library is free software: you can redistribute it
+ * and/or modify it under the terms of version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * The x26x_es_utils library is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See version 2 of the GNU General Public License for more details.
+ *
+ * You should have received a copy of version 2 of the GNU General
+ * Public License along with the x26x_es_utils library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "encoder_pool.hpp"
+
+namespace x26x_es_utils
+{
+
+namespace // anonymous
+{
+
+// reference pictures and pictures being encoded, on top of the lookahead
+constexpr std::size_t extra_pictures = 4;
+
+} // anonymous
+
+std::size_t estimated_session_bytes(
+  x26x_proto::common_session_params_t const& params, int encoder_delay)
+{
+  std::size_t delay = encoder_delay > 0 ?
+    static_cast<std::size_t>(encoder_delay) : 0;
+  std::size_t picture_size = x26x_proto::frame_size(
+    params.width_, params.height_, params.format_);
+  return picture_size * (delay + extra_pictures);
+}
+
+} // x26x_es_utils
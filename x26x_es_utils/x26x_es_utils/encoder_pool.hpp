@@ -0,0 +1,355 @@
+/*
+ * Copyright (C) 2026 CodeShop B.V.
+ *
+ * This file is part of the x26x_es_utils library.
+ *
+ * The x26x_es_utils library is free software: you can redistribute it
+ * and/or modify it under the terms of version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * The x26x_es_utils library is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See version 2 of the GNU General Public License for more details.
+ *
+ * You should have received a copy of version 2 of the GNU General
+ * Public License along with the x26x_es_utils library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef X26X_ES_UTILS_ENCODER_POOL_HPP_
+#define X26X_ES_UTILS_ENCODER_POOL_HPP_
+
+#include <cuti/logging_context.hpp>
+#include <cuti/scoped_thread.hpp>
+
+#include <x26x_proto/types.hpp>
+
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace x26x_es_utils
+{
+
+/*
+ * Returns a rough estimate of the memory held by an opened encoder
+ * for frames with the given parameters: its lookahead and reference
+ * pictures.
+ */
+std::size_t estimated_session_bytes(
+  x26x_proto::common_session_params_t const& params, int encoder_delay);
+
+/*
+ * Keeps opened encoding sessions ready for upcoming encode requests,
+ * so that the cost of opening an encoder (parameter setup, thread
+ * pool creation, frame buffer allocation) is not paid on the request
+ * path.
+ *
+ * Neither libx264 nor libx265 can be fed new frames once it has been
+ * flushed, so an encoder cannot be reused for the next segment.
+ * Instead, for each session handed out, a background thread opens a
+ * spare encoder with the same session parameters, which a later
+ * request for those parameters takes over.  Sessions
+ * that are done are closed on the same background thread.
+ *
+ * The number of spare sessions and their estimated memory use are
+ * bounded; the least recently opened spares are closed first.  A
+ * pool with max_spares == 0 keeps no spares, but still closes
+ * sessions in the background.
+ *
+ * All spares are opened with the same encoder settings, limited to
+ * the number of threads granted to the request (see thread_budget_t),
+ * so spares are matched on their session parameters and thread count.
+ */
+template<typename EncoderSettings, typename EncodingSession,
+         typename SessionParams>
+struct encoder_pool_t
+{
+  encoder_pool_t(cuti::logging_context_t const& context,
+                 EncoderSettings encoder_settings,
+                 std::size_t max_spares,
+                 std::size_t max_spare_bytes)
+  : context_(context)
+  , encoder_settings_(std::move(encoder_settings))
+  , max_spares_(max_spares)
+  , max_spare_bytes_(max_spare_bytes)
+  , mutex_()
+  , cv_()
+  , spares_()
+  , spare_bytes_(0)
+  , wanted_()
+  , retired_()
+  , hits_(0)
+  , misses_(0)
+  , stopping_(false)
+  , thread_(nullptr)
+  {
+    thread_ = std::make_unique<cuti::scoped_thread_t>(
+      [this] { this->run(); });
+  }
+
+  encoder_pool_t(encoder_pool_t const&) = delete;
+  encoder_pool_t& operator=(encoder_pool_t const&) = delete;
+
+  /*
+   * Returns a session for session_params, using at most the given
+   * number of encoder threads (0: the encoder's default): a spare if
+   * one is available, or else a newly opened one.  Throws if the
+   * encoder cannot be opened.
+   */
+  std::unique_ptr<EncodingSession> obtain(
+    SessionParams const& session_params, unsigned int threads = 0)
+  {
+    std::unique_ptr<EncodingSession> result = nullptr;
+
+    {
+      std::scoped_lock<std::mutex> lock(mutex_);
+
+      auto pos = spares_.begin();
+      while(pos != spares_.end() &&
+            !(pos->threads_ == threads && pos->params_ == session_params))
+      {
+        ++pos;
+      }
+
+      if(pos != spares_.end())
+      {
+        result = std::move(pos->session_);
+        spare_bytes_ -= pos->bytes_;
+        spares_.erase(pos);
+        ++hits_;
+      }
+      else
+      {
+        ++misses_;
+      }
+
+      // no point in opening more spares than we can keep
+      if(wanted_.size() < max_spares_)
+      {
+        wanted_.emplace_back(session_params, threads);
+      }
+    }
+
+    if(result != nullptr)
+    {
+      if(auto msg = context_.message_at(cuti::loglevel_t::info))
+      {
+        *msg << "encoder_pool[" << this << "]: reusing spare session";
+      }
+    }
+    else
+    {
+      result = this->open_session(session_params, threads);
+    }
+
+    if(max_spares_ != 0)
+    {
+      cv_.notify_one();
+    }
+
+    return result;
+  }
+
+  /*
+   * Hands a session that is no longer needed to the background
+   * thread for closing.
+   */
+  void release(std::unique_ptr<EncodingSession> session) noexcept
+  {
+    assert(session != nullptr);
+
+    try
+    {
+      std::scoped_lock<std::mutex> lock(mutex_);
+      retired_.push_back(std::move(session));
+    }
+    catch(std::exception const&)
+    {
+      // out of memory: close it here
+      session.reset();
+      return;
+    }
+    cv_.notify_one();
+  }
+
+  /*
+   * Statistics: the number of obtain() calls served by a spare (hits)
+   * or by opening a new session (misses), and the current number of
+   * spares and their estimated memory use.
+   */
+  std::size_t hits() const noexcept
+  {
+    std::scoped_lock<std::mutex> lock(mutex_);
+    return hits_;
+  }
+
+  std::size_t misses() const noexcept
+  {
+    std::scoped_lock<std::mutex> lock(mutex_);
+    return misses_;
+  }
+
+  std::size_t spares() const noexcept
+  {
+    std::scoped_lock<std::mutex> lock(mutex_);
+    return spares_.size();
+  }
+
+  std::size_t spare_bytes() const noexcept
+  {
+    std::scoped_lock<std::mutex> lock(mutex_);
+    return spare_bytes_;
+  }
+
+  ~encoder_pool_t()
+  {
+    {
+      std::scoped_lock<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    cv_.notify_one();
+    thread_.reset();
+  }
+
+private :
+  struct spare_t
+  {
+    SessionParams params_;
+    unsigned int threads_;
+    std::unique_ptr<EncodingSession> session_;
+    std::size_t bytes_;
+  };
+
+  void run()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while(!stopping_)
+    {
+      if(!retired_.empty())
+      {
+        std::vector<std::unique_ptr<EncodingSession>> retired;
+        retired.swap(retired_);
+
+        lock.unlock();
+        retired.clear();
+        lock.lock();
+      }
+      else if(!wanted_.empty())
+      {
+        auto [session_params, threads] = std::move(wanted_.front());
+        wanted_.pop_front();
+
+        lock.unlock();
+        this->open_spare(std::move(session_params), threads);
+        lock.lock();
+      }
+      else
+      {
+        cv_.wait(lock);
+      }
+    }
+
+    std::list<spare_t> spares;
+    spares.swap(spares_);
+    spare_bytes_ = 0;
+    std::vector<std::unique_ptr<EncodingSession>> retired;
+    retired.swap(retired_);
+
+    lock.unlock();
+    spares.clear();
+    retired.clear();
+    lock.lock();
+  }
+
+  std::unique_ptr<EncodingSession> open_session(
+    SessionParams const& session_params, unsigned int threads) const
+  {
+    EncoderSettings encoder_settings = encoder_settings_;
+    apply_thread_grant(encoder_settings, threads);
+    return std::make_unique<EncodingSession>(
+      context_, encoder_settings, session_params);
+  }
+
+  void open_spare(SessionParams session_params, unsigned int threads)
+  {
+    std::unique_ptr<EncodingSession> session = nullptr;
+    std::size_t bytes = 0;
+    try
+    {
+      session = this->open_session(session_params, threads);
+      bytes = estimated_session_bytes(
+        session_params.common_, session->max_delayed_frames());
+    }
+    catch(std::exception const& ex)
+    {
+      // the request itself will report the problem
+      if(auto msg = context_.message_at(cuti::loglevel_t::warning))
+      {
+        *msg << "encoder_pool[" << this <<
+          "]: failed to open spare session: " << ex.what();
+      }
+      return;
+    }
+
+    if(bytes > max_spare_bytes_)
+    {
+      return;
+    }
+
+    std::list<spare_t> evicted;
+    {
+      std::scoped_lock<std::mutex> lock(mutex_);
+
+      spares_.push_front(spare_t{
+        std::move(session_params), threads, std::move(session), bytes});
+      spare_bytes_ += bytes;
+
+      while(spares_.size() > max_spares_ ||
+            spare_bytes_ > max_spare_bytes_)
+      {
+        spare_bytes_ -= spares_.back().bytes_;
+        evicted.splice(evicted.end(), spares_, std::prev(spares_.end()));
+      }
+    }
+
+    if(auto msg = context_.message_at(cuti::loglevel_t::info))
+    {
+      *msg << "encoder_pool[" << this << "]: opened spare session (" <<
+        bytes << " bytes); " << evicted.size() << " spare(s) evicted";
+    }
+  }
+
+private :
+  cuti::logging_context_t const& context_;
+  EncoderSettings const encoder_settings_;
+  std::size_t const max_spares_;
+  std::size_t const max_spare_bytes_;
+
+  std::mutex mutable mutex_;
+  std::condition_variable cv_;
+  std::list<spare_t> spares_; // most recently opened first
+  std::size_t spare_bytes_;
+  std::deque<std::pair<SessionParams, unsigned int>> wanted_;
+  std::vector<std::unique_ptr<EncodingSession>> retired_;
+  std::size_t hits_;
+  std::size_t misses_;
+  bool stopping_;
+
+  // declared last: opens and closes sessions until joined
+  std::unique_ptr<cuti::scoped_thread_t> thread_;
+};
+
+} // x26x_es_utils
+
+#endif
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2026 CodeShop B.V.
+ *
+ * This file is part of the x26x_es_utils library.
+ *
+ * The x26x_es_utils library is free software: you can redistribute it
+ * and/or modify it under the terms of version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * The x26x_es_utils library is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See version 2 of the GNU General Public License for more details.
+ *
+ * You should have received a copy of version 2 of the GNU General
+ * Public License along with the x26x_es_utils library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "frame_ring.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace x26x_es_utils
+{
+
+namespace // anonymous
+{
+
+constexpr std::size_t min_auto_depth = 2;
+constexpr std::size_t max_auto_depth = 16;
+
+} // anonymous
+
+frame_ring_t::frame_ring_t(std::size_t capacity)
+: slots_(capacity)
+, head_(0)
+, size_(0)
+{
+  assert(capacity != 0);
+}
+
+void frame_ring_t::push_back(x26x_proto::frame_t&& frame)
+{
+  assert(!this->full());
+
+  std::size_t tail = head_ + size_;
+  if(tail >= slots_.size())
+  {
+    tail -= slots_.size();
+  }
+  slots_[tail] = std::move(frame);
+  ++size_;
+}
+
+x26x_proto::frame_t frame_ring_t::pop_front()
+{
+  assert(!this->empty());
+
+  x26x_proto::frame_t result = std::move(slots_[head_]);
+  ++head_;
+  if(head_ == slots_.size())
+  {
+    head_ = 0;
+  }
+  --size_;
+
+  return result;
+}
+
+void frame_ring_t::clear() noexcept
+{
+  while(!this->empty())
+  {
+    this->pop_front();
+  }
+  head_ = 0;
+}
+
+std::size_t frame_queue_depth(unsigned int configured_depth,
+                              int encoder_delay)
+{
+  if(configured_depth != 0)
+  {
+    return configured_depth;
+  }
+
+  std::size_t delay = encoder_delay > 0 ?
+    static_cast<std::size_t>(encoder_delay) : 0;
+  return std::clamp(delay, min_auto_depth, max_auto_depth);
+}
+
+} // x26x_es_utils
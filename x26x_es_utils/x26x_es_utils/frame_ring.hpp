@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2026 CodeShop B.V.
+ *
+ * This file is part of the x26x_es_utils library.
+ *
+ * The x26x_es_utils library is free software: you can redistribute it
+ * and/or modify it under the terms of version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * The x26x_es_utils library is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See version 2 of the GNU General Public License for more details.
+ *
+ * You should have received a copy of version 2 of the GNU General
+ * Public License along with the x26x_es_utils library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef X26X_ES_UTILS_FRAME_RING_HPP_
+#define X26X_ES_UTILS_FRAME_RING_HPP_
+
+#include <x26x_proto/types.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace x26x_es_utils
+{
+
+/*
+ * Fixed-capacity FIFO of frames.  All slots are allocated up front,
+ * so pushing and popping never allocate; a full ring is the signal
+ * for its producer to stop reading frames.
+ */
+struct frame_ring_t
+{
+  explicit frame_ring_t(std::size_t capacity);
+
+  frame_ring_t(frame_ring_t const&) = delete;
+  frame_ring_t& operator=(frame_ring_t const&) = delete;
+
+  std::size_t capacity() const noexcept
+  { return slots_.size(); }
+
+  std::size_t size() const noexcept
+  { return size_; }
+
+  bool empty() const noexcept
+  { return size_ == 0; }
+
+  bool full() const noexcept
+  { return size_ == slots_.size(); }
+
+  /*
+   * Appends a frame; the ring must not be full.
+   */
+  void push_back(x26x_proto::frame_t&& frame);
+
+  /*
+   * Removes and returns the oldest frame; the ring must not be empty.
+   */
+  x26x_proto::frame_t pop_front();
+
+  void clear() noexcept;
+
+private :
+  std::vector<x26x_proto::frame_t> slots_;
+  std::size_t head_;
+  std::size_t size_;
+};
+
+/*
+ * Returns the frame queue depth for an encoding session.  A non-zero
+ * configured_depth is used as is.  Otherwise the depth follows the
+ * encoder's own lookahead (encoder_delay frames): queueing more
+ * frames than the encoder holds itself cannot keep it any busier, and
+ * only adds to the per-session memory footprint.
+ */
+std::size_t frame_queue_depth(unsigned int configured_depth,
+                              int encoder_delay);
+
+} // x26x_es_utils
+
+#endif
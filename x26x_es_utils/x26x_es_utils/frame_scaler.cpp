@@ -0,0 +1,295 @@
+/*
+ * Copyright (C) 2026 CodeShop B.V.
+ *
+ * This file is part of the x26x_es_utils library.
+ *
+ * The x26x_es_utils library is free software: you can redistribute it
+ * and/or modify it under the terms of version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * The x26x_es_utils library is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See version 2 of the GNU General Public License for more details.
+ *
+ * You should have received a copy of version 2 of the GNU General
+ * Public License along with the x26x_es_utils library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "frame_scaler.hpp"
+
+#include <cuti/exception_builder.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace x26x_es_utils
+{
+
+namespace // anonymous
+{
+
+// bilinear weights are in units of 1/weight_one
+constexpr unsigned int weight_bits = 12;
+constexpr unsigned int weight_one = 1u << weight_bits;
+
+/*
+ * The source pixels contributing to a single target pixel: the
+ * weights, which add up to total_, apply to the source pixels
+ * starting at first_.
+ */
+struct filter_t
+{
+  std::size_t first_;
+  std::vector<unsigned int> weights_;
+  unsigned int total_;
+};
+
+/*
+ * Interpolates linearly between the two source pixels nearest to the
+ * center of each of the dst_size target pixels; used when upscaling.
+ */
+std::vector<filter_t> make_bilinear_filters(uint32_t src_size,
+                                            uint32_t dst_size)
+{
+  std::vector<filter_t> result(dst_size);
+
+  for(uint32_t i = 0; i != dst_size; ++i)
+  {
+    int64_t pos = (2 * int64_t(i) + 1) * src_size * weight_one /
+      (2 * int64_t(dst_size)) - weight_one / 2;
+    if(pos < 0)
+    {
+      pos = 0;
+    }
+
+    filter_t& filter = result[i];
+    filter.first_ = static_cast<std::size_t>(pos >> weight_bits);
+    if(filter.first_ + 1 < src_size)
+    {
+      unsigned int weight = static_cast<unsigned int>(
+        pos & (weight_one - 1));
+      filter.weights_ = { weight_one - weight, weight };
+    }
+    else
+    {
+      filter.first_ = src_size - 1;
+      filter.weights_ = { weight_one };
+    }
+    filter.total_ = weight_one;
+  }
+
+  return result;
+}
+
+/*
+ * Averages the source pixels covered by each of the dst_size target
+ * pixels, weighted by their coverage; used when downscaling.  Unlike
+ * bilinear interpolation, this takes every source pixel into account,
+ * so larger scale factors do not alias.
+ */
+std::vector<filter_t> make_area_filters(uint32_t src_size,
+                                        uint32_t dst_size)
+{
+  std::vector<filter_t> result(dst_size);
+
+  // in units of 1/dst_size source pixels, target pixel i covers
+  // [i * src_size, (i + 1) * src_size>
+  for(uint32_t i = 0; i != dst_size; ++i)
+  {
+    uint64_t const begin = uint64_t(i) * src_size;
+    uint64_t const end = begin + src_size;
+
+    filter_t& filter = result[i];
+    filter.first_ = static_cast<std::size_t>(begin / dst_size);
+    for(uint64_t pixel = filter.first_; pixel * dst_size < end; ++pixel)
+    {
+      uint64_t const covered =
+        std::min(end, (pixel + 1) * dst_size) -
+        std::max(begin, pixel * dst_size);
+      filter.weights_.push_back(static_cast<unsigned int>(covered));
+    }
+    filter.total_ = src_size;
+  }
+
+  return result;
+}
+
+std::vector<filter_t> make_filters(uint32_t src_size, uint32_t dst_size)
+{
+  return dst_size < src_size ?
+    make_area_filters(src_size, dst_size) :
+    make_bilinear_filters(src_size, dst_size);
+}
+
+template<std::size_t ElemSize>
+unsigned int load_sample(uint8_t const* p)
+{
+  if constexpr(ElemSize == 1)
+  {
+    return p[0];
+  }
+  else
+  {
+    // little endian
+    return p[0] | (p[1] << 8);
+  }
+}
+
+template<std::size_t ElemSize>
+void store_sample(uint8_t* p, unsigned int value)
+{
+  if constexpr(ElemSize == 1)
+  {
+    p[0] = static_cast<uint8_t>(value);
+  }
+  else
+  {
+    p[0] = static_cast<uint8_t>(value);
+    p[1] = static_cast<uint8_t>(value >> 8);
+  }
+}
+
+/*
+ * Scales a plane of pixels with the given number of interleaved
+ * components (2 for NV12's chroma plane); returns the end of the
+ * target plane.
+ */
+template<std::size_t ElemSize>
+uint8_t* scale_plane(uint8_t const* src,
+                     uint32_t src_width, uint32_t src_height,
+                     uint8_t* dst,
+                     uint32_t dst_width, uint32_t dst_height,
+                     unsigned int components)
+{
+  std::vector<filter_t> const x_filters = make_filters(src_width, dst_width);
+  std::vector<filter_t> const y_filters =
+    make_filters(src_height, dst_height);
+
+  std::size_t const pixel_size = components * ElemSize;
+  std::size_t const src_stride = src_width * pixel_size;
+
+  for(filter_t const& y_filter : y_filters)
+  {
+    uint8_t const* rows = src + y_filter.first_ * src_stride;
+
+    for(filter_t const& x_filter : x_filters)
+    {
+      uint8_t const* pixels = rows + x_filter.first_ * pixel_size;
+
+      for(unsigned int c = 0; c != components; ++c)
+      {
+        uint8_t const* row = pixels + c * ElemSize;
+        uint64_t sum = 0;
+
+        for(unsigned int wy : y_filter.weights_)
+        {
+          uint8_t const* sample = row;
+          uint64_t row_sum = 0;
+          for(unsigned int wx : x_filter.weights_)
+          {
+            row_sum += load_sample<ElemSize>(sample) * wx;
+            sample += pixel_size;
+          }
+          sum += row_sum * wy;
+          row += src_stride;
+        }
+
+        uint64_t const total = uint64_t(y_filter.total_) * x_filter.total_;
+        unsigned int value = static_cast<unsigned int>(
+          (sum + total / 2) / total);
+
+        store_sample<ElemSize>(dst, value);
+        dst += ElemSize;
+      }
+    }
+  }
+
+  return dst;
+}
+
+template<std::size_t ElemSize>
+void scale_planes(x26x_proto::frame_t const& frame,
+                  x26x_proto::frame_t& result)
+{
+  uint8_t const* src = frame.data_.data();
+  uint8_t* dst = result.data_.data();
+
+  dst = scale_plane<ElemSize>(src, frame.width_, frame.height_,
+    dst, result.width_, result.height_, 1);
+  src += std::size_t(frame.width_) * frame.height_ * ElemSize;
+
+  uint32_t const src_chroma_width = frame.width_ / 2;
+  uint32_t const src_chroma_height = frame.height_ / 2;
+  uint32_t const dst_chroma_width = result.width_ / 2;
+  uint32_t const dst_chroma_height = result.height_ / 2;
+
+  if(frame.format_ == x26x_proto::format_t::NV12)
+  {
+    scale_plane<ElemSize>(src, src_chroma_width, src_chroma_height,
+      dst, dst_chroma_width, dst_chroma_height, 2);
+  }
+  else
+  {
+    for(int plane = 0; plane != 2; ++plane)
+    {
+      dst = scale_plane<ElemSize>(src, src_chroma_width, src_chroma_height,
+        dst, dst_chroma_width, dst_chroma_height, 1);
+      src += std::size_t(src_chroma_width) * src_chroma_height * ElemSize;
+    }
+  }
+}
+
+void check_dimensions(char const* what, uint32_t width, uint32_t height)
+{
+  if(width == 0 || height == 0 || width % 2 != 0 || height % 2 != 0)
+  {
+    cuti::exception_builder_t<std::runtime_error> builder;
+    builder << "scale_frame(): unsupported " << what << " dimensions " <<
+      width << 'x' << height;
+    builder.explode();
+  }
+}
+
+} // anonymous
+
+x26x_proto::frame_t scale_frame(x26x_proto::frame_t const& frame,
+                                uint32_t width, uint32_t height)
+{
+  check_dimensions("source", frame.width_, frame.height_);
+  check_dimensions("target", width, height);
+
+  if(frame.data_.size() !=
+     x26x_proto::frame_size(frame.width_, frame.height_, frame.format_))
+  {
+    cuti::exception_builder_t<std::runtime_error> builder;
+    builder << "scale_frame(): unexpected frame data size " <<
+      frame.data_.size();
+    builder.explode();
+  }
+
+  x26x_proto::frame_t result;
+  result.width_ = width;
+  result.height_ = height;
+  result.format_ = frame.format_;
+  result.pts_ = frame.pts_;
+  result.timescale_ = frame.timescale_;
+  result.keyframe_ = frame.keyframe_;
+  result.data_.resize(x26x_proto::frame_size(width, height, frame.format_));
+
+  if(frame.format_ == x26x_proto::format_t::YUV420P10LE)
+  {
+    scale_planes<2>(frame, result);
+  }
+  else
+  {
+    scale_planes<1>(frame, result);
+  }
+
+  return result;
+}
+
+} // x26x_es_utils
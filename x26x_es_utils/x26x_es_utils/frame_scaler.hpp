@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2026 CodeShop B.V.
+ *
+ * This file is part of the x26x_es_utils library.
+ *
+ * The x26x_es_utils library is free software: you can redistribute it
+ * and/or modify it under the terms of version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * The x26x_es_utils library is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See version 2 of the GNU General Public License for more details.
+ *
+ * You should have received a copy of version 2 of the GNU General
+ * Public License along with the x26x_es_utils library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef X26X_ES_UTILS_FRAME_SCALER_HPP_
+#define X26X_ES_UTILS_FRAME_SCALER_HPP_
+
+#include <x26x_proto/types.hpp>
+
+#include <cstdint>
+
+namespace x26x_es_utils
+{
+
+/*
+ * Returns a copy of frame scaled to width x height; the frame's
+ * format, timing and keyframe flag are kept.  Downscaling averages
+ * the source pixels covered by each target pixel, so any scale factor
+ * is safe from aliasing; upscaling interpolates bilinearly.  Meant
+ * for the scale factors of a bitrate ladder, not for quality
+ * resampling.
+ *
+ * Throws if the frame's data does not match its dimensions and
+ * format, or if a dimension is zero or odd.
+ */
+x26x_proto::frame_t scale_frame(x26x_proto::frame_t const& frame,
+                                uint32_t width, uint32_t height);
+
+} // x26x_es_utils
+
+#endif
@@ -21,17 +21,23 @@
 #define X26X_ES_UTILS_SERVICE_HPP_
 
 #include "encode_handler.hpp"
+#include "encode_ladder_handler.hpp"
+#include "encoder_pool.hpp"
+#include "thread_budget.hpp"
 
 #include <cuti/add_handler.hpp>
+#include <cuti/buffer_pool.hpp>
 #include <cuti/dispatcher.hpp>
 #include <cuti/dispatcher.hpp>
 #include <cuti/echo_handler.hpp>
 #include <cuti/endpoint.hpp>
+#include <cuti/logging_context.hpp>
 #include <cuti/method.hpp>
 #include <cuti/method_map.hpp>
 #include <cuti/service.hpp>
 #include <cuti/subtract_handler.hpp>
 
+#include <cstddef>
 #include <memory>
 #include <vector>
 
@@ -42,16 +48,31 @@ template<typename EncoderSettings, typename EncodingSession,
          typename SessionParams, typename SampleHeaders>
 struct service_t : cuti::service_t
 {
+  using encoder_pool_t = x26x_es_utils::encoder_pool_t<
+    EncoderSettings, EncodingSession, SessionParams>;
+
   service_t(cuti::logging_context_t const& context,
             cuti::socket_layer_t& sockets,
             cuti::dispatcher_config_t const& dispatcher_config,
             EncoderSettings const& encoder_settings,
             std::vector<cuti::endpoint_t> const& endpoints)
-  : map_(std::make_unique<cuti::method_map_t>())
+  : context_(context)
+  , thread_budget_(std::make_unique<thread_budget_t>(
+      encoder_settings.encoder_threads_.value_,
+      encoder_settings.max_session_threads_.value_))
+  , encoder_pool_(std::make_unique<encoder_pool_t>(
+      context, encoder_settings,
+      encoder_settings.encoder_pool_size_.value_,
+      std::size_t(encoder_settings.encoder_pool_memory_.value_) << 20))
+  , map_(std::make_unique<cuti::method_map_t>())
   , dispatcher_(std::make_unique<cuti::dispatcher_t>(
                   context, sockets, dispatcher_config))
   , endpoints_()
   {
+    // the buffer pool is process-wide; recycling is opt-in
+    cuti::default_buffer_pool().set_max_pooled_bytes(
+      std::size_t(encoder_settings.buffer_pool_memory_.value_) << 20);
+
     // add sample methods (for manual testing)
     map_->add_method_factory(
       "add", cuti::default_method_factory<cuti::add_handler_t>());
@@ -61,7 +82,8 @@ struct service_t : cuti::service_t
       "subtract", cuti::default_method_factory<cuti::subtract_handler_t>());
 
     // add encode method
-    auto encode_method_factory = [encoder_settings](
+    auto encode_method_factory = [&sockets, encoder_settings,
+      &encoder_pool = *encoder_pool_, &thread_budget = *thread_budget_](
       cuti::result_t<void>& result,
       cuti::logging_context_t const& context,
       cuti::bound_inbuf_t& inbuf,
@@ -69,11 +91,26 @@ struct service_t : cuti::service_t
     {
       return cuti::make_method<encode_handler_t<EncoderSettings,
         EncodingSession, SessionParams, SampleHeaders>>(result, context, inbuf,
-        outbuf, encoder_settings);
+        outbuf, sockets, encoder_settings, encoder_pool, thread_budget);
     };
     map_->add_method_factory(
       "encode", std::move(encode_method_factory));
 
+    // add encode_ladder method
+    auto encode_ladder_method_factory = [&sockets, encoder_settings,
+      &encoder_pool = *encoder_pool_, &thread_budget = *thread_budget_](
+      cuti::result_t<void>& result,
+      cuti::logging_context_t const& context,
+      cuti::bound_inbuf_t& inbuf,
+      cuti::bound_outbuf_t& outbuf)
+    {
+      return cuti::make_method<encode_ladder_handler_t<EncoderSettings,
+        EncodingSession, SessionParams, SampleHeaders>>(result, context, inbuf,
+        outbuf, sockets, encoder_settings, encoder_pool, thread_budget);
+    };
+    map_->add_method_factory(
+      "encode_ladder", std::move(encode_ladder_method_factory));
+
     for(auto const& endpoint : endpoints)
     {
       auto bound_endpoint = dispatcher_->add_listener(endpoint, *map_);
@@ -86,9 +123,32 @@ struct service_t : cuti::service_t
     return endpoints_;
   }
 
+  encoder_pool_t const& encoder_pool() const
+  {
+    return *encoder_pool_;
+  }
+
+  thread_budget_t const& thread_budget() const
+  {
+    return *thread_budget_;
+  }
+
+  cuti::buffer_pool_t const& buffer_pool() const
+  {
+    return cuti::default_buffer_pool();
+  }
+
   void run() override
   {
     dispatcher_->run();
+
+    if(auto msg = context_.message_at(cuti::loglevel_t::info))
+    {
+      cuti::buffer_pool_t const& pool = this->buffer_pool();
+      *msg << "buffer pool: " << pool.hits() << " hit(s) " <<
+        pool.misses() << " miss(es) " << pool.pooled_bytes() <<
+        " byte(s) pooled";
+    }
   }
 
   void stop(int sig) override
@@ -100,6 +160,10 @@ struct service_t : cuti::service_t
   { }
 
 private :
+  cuti::logging_context_t const& context_;
+  // declared before the dispatcher: its encode handlers use these
+  std::unique_ptr<thread_budget_t> thread_budget_;
+  std::unique_ptr<encoder_pool_t> encoder_pool_;
   std::unique_ptr<cuti::method_map_t> map_;
   std::unique_ptr<cuti::dispatcher_t> dispatcher_;
   std::vector<cuti::endpoint_t> endpoints_;
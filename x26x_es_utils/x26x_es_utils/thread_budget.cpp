@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) 2026 CodeShop B.V.
+ *
+ * This file is part of the x26x_es_utils library.
+ *
+ * The x26x_es_utils library is free software: you can redistribute it
+ * and/or modify it under the terms of version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * The x26x_es_utils library is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See version 2 of the GNU General Public License for more details.
+ *
+ * You should have received a copy of version 2 of the GNU General
+ * Public License along with the x26x_es_utils library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "thread_budget.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace x26x_es_utils
+{
+
+thread_budget_t::grant_t::grant_t(thread_budget_t* budget,
+                                  unsigned int threads,
+                                  unsigned int sessions) noexcept
+: budget_((assert(budget != nullptr), budget))
+, threads_(threads)
+, sessions_(sessions)
+{ }
+
+thread_budget_t::grant_t::grant_t(grant_t&& rhs) noexcept
+: budget_(rhs.budget_)
+, threads_(rhs.threads_)
+, sessions_(rhs.sessions_)
+{
+  rhs.budget_ = nullptr;
+  rhs.threads_ = 0;
+  rhs.sessions_ = 0;
+}
+
+thread_budget_t::grant_t::~grant_t()
+{
+  if(budget_ != nullptr)
+  {
+    budget_->release(threads_, sessions_);
+  }
+}
+
+thread_budget_t::waiter_t::waiter_t(thread_budget_t& budget,
+                                    cuti::socket_layer_t& sockets,
+                                    unsigned int sessions)
+: budget_(budget)
+, sessions_((assert(sessions != 0), sessions))
+, ready_(sockets)
+, pos_()
+, queued_(false)
+{
+  std::scoped_lock<std::mutex> lock(budget_.mutex_);
+
+  pos_ = budget_.waiters_.insert(budget_.waiters_.end(), this);
+  queued_ = true;
+
+  if(pos_ == budget_.waiters_.begin())
+  {
+    // threads may have been released since our caller last tried
+    ready_.wakeup();
+  }
+}
+
+std::optional<thread_budget_t::grant_t>
+thread_budget_t::waiter_t::try_acquire()
+{
+  std::scoped_lock<std::mutex> lock(budget_.mutex_);
+  assert(queued_);
+
+  if(pos_ != budget_.waiters_.begin())
+  {
+    return std::nullopt;
+  }
+
+  std::optional<grant_t> result = budget_.acquire_locked(sessions_);
+  if(result != std::nullopt)
+  {
+    budget_.waiters_.erase(pos_);
+    queued_ = false;
+
+    // the next waiter may fit in what is left
+    budget_.wake_first_waiter_locked();
+  }
+  return result;
+}
+
+void thread_budget_t::waiter_t::call_when_ready(cuti::scheduler_t& scheduler,
+                                                cuti::callback_t callback)
+{
+  ready_.call_on_wakeup(scheduler, std::move(callback));
+}
+
+void thread_budget_t::waiter_t::cancel_when_ready() noexcept
+{
+  ready_.cancel_on_wakeup();
+}
+
+thread_budget_t::waiter_t::~waiter_t()
+{
+  std::scoped_lock<std::mutex> lock(budget_.mutex_);
+
+  if(queued_)
+  {
+    bool first = pos_ == budget_.waiters_.begin();
+    budget_.waiters_.erase(pos_);
+    if(first)
+    {
+      budget_.wake_first_waiter_locked();
+    }
+  }
+}
+
+thread_budget_t::thread_budget_t(unsigned int total_threads,
+                                 unsigned int max_session_threads)
+: total_threads_(total_threads)
+, max_session_threads_((assert(max_session_threads != 0),
+    max_session_threads))
+, mutex_()
+, available_threads_(total_threads)
+, active_sessions_(0)
+, waiters_()
+{ }
+
+std::optional<thread_budget_t::grant_t>
+thread_budget_t::try_acquire(unsigned int sessions)
+{
+  std::scoped_lock<std::mutex> lock(mutex_);
+
+  if(!waiters_.empty())
+  {
+    return std::nullopt;
+  }
+  return this->acquire_locked(sessions);
+}
+
+unsigned int thread_budget_t::available_threads() const noexcept
+{
+  std::scoped_lock<std::mutex> lock(mutex_);
+  return available_threads_;
+}
+
+std::size_t thread_budget_t::active_sessions() const noexcept
+{
+  std::scoped_lock<std::mutex> lock(mutex_);
+  return active_sessions_;
+}
+
+std::size_t thread_budget_t::waiting_requests() const noexcept
+{
+  std::scoped_lock<std::mutex> lock(mutex_);
+  return waiters_.size();
+}
+
+std::optional<thread_budget_t::grant_t>
+thread_budget_t::acquire_locked(unsigned int sessions)
+{
+  assert(sessions != 0);
+
+  unsigned int threads = 0;
+  if(total_threads_ != 0)
+  {
+    if(available_threads_ < sessions)
+    {
+      return std::nullopt;
+    }
+
+    unsigned int fair_share = static_cast<unsigned int>(
+      std::size_t(total_threads_) * sessions / (active_sessions_ + sessions));
+    threads = std::clamp(fair_share, sessions,
+      max_session_threads_ * sessions);
+    threads = std::min(threads, available_threads_);
+    available_threads_ -= threads;
+  }
+  active_sessions_ += sessions;
+
+  return grant_t(this, threads, sessions);
+}
+
+void thread_budget_t::wake_first_waiter_locked() noexcept
+{
+  if(!waiters_.empty())
+  {
+    waiters_.front()->ready_.wakeup();
+  }
+}
+
+void thread_budget_t::release(unsigned int threads,
+                              unsigned int sessions) noexcept
+{
+  std::scoped_lock<std::mutex> lock(mutex_);
+
+  assert(active_sessions_ >= sessions);
+  active_sessions_ -= sessions;
+  available_threads_ += threads;
+  assert(available_threads_ <= total_threads_);
+
+  this->wake_first_waiter_locked();
+}
+
+} // x26x_es_utils
@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2026 CodeShop B.V.
+ *
+ * This file is part of the x26x_es_utils library.
+ *
+ * The x26x_es_utils library is free software: you can redistribute it
+ * and/or modify it under the terms of version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * The x26x_es_utils library is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See version 2 of the GNU General Public License for more details.
+ *
+ * You should have received a copy of version 2 of the GNU General
+ * Public License along with the x26x_es_utils library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef X26X_ES_UTILS_THREAD_BUDGET_HPP_
+#define X26X_ES_UTILS_THREAD_BUDGET_HPP_
+
+#include <cuti/callback.hpp>
+#include <cuti/scheduler.hpp>
+#include <cuti/socket_layer.hpp>
+#include <cuti/wakeup_pipe.hpp>
+
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <optional>
+
+namespace x26x_es_utils
+{
+
+/*
+ * A service-wide budget of encoder worker threads, shared by all
+ * concurrent encoding sessions so that they do not each start a
+ * thread for every core.
+ *
+ * An encoder's thread count is fixed when it is opened, so the
+ * budget is divided when sessions start: a new session is granted a
+ * fair share of the budget given the number of active sessions, but
+ * at most max_session_threads and no more than what is left.  A
+ * request running several sessions is granted at least one thread
+ * per session, and counts as that many sessions.  When too few
+ * threads are left, the request has to wait (see waiter_t) until
+ * others finish.  A budget of 0 threads means no budget: every
+ * request is admitted immediately, with the encoder's own thread
+ * defaults.
+ */
+struct thread_budget_t
+{
+  static unsigned int constexpr default_max_session_threads = 16;
+
+  /*
+   * A number of threads held by a request's sessions; returned to the
+   * budget on destruction.
+   */
+  struct grant_t
+  {
+    grant_t(grant_t&& rhs) noexcept;
+    grant_t& operator=(grant_t const&) = delete;
+
+    /*
+     * Returns the number of threads granted, or 0 if there is no
+     * budget.
+     */
+    unsigned int threads() const noexcept
+    { return threads_; }
+
+    ~grant_t();
+
+  private :
+    friend struct thread_budget_t;
+
+    grant_t(thread_budget_t* budget, unsigned int threads,
+            unsigned int sessions) noexcept;
+
+  private :
+    thread_budget_t* budget_;
+    unsigned int threads_;
+    unsigned int sessions_;
+  };
+
+  /*
+   * A request waiting for a grant.  Waiters are admitted in the order
+   * they were created, and while any are waiting, try_acquire() on
+   * the budget admits no one else.
+   *
+   * The budget is shared between scheduler threads; a waiter is woken
+   * up on its own scheduler when it may be its turn.  Its member
+   * functions are meant to be called from that scheduler's thread.
+   */
+  struct waiter_t
+  {
+    waiter_t(thread_budget_t& budget, cuti::socket_layer_t& sockets,
+             unsigned int sessions = 1);
+
+    waiter_t(waiter_t const&) = delete;
+    waiter_t& operator=(waiter_t const&) = delete;
+
+    /*
+     * Returns the grant if it is this waiter's turn and enough
+     * threads are available, leaving the queue; std::nullopt
+     * otherwise.
+     */
+    std::optional<grant_t> try_acquire();
+
+    /*
+     * Schedules a one-time callback for when try_acquire() may
+     * succeed, canceling any previously requested callback.
+     */
+    void call_when_ready(cuti::scheduler_t& scheduler,
+                         cuti::callback_t callback);
+
+    void cancel_when_ready() noexcept;
+
+    /*
+     * Leaves the queue, if still waiting.
+     */
+    ~waiter_t();
+
+  private :
+    friend struct thread_budget_t;
+
+    thread_budget_t& budget_;
+    unsigned int const sessions_;
+    cuti::wakeup_pipe_t ready_;
+    std::list<waiter_t*>::iterator pos_; // valid while queued
+    bool queued_;
+  };
+
+  explicit thread_budget_t(
+    unsigned int total_threads,
+    unsigned int max_session_threads = default_max_session_threads);
+
+  thread_budget_t(thread_budget_t const&) = delete;
+  thread_budget_t& operator=(thread_budget_t const&) = delete;
+
+  /*
+   * Tries to admit a new request running the given number of
+   * sessions, returning its grant, or std::nullopt if too few threads
+   * are left or other requests are waiting.  A request needing more
+   * sessions than total_threads() can never be admitted.
+   */
+  std::optional<grant_t> try_acquire(unsigned int sessions = 1);
+
+  unsigned int total_threads() const noexcept
+  { return total_threads_; }
+
+  /*
+   * Returns the number of threads not currently granted.
+   */
+  unsigned int available_threads() const noexcept;
+
+  /*
+   * Returns the number of sessions holding a grant.
+   */
+  std::size_t active_sessions() const noexcept;
+
+  /*
+   * Returns the number of requests waiting for a grant.
+   */
+  std::size_t waiting_requests() const noexcept;
+
+private :
+  std::optional<grant_t> acquire_locked(unsigned int sessions);
+  void wake_first_waiter_locked() noexcept;
+  void release(unsigned int threads, unsigned int sessions) noexcept;
+
+private :
+  unsigned int const total_threads_;
+  unsigned int const max_session_threads_;
+
+  std::mutex mutable mutex_;
+  unsigned int available_threads_;
+  std::size_t active_sessions_;
+  std::list<waiter_t*> waiters_; // oldest first
+};
+
+} // x26x_es_utils
+
+#endif
@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2026 CodeShop B.V.
+ *
+ * This file is part of the x26x service protocol library.
+ *
+ * The x26x service protocol library is free software: you can
+ * redistribute it and/or modify it under the terms of version 2.1 of
+ * the GNU Lesser General Public License as published by the Free
+ * Software Foundation.
+ *
+ * The x26x service protocol library is distributed in the hope that
+ * it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See version 2.1 of the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of version 2.1 of the GNU Lesser
+ * General Public License along with the x26x service protocol
+ * library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <x26x_proto/frame_queue.hpp>
+
+#include <cuti/scoped_thread.hpp>
+
+#include <cstddef>
+#include <exception>
+#include <iostream>
+#include <optional>
+
+#undef NDEBUG
+#include <cassert>
+
+namespace // anonymous
+{
+
+using namespace x26x_proto;
+
+frame_t make_frame(uint64_t pts)
+{
+  frame_t frame;
+  frame.pts_ = pts;
+  frame.data_.insert(frame.data_.begin(), 100, 42);
+  return frame;
+}
+
+void test_empty()
+{
+  frame_queue_t queue;
+  queue.close();
+  assert(queue.pop() == std::nullopt);
+  assert(queue.pop() == std::nullopt);
+}
+
+void test_fifo()
+{
+  frame_queue_t queue(3);
+  queue.push(make_frame(0));
+  queue.push(make_frame(1));
+  queue.push(make_frame(2));
+
+  auto frame = queue.pop();
+  assert(frame != std::nullopt);
+  assert(frame->pts_ == 0);
+
+  queue.push(make_frame(3));
+  queue.close();
+
+  for(uint64_t pts = 1; pts != 4; ++pts)
+  {
+    frame = queue.pop();
+    assert(frame != std::nullopt);
+    assert(frame->pts_ == pts);
+    assert(frame->data_.size() == 100);
+  }
+  assert(queue.pop() == std::nullopt);
+}
+
+void test_producer_thread(std::size_t capacity, uint64_t count)
+{
+  frame_queue_t queue(capacity);
+
+  {
+    cuti::scoped_thread_t producer([&]
+    {
+      for(uint64_t pts = 0; pts != count; ++pts)
+      {
+        queue.push(make_frame(pts));
+      }
+      queue.close();
+    });
+
+    uint64_t expected_pts = 0;
+    while(auto frame = queue.pop())
+    {
+      assert(frame->pts_ == expected_pts);
+      ++expected_pts;
+    }
+    assert(expected_pts == count);
+  }
+}
+
+void test_cancel_push()
+{
+  frame_queue_t queue(1);
+
+  {
+    cuti::scoped_thread_t producer([&]
+    {
+      uint64_t pts = 0;
+      while(queue.push(make_frame(pts)))
+      {
+        ++pts;
+      }
+    });
+
+    auto frame = queue.pop();
+    assert(frame != std::nullopt);
+    assert(frame->pts_ == 0);
+
+    // the producer is (or will be) waiting for a full queue
+    queue.cancel();
+  }
+
+  bool caught = false;
+  try
+  {
+    queue.pop();
+  }
+  catch(std::exception const&)
+  {
+    caught = true;
+  }
+  assert(caught);
+}
+
+void test_cancel_pop()
+{
+  frame_queue_t queue;
+  bool caught = false;
+
+  {
+    cuti::scoped_thread_t consumer([&]
+    {
+      try
+      {
+        queue.pop();
+      }
+      catch(std::exception const&)
+      {
+        caught = true;
+      }
+    });
+
+    queue.cancel();
+  }
+
+  assert(caught);
+  assert(!queue.push(make_frame(0)));
+}
+
+void run_tests(int, char const* const*)
+{
+  test_empty();
+  test_fifo();
+  test_producer_thread(1, 1000);
+  test_producer_thread(frame_queue_t::default_capacity, 1000);
+  test_cancel_push();
+  test_cancel_pop();
+}
+
+} // anonymous
+
+int main(int argc, char* argv[])
+{
+  try
+  {
+    run_tests(argc, argv);
+  }
+  catch(std::exception const& ex)
+  {
+    std::cerr << argv[0] << ": exception: " << ex.what() << std::endl;
+    throw;
+  }
+
+  return 0;
+}
@@ -71,6 +71,14 @@ sample_t make_example_sample()
   return sample;
 }
 
+rendition_sample_t make_example_rendition_sample()
+{
+  rendition_sample_t rendition_sample;
+  rendition_sample.rendition_ = 2;
+  rendition_sample.sample_ = make_example_sample();
+  return rendition_sample;
+}
+
 void test_serialization(
   cuti::logging_context_t const& context,
   std::size_t bufsize)
@@ -80,6 +88,7 @@ void test_serialization(
   test_roundtrip(context, bufsize, make_example_common_session_params());
   test_roundtrip(context, bufsize, make_example_frame());
   test_roundtrip(context, bufsize, make_example_sample());
+  test_roundtrip(context, bufsize, make_example_rendition_sample());
 }
 
 struct options_t
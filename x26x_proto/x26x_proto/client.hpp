@@ -22,6 +22,7 @@
 #ifndef X26X_PROTO_CLIENT_HPP_
 #define X26X_PROTO_CLIENT_HPP_
 
+#include "frame_queue.hpp"
 #include "linkage.h"
 #include "types.hpp"
 
@@ -34,6 +35,7 @@
 #include <cuti/throughput_checker.hpp>
 #include <cuti/type_list.hpp>
 
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -61,6 +63,13 @@ struct client_t
   using encode_request_types_t =
     cuti::type_list_t<SessionParams, cuti::sequence_t<x26x_proto::frame_t>>;
 
+  using encode_ladder_reply_types_t =
+    cuti::type_list_t<cuti::sequence_t<SampleHeaders>,
+                      cuti::sequence_t<x26x_proto::rendition_sample_t>>;
+  using encode_ladder_request_types_t =
+    cuti::type_list_t<cuti::sequence_t<SessionParams>,
+                      cuti::sequence_t<x26x_proto::frame_t>>;
+
   // 'subtract' is for testing purposes
   using subtract_reply_types_t =
     cuti::type_list_t<int>;
@@ -135,6 +144,25 @@ struct client_t
     rpc_client_.start("encode", std::move(inputs), std::move(outputs));
   }
 
+  template<typename SampleHeadersConsumer, typename SampleConsumer,
+           typename SessionParamsProducer, typename FrameProducer>
+  void start_encode_ladder(SampleHeadersConsumer&& sample_headers_consumer,
+                           SampleConsumer&& sample_consumer,
+                           SessionParamsProducer&& session_params_producer,
+                           FrameProducer&& frame_producer)
+  {
+    auto inputs = cuti::make_input_list_ptr<encode_ladder_reply_types_t>(
+      std::forward<SampleHeadersConsumer>(sample_headers_consumer),
+      std::forward<SampleConsumer>(sample_consumer));
+
+    auto outputs = cuti::make_output_list_ptr<encode_ladder_request_types_t>(
+      std::forward<SessionParamsProducer>(session_params_producer),
+      std::forward<FrameProducer>(frame_producer));
+
+    rpc_client_.start(
+      "encode_ladder", std::move(inputs), std::move(outputs));
+  }
+
   template<typename Result, typename Arg1, typename Arg2>
   void start_subtract(Result&& result, Arg1&& arg1, Arg2&& arg2)
   {
@@ -182,6 +210,88 @@ struct client_t
     return result;
   }
 
+  /*
+   * Encodes the same frames for each of the renditions in
+   * session_params, uploading the frames only once; the server scales
+   * the frames to each rendition's size.  Returns the sample headers
+   * for each rendition, in order, and the samples for all renditions,
+   * tagged with the index of their rendition.
+   */
+  std::pair<std::vector<SampleHeaders>,
+            std::vector<x26x_proto::rendition_sample_t>>
+  encode_ladder(std::vector<SessionParams> session_params,
+                std::vector<x26x_proto::frame_t> frames)
+  {
+    std::pair<std::vector<SampleHeaders>,
+              std::vector<x26x_proto::rendition_sample_t>> result;
+
+    this->start_encode_ladder(result.first, result.second,
+      std::move(session_params), std::move(frames));
+    this->complete_current_call();
+
+    return result;
+  }
+
+  /*
+   * Streaming encode: frames are pulled from frame_producer, a
+   * callable returning std::optional<frame_t> (std::nullopt after the
+   * last frame), as the connection can take them, and each sample is
+   * handed to sample_consumer, a callable taking a sample_t, as soon
+   * as it arrives.  The sample headers, which precede the samples,
+   * are handed to sample_headers_consumer.  Only the frames and
+   * samples in flight are held in memory; see also frame_queue_t.
+   * frame_producer is called on the thread running the client's
+   * scheduler, and should not block for long.
+   */
+  template<typename FrameProducer,
+           typename SampleHeadersConsumer, typename SampleConsumer>
+  void encode_stream(SessionParams session_params,
+                     FrameProducer&& frame_producer,
+                     SampleHeadersConsumer&& sample_headers_consumer,
+                     SampleConsumer&& sample_consumer)
+  {
+    auto samples_consumer = [&sample_consumer](
+      std::optional<x26x_proto::sample_t> opt_sample)
+    {
+      if(opt_sample != std::nullopt)
+      {
+        sample_consumer(std::move(*opt_sample));
+      }
+    };
+
+    this->start_encode(
+      std::forward<SampleHeadersConsumer>(sample_headers_consumer),
+      std::move(samples_consumer),
+      std::move(session_params),
+      std::forward<FrameProducer>(frame_producer));
+    this->complete_current_call();
+  }
+
+  /*
+   * Streaming encode pulling its frames from frame_queue.  If the
+   * encode call fails, frame_queue is canceled, so a producer thread
+   * waiting in frame_queue.push() does not wait forever.
+   */
+  template<typename SampleHeadersConsumer, typename SampleConsumer>
+  void encode_stream(SessionParams session_params,
+                     frame_queue_t& frame_queue,
+                     SampleHeadersConsumer&& sample_headers_consumer,
+                     SampleConsumer&& sample_consumer)
+  {
+    try
+    {
+      this->encode_stream(std::move(session_params),
+        [&frame_queue] { return frame_queue.pop(); },
+        std::forward<SampleHeadersConsumer>(sample_headers_consumer),
+        std::forward<SampleConsumer>(sample_consumer));
+    }
+    catch(...)
+    {
+      frame_queue.cancel();
+      throw;
+    }
+  }
+
   int subtract(int arg1, int arg2)
   {
     int result;
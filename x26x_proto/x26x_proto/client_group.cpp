@@ -0,0 +1,22 @@
+/*
+ * Copyright (C) 2026 CodeShop B.V.
+ *
+ * This file is part of the x26x service protocol library.
+ *
+ * The x26x service protocol library is free software: you can
+ * redistribute it and/or modify it under the terms of version 2.1 of
+ * the GNU Lesser General Public License as published by the Free
+ * Software Foundation.
+ *
+ * The x26x service protocol library is distributed in the hope that
+ * it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See version 2.1 of the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of version 2.1 of the GNU Lesser
+ * General Public License along with the x26x service protocol
+ * library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "client_group.hpp"
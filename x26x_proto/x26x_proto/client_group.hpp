@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2026 CodeShop B.V.
+ *
+ * This file is part of the x26x service protocol library.
+ *
+ * The x26x service protocol library is free software: you can
+ * redistribute it and/or modify it under the terms of version 2.1 of
+ * the GNU Lesser General Public License as published by the Free
+ * Software Foundation.
+ *
+ * The x26x service protocol library is distributed in the hope that
+ * it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See version 2.1 of the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of version 2.1 of the GNU Lesser
+ * General Public License along with the x26x service protocol
+ * library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef X26X_PROTO_CLIENT_GROUP_HPP_
+#define X26X_PROTO_CLIENT_GROUP_HPP_
+
+#include "client.hpp"
+#include "linkage.h"
+#include "types.hpp"
+
+#include <cuti/endpoint.hpp>
+#include <cuti/input_list.hpp>
+#include <cuti/logging_context.hpp>
+#include <cuti/nb_client_cache.hpp>
+#include <cuti/output_list.hpp>
+#include <cuti/rpc_client_group.hpp>
+#include <cuti/throughput_checker.hpp>
+
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+namespace x26x_proto
+{
+
+/*
+ * Drives any number of concurrent calls, possibly to different
+ * servers, from a single thread; for example, the encodes for all
+ * the rungs of a bitrate ladder.  See cuti::rpc_client_group_t.
+ */
+template<typename SessionParams, typename SampleHeaders>
+struct client_group_t
+{
+  using client_types_t = client_t<SessionParams, SampleHeaders>;
+
+  using call_id_t = cuti::rpc_client_group_t::call_id_t;
+  using completion_t = cuti::rpc_client_group_t::completion_t;
+
+  client_group_t(cuti::logging_context_t const& context,
+                 cuti::nb_client_cache_t& client_cache,
+                 cuti::throughput_settings_t settings =
+                   cuti::throughput_settings_t())
+  : rpc_client_group_(context, client_cache, std::move(settings))
+  { }
+
+  client_group_t(client_group_t const&) = delete;
+  client_group_t& operator=(client_group_t const&) = delete;
+
+  std::size_t size() const
+  { return rpc_client_group_.size(); }
+
+  bool busy() const
+  { return rpc_client_group_.busy(); }
+
+  std::optional<completion_t> step()
+  { return rpc_client_group_.step(); }
+
+  completion_t complete_next_call()
+  { return rpc_client_group_.complete_next_call(); }
+
+  template<typename Result, typename Arg1, typename Arg2>
+  call_id_t start_add(cuti::endpoint_t const& server_address,
+                      Result&& result, Arg1&& arg1, Arg2&& arg2)
+  {
+    auto inputs = cuti::make_input_list_ptr<
+      typename client_types_t::add_reply_types_t>(
+        std::forward<Result>(result));
+
+    auto outputs = cuti::make_output_list_ptr<
+      typename client_types_t::add_request_types_t>(
+        std::forward<Arg1>(arg1), std::forward<Arg2>(arg2));
+
+    return rpc_client_group_.start(
+      server_address, "add", std::move(inputs), std::move(outputs));
+  }
+
+  template<typename SampleHeadersConsumer, typename SampleConsumer,
+           typename SessionParamsProducer, typename FrameProducer>
+  call_id_t start_encode(cuti::endpoint_t const& server_address,
+                         SampleHeadersConsumer&& sample_headers_consumer,
+                         SampleConsumer&& sample_consumer,
+                         SessionParamsProducer&& session_params_producer,
+                         FrameProducer&& frame_producer)
+  {
+    auto inputs = cuti::make_input_list_ptr<
+      typename client_types_t::encode_reply_types_t>(
+        std::forward<SampleHeadersConsumer>(sample_headers_consumer),
+        std::forward<SampleConsumer>(sample_consumer));
+
+    auto outputs = cuti::make_output_list_ptr<
+      typename client_types_t::encode_request_types_t>(
+        std::forward<SessionParamsProducer>(session_params_producer),
+        std::forward<FrameProducer>(frame_producer));
+
+    return rpc_client_group_.start(
+      server_address, "encode", std::move(inputs), std::move(outputs));
+  }
+
+  template<typename SampleHeadersConsumer, typename SampleConsumer,
+           typename SessionParamsProducer, typename FrameProducer>
+  call_id_t start_encode_ladder(cuti::endpoint_t const& server_address,
+                                SampleHeadersConsumer&& sample_headers_consumer,
+                                SampleConsumer&& sample_consumer,
+                                SessionParamsProducer&& session_params_producer,
+                                FrameProducer&& frame_producer)
+  {
+    auto inputs = cuti::make_input_list_ptr<
+      typename client_types_t::encode_ladder_reply_types_t>(
+        std::forward<SampleHeadersConsumer>(sample_headers_consumer),
+        std::forward<SampleConsumer>(sample_consumer));
+
+    auto outputs = cuti::make_output_list_ptr<
+      typename client_types_t::encode_ladder_request_types_t>(
+        std::forward<SessionParamsProducer>(session_params_producer),
+        std::forward<FrameProducer>(frame_producer));
+
+    return rpc_client_group_.start(
+      server_address, "encode_ladder", std::move(inputs), std::move(outputs));
+  }
+
+private :
+  cuti::rpc_client_group_t rpc_client_group_;
+};
+
+} // x26x_proto
+
+#endif
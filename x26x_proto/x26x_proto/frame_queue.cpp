@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2026 CodeShop B.V.
+ *
+ * This file is part of the x26x service protocol library.
+ *
+ * The x26x service protocol library is free software: you can
+ * redistribute it and/or modify it under the terms of version 2.1 of
+ * the GNU Lesser General Public License as published by the Free
+ * Software Foundation.
+ *
+ * The x26x service protocol library is distributed in the hope that
+ * it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See version 2.1 of the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of version 2.1 of the GNU Lesser
+ * General Public License along with the x26x service protocol
+ * library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "frame_queue.hpp"
+
+#include <cuti/exception_builder.hpp>
+
+#include <cassert>
+#include <stdexcept>
+#include <utility>
+
+namespace x26x_proto
+{
+
+frame_queue_t::frame_queue_t(std::size_t capacity)
+: mutex_()
+, not_full_()
+, not_empty_()
+, ring_((assert(capacity != 0), capacity))
+, first_(0)
+, size_(0)
+, closed_(false)
+, canceled_(false)
+{ }
+
+bool frame_queue_t::push(frame_t frame)
+{
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    assert(!closed_);
+
+    not_full_.wait(lock,
+      [this] { return size_ != ring_.size() || canceled_; });
+    if(canceled_)
+    {
+      return false;
+    }
+
+    ring_[(first_ + size_) % ring_.size()] = std::move(frame);
+    ++size_;
+  }
+  not_empty_.notify_one();
+
+  return true;
+}
+
+void frame_queue_t::close()
+{
+  {
+    std::scoped_lock<std::mutex> lock(mutex_);
+    closed_ = true;
+  }
+  not_empty_.notify_one();
+}
+
+std::optional<frame_t> frame_queue_t::pop()
+{
+  std::optional<frame_t> result = std::nullopt;
+
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    not_empty_.wait(lock,
+      [this] { return size_ != 0 || closed_ || canceled_; });
+    if(canceled_)
+    {
+      cuti::exception_builder_t<std::runtime_error> builder;
+      builder << "frame queue canceled";
+      builder.explode();
+    }
+    if(size_ == 0)
+    {
+      return result;
+    }
+
+    result.emplace(std::move(ring_[first_]));
+    first_ = (first_ + 1) % ring_.size();
+    --size_;
+  }
+  not_full_.notify_one();
+
+  return result;
+}
+
+void frame_queue_t::cancel()
+{
+  {
+    std::scoped_lock<std::mutex> lock(mutex_);
+    canceled_ = true;
+    for(; size_ != 0; --size_)
+    {
+      ring_[first_] = frame_t();
+      first_ = (first_ + 1) % ring_.size();
+    }
+  }
+  not_full_.notify_all();
+  not_empty_.notify_all();
+}
+
+} // x26x_proto
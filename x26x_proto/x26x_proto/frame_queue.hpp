@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2026 CodeShop B.V.
+ *
+ * This file is part of the x26x service protocol library.
+ *
+ * The x26x service protocol library is free software: you can
+ * redistribute it and/or modify it under the terms of version 2.1 of
+ * the GNU Lesser General Public License as published by the Free
+ * Software Foundation.
+ *
+ * The x26x service protocol library is distributed in the hope that
+ * it will be useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See version 2.1 of the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of version 2.1 of the GNU Lesser
+ * General Public License along with the x26x service protocol
+ * library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef X26X_PROTO_FRAME_QUEUE_HPP_
+#define X26X_PROTO_FRAME_QUEUE_HPP_
+
+#include "linkage.h"
+#include "types.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace x26x_proto
+{
+
+/*
+ * A bounded, thread-safe ring of frames, for feeding an encode call
+ * from a thread that produces frames (say, a decoder) while the
+ * client thread sends them.  At most capacity frames are buffered:
+ * push() waits for the client to catch up, so memory use does not
+ * depend on the length of the segment.
+ *
+ * Pass the queue to client_t::encode_stream(), which cancels the
+ * queue if the encode call fails; if the producer fails, it should
+ * cancel the queue to make the encode call fail.
+ *
+ * Please note that pop() blocks the thread calling it, which, for an
+ * encode call, is the thread running the client's scheduler.  Any
+ * other clients sharing that scheduler are stalled while the queue is
+ * empty, so a producer that may fall behind should not feed a client
+ * on a shared scheduler.
+ */
+struct X26X_PROTO_ABI frame_queue_t
+{
+  static std::size_t constexpr default_capacity = 8;
+
+  explicit frame_queue_t(std::size_t capacity = default_capacity);
+
+  frame_queue_t(frame_queue_t const&) = delete;
+  frame_queue_t& operator=(frame_queue_t const&) = delete;
+
+  /*
+   * Adds a frame, waiting while the queue is full.  Returns false,
+   * dropping the frame, if the queue is canceled.
+   * PRE: close() has not been called.
+   */
+  bool push(frame_t frame);
+
+  /*
+   * Marks the end of the frames; pop() returns std::nullopt once the
+   * queue is drained.  No effect on a canceled queue.
+   */
+  void close();
+
+  /*
+   * Removes the oldest frame, waiting while the queue is empty and
+   * not closed.  Returns std::nullopt at the end of the frames.
+   * Throws if the queue is canceled.
+   */
+  std::optional<frame_t> pop();
+
+  /*
+   * Cancels the queue, dropping any buffered frames and waking up any
+   * waiting push() or pop(); from now on, push() returns false and
+   * pop() throws.
+   */
+  void cancel();
+
+private :
+  std::mutex mutex_;
+  std::condition_variable not_full_;
+  std::condition_variable not_empty_;
+  std::vector<frame_t> ring_;
+  std::size_t first_;
+  std::size_t size_;
+  bool closed_;
+  bool canceled_;
+};
+
+} // x26x_proto
+
+#endif
@@ -97,6 +97,13 @@ std::string to_string(sample_t::type_t type)
       std::to_string(cuti::to_underlying(type));
   }
 }
+
+rendition_sample_t::rendition_sample_t()
+: rendition_(0)
+, sample_()
+{
+}
+
 } // x26x_proto
 
 x26x_proto::format_t
@@ -212,3 +219,22 @@ cuti::tuple_mapping_t<x26x_proto::sample_t>::from_tuple(tuple_t tuple)
   value.data_ = std::move(std::get<3>(tuple));
   return value;
 }
+
+cuti::tuple_mapping_t<x26x_proto::rendition_sample_t>::tuple_t
+cuti::tuple_mapping_t<x26x_proto::rendition_sample_t>::to_tuple(
+  x26x_proto::rendition_sample_t value)
+{
+  return tuple_t(
+    value.rendition_,
+    std::move(value.sample_));
+}
+
+x26x_proto::rendition_sample_t
+cuti::tuple_mapping_t<x26x_proto::rendition_sample_t>::from_tuple(
+  tuple_t tuple)
+{
+  x26x_proto::rendition_sample_t value;
+  value.rendition_ = std::get<0>(tuple);
+  value.sample_ = std::move(std::get<1>(tuple));
+  return value;
+}
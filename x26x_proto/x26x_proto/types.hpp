@@ -99,6 +99,20 @@ struct X26X_PROTO_ABI sample_t
 
 X26X_PROTO_ABI std::string to_string(sample_t::type_t type);
 
+/*
+ * A sample produced by an encode_ladder request, tagged with the
+ * index of its rendition in the request's session parameters.
+ */
+struct X26X_PROTO_ABI rendition_sample_t
+{
+  rendition_sample_t();
+
+  uint32_t rendition_;
+  sample_t sample_;
+
+  bool operator==(rendition_sample_t const& rhs) const = default;
+};
+
 } // x26x_proto
 
 // adapters for cuti serialization
@@ -168,4 +182,16 @@ struct X26X_PROTO_ABI cuti::tuple_mapping_t<x26x_proto::sample_t>
   static x26x_proto::sample_t from_tuple(tuple_t tuple);
 };
 
+template<>
+struct X26X_PROTO_ABI cuti::tuple_mapping_t<x26x_proto::rendition_sample_t>
+{
+  using tuple_t = std::tuple<
+    uint32_t,
+    x26x_proto::sample_t>;
+
+  static tuple_t to_tuple(x26x_proto::rendition_sample_t value);
+
+  static x26x_proto::rendition_sample_t from_tuple(tuple_t tuple);
+};
+
 #endif